@@ -106,6 +106,163 @@ extern "C" {
   */
 //#define KWE_ECP_SHORT_WEIERSTRASS_ENABLED
 
+/**
+  * \def KWE_CCB_PERSISTENT_SESSION_ENABLED
+  *
+  * Keeps the CCB initialized between asymmetric operations instead of
+  * running HAL_CCB_Init and HAL_CCB_DeInit around each of them.
+  * The session is closed by KWE_CcbSessionClose(), by KWE_CcbSessionPoll()
+  * once idle for KWE_CCB_SESSION_IDLE_TIMEOUT, or after a CCB error.
+  * KWE_CcbSessionIdleCallback() is called each time the session stays open,
+  * the application schedules KWE_CcbSessionPoll() from it
+  * KWE_CCB_SESSION_IDLE_TIMEOUT_MS later.
+  *
+  * Comment this macro to release the CCB after every operation.
+  *
+  * Requires KWE_ASYMMETRIC_KEY_WRAP_ENABLED.
+  */
+#define KWE_CCB_PERSISTENT_SESSION_ENABLED
+
+/**
+  * \def KWE_CCB_SESSION_IDLE_TIMEOUT
+  *
+  * Idle time, in KWE_GET_TICK() units, after which KWE_CcbSessionPoll()
+  * closes the CCB session.
+  *
+  * Requires KWE_CCB_PERSISTENT_SESSION_ENABLED.
+  */
+#define KWE_CCB_SESSION_IDLE_TIMEOUT    (100U)
+
+/**
+  * \def KWE_CCB_SESSION_IDLE_TIMEOUT_MS
+  *
+  * Delay, in ms, after which the application calls KWE_CcbSessionPoll()
+  * once the session is idle. It must not be shorter than
+  * KWE_CCB_SESSION_IDLE_TIMEOUT, whatever the KWE_GET_TICK() time base,
+  * or the session is left open.
+  *
+  * Requires KWE_CCB_PERSISTENT_SESSION_ENABLED.
+  */
+#define KWE_CCB_SESSION_IDLE_TIMEOUT_MS (100U)
+
+/**
+  * \def KWE_GET_TICK
+  *
+  * Time base used by KWE session statistics and idle timeout.
+  * HAL_GetTick() has a 1 ms resolution, define it to a cycle counter
+  * (e.g. DWT->CYCCNT) for finer setup versus compute time figures.
+  */
+#define KWE_GET_TICK()                  HAL_GetTick()
+
+/**
+  * \def KWE_AES_KEY_RESIDENCY_ENABLED
+  *
+  * Keeps the last unwrapped AES key loaded in the SAES key registers and
+  * skips HAL_CRYPEx_UnwrapKey when the next operation uses the same wrapped
+  * key. The resident key is dropped by KWE_AesKeyInvalidate(), on key
+  * destroy, when another SAES or CCB user runs, or after an error.
+  *
+  * Comment this macro to unwrap the AES key on every operation.
+  *
+  * Requires PSA_KWE_DRIVER_ENABLED.
+  */
+#define KWE_AES_KEY_RESIDENCY_ENABLED
+
+/**
+  * \def KWE_AES_ASYNC_ENABLED
+  *
+  * Enables KWE_AesCipherUpdateAsync(), which runs SAES transfers by
+  * interrupt and reports completion through a callback, so that the calling
+  * thread gets the CPU back during long encryptions.
+  *
+  * The KWE core then defines HAL_CRYP_OutCpltCallback() and
+  * HAL_CRYP_ErrorCallback(), so the application cannot define them.
+  * KWE_AesAsyncIRQHandler() must be called from the SAES interrupt, and
+  * KWE_AesAsyncProcess() from thread context each time the interrupt calls
+  * KWE_AesAsyncScheduleCallback(): it unwraps the key for the next chunk.
+  * The Zephyr application does so with a work item, and needs CONFIG_POLL
+  * for the k_poll_signal raised on completion.
+  *
+  * Uncomment this macro to enable asynchronous AES operations.
+  *
+  * Requires PSA_KWE_DRIVER_ENABLED.
+  */
+//#define KWE_AES_ASYNC_ENABLED
+
+/**
+  * \def KWE_AES_ASYNC_DMA_ENABLED
+  *
+  * Moves the data of asynchronous AES operations by DMA instead of by
+  * interrupt. The application links the SAES input and output DMA channels
+  * to hcryp in HAL_CRYP_MspInit() and services their interrupts.
+  *
+  * Uncomment a macro to use DMA for asynchronous AES operations.
+  *
+  * Requires KWE_AES_ASYNC_ENABLED and HAL_DMA_MODULE_ENABLED.
+  */
+//#define KWE_AES_ASYNC_DMA_ENABLED
+
+/**
+  * \def KWE_WORKSPACE_ECC_MAX_SIZE
+  *
+  * Size in bytes of the largest enabled curve order, used for the ECDSA
+  * digest and the ECDH shared point held in the KWE workspace.
+  * 32U for P-256, 48U for P-384, 66U for P-521.
+  *
+  * Requires KWE_ASYMMETRIC_KEY_WRAP_ENABLED and MBEDTLS_ECDSA_C or
+  * MBEDTLS_ECDH_C.
+  */
+#define KWE_WORKSPACE_ECC_MAX_SIZE      (66U)
+
+/**
+  * \def KWE_WORKSPACE_RSA_MAX_SIZE
+  *
+  * Size in bytes of the largest enabled RSA modulus, used for the encoded
+  * message held in the KWE workspace.
+  *
+  * Requires KWE_ASYMMETRIC_KEY_WRAP_ENABLED and MBEDTLS_RSA_C.
+  */
+#define KWE_WORKSPACE_RSA_MAX_SIZE      (512U)
+
+/**
+  * \def KWE_ECC_PUBLIC_KEY_CACHE_SIZE
+  *
+  * Number of public keys kept in RAM for ECC blobs created before the
+  * public key was stored with the wrapped key. Such a public key is
+  * computed on its first export and then returned from the cache.
+  *
+  * Set to 0U to compute the public key of these blobs on every export.
+  *
+  * Requires PSA_KWE_DRIVER_ENABLED.
+  */
+#define KWE_ECC_PUBLIC_KEY_CACHE_SIZE   (4U)
+
+/**
+  * \def KWE_ECDSA_BATCH_SIZE
+  *
+  * Number of ECDSA digests prepared in the KWE workspace and signed in one
+  * CCB session by mbedtls_kwe_opaque_signature_sign_hash_batch(). Larger
+  * batches are split in chunks of this size.
+  *
+  * Set to 1U to keep a single digest in the workspace, batches are then
+  * signed one digest at a time.
+  *
+  * Requires KWE_ASYMMETRIC_KEY_WRAP_ENABLED and MBEDTLS_ECDSA_C.
+  */
+#define KWE_ECDSA_BATCH_SIZE            (8U)
+
+/**
+  * \def KWE_PROVISION_MAX_KEYS
+  *
+  * Largest number of keys provisioned by one call to
+  * mbedtls_kwe_opaque_provision_keys(). It must not exceed
+  * ITS_BATCH_MAX_OBJECTS as all the keys are stored in one batch. The
+  * wrapped keys are held in a heap buffer during the call.
+  *
+  * Requires PSA_KWE_DRIVER_ENABLED and PSA_USE_ITS_ALT.
+  */
+#define KWE_PROVISION_MAX_KEYS          (16U)
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +63,52 @@ extern "C" {
   */
 //#define HW_CRYPTO_DPA_AES
 
+/**
+  * @brief MBEDTLS_HAL_AES_SW_THRESHOLD Length in bytes under which the ST AES
+  *        alternative module processes a message with its software AES
+  *        instead of the AES hardware accelerator, whose setup and polling
+  *        overhead dominates for short messages.
+  *        mbedtls_aes_hw_calibrate() replaces it at run time by the measured
+  *        crossover of the two implementations.
+  *
+  * @note The software AES is bitsliced, without any table, so that it runs
+  *       in constant time. It is not used with HW_CRYPTO_DPA_AES.
+  *
+  *       Set to 0 to process all the messages with the hardware accelerator,
+  *       comment the macro to remove the software AES.
+  *       Requires: MBEDTLS_HAL_AES_ALT
+  */
+#if defined(CONFIG_AES_SW_THRESHOLD)
+#define MBEDTLS_HAL_AES_SW_THRESHOLD    CONFIG_AES_SW_THRESHOLD
+#else
+#define MBEDTLS_HAL_AES_SW_THRESHOLD    (64U)
+#endif /* CONFIG_AES_SW_THRESHOLD */
+
+/**
+  * @brief MBEDTLS_HAL_CRYP_DMA_THRESHOLD Length in bytes from which the ST AES
+  *        and GCM alternative modules move the data of a peripheral call by
+  *        DMA, and block the calling thread until the transfer completes,
+  *        instead of feeding the peripheral word by word.
+  *        The DMA channels and the blocking primitive are given at init by
+  *        mbedtls_aes_hw_dma_setup(), transfers are polled until then.
+  *
+  * @note  The length is compared with the length of each peripheral call,
+  *        at most 1024 bytes with MBEDTLS_THREADING_C. Buffers that are not
+  *        32-bit aligned, partial blocks, and a GCM payload continuing a
+  *        partial block are still fed by the CPU.
+  *
+  *       Set CONFIG_CRYP_DMA_THRESHOLD to 0, or comment the macro, to poll
+  *       all the transfers.
+  *       Requires: MBEDTLS_HAL_AES_ALT, HAL_DMA_MODULE_ENABLED
+  */
+#if defined(CONFIG_CRYP_DMA_THRESHOLD)
+#if (CONFIG_CRYP_DMA_THRESHOLD > 0)
+#define MBEDTLS_HAL_CRYP_DMA_THRESHOLD  CONFIG_CRYP_DMA_THRESHOLD
+#endif /* CONFIG_CRYP_DMA_THRESHOLD > 0 */
+#else
+#define MBEDTLS_HAL_CRYP_DMA_THRESHOLD  (256U)
+#endif /* CONFIG_CRYP_DMA_THRESHOLD */
+
 
 /**
   * @brief MBEDTLS_HAL_GCM_ALT Enables ST GCM alternative module to replace mbed
@@ -122,15 +168,49 @@ extern "C" {
   *        registers to memory, and then be restored from memory to the HASH
   *        registers.
   *
+  *        The registers are only saved, and those of the next context
+  *        restored, when another context uses the HASH peripheral.
+  *
   *        Uncomment a macro to enable ST HASH save context.
   *        Requires: MBEDTLS_SHA256_ALT.
   */
 //#define ST_HW_CONTEXT_SAVING
 
+/**
+  * @brief MBEDTLS_HAL_HASH_BATCH_QUANTUM Bytes hashed for each context per
+  *        turn of mbedtls_sha256_update_batch() and
+  *        mbedtls_sha1_update_batch(). A smaller quantum serves the short
+  *        updates of a batch sooner, a larger one saves context switches.
+  *
+  *        Uncomment a macro to change the default of 512 bytes.
+  *        Requires: MBEDTLS_HAL_SHA256_ALT or MBEDTLS_HAL_SHA1_ALT.
+  */
+//#define MBEDTLS_HAL_HASH_BATCH_QUANTUM  ((size_t) 512)
+
+/**
+  * @brief MBEDTLS_HAL_HMAC_ALT Enables ST HMAC alternative module to compute
+  *        the PSA HMAC-SHA-1, HMAC-SHA-224 and HMAC-SHA-256 algorithms, and
+  *        the HKDF and TLS PRF derivations built on them, with the HMAC mode
+  *        of STM32 HASH hardware accelerator instead of two software padded
+  *        hash passes.
+  *
+  *        An HMAC operation keeps its key and inner hash in the HASH
+  *        registers between updates, so it needs ST_HW_CONTEXT_SAVING to
+  *        give the peripheral to other hash or HMAC contexts.
+  *
+  *        Uncomment a macro to enable ST HMAC hardware alternative module.
+  *        Requires: MBEDTLS_PSA_BUILTIN_ALG_HMAC, ST_HW_CONTEXT_SAVING.
+  */
+//#define MBEDTLS_HAL_HMAC_ALT
+
 #if defined(ST_HW_CONTEXT_SAVING) && (USE_HAL_HASH_SUSPEND_RESUME != 1U)
 #error "Enable USE_HAL_HASH_SUSPEND_RESUME flag to save HASH context"
 #endif /* ST_HW_CONTEXT_SAVING && USE_HAL_HASH_SUSPEND_RESUME */
 
+#if defined(MBEDTLS_HAL_HMAC_ALT) && !defined(ST_HW_CONTEXT_SAVING)
+#error "MBEDTLS_HAL_HMAC_ALT requires ST_HW_CONTEXT_SAVING"
+#endif /* MBEDTLS_HAL_HMAC_ALT && !ST_HW_CONTEXT_SAVING */
+
 /**
   * @brief MBEDTLS_HAL_ECDSA_ALT Enables ST ECDSA alternative module to replace
   *        mbed TLS ECDSA sign and  verify functions by ST ECDSA alternative
@@ -173,6 +253,24 @@ extern "C" {
   */
 //#define MBEDTLS_HAL_RSA_ALT
 
+/**
+  * @brief MBEDTLS_HAL_PKA_GET_TICK Time base of the PKA session statistics
+  *        read by mbedtls_pka_session_get_stats(). Within a session opened by
+  *        mbedtls_pka_session_start(), the ECDSA, ECDH, ECP and RSA
+  *        alternative modules keep the PKA initialized between operations
+  *        and clear its RAM when mbedtls_pka_session_end() closes it, or
+  *        as soon as an operation on secret operands ends.
+  *
+  *        Left undefined, the statistics use HAL_GetTick(). It has a 1 ms
+  *        resolution, define it to a cycle counter started by the
+  *        application (e.g. DWT->CYCCNT) to compare the setup time of a
+  *        certificate chain verified in a session and operation by
+  *        operation.
+  *        Requires: MBEDTLS_HAL_ECDSA_ALT, MBEDTLS_HAL_ECDH_ALT,
+  *                  MBEDTLS_HAL_ECP_ALT or MBEDTLS_HAL_RSA_ALT.
+  */
+//#define MBEDTLS_HAL_PKA_GET_TICK()  (DWT->CYCCNT)
+
 /**
   * @brief MBEDTLS_HAL_ENTROPY_HARDWARE_ALT Enables ST entropy source module
   *        to replace mbed TLS entropy module by ST entropy implementation
@@ -3435,6 +3435,31 @@
  */
 //#define MBEDTLS_SHA256_USE_A64_CRYPTO_ONLY
 
+/**
+ * \def MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT
+ *
+ * Enable acceleration of the SHA-256 and SHA-224 cryptographic hash algorithms
+ * with the x86 SHA extensions (SHA-NI) if they are available at runtime, and
+ * hash the buffers of mbedtls_sha256_batch() eight at a time in the lanes of
+ * AVX2 registers on CPUs that have AVX2 but not SHA-NI. Both are detected
+ * with CPUID. If neither is present, the library will fall back to the C
+ * implementation.
+ *
+ * \note This is meant for host builds, for instance tooling that hashes many
+ * small objects. If MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT is defined when
+ * building for a non-x86-64 target it will be silently ignored.
+ *
+ * \note    Minimum compiler versions for this feature are Clang 3.9 or GCC 5.0.
+ *
+ * Requires: MBEDTLS_SHA256_C.
+ *
+ * Module:  library/sha256.c
+ *
+ * Uncomment to have the library check for the x86 SHA extensions and AVX2
+ * and use them if available.
+ */
+//#define MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT
+
 /**
  * \def MBEDTLS_SHA384_C
  *
@@ -4073,6 +4098,34 @@
  */
 //#define MBEDTLS_PSA_KEY_SLOT_COUNT 32
 
+/** \def MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE
+ * The number of GCM contexts that the one-shot psa_aead_encrypt() and
+ * psa_aead_decrypt() keep with their key set, so that consecutive messages
+ * with the same key skip the key schedule and the hash subkey computation.
+ * The least recently used context is replaced on a miss, and the contexts
+ * of a key are dropped by psa_destroy_key().
+ *
+ * Each context holds the key schedule of its key, kept in RAM after the
+ * message is processed until the key is destroyed or the context is
+ * replaced. Default: 0, the cache is disabled.
+ *
+ * This option has no effect when #MBEDTLS_PSA_CRYPTO_C is disabled.
+ */
+//#define MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE 4
+
+/** \def MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE
+ * The largest number of ECDSA signatures that mbedtls_psa_verify_hash_batch()
+ * gives to the PKA at a time, when #MBEDTLS_HAL_ECDSA_ALT and
+ * #MBEDTLS_ECDSA_VERIFY_ALT are enabled. The keys of these signatures stay
+ * locked while they are verified and each signature takes about 50 bytes
+ * of stack on a 32-bit target.
+ *
+ * Set to 1 to verify the signatures of a batch one by one.
+ *
+ * This option has no effect when #MBEDTLS_PSA_CRYPTO_C is disabled.
+ */
+//#define MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE 8
+
 /* RSA OPTIONS */
 //#define MBEDTLS_RSA_GEN_KEY_MIN_BITS            1024 /**<  Minimum RSA key size that can be generated in bits (Minimum possible value is 128 bits) */
 
@@ -13,6 +13,7 @@ NOT NEEDED #include "stm32u3xx_nucleo.h"
 
 
 #include <stdint.h>
+#include "kwe_core.h"
 
 int crypto_main(void);
 /* Exported types ------------------------------------------------------------*/
@@ -20,6 +21,9 @@ int crypto_main(void);
 /* Exported variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
+#if defined(KWE_AES_ASYNC_ENABLED)
+void crypto_kwe_async_signal(KWE_StatusTypeDef status, void *p_context);
+#endif /* KWE_AES_ASYNC_ENABLED */
 
 #ifdef __cplusplus
 }
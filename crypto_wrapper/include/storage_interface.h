@@ -25,6 +25,13 @@
 #include "psa_its_alt.h"
 
 /* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint64_t obj_uid;                 /*!< Unique identifier of the object */
+  uint32_t obj_length;              /*!< Size of the object in bytes */
+  const void *p_obj;                /*!< Pointer to the object to be stored */
+} storage_obj_t;
+
 /* Exported constants --------------------------------------------------------*/
 #define ITS_ENCRYPTION_SECRET_KEY_ID  ((psa_key_id_t)0x2FFFAAAA)
 
@@ -44,5 +51,8 @@ psa_status_t storage_get_info(uint64_t obj_uid,
 
 psa_status_t storage_remove(uint64_t obj_uid, uint32_t obj_size);
 
+psa_status_t storage_set_batch(const storage_obj_t *p_objs,
+                               uint32_t obj_count);
+
 #endif  /* STORAGE_INTERFACE_H */
 
@@ -34,19 +34,60 @@
 #if defined(MBEDTLS_AES_C)
 #if defined(MBEDTLS_AES_ALT)
 #include <string.h>
+#include <stdint.h>
 #include "mbedtls/aes.h"
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+#if defined(HW_CRYPTO_DPA_AES) && defined(KWE_DRIVER_ENABLED)
+#include "kwe_core.h"
+#endif /* HW_CRYPTO_DPA_AES && KWE_DRIVER_ENABLED */
 
 #if defined(MBEDTLS_HAL_AES_ALT)
 
+/* Global variables ----------------------------------------------------------*/
+#if defined(MBEDTLS_THREADING_C)
+/*
+ * Lock of the CRYP peripheral, shared by the AES and CCM contexts. AES calls
+ * hold it for one block operation, or for one slice of ST_AES_SLICE_SIZE
+ * bytes of a long CBC or CTR buffer, so that a waiting thread is never held
+ * for more than a slice by each thread served before it.
+ */
+mbedtls_threading_mutex_t cryp_mutex;
+unsigned char cryp_mutex_started = 0;
+unsigned int cryp_context_count = 0;
+#endif /* MBEDTLS_THREADING_C */
+
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 #define ST_AES_TIMEOUT     0xFFU   /* 255 ms timeout for the crypto processor */
 #define ST_AES_NO_ALGO     0xFFFFU /* any algo is programmed */
+#if defined(MBEDTLS_THREADING_C)
+#define ST_AES_SLICE_SIZE  1024U   /* bytes processed per CRYP lock */
+#else
+#define ST_AES_SLICE_SIZE  0xFFF0U /* largest block multiple of a HAL call */
+#endif /* MBEDTLS_THREADING_C */
+#define ST_AES_BULK_BLOCKS 32U     /* XTS/CFB/OFB blocks per HAL call, 512 bytes */
+#define ST_AES_CALIBRATION_SIZES  7U   /* 16 to 1024 bytes */
+#define ST_AES_CALIBRATION_ROUNDS 8U   /* operations averaged per measure */
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+#define ST_AES_DMA_MAX_SIZE 0xFFF0U    /* largest block multiple of a DMA transfer */
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
 
 /* Private macro -------------------------------------------------------------*/
+#if defined(HW_CRYPTO_DPA_AES) && defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+/*
+ * SAES is shared with the key wrap engine: drop the wrapped key it keeps
+ * loaded before reprogramming the peripheral
+ */
+#define ST_SAES_CLAIM()   KWE_AesKeyInvalidate()
+#else
+#define ST_SAES_CLAIM()
+#endif /* HW_CRYPTO_DPA_AES && KWE_AES_KEY_RESIDENCY_ENABLED */
+
 /*
  * 32-bit integer manipulation macros (big endian)
  */
@@ -71,14 +112,894 @@
 #endif /* PUT_UINT32_BE */
 
 /* Private variables ---------------------------------------------------------*/
+/*
+ * Context whose key and configuration are loaded in the peripheral. Calls on
+ * this context with the same algorithm, direction and chaining value skip
+ * the peripheral reconfiguration and the key and IV loads.
+ */
+static struct
+{
+  mbedtls_aes_context *p_ctx; /* Owner of the peripheral, NULL if none */
+  uint32_t algorithm;         /* Algorithm programmed for the owner */
+  int mode;                   /* MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT */
+  uint32_t iv_valid;          /* iv holds the chaining value left in the peripheral */
+  uint32_t iv[4];             /* CBC IV or CTR counter left in the peripheral */
+} st_aes_owner;
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+/*
+ * DMA channels of the peripheral, and the primitive the calling thread
+ * blocks on during a transfer, given by mbedtls_aes_hw_dma_setup()
+ */
+static struct
+{
+  AES_TypeDef *instance;          /* Peripheral served, NULL if no DMA */
+  DMA_HandleTypeDef *hdma_in;     /* Memory to peripheral input channel */
+  DMA_HandleTypeDef *hdma_out;    /* Peripheral output to memory channel */
+  int (*wait)(uint32_t timeout);  /* Block until signal() */
+  void (*signal)(void);           /* Wake the blocked thread */
+  volatile uint32_t error;        /* Set by a channel error */
+} st_aes_dma;
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+/*
+ * Take the CRYP peripheral for the calling thread
+ */
+static int st_aes_lock(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_lock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return 0;
+}
+
+/*
+ * Hand the CRYP peripheral over to the next waiting thread. ret is returned
+ * unless the unlock fails.
+ */
+static int st_aes_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_unlock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return ret;
+}
+
+/*
+ * Make the peripheral ready for a call on ctx. The configuration is only
+ * applied when the ownership, the algorithm or the direction changes, or
+ * when the IV given is not the chaining value left in the peripheral.
+ * iv is NULL for ECB. To be called with the CRYP lock held.
+ */
+static int st_aes_acquire(mbedtls_aes_context *ctx,
+                          uint32_t algorithm,
+                          int mode,
+                          uint32_t *iv)
+{
+  if ((st_aes_owner.p_ctx == ctx)
+      && (st_aes_owner.algorithm == algorithm)
+      && (st_aes_owner.mode == mode)
+      && ((iv == NULL)
+          || ((st_aes_owner.iv_valid != 0U) && (memcmp(st_aes_owner.iv, iv, sizeof(st_aes_owner.iv)) == 0))))
+  {
+    return 0;
+  }
+
+  if (st_aes_owner.p_ctx != ctx)
+  {
+    /* allow multi-instance of CRYP use: switch the CRYP hw module context */
+    mbedtls_aes_hw_release();
+    ST_SAES_CLAIM();
+    ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
+  }
+
+  ctx->hcryp_aes.Init.Algorithm = ctx->Algorithm = algorithm;
+  ctx->hcryp_aes.Init.pInitVect = iv;
+  ctx->hcryp_aes.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ONCE;
+
+  /* Configure the CRYP */
+  if (HAL_CRYP_SetConfig(&ctx->hcryp_aes, &ctx->hcryp_aes.Init) != HAL_OK)
+  {
+    st_aes_owner.p_ctx = NULL;
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  /* Key and IV are loaded by the next process call only */
+  ctx->hcryp_aes.KeyIVConfig = 0U;
+
+  st_aes_owner.p_ctx = ctx;
+  st_aes_owner.algorithm = algorithm;
+  st_aes_owner.mode = mode;
+  st_aes_owner.iv_valid = 0U;
+
+  return 0;
+}
+
+/*
+ * Record the chaining value left in the peripheral by the owner
+ */
+static void st_aes_save_iv(const unsigned char iv[16])
+{
+  GET_UINT32_BE(st_aes_owner.iv[0], iv, 0);
+  GET_UINT32_BE(st_aes_owner.iv[1], iv, 4);
+  GET_UINT32_BE(st_aes_owner.iv[2], iv, 8);
+  GET_UINT32_BE(st_aes_owner.iv[3], iv, 12);
+  st_aes_owner.iv_valid = 1U;
+}
+
+/*
+ * Process length bytes, a multiple of 16, with the configured peripheral.
+ * Long aligned buffers are moved by DMA once the HAL has loaded the key and
+ * the IV with the first block, other buffers are polled by the HAL. To be
+ * called with the CRYP lock held.
+ */
+static HAL_StatusTypeDef st_aes_process(mbedtls_aes_context *ctx,
+                                        int mode,
+                                        size_t length,
+                                        const unsigned char *input,
+                                        unsigned char *output)
+{
+  HAL_StatusTypeDef status;
+  size_t hal_length = length;
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+  if (mbedtls_aes_hw_dma_usable(&ctx->hcryp_aes, input, output, length))
+  {
+    hal_length = 16U;
+  }
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
+  if (mode == MBEDTLS_AES_DECRYPT)
+  {
+    status = HAL_CRYP_Decrypt(&ctx->hcryp_aes, (uint32_t *)input, hal_length, (uint32_t *)output, ST_AES_TIMEOUT);
+  }
+  else
+  {
+    status = HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, hal_length, (uint32_t *)output, ST_AES_TIMEOUT);
+  }
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+  if ((status == HAL_OK) && (hal_length < length)
+      && (mbedtls_aes_hw_dma_transfer(&ctx->hcryp_aes, input + hal_length, output + hal_length,
+                                      length - hal_length) != 0))
+  {
+    status = HAL_ERROR;
+  }
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
+  return status;
+}
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+/*
+ * Software AES, bitsliced so that it runs in constant time without any
+ * table: bit b of the 16 state bytes is held in the word q[b], the byte of
+ * row r and column c being at bit 4 * c + r.
+ */
+#define ST_AES_XTIME(x)    ((((x) << 1) ^ ((((x) >> 7) & 1U) * 0x1BU)) & 0xFFU)
+#define ST_AES_ROW(r)      (0x1111UL << (r))
+
+#ifndef GET_UINT32_LE
+#define GET_UINT32_LE(n,b,i)                            \
+  do {                                                    \
+    (n) = ( (uint32_t) (b)[(i)    ]       )             \
+          | ( (uint32_t) (b)[(i) + 1] <<  8 )             \
+          | ( (uint32_t) (b)[(i) + 2] << 16 )             \
+          | ( (uint32_t) (b)[(i) + 3] << 24 );            \
+  } while( 0 )
+#endif /* GET_UINT32_LE */
+
+#ifndef PUT_UINT32_LE
+#define PUT_UINT32_LE(n,b,i)                            \
+  do {                                                    \
+    (b)[(i)    ] = (unsigned char) ( (n)       );       \
+    (b)[(i) + 1] = (unsigned char) ( (n) >>  8 );       \
+    (b)[(i) + 2] = (unsigned char) ( (n) >> 16 );       \
+    (b)[(i) + 3] = (unsigned char) ( (n) >> 24 );       \
+  } while( 0 )
+#endif /* PUT_UINT32_LE */
+
+/* Messages shorter than this length are processed in software */
+static size_t st_aes_sw_threshold = MBEDTLS_HAL_AES_SW_THRESHOLD;
+
+/*
+ * Bitslice a block into q
+ */
+static void st_aes_ct_load(uint32_t q[8], const unsigned char block[16])
+{
+  uint32_t b;
+  uint32_t k;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    q[b] = 0U;
+    for (k = 0U; k < 16U; k++)
+    {
+      q[b] |= (((uint32_t) block[k] >> b) & 1U) << k;
+    }
+  }
+}
+
+/*
+ * Gather the bytes of q into a block
+ */
+static void st_aes_ct_store(unsigned char block[16], const uint32_t q[8])
+{
+  uint32_t b;
+  uint32_t k;
+  uint32_t v;
+
+  for (k = 0U; k < 16U; k++)
+  {
+    v = 0U;
+    for (b = 0U; b < 8U; b++)
+    {
+      v |= ((q[b] >> k) & 1U) << b;
+    }
+    block[k] = (unsigned char) v;
+  }
+}
+
+/*
+ * SubBytes, with the Boyar-Peralta S-box circuit
+ */
+static void st_aes_ct_sbox(uint32_t q[8])
+{
+  uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+  uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+  uint32_t y20, y21;
+  uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+  uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+  uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+  uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+  uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+  uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+  uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+  uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+  uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+  uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation */
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9 = x0 ^ x3;
+  y8 = x0 ^ x5;
+  t0 = x1 ^ x2;
+  y1 = t0 ^ x7;
+  y4 = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2 = y1 ^ x0;
+  y5 = y1 ^ x6;
+  y3 = y5 ^ y8;
+  t1 = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6 = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7 = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non-linear section, the inversion in GF(2^8) */
+  t2 = y12 & y15;
+  t3 = y3 & y6;
+  t4 = t3 ^ t2;
+  t5 = y4 & x7;
+  t6 = t5 ^ t2;
+  t7 = y13 & y16;
+  t8 = y5 & y1;
+  t9 = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0 = t44 & y15;
+  z1 = t37 & y6;
+  z2 = t33 & x7;
+  z3 = t43 & y16;
+  z4 = t40 & y1;
+  z5 = t29 & y7;
+  z6 = t42 & y11;
+  z7 = t45 & y17;
+  z8 = t41 & y10;
+  z9 = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation */
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0 = t59 ^ t63;
+  s6 = t56 ^ ~t62;
+  s7 = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3 = t53 ^ t66;
+  s4 = t51 ^ t66;
+  s5 = t47 ^ t65;
+  s1 = t64 ^ ~s3;
+  s2 = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+}
+
+/*
+ * Inverse of the linear part of the S-box affine transformation
+ */
+static void st_aes_ct_inv_affine(uint32_t q[8])
+{
+  uint32_t t[8];
+  uint32_t b;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    t[b] = q[(b + 2U) & 7U] ^ q[(b + 5U) & 7U] ^ q[(b + 7U) & 7U];
+  }
+  for (b = 0U; b < 8U; b++)
+  {
+    q[b] = t[b];
+  }
+}
+
+/*
+ * InvSubBytes, through the S-box circuit: the inversion in GF(2^8) is
+ * S(x) with the affine transformation undone, InvS(y) = A^-1(S(A^-1(y)))
+ * where A^-1(y) = M^-1.y ^ 0x05
+ */
+static void st_aes_ct_inv_sbox(uint32_t q[8])
+{
+  st_aes_ct_inv_affine(q);
+  q[0] = ~q[0];
+  q[2] = ~q[2];
+  st_aes_ct_sbox(q);
+  st_aes_ct_inv_affine(q);
+  q[0] = ~q[0];
+  q[2] = ~q[2];
+}
+
+/*
+ * Rotation of the 16 state bits right by n positions
+ */
+static inline uint32_t st_aes_ct_rotr16(uint32_t x, uint32_t n)
+{
+  return ((x >> n) | (x << (16U - n))) & 0xFFFFU;
+}
+
+/*
+ * Byte of row r + n of each column moved to row r
+ */
+static inline uint32_t st_aes_ct_rotc(uint32_t x, uint32_t n)
+{
+  uint32_t mask = 0x1111U * ((1U << (4U - n)) - 1U);
+
+  return ((x >> n) & mask) | ((x << (4U - n)) & (~mask & 0xFFFFU));
+}
+
+static void st_aes_ct_shift_rows(uint32_t q[8])
+{
+  uint32_t b;
+  uint32_t x;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    x = q[b];
+    q[b] = (x & ST_AES_ROW(0))
+           | st_aes_ct_rotr16(x & ST_AES_ROW(1), 4U)
+           | st_aes_ct_rotr16(x & ST_AES_ROW(2), 8U)
+           | st_aes_ct_rotr16(x & ST_AES_ROW(3), 12U);
+  }
+}
+
+static void st_aes_ct_inv_shift_rows(uint32_t q[8])
+{
+  uint32_t b;
+  uint32_t x;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    x = q[b];
+    q[b] = (x & ST_AES_ROW(0))
+           | st_aes_ct_rotr16(x & ST_AES_ROW(1), 12U)
+           | st_aes_ct_rotr16(x & ST_AES_ROW(2), 8U)
+           | st_aes_ct_rotr16(x & ST_AES_ROW(3), 4U);
+  }
+}
+
+/*
+ * Multiplication of the 16 bytes by x in GF(2^8)
+ */
+static void st_aes_ct_xtime(uint32_t q[8])
+{
+  uint32_t hi = q[7];
+  uint32_t b;
+
+  for (b = 7U; b > 0U; b--)
+  {
+    q[b] = q[b - 1U];
+  }
+  q[0] = hi;
+  q[1] ^= hi;
+  q[3] ^= hi;
+  q[4] ^= hi;
+}
+
+/*
+ * MixColumns: a'[r] = 2.(a[r] ^ a[r+1]) ^ a[r+1] ^ a[r+2] ^ a[r+3]
+ */
+static void st_aes_ct_mix_columns(uint32_t q[8])
+{
+  uint32_t t[8];
+  uint32_t r1;
+  uint32_t b;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    r1 = st_aes_ct_rotc(q[b], 1U);
+    t[b] = q[b] ^ r1;
+    q[b] = r1 ^ st_aes_ct_rotc(q[b], 2U) ^ st_aes_ct_rotc(q[b], 3U);
+  }
+  st_aes_ct_xtime(t);
+  for (b = 0U; b < 8U; b++)
+  {
+    q[b] ^= t[b];
+  }
+}
+
+/*
+ * InvMixColumns, as MixColumns after a'[r] = a[r] ^ 4.(a[r] ^ a[r+2])
+ */
+static void st_aes_ct_inv_mix_columns(uint32_t q[8])
+{
+  uint32_t t[8];
+  uint32_t b;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    t[b] = q[b] ^ st_aes_ct_rotc(q[b], 2U);
+  }
+  st_aes_ct_xtime(t);
+  st_aes_ct_xtime(t);
+  for (b = 0U; b < 8U; b++)
+  {
+    q[b] ^= t[b];
+  }
+  st_aes_ct_mix_columns(q);
+}
+
+static void st_aes_ct_add_round_key(uint32_t q[8], const uint32_t *rk)
+{
+  uint32_t b;
+
+  for (b = 0U; b < 8U; b++)
+  {
+    q[b] ^= rk[b];
+  }
+}
+
+/*
+ * SubWord of the key schedule
+ */
+static uint32_t st_aes_ct_sub_word(uint32_t x)
+{
+  unsigned char block[16] = {0};
+  uint32_t q[8];
+
+  PUT_UINT32_LE(x, block, 0);
+  st_aes_ct_load(q, block);
+  st_aes_ct_sbox(q);
+  st_aes_ct_store(block, q);
+  GET_UINT32_LE(x, block, 0);
+
+  mbedtls_platform_zeroize(q, sizeof(q));
+  mbedtls_platform_zeroize(block, sizeof(block));
+
+  return x;
+}
+
+/*
+ * Software AES key schedule, keybits is 128 or 256. The round keys are
+ * stored bitsliced, and used in reverse order for the decryption.
+ */
+static void st_aes_sw_setkey(mbedtls_aes_context *ctx,
+                             const unsigned char *key,
+                             unsigned int keybits)
+{
+  uint32_t w[60];
+  unsigned char block[16];
+  uint32_t nk = keybits / 32U;
+  uint32_t rcon = 1U;
+  uint32_t tmp;
+  uint32_t i;
+
+  ctx->sw_nr = nk + 6U;
+
+  for (i = 0U; i < nk; i++)
+  {
+    GET_UINT32_LE(w[i], key, 4U * i);
+  }
+
+  for (i = nk; i < (4U * (ctx->sw_nr + 1U)); i++)
+  {
+    tmp = w[i - 1U];
+    if ((i % nk) == 0U)
+    {
+      /* RotWord, SubWord and round constant */
+      tmp = st_aes_ct_sub_word((tmp >> 8) | (tmp << 24)) ^ rcon;
+      rcon = ST_AES_XTIME(rcon);
+    }
+    else if ((nk > 6U) && ((i % nk) == 4U))
+    {
+      tmp = st_aes_ct_sub_word(tmp);
+    }
+    w[i] = w[i - nk] ^ tmp;
+  }
+
+  for (i = 0U; i <= ctx->sw_nr; i++)
+  {
+    PUT_UINT32_LE(w[(4U * i)], block, 0);
+    PUT_UINT32_LE(w[(4U * i) + 1U], block, 4);
+    PUT_UINT32_LE(w[(4U * i) + 2U], block, 8);
+    PUT_UINT32_LE(w[(4U * i) + 3U], block, 12);
+    st_aes_ct_load(&ctx->sw_rk[8U * i], block);
+  }
+
+  mbedtls_platform_zeroize(w, sizeof(w));
+  mbedtls_platform_zeroize(block, sizeof(block));
+}
+
+/*
+ * Software AES block encryption/decryption
+ */
+static void st_aes_sw_crypt_block(const mbedtls_aes_context *ctx,
+                                  int mode,
+                                  const unsigned char input[16],
+                                  unsigned char output[16])
+{
+  const uint32_t *rk = ctx->sw_rk;
+  uint32_t q[8];
+  uint32_t round;
+
+  st_aes_ct_load(q, input);
+
+  if (mode == MBEDTLS_AES_DECRYPT)
+  {
+    st_aes_ct_add_round_key(q, &rk[8U * ctx->sw_nr]);
+    for (round = ctx->sw_nr - 1U; round > 0U; round--)
+    {
+      st_aes_ct_inv_shift_rows(q);
+      st_aes_ct_inv_sbox(q);
+      st_aes_ct_add_round_key(q, &rk[8U * round]);
+      st_aes_ct_inv_mix_columns(q);
+    }
+    st_aes_ct_inv_shift_rows(q);
+    st_aes_ct_inv_sbox(q);
+    st_aes_ct_add_round_key(q, rk);
+  }
+  else
+  {
+    st_aes_ct_add_round_key(q, rk);
+    for (round = 1U; round < ctx->sw_nr; round++)
+    {
+      st_aes_ct_sbox(q);
+      st_aes_ct_shift_rows(q);
+      st_aes_ct_mix_columns(q);
+      st_aes_ct_add_round_key(q, &rk[8U * round]);
+    }
+    st_aes_ct_sbox(q);
+    st_aes_ct_shift_rows(q);
+    st_aes_ct_add_round_key(q, &rk[8U * ctx->sw_nr]);
+  }
+
+  st_aes_ct_store(output, q);
+  mbedtls_platform_zeroize(q, sizeof(q));
+}
+
+/*
+ * Whether a message of length bytes on ctx is processed in software
+ */
+static int st_aes_use_sw(const mbedtls_aes_context *ctx, size_t length)
+{
+  return (ctx->sw_nr != 0U) && (length < st_aes_sw_threshold);
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC) || defined(MBEDTLS_CIPHER_MODE_CFB) \
+    || defined(MBEDTLS_CIPHER_MODE_OFB)
+/*
+ * Software AES-CBC encryption/decryption, length is a multiple of 16
+ */
+static void st_aes_sw_crypt_cbc(const mbedtls_aes_context *ctx,
+                                int mode,
+                                size_t length,
+                                unsigned char iv[16],
+                                const unsigned char *input,
+                                unsigned char *output)
+{
+  unsigned char tmp[16];
+  size_t i;
+
+  for (; length > 0U; length -= 16U, input += 16, output += 16)
+  {
+    if (mode == MBEDTLS_AES_DECRYPT)
+    {
+      memcpy(tmp, input, 16);
+      st_aes_sw_crypt_block(ctx, MBEDTLS_AES_DECRYPT, input, output);
+      for (i = 0U; i < 16U; i++)
+      {
+        output[i] ^= iv[i];
+      }
+      memcpy(iv, tmp, 16);
+    }
+    else
+    {
+      for (i = 0U; i < 16U; i++)
+      {
+        output[i] = input[i] ^ iv[i];
+      }
+      st_aes_sw_crypt_block(ctx, MBEDTLS_AES_ENCRYPT, output, output);
+      memcpy(iv, output, 16);
+    }
+  }
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC || MBEDTLS_CIPHER_MODE_CFB || MBEDTLS_CIPHER_MODE_OFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+/*
+ * Software AES-CTR, length is a multiple of 16. Only the 32-bit low word of
+ * the counter is incremented, as the peripheral does.
+ */
+static void st_aes_sw_crypt_ctr(const mbedtls_aes_context *ctx,
+                                size_t length,
+                                unsigned char nonce_counter[16],
+                                const unsigned char *input,
+                                unsigned char *output)
+{
+  unsigned char stream[16];
+  size_t i;
+
+  for (; length > 0U; length -= 16U, input += 16, output += 16)
+  {
+    st_aes_sw_crypt_block(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream);
+    for (i = 0U; i < 16U; i++)
+    {
+      output[i] = input[i] ^ stream[i];
+    }
+
+    for (i = 16U; i > 12U; i--)
+    {
+      if (++nonce_counter[i - 1U] != 0U)
+      {
+        break;
+      }
+    }
+  }
+
+  mbedtls_platform_zeroize(stream, sizeof(stream));
+}
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+#if defined(MBEDTLS_CIPHER_MODE_XTS) || defined(MBEDTLS_CIPHER_MODE_CFB)
+/*
+ * AES-ECB encryption/decryption of several blocks in one peripheral call,
+ * length is a multiple of 16 not larger than ST_AES_SLICE_SIZE
+ */
+static int st_aes_crypt_ecb_blocks(mbedtls_aes_context *ctx,
+                                   int mode,
+                                   size_t length,
+                                   const unsigned char *input,
+                                   unsigned char *output)
+{
+  int ret = 0;
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  if (st_aes_use_sw(ctx, length))
+  {
+    for (; length > 0U; length -= 16U, input += 16, output += 16)
+    {
+      st_aes_sw_crypt_block(ctx, mode, input, output);
+    }
+    return 0;
+  }
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+  ret = st_aes_lock();
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  ret = st_aes_acquire(ctx, CRYP_AES_ECB, mode, NULL);
+  if (ret != 0)
+  {
+    goto exit;
+  }
+
+  if (st_aes_process(ctx, mode, length, input, output) != HAL_OK)
+  {
+    st_aes_owner.p_ctx = NULL;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+exit:
+  return st_aes_unlock(ret);
+}
+#endif /* MBEDTLS_CIPHER_MODE_XTS || MBEDTLS_CIPHER_MODE_CFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC) || defined(MBEDTLS_CIPHER_MODE_CFB) \
+    || defined(MBEDTLS_CIPHER_MODE_OFB)
+/*
+ * AES-CBC encryption/decryption of one slice, under the CRYP lock
+ */
+static int st_aes_cbc_slice(mbedtls_aes_context *ctx,
+                            int mode,
+                            size_t length,
+                            unsigned char iv[16],
+                            const unsigned char *input,
+                            unsigned char *output)
+{
+  int ret = 0;
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  if (st_aes_use_sw(ctx, length))
+  {
+    st_aes_sw_crypt_cbc(ctx, mode, length, iv, input, output);
+    return 0;
+  }
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+  ret = st_aes_lock();
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  /* Set IV with invert endianness */
+  GET_UINT32_BE(ctx->iv[0], iv, 0);
+  GET_UINT32_BE(ctx->iv[1], iv, 4);
+  GET_UINT32_BE(ctx->iv[2], iv, 8);
+  GET_UINT32_BE(ctx->iv[3], iv, 12);
+
+  /* Nothing to reconfigure if iv chains from the previous call */
+  ret = st_aes_acquire(ctx, CRYP_AES_CBC, mode, ctx->iv);
+  if (ret != 0)
+  {
+    goto exit;
+  }
+
+  if (mode == MBEDTLS_AES_DECRYPT)
+  {
+    if (st_aes_process(ctx, mode, length, input, output) != HAL_OK)
+    {
+      st_aes_owner.p_ctx = NULL;
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+
+    /* Get IV vector for the next call */
+    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR3, iv, 0);
+    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR2, iv, 4);
+    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR1, iv, 8);
+    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR0, iv, 12);
+
+  }
+  else
+  {
+    if (st_aes_process(ctx, mode, length, input, output) != HAL_OK)
+    {
+      st_aes_owner.p_ctx = NULL;
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+
+    /* current output is the IV vector for the next call */
+    memcpy(iv, &output[length - 16], 16);
+  }
+
+  /* The peripheral IV registers hold the IV of the next call */
+  st_aes_save_iv(iv);
+  ctx->hcryp_aes.Instance->CR &= ~AES_CR_EN;
+
+exit:
+  return st_aes_unlock(ret);
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC || MBEDTLS_CIPHER_MODE_CFB || MBEDTLS_CIPHER_MODE_OFB */
+
 static int aes_set_key(mbedtls_aes_context *ctx,
                        const unsigned char *key,
                        unsigned int keybits)
 {
   unsigned int i = 0;
+  int ret = 0;
 
   switch (keybits)
   {
@@ -128,10 +1049,19 @@ static int aes_set_key(mbedtls_aes_context *ctx,
   }
 #endif /* HW_CRYPTO_DPA_AES */
 
+  ret = st_aes_lock();
+  if (ret != 0)
+  {
+    return ret;
+  }
+
   /* Deinitializes the CRYP peripheral */
+  mbedtls_aes_hw_release();
+  ST_SAES_CLAIM();
   if (HAL_CRYP_DeInit(&ctx->hcryp_aes) != HAL_OK)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
   }
 
 #if defined(HW_CRYPTO_DPA_AES)
@@ -144,13 +1074,20 @@ static int aes_set_key(mbedtls_aes_context *ctx,
 
   if (HAL_CRYP_Init(&ctx->hcryp_aes) != HAL_OK)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
   }
 
   /* allow multi-instance of CRYP use: save context for CRYP HW module CR */
   ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR;
 
-  return 0;
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  /* Same key for the short messages processed in software */
+  st_aes_sw_setkey(ctx, key, keybits);
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+exit:
+  return st_aes_unlock(ret);
 }
 
 /* Implementation that should never be optimized out by the compiler */
@@ -165,6 +1102,17 @@ static void mbedtls_zeroize(void *value, size_t size)
 
 void mbedtls_aes_init(mbedtls_aes_context *ctx)
 {
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  /* mutex cannot be initialized twice */
+  if (!cryp_mutex_started)
+  {
+    mbedtls_mutex_init(&cryp_mutex);
+    cryp_mutex_started = 1;
+  }
+  cryp_context_count++;
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
 
   memset(ctx, 0, sizeof(mbedtls_aes_context));
 
@@ -178,9 +1126,285 @@ void mbedtls_aes_free(mbedtls_aes_context *ctx)
     return;
   }
 
+  /* The peripheral must not be handed back to a freed context */
+  (void) st_aes_lock();
+  if (st_aes_owner.p_ctx == ctx)
+  {
+    st_aes_owner.p_ctx = NULL;
+  }
+  (void) st_aes_unlock(0);
+
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  if (cryp_context_count > 0)
+  {
+    cryp_context_count--;
+  }
+
+  /* mutex is freed with the last context */
+  if ((cryp_context_count == 0) && cryp_mutex_started)
+  {
+    mbedtls_mutex_free(&cryp_mutex);
+    cryp_mutex_started = 0;
+  }
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
+
   mbedtls_zeroize(ctx, sizeof(mbedtls_aes_context));
 }
 
+/*
+ * Save the context owning the peripheral and forget it, before another
+ * driver or context reprograms the peripheral. To be called with the CRYP
+ * lock held.
+ */
+void mbedtls_aes_hw_release(void)
+{
+  if (st_aes_owner.p_ctx != NULL)
+  {
+    st_aes_owner.p_ctx->ctx_save_cr = st_aes_owner.p_ctx->hcryp_aes.Instance->CR;
+    st_aes_owner.p_ctx = NULL;
+  }
+}
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+/*
+ * Output channel transfer complete, from the DMA interrupt
+ */
+static void st_aes_dma_complete(DMA_HandleTypeDef *hdma)
+{
+  (void) hdma;
+
+  st_aes_dma.signal();
+}
+
+/*
+ * Channel transfer error, from the DMA interrupt
+ */
+static void st_aes_dma_error(DMA_HandleTypeDef *hdma)
+{
+  (void) hdma;
+
+  st_aes_dma.error = 1U;
+  st_aes_dma.signal();
+}
+
+void mbedtls_aes_hw_dma_setup(AES_TypeDef *instance,
+                              DMA_HandleTypeDef *hdma_in,
+                              DMA_HandleTypeDef *hdma_out,
+                              int (*wait)(uint32_t timeout),
+                              void (*signal)(void))
+{
+  if ((hdma_in == NULL) || (hdma_out == NULL) || (wait == NULL) || (signal == NULL))
+  {
+    st_aes_dma.instance = NULL;
+  }
+  else
+  {
+    hdma_in->XferCpltCallback = NULL;
+    hdma_in->XferErrorCallback = st_aes_dma_error;
+    hdma_out->XferCpltCallback = st_aes_dma_complete;
+    hdma_out->XferErrorCallback = st_aes_dma_error;
+
+    st_aes_dma.hdma_in = hdma_in;
+    st_aes_dma.hdma_out = hdma_out;
+    st_aes_dma.wait = wait;
+    st_aes_dma.signal = signal;
+    st_aes_dma.instance = instance;
+  }
+}
+
+int mbedtls_aes_hw_dma_usable(const CRYP_HandleTypeDef *hcryp,
+                              const unsigned char *input,
+                              const unsigned char *output,
+                              size_t length)
+{
+  return (st_aes_dma.instance != NULL)
+         && (hcryp->Instance == st_aes_dma.instance)
+         && (length >= MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+         && (length > 16U)
+         && ((length % 16U) == 0U)
+         && ((((uintptr_t) input | (uintptr_t) output) & 3U) == 0U);
+}
+
+/*
+ * The DMA requests are enabled once both channels run, and disabled after
+ * the last output word. A transfer that fails or times out leaves the
+ * peripheral in an unknown state: the caller forgets its configuration.
+ */
+int mbedtls_aes_hw_dma_transfer(CRYP_HandleTypeDef *hcryp,
+                                const unsigned char *input,
+                                unsigned char *output,
+                                size_t length)
+{
+  AES_TypeDef *instance = hcryp->Instance;
+  size_t chunk;
+  int ret = 0;
+
+  while ((length > 0U) && (ret == 0))
+  {
+    chunk = (length < ST_AES_DMA_MAX_SIZE) ? length : ST_AES_DMA_MAX_SIZE;
+    st_aes_dma.error = 0U;
+
+    if (HAL_DMA_Start_IT(st_aes_dma.hdma_out, (uint32_t) &instance->DOUTR, (uint32_t) output, chunk) != HAL_OK)
+    {
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+    if (HAL_DMA_Start_IT(st_aes_dma.hdma_in, (uint32_t) input, (uint32_t) &instance->DINR, chunk) != HAL_OK)
+    {
+      (void) HAL_DMA_Abort(st_aes_dma.hdma_out);
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    instance->CR |= AES_CR_DMAINEN | AES_CR_DMAOUTEN | AES_CR_EN;
+
+    if ((st_aes_dma.wait(ST_AES_TIMEOUT) != 0) || (st_aes_dma.error != 0U))
+    {
+      (void) HAL_DMA_Abort(st_aes_dma.hdma_in);
+      (void) HAL_DMA_Abort(st_aes_dma.hdma_out);
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    instance->CR &= ~(AES_CR_DMAINEN | AES_CR_DMAOUTEN);
+    __HAL_CRYP_CLEAR_FLAG(hcryp, CRYP_CLEAR_CCF);
+
+    length -= chunk;
+    input += chunk;
+    output += chunk;
+  }
+
+  return ret;
+}
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
+#if defined(HW_CRYPTO_DPA_AES) && defined(KWE_DRIVER_ENABLED)
+/*
+ * The key wrap engine reprograms SAES, or its key registers are lost
+ */
+void KWE_AesKeyInvalidateCallback(void)
+{
+  mbedtls_aes_hw_release();
+}
+#endif /* HW_CRYPTO_DPA_AES && KWE_DRIVER_ENABLED */
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+void mbedtls_aes_hw_set_threshold(size_t threshold)
+{
+  st_aes_sw_threshold = threshold;
+}
+
+size_t mbedtls_aes_hw_get_threshold(void)
+{
+  return st_aes_sw_threshold;
+}
+
+/*
+ * Time CBC encryptions of length bytes with the current threshold
+ */
+static int st_aes_calibrate_measure(mbedtls_aes_context *ctx,
+                                    unsigned char *buffer,
+                                    size_t length,
+                                    uint32_t *p_cycles)
+{
+  unsigned char iv[16] = {0};
+  uint32_t round;
+  uint32_t start;
+  int ret = 0;
+
+  start = DWT->CYCCNT;
+  for (round = 0U; (round < ST_AES_CALIBRATION_ROUNDS) && (ret == 0); round++)
+  {
+    ret = mbedtls_aes_crypt_cbc(ctx, MBEDTLS_AES_ENCRYPT, length, iv, buffer, buffer);
+  }
+  *p_cycles = (DWT->CYCCNT - start) / ST_AES_CALIBRATION_ROUNDS;
+
+  return ret;
+}
+
+/*
+ * Time CBC encryptions through both paths with the DWT cycle counter, then
+ * through the dispatch with the threshold found. To be called before other
+ * threads use AES, as the threshold is switched during the measures.
+ */
+int mbedtls_aes_hw_calibrate(uint32_t *p_hw_cycles,
+                             uint32_t *p_sw_cycles,
+                             uint32_t *p_hybrid_cycles,
+                             size_t count)
+{
+  static const unsigned char key[16] =
+  {
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+    0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+  };
+  __ALIGN_BEGIN unsigned char buffer[16U << (ST_AES_CALIBRATION_SIZES - 1U)] __ALIGN_END;
+  mbedtls_aes_context ctx;
+  size_t previous_threshold = st_aes_sw_threshold;
+  size_t threshold = 16U << ST_AES_CALIBRATION_SIZES;
+  size_t length;
+  size_t i;
+  uint32_t cycles[2];
+  uint32_t path;
+  int ret = 0;
+
+  if ((count == 0U) || (count > ST_AES_CALIBRATION_SIZES))
+  {
+    return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+  }
+
+  /* Start the cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  memset(buffer, 0, sizeof(buffer));
+  mbedtls_aes_init(&ctx);
+  ret = mbedtls_aes_setkey_enc(&ctx, key, 128);
+
+  for (i = 0U; (i < count) && (ret == 0); i++)
+  {
+    length = 16U << i;
+
+    /* Peripheral first, then software */
+    for (path = 0U; (path < 2U) && (ret == 0); path++)
+    {
+      st_aes_sw_threshold = (path == 0U) ? 0U : SIZE_MAX;
+      ret = st_aes_calibrate_measure(&ctx, buffer, length, &cycles[path]);
+    }
+
+    if (p_hw_cycles != NULL)
+    {
+      p_hw_cycles[i] = cycles[0];
+    }
+    if (p_sw_cycles != NULL)
+    {
+      p_sw_cycles[i] = cycles[1];
+    }
+
+    /* Shortest length for which the peripheral is faster */
+    if ((cycles[0] < cycles[1]) && (length < threshold))
+    {
+      threshold = length;
+    }
+  }
+
+  /* Dispatch with the calibrated threshold */
+  st_aes_sw_threshold = threshold;
+  for (i = 0U; (i < count) && (ret == 0); i++)
+  {
+    ret = st_aes_calibrate_measure(&ctx, buffer, 16U << i, &cycles[0]);
+    if (p_hybrid_cycles != NULL)
+    {
+      p_hybrid_cycles[i] = cycles[0];
+    }
+  }
+
+  mbedtls_aes_free(&ctx);
+
+  st_aes_sw_threshold = (ret == 0) ? threshold : previous_threshold;
+
+  return ret;
+}
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
 #if defined(MBEDTLS_CIPHER_MODE_XTS)
 void mbedtls_aes_xts_init(mbedtls_aes_xts_context *ctx)
 {
@@ -312,66 +1536,43 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx,
 {
   int ret = 0;
 
-  /* allow multi-instance of CRYP use: restore context for CRYP hw module */
-  ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  if (st_aes_use_sw(ctx, 16U))
+  {
+    st_aes_sw_crypt_block(ctx, mode, input, output);
+    return 0;
+  }
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
 
-  /* Set the Algo if not configured till now */
-  if (CRYP_AES_ECB != ctx->Algorithm)
+  ret = st_aes_lock();
+  if (ret != 0)
   {
-    ctx->hcryp_aes.Init.Algorithm = ctx->Algorithm = CRYP_AES_ECB;
+    return ret;
+  }
 
-    /* Configure the CRYP  */
-    if (HAL_CRYP_SetConfig(&ctx->hcryp_aes, &ctx->hcryp_aes.Init) != HAL_OK)
-    {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-    }
+  ret = st_aes_acquire(ctx, CRYP_AES_ECB, mode, NULL);
+  if (ret != 0)
+  {
+    goto exit;
   }
 
   if (mode == MBEDTLS_AES_DECRYPT)   /* AES decryption */
   {
     ret = mbedtls_internal_aes_decrypt(ctx, input, output);
-    if (ret != 0)
-    {
-      return ret;
-    }
   }
   else     /* AES encryption */
   {
     ret = mbedtls_internal_aes_encrypt(ctx, input, output);
-    if (ret != 0)
-    {
-      return ret;
-    }
   }
-  /* allow multi-instance of CRYP use: save context for CRYP HW module CR */
-  ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR;
 
-  return 0;
+exit:
+  return st_aes_unlock(ret);
 }
 
 #if defined(MBEDTLS_CIPHER_MODE_CBC)
 /*
  * AES-CBC buffer encryption/decryption
  */
-static int st_cbc_restore_context(mbedtls_aes_context *ctx)
-{
-  /* allow multi-instance of CRYP use: restore context for CRYP hw module */
-  ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
-
-  /* Re-initialize AES processor with proper parameters
-     and (re-)apply key and IV for multi context usecases */
-  if (HAL_CRYP_DeInit(&ctx->hcryp_aes) != HAL_OK)
-  {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-  }
-
-  if (HAL_CRYP_Init(&ctx->hcryp_aes) != HAL_OK)
-  {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-  }
-  return 0;
-}
-
 int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
                           int mode,
                           size_t length,
@@ -379,7 +1580,7 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
                           const unsigned char *input,
                           unsigned char *output)
 {
-  __ALIGN_BEGIN static uint32_t iv_32B[4] __ALIGN_END;
+  size_t slice_length;
   int ret = 0;
 
   if (length % 16)
@@ -387,61 +1588,22 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
     return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
   }
 
-  ret = st_cbc_restore_context(ctx);
-  if (ret != 0)
-  {
-    return ret;
-  }
-
-  /* Set the Algo if not configured till now */
-  if (CRYP_AES_CBC != ctx->Algorithm)
-  {
-    ctx->hcryp_aes.Init.Algorithm = ctx->Algorithm = CRYP_AES_CBC;
-  }
-
-  /* Set IV with invert endianness */
-  GET_UINT32_BE(iv_32B[0], iv, 0);
-  GET_UINT32_BE(iv_32B[1], iv, 4);
-  GET_UINT32_BE(iv_32B[2], iv, 8);
-  GET_UINT32_BE(iv_32B[3], iv, 12);
-
-  ctx->hcryp_aes.Init.pInitVect = iv_32B;
-
-  /* reconfigure the CRYP */
-  if (HAL_CRYP_SetConfig(&ctx->hcryp_aes, &ctx->hcryp_aes.Init) != HAL_OK)
-  {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-  }
-
-  if (mode == MBEDTLS_AES_DECRYPT)
+  /* The CRYP lock is released between slices to let other threads in */
+  while (length > 0U)
   {
-    if (HAL_CRYP_Decrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK)
-    {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-    }
+    slice_length = (length < ST_AES_SLICE_SIZE) ? length : ST_AES_SLICE_SIZE;
 
-    /* Get IV vector for the next call */
-    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR3, iv, 0);
-    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR2, iv, 4);
-    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR1, iv, 8);
-    PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR0, iv, 12);
-
-  }
-  else
-  {
-    if (HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK)
+    ret = st_aes_cbc_slice(ctx, mode, slice_length, iv, input, output);
+    if (ret != 0)
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      return ret;
     }
 
-    /* current output is the IV vector for the next call */
-    memcpy(iv, &output[length - 16], 16);
+    length -= slice_length;
+    input += slice_length;
+    output += slice_length;
   }
 
-  /* Save the internal IV vector for multi context purpose */
-  ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR; /* save here before overwritten */
-  ctx->hcryp_aes.Instance->CR &= ~AES_CR_EN;
-
   return 0;
 }
 #endif /* MBEDTLS_CIPHER_MODE_CBC */
@@ -519,6 +1681,7 @@ int mbedtls_aes_crypt_xts(mbedtls_aes_xts_context *ctx,
   unsigned char tweak[16] = {0};
   unsigned char prev_tweak[16] = {0};
   unsigned char tmp[16] = {0};
+  __ALIGN_BEGIN unsigned char tweaks[ST_AES_BULK_BLOCKS * 16] __ALIGN_END;
 
   /* Data units must be at least 16 bytes long. */
   if (length < 16)
@@ -540,21 +1703,65 @@ int mbedtls_aes_crypt_xts(mbedtls_aes_xts_context *ctx,
     return ret;
   }
 
-  while (blocks--)
+  /* The last full block of a decryption with leftover bytes is processed
+   * with the ciphertext stealing, all the others are processed in bulk. */
+  if (leftover && (mode == MBEDTLS_AES_DECRYPT))
+  {
+    blocks--;
+  }
+
+  while (blocks > 0)
   {
     size_t i = 0;
+    size_t chunk_blocks = (blocks < ST_AES_BULK_BLOCKS) ? blocks : ST_AES_BULK_BLOCKS;
+    size_t chunk_length = chunk_blocks * 16;
 
-    if (leftover && (mode == MBEDTLS_AES_DECRYPT) && blocks == 0)
+    /* Mask the blocks of the chunk with their tweak sequence */
+    for (i = 0; i < chunk_length; i += 16)
     {
-      /* We are on the last block in a decrypt operation that has
-       * leftover bytes, so we need to use the next tweak for this block,
-       * and this tweak for the leftover bytes. Save the current tweak for
-       * the leftovers and then update the current tweak for use on this,
-       * the last full block. */
-      memcpy(prev_tweak, tweak, sizeof(tweak));
+      size_t j = 0;
+
+      memcpy(&tweaks[i], tweak, sizeof(tweak));
+      for (j = 0; j < 16; j++)
+      {
+        output[i + j] = input[i + j] ^ tweak[j];
+      }
+
+      /* Update the tweak for the next block. */
       mbedtls_gf128mul_x_ble(tweak, tweak);
     }
 
+    ret = st_aes_crypt_ecb_blocks(&ctx->crypt, mode, chunk_length, output, output);
+    if (ret != 0)
+    {
+      mbedtls_platform_zeroize(tweaks, sizeof(tweaks));
+      return ret;
+    }
+
+    for (i = 0; i < chunk_length; i++)
+    {
+      output[i] ^= tweaks[i];
+    }
+
+    blocks -= chunk_blocks;
+    output += chunk_length;
+    input += chunk_length;
+  }
+
+  mbedtls_platform_zeroize(tweaks, sizeof(tweaks));
+
+  if (leftover && (mode == MBEDTLS_AES_DECRYPT))
+  {
+    size_t i = 0;
+
+    /* We are on the last block in a decrypt operation that has
+     * leftover bytes, so we need to use the next tweak for this block,
+     * and this tweak for the leftover bytes. Save the current tweak for
+     * the leftovers and then update the current tweak for use on this,
+     * the last full block. */
+    memcpy(prev_tweak, tweak, sizeof(tweak));
+    mbedtls_gf128mul_x_ble(tweak, tweak);
+
     for (i = 0; i < 16; i++)
     {
       tmp[i] = input[i] ^ tweak[i];
@@ -571,9 +1778,6 @@ int mbedtls_aes_crypt_xts(mbedtls_aes_xts_context *ctx,
       output[i] = tmp[i] ^ tweak[i];
     }
 
-    /* Update the tweak for the next block. */
-    mbedtls_gf128mul_x_ble(tweak, tweak);
-
     output += 16;
     input += 16;
   }
@@ -625,6 +1829,60 @@ int mbedtls_aes_crypt_xts(mbedtls_aes_xts_context *ctx,
 #endif /* MBEDTLS_CIPHER_MODE_XTS */
 
 #if defined(MBEDTLS_CIPHER_MODE_CFB)
+/*
+ * AES-CFB128 encryption/decryption of whole blocks, up to ST_AES_BULK_BLOCKS
+ * blocks in two peripheral calls. iv holds the previous ciphertext block.
+ */
+static int st_aes_cfb128_blocks(mbedtls_aes_context *ctx,
+                                int mode,
+                                size_t length,
+                                unsigned char iv[16],
+                                const unsigned char *input,
+                                unsigned char *output)
+{
+  int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+  size_t i = 0;
+  __ALIGN_BEGIN unsigned char stream[ST_AES_BULK_BLOCKS * 16] __ALIGN_END;
+
+  if (mode == MBEDTLS_AES_DECRYPT)
+  {
+    /* The key stream is the encryption of the ciphertext shifted by a block */
+    memcpy(stream, iv, 16);
+    memcpy(&stream[16], input, length - 16);
+    memcpy(iv, &input[length - 16], 16);
+
+    ret = st_aes_crypt_ecb_blocks(ctx, MBEDTLS_AES_ENCRYPT, length, stream, stream);
+  }
+  else
+  {
+    /* The first key stream block is the encryption of iv. Each next one is
+     * E(C) = E(P ^ K), the CBC encryption of the plaintext from it. */
+    ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, stream);
+    if ((ret == 0) && (length > 16))
+    {
+      memcpy(iv, stream, 16);
+      ret = st_aes_cbc_slice(ctx, MBEDTLS_AES_ENCRYPT, length - 16, iv, input, &stream[16]);
+    }
+  }
+
+  if (ret == 0)
+  {
+    for (i = 0; i < length; i++)
+    {
+      output[i] = input[i] ^ stream[i];
+    }
+
+    if (mode == MBEDTLS_AES_ENCRYPT)
+    {
+      memcpy(iv, &output[length - 16], 16);
+    }
+  }
+
+  mbedtls_platform_zeroize(stream, sizeof(stream));
+
+  return ret;
+}
+
 /*
  * AES-CFB128 buffer encryption/decryption
  */
@@ -639,46 +1897,60 @@ int mbedtls_aes_crypt_cfb128(mbedtls_aes_context *ctx,
   int c = 0;
   int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
   size_t n = 0;
+  size_t chunk_length = 0;
 
   n = *iv_off;
 
-  if (mode == MBEDTLS_AES_DECRYPT)
+  if (n > 15)
+  {
+    return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+  }
+
+  while (length > 0)
   {
-    while (length--)
+    /* Whole blocks from a block boundary are processed in bulk */
+    if ((n == 0) && (length >= 16))
     {
-      if (n == 0)
+      chunk_length = length & ~((size_t)0x0F);
+      if (chunk_length > (ST_AES_BULK_BLOCKS * 16))
       {
-        ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
-        if (ret != 0)
-        {
-          return ret;
-        }
+        chunk_length = ST_AES_BULK_BLOCKS * 16;
       }
 
-      c = *input++;
-      *output++ = (unsigned char)(c ^ iv[n]);
-      iv[n] = (unsigned char) c;
+      ret = st_aes_cfb128_blocks(ctx, mode, chunk_length, iv, input, output);
+      if (ret != 0)
+      {
+        return ret;
+      }
 
-      n = (n + 1) & 0x0F;
+      length -= chunk_length;
+      input += chunk_length;
+      output += chunk_length;
+      continue;
     }
-  }
-  else
-  {
-    while (length--)
+
+    if (n == 0)
     {
-      if (n == 0)
+      ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
+      if (ret != 0)
       {
-        ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
-        if (ret != 0)
-        {
-          return ret;
-        }
+        return ret;
       }
+    }
 
+    if (mode == MBEDTLS_AES_DECRYPT)
+    {
+      c = *input++;
+      *output++ = (unsigned char)(c ^ iv[n]);
+      iv[n] = (unsigned char) c;
+    }
+    else
+    {
       iv[n] = *output++ = (unsigned char)(iv[n] ^ *input++);
-
-      n = (n + 1) & 0x0F;
     }
+
+    n = (n + 1) & 0x0F;
+    length--;
   }
 
   *iv_off = n;
@@ -699,6 +1971,49 @@ int mbedtls_aes_crypt_cfb8(mbedtls_aes_context *ctx,
   int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
   unsigned char c;
   unsigned char ov[17];
+  size_t chunk_length = 0;
+  size_t i = 0;
+  unsigned char history[16 + ST_AES_BULK_BLOCKS];
+  __ALIGN_BEGIN unsigned char stream[ST_AES_BULK_BLOCKS * 16] __ALIGN_END;
+
+  /* The ciphertext is known when decrypting: the shift register of each
+   * byte is the 16 ciphertext bytes before it, so that the key stream of
+   * ST_AES_BULK_BLOCKS bytes is computed in one peripheral call. */
+  if (mode == MBEDTLS_AES_DECRYPT)
+  {
+    while (length > 0)
+    {
+      chunk_length = (length < ST_AES_BULK_BLOCKS) ? length : ST_AES_BULK_BLOCKS;
+
+      memcpy(history, iv, 16);
+      memcpy(&history[16], input, chunk_length);
+      for (i = 0; i < chunk_length; i++)
+      {
+        memcpy(&stream[i * 16], &history[i], 16);
+      }
+
+      ret = st_aes_crypt_ecb_blocks(ctx, MBEDTLS_AES_ENCRYPT, chunk_length * 16, stream, stream);
+      if (ret != 0)
+      {
+        mbedtls_platform_zeroize(stream, sizeof(stream));
+        return ret;
+      }
+
+      for (i = 0; i < chunk_length; i++)
+      {
+        output[i] = input[i] ^ stream[i * 16];
+      }
+      memcpy(iv, &history[chunk_length], 16);
+
+      length -= chunk_length;
+      input += chunk_length;
+      output += chunk_length;
+    }
+
+    mbedtls_platform_zeroize(stream, sizeof(stream));
+
+    return 0;
+  }
 
   while (length--)
   {
@@ -709,17 +2024,9 @@ int mbedtls_aes_crypt_cfb8(mbedtls_aes_context *ctx,
       return ret;
     }
 
-    if (mode == MBEDTLS_AES_DECRYPT)
-    {
-      ov[16] = *input;
-    }
-
     c = *output++ = (unsigned char)(iv[0] ^ *input++);
 
-    if (mode == MBEDTLS_AES_ENCRYPT)
-    {
-      ov[16] = c;
-    }
+    ov[16] = c;
 
     memcpy(iv, ov + 1, 16);
   }
@@ -741,6 +2048,9 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context *ctx,
 {
   int ret = 0;
   size_t n = 0;
+  size_t chunk_length = 0;
+  size_t i = 0;
+  __ALIGN_BEGIN unsigned char stream[ST_AES_BULK_BLOCKS * 16] __ALIGN_END;
 
   n = *iv_off;
 
@@ -749,8 +2059,36 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context *ctx,
     return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
   }
 
-  while (length--)
+  while (length > 0)
   {
+    /* The key stream of whole blocks is the CBC encryption of zero blocks
+     * from iv, computed in one peripheral call per chunk */
+    if ((n == 0) && (length >= 16))
+    {
+      chunk_length = length & ~((size_t)0x0F);
+      if (chunk_length > sizeof(stream))
+      {
+        chunk_length = sizeof(stream);
+      }
+
+      memset(stream, 0, chunk_length);
+      ret = st_aes_cbc_slice(ctx, MBEDTLS_AES_ENCRYPT, chunk_length, iv, stream, stream);
+      if (ret != 0)
+      {
+        goto exit;
+      }
+
+      for (i = 0; i < chunk_length; i++)
+      {
+        output[i] = input[i] ^ stream[i];
+      }
+
+      length -= chunk_length;
+      input += chunk_length;
+      output += chunk_length;
+      continue;
+    }
+
     if (n == 0)
     {
       ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
@@ -762,16 +2100,77 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context *ctx,
     *output++ =  *input++ ^ iv[n];
 
     n = (n + 1) & 0x0F;
+    length--;
   }
 
   *iv_off = n;
 
 exit:
+  mbedtls_platform_zeroize(stream, sizeof(stream));
+
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_OFB */
 
 #if defined(MBEDTLS_CIPHER_MODE_CTR)
+/*
+ * AES-CTR encryption/decryption of one slice, under the CRYP lock
+ */
+static int st_aes_ctr_slice(mbedtls_aes_context *ctx,
+                            size_t length,
+                            unsigned char nonce_counter[16],
+                            const unsigned char *input,
+                            unsigned char *output)
+{
+  int ret = 0;
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  if (st_aes_use_sw(ctx, length))
+  {
+    st_aes_sw_crypt_ctr(ctx, length, nonce_counter, input, output);
+    return 0;
+  }
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+  ret = st_aes_lock();
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  /* Set IV with invert endianness */
+  GET_UINT32_BE(ctx->iv[0], nonce_counter, 0);
+  GET_UINT32_BE(ctx->iv[1], nonce_counter, 4);
+  GET_UINT32_BE(ctx->iv[2], nonce_counter, 8);
+  GET_UINT32_BE(ctx->iv[3], nonce_counter, 12);
+
+  /* Nothing to reconfigure if the counter follows the previous call */
+  if (st_aes_acquire(ctx, CRYP_AES_CTR, MBEDTLS_AES_ENCRYPT, ctx->iv) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  if (st_aes_process(ctx, MBEDTLS_AES_ENCRYPT, length, input, output) != HAL_OK)
+  {
+    st_aes_owner.p_ctx = NULL;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  /* Get IV vector for the next call */
+  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR3, nonce_counter, 0);
+  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR2, nonce_counter, 4);
+  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR1, nonce_counter, 8);
+  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR0, nonce_counter, 12);
+
+  /* The peripheral IV registers hold the counter of the next call */
+  st_aes_save_iv(nonce_counter);
+
+exit:
+  return st_aes_unlock(ret);
+}
+
 /*
  * AES-CTR buffer encryption/decryption
  */
@@ -786,60 +2185,42 @@ int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx,
 
   size_t in_length = 0;
   size_t last_bytes = 0;
-  __ALIGN_BEGIN static uint32_t iv_32B[4] __ALIGN_END;
+  size_t slice_length;
+  int ret = 0;
   __ALIGN_BEGIN unsigned char work_buf[16] __ALIGN_END;
 
   last_bytes = length % 16U;
   in_length = length - last_bytes;
 
-  /* allow multi-instance of CRYP use: restore context for CRYP hw module */
-  ctx->hcryp_aes.Instance->CR = ctx->ctx_save_cr;
-
-  /* Set the Algo if not configured till now */
-  if (CRYP_AES_CTR != ctx->Algorithm)
+  /* The CRYP lock is released between slices to let other threads in */
+  while (in_length > 0U)
   {
-    ctx->hcryp_aes.Init.Algorithm = ctx->Algorithm = CRYP_AES_CTR;
-  }
-
-  /* Set IV with invert endianness */
-  GET_UINT32_BE(iv_32B[0], nonce_counter, 0);
-  GET_UINT32_BE(iv_32B[1], nonce_counter, 4);
-  GET_UINT32_BE(iv_32B[2], nonce_counter, 8);
-  GET_UINT32_BE(iv_32B[3], nonce_counter, 12);
+    slice_length = (in_length < ST_AES_SLICE_SIZE) ? in_length : ST_AES_SLICE_SIZE;
 
-  ctx->hcryp_aes.Init.pInitVect = iv_32B;
-  ctx->hcryp_aes.Init.KeyIVConfigSkip = CRYP_IVCONFIG_ONCE;
-
-  /* Set AES configuration */
-  if (HAL_CRYP_SetConfig(&ctx->hcryp_aes, &ctx->hcryp_aes.Init) != HAL_OK)
-  {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-  }
+    ret = st_aes_ctr_slice(ctx, slice_length, nonce_counter, input, output);
+    if (ret != 0)
+    {
+      return ret;
+    }
 
-  if (HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, in_length, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK)
-  {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    in_length -= slice_length;
+    input += slice_length;
+    output += slice_length;
   }
 
   if (last_bytes)
   {
     memset(work_buf, 0U, sizeof(work_buf));
-    memcpy(work_buf, input + in_length, last_bytes);
-    if (HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)work_buf, 16U, (uint32_t *)(output + in_length),
-                         ST_AES_TIMEOUT) != HAL_OK)
+    memcpy(work_buf, input, last_bytes);
+    ret = st_aes_ctr_slice(ctx, 16U, nonce_counter, work_buf, work_buf);
+    if (ret != 0)
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      return ret;
     }
-  }
-
-  /* Get IV vector for the next call */
-  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR3, nonce_counter, 0);
-  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR2, nonce_counter, 4);
-  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR1, nonce_counter, 8);
-  PUT_UINT32_BE(ctx->hcryp_aes.Instance->IVR0, nonce_counter, 12);
 
-  /* allow multi-instance of CRYP use: save context for CRYP HW module CR */
-  ctx->ctx_save_cr = ctx->hcryp_aes.Instance->CR;
+    /* Only the last bytes of the key stream block are output */
+    memcpy(output, work_buf, last_bytes);
+  }
 
   return 0;
 }
@@ -852,6 +2233,7 @@ int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx,
 
   if (HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, 16, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK)
   {
+    st_aes_owner.p_ctx = NULL;
     return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
   }
   return 0;
@@ -864,6 +2246,7 @@ int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx,
 {
   if (HAL_CRYP_Decrypt(&ctx->hcryp_aes, (uint32_t *)input, 16, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK)
   {
+    st_aes_owner.p_ctx = NULL;
     return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
   }
   return 0;
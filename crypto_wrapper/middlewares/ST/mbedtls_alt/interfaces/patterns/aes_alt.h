@@ -47,10 +47,26 @@
 
 #if defined(MBEDTLS_HAL_AES_ALT)
 
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+
+/* Short messages are processed in software, except for DPA protected keys */
+#if defined(MBEDTLS_HAL_AES_SW_THRESHOLD) && !defined(HW_CRYPTO_DPA_AES)
+#define MBEDTLS_HAL_AES_SW_ENABLED
+#endif /* MBEDTLS_HAL_AES_SW_THRESHOLD && !HW_CRYPTO_DPA_AES */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(MBEDTLS_THREADING_C)
+/* CRYP peripheral lock, shared by the AES and CCM contexts */
+extern mbedtls_threading_mutex_t cryp_mutex;
+extern unsigned char cryp_mutex_started;
+extern unsigned int cryp_context_count;
+#endif /* MBEDTLS_THREADING_C */
+
 /**
   * @brief          AES context structure
   */
@@ -60,6 +76,11 @@ typedef struct
   uint32_t Algorithm;            /* Algorithm set (or not) in driver */
   CRYP_HandleTypeDef hcryp_aes;  /* HW driver handle */
   uint32_t ctx_save_cr;          /* Saved HW context for multi-instance */
+  uint32_t iv[4];                /* IV or counter staged for the HW driver */
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+  uint32_t sw_nr;                /* Software AES rounds, 0 if no software key */
+  uint32_t sw_rk[120];           /* Software AES round keys, bitsliced */
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
 }
 mbedtls_aes_context;
 
@@ -80,6 +101,94 @@ int mbedtls_aes_wrap(mbedtls_aes_context *ctx,
                      uint32_t *input,
                      uint32_t *output);
 
+/**
+  * @brief          Forget the AES context whose key is loaded in the AES
+  *                 peripheral. To be called before another driver
+  *                 reprograms or de-initializes the peripheral.
+  */
+void mbedtls_aes_hw_release(void);
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED)
+/**
+  * @brief          Measure the latency of the AES peripheral and of the
+  *                 software AES for CBC encryptions of 16 to
+  *                 16 << (count - 1) bytes, set the software threshold
+  *                 to the shortest length for which the peripheral is faster,
+  *                 then measure the dispatch with that threshold.
+  *
+  * @param p_hw_cycles      Cycles per length with the peripheral, or NULL.
+  * @param p_sw_cycles      Cycles per length in software, or NULL.
+  * @param p_hybrid_cycles  Cycles per length with the calibrated threshold,
+  *                         or NULL.
+  * @param count            Number of lengths measured, 1 to 7.
+  *
+  * @return         0 on success, or an MBEDTLS_ERR_xxx error code.
+  */
+int mbedtls_aes_hw_calibrate(uint32_t *p_hw_cycles,
+                             uint32_t *p_sw_cycles,
+                             uint32_t *p_hybrid_cycles,
+                             size_t count);
+
+/**
+  * @brief          Set the length in bytes under which messages are
+  *                 processed in software, 0 to always use the peripheral.
+  */
+void mbedtls_aes_hw_set_threshold(size_t threshold);
+
+/**
+  * @brief          Get the length in bytes under which messages are
+  *                 processed in software.
+  */
+size_t mbedtls_aes_hw_get_threshold(void);
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED */
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+/**
+  * @brief          Give the AES and GCM modules the DMA channels of the
+  *                 peripheral, and the means to block the calling thread
+  *                 during a transfer. Transfers are polled until then. To
+  *                 be called before the AES and GCM contexts are used.
+  *
+  * @note           The application initializes the channels with the input
+  *                 and output DMA requests of instance and 32-bit transfers,
+  *                 and calls HAL_DMA_IRQHandler() from their interrupts.
+  *
+  * @param instance Peripheral served by the channels, AES or SAES.
+  * @param hdma_in  Channel from memory to the peripheral input.
+  * @param hdma_out Channel from the peripheral output to memory.
+  * @param wait     Block the calling thread until signal() is called or
+  *                 timeout ms elapse, return 0 when signalled.
+  * @param signal   Wake the thread blocked in wait(), called from the DMA
+  *                 interrupt.
+  */
+void mbedtls_aes_hw_dma_setup(AES_TypeDef *instance,
+                              DMA_HandleTypeDef *hdma_in,
+                              DMA_HandleTypeDef *hdma_out,
+                              int (*wait)(uint32_t timeout),
+                              void (*signal)(void));
+
+/**
+  * @brief          Tell whether a peripheral call of length bytes on hcryp
+  *                 can move its data by DMA.
+  */
+int mbedtls_aes_hw_dma_usable(const CRYP_HandleTypeDef *hcryp,
+                              const unsigned char *input,
+                              const unsigned char *output,
+                              size_t length);
+
+/**
+  * @brief          Feed length bytes, a multiple of 16, to the peripheral
+  *                 configured by hcryp by DMA, and wait for the output. To be
+  *                 called with the CRYP lock held.
+  *
+  * @return         0 on success, or MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED.
+  */
+int mbedtls_aes_hw_dma_transfer(CRYP_HandleTypeDef *hcryp,
+                                const unsigned char *input,
+                                unsigned char *output,
+                                size_t length);
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
 
 #ifdef __cplusplus
 }
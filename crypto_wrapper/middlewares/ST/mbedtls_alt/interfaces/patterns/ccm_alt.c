@@ -38,6 +38,12 @@
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
 #include "mbedtls/constant_time.h"
+#if defined(MBEDTLS_HAL_AES_ALT)
+#include "mbedtls/aes.h"
+#endif /* MBEDTLS_HAL_AES_ALT */
+#if defined(HW_CRYPTO_DPA_AES) && defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+#include "kwe_core.h"
+#endif /* HW_CRYPTO_DPA_AES && KWE_AES_KEY_RESIDENCY_ENABLED */
 
 #include <string.h>
 #include "mbedtls/platform.h"
@@ -53,7 +59,34 @@
                         If 0 < a < 2e16-2e8,
                         then a is encoded as [a]16, i.e., two octets */
 
+/* CCM phases in the GCMPH field of the CR register */
+#define ST_CCM_PHASE_INIT     0x00000000U
+#define ST_CCM_PHASE_HEADER   AES_CR_GCMPH_0
+#define ST_CCM_PHASE_PAYLOAD  AES_CR_GCMPH_1
+#define ST_CCM_PHASE_FINAL    AES_CR_GCMPH
+#define ST_CCM_MODE_DECRYPT   AES_CR_MODE_1
+
 /* Private macro -------------------------------------------------------------*/
+#if defined(HW_CRYPTO_DPA_AES) && defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+/*
+ * SAES is shared with the key wrap engine: drop the wrapped key it keeps
+ * loaded before reprogramming the peripheral
+ */
+#define ST_SAES_CLAIM()   KWE_AesKeyInvalidate()
+#else
+#define ST_SAES_CLAIM()
+#endif /* HW_CRYPTO_DPA_AES && KWE_AES_KEY_RESIDENCY_ENABLED */
+
+#if defined(MBEDTLS_HAL_AES_ALT)
+/*
+ * The AES module keeps the key of its last context loaded: make it reload
+ * its configuration once the peripheral has been reprogrammed
+ */
+#define ST_AES_RELEASE()  mbedtls_aes_hw_release()
+#else
+#define ST_AES_RELEASE()
+#endif /* MBEDTLS_HAL_AES_ALT */
+
 /*
  * 32-bit integer manipulation macros (big endian)
  */
@@ -70,6 +103,234 @@
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
+
+/*
+ * Take the CRYP peripheral for the calling thread
+ */
+static int ccm_lock(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_lock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return 0;
+}
+
+/*
+ * Hand the CRYP peripheral over to the next waiting thread. ret is returned
+ * unless the unlock fails.
+ */
+static int ccm_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_unlock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return ret;
+}
+
+/*
+ * Wait until a status flag of the CRYP peripheral is set
+ */
+static int ccm_wait_flag(mbedtls_ccm_context *ctx, uint32_t flag)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (__HAL_CRYP_GET_FLAG(&ctx->hcryp_ccm, flag) == RESET)
+  {
+    if ((HAL_GetTick() - tickstart) > ST_CRYP_TIMEOUT)
+    {
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Start the message of ctx on the peripheral, its key being loaded: init
+ * phase on the first authentication block B0, then selection of the header
+ * phase, or of the payload phase without additional data. The HAL is then
+ * left to process the payload only.
+ */
+static int ccm_init_phase(mbedtls_ccm_context *ctx)
+{
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+  uint32_t *b0 = (uint32_t *)ctx->y;
+
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+  instance->IVR3 = b0[0];
+  instance->IVR2 = b0[1];
+  instance->IVR1 = b0[2];
+  instance->IVR0 = b0[3];
+  instance->CR = ctx->ctx_save_cr & ~AES_CR_EN;
+  SET_BIT(instance->CR, AES_CR_EN);
+
+  if (ccm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
+  {
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+  __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_ccm, CRYP_CLEAR_CCF);
+
+  MODIFY_REG(instance->CR, AES_CR_GCMPH,
+             (ctx->add_len > 0) ? ST_CCM_PHASE_HEADER : ST_CCM_PHASE_PAYLOAD);
+  SET_BIT(instance->CR, AES_CR_EN);
+
+  /* init and header phases are not to be run by the HAL */
+  ctx->hcryp_ccm.KeyIVConfig = 1U;
+
+  return 0;
+}
+
+/*
+ * Give the peripheral back the state of ctx: configuration and CCM phase,
+ * key, and for a message in progress the CBC-MAC state (SUSPxR) and the
+ * counter (IVRx) saved by ccm_suspend(). A message still to be started
+ * goes through ccm_init_phase().
+ */
+static int ccm_resume(mbedtls_ccm_context *ctx)
+{
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+  uint32_t phase = ctx->ctx_save_cr & AES_CR_GCMPH;
+  uint32_t *key = ctx->ccm_key;
+
+  /* allow multi-context of CRYP use: restore context */
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+
+  if (phase != ST_CCM_PHASE_INIT)
+  {
+    instance->SUSP0R = ctx->susp[0];
+    instance->SUSP1R = ctx->susp[1];
+    instance->SUSP2R = ctx->susp[2];
+    instance->SUSP3R = ctx->susp[3];
+    instance->SUSP4R = ctx->susp[4];
+    instance->SUSP5R = ctx->susp[5];
+    instance->SUSP6R = ctx->susp[6];
+    instance->SUSP7R = ctx->susp[7];
+    instance->IVR0 = ctx->ivr[0];
+    instance->IVR1 = ctx->ivr[1];
+    instance->IVR2 = ctx->ivr[2];
+    instance->IVR3 = ctx->ivr[3];
+  }
+
+  instance->CR = ctx->ctx_save_cr & ~AES_CR_EN;
+
+#if defined(HW_CRYPTO_DPA_AES)
+  /* hardware key is loaded by the key selection */
+  if (ctx->hcryp_ccm.Init.KeyProtection == CRYP_KEYSEL_NORMAL)
+#endif /* HW_CRYPTO_DPA_AES */
+  {
+    if (ctx->hcryp_ccm.Init.KeySize == CRYP_KEYSIZE_256B)
+    {
+      instance->KEYR7 = key[0];
+      instance->KEYR6 = key[1];
+      instance->KEYR5 = key[2];
+      instance->KEYR4 = key[3];
+      key += 4;
+    }
+    instance->KEYR3 = key[0];
+    instance->KEYR2 = key[1];
+    instance->KEYR1 = key[2];
+    instance->KEYR0 = key[3];
+  }
+
+  if (ccm_wait_flag(ctx, CRYP_FLAG_KEYVALID) != 0)
+  {
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  if (phase == ST_CCM_PHASE_INIT)
+  {
+    return ccm_init_phase(ctx);
+  }
+
+  SET_BIT(instance->CR, AES_CR_EN);
+
+  return 0;
+}
+
+/*
+ * Save the state of the message in progress in ctx and disable the
+ * peripheral, so that other contexts can use it until ccm_resume().
+ * To be called between two blocks, once the last one has completed.
+ */
+static void ccm_suspend(mbedtls_ccm_context *ctx)
+{
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+
+  ctx->susp[0] = instance->SUSP0R;
+  ctx->susp[1] = instance->SUSP1R;
+  ctx->susp[2] = instance->SUSP2R;
+  ctx->susp[3] = instance->SUSP3R;
+  ctx->susp[4] = instance->SUSP4R;
+  ctx->susp[5] = instance->SUSP5R;
+  ctx->susp[6] = instance->SUSP6R;
+  ctx->susp[7] = instance->SUSP7R;
+  ctx->ivr[0] = instance->IVR0;
+  ctx->ivr[1] = instance->IVR1;
+  ctx->ivr[2] = instance->IVR2;
+  ctx->ivr[3] = instance->IVR3;
+
+  /* allow multi-context of CRYP : save context */
+  ctx->ctx_save_cr = instance->CR & ~AES_CR_EN;
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+}
+
+/*
+ * End the message of ctx, on completion or after an error: the next one
+ * starts again from the init phase
+ */
+static void ccm_abort(mbedtls_ccm_context *ctx)
+{
+  CLEAR_BIT(ctx->hcryp_ccm.Instance->CR, AES_CR_EN);
+  ctx->ctx_save_cr &= ~(AES_CR_GCMPH | AES_CR_NPBLB);
+  ctx->hcryp_ccm.KeyIVConfig = 0U;
+  mbedtls_platform_zeroize(ctx->susp, sizeof(ctx->susp));
+  mbedtls_platform_zeroize(ctx->ivr, sizeof(ctx->ivr));
+  mbedtls_platform_zeroize(ctx->b, sizeof(ctx->b));
+}
+
+/*
+ * Feed a block to the current CCM phase of the peripheral. The output block,
+ * if any, is read back into block.
+ */
+static int ccm_process_block(mbedtls_ccm_context *ctx,
+                             uint32_t block[4],
+                             int read_output)
+{
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+
+  instance->DINR = block[0];
+  instance->DINR = block[1];
+  instance->DINR = block[2];
+  instance->DINR = block[3];
+
+  if (ccm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
+  {
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  if (read_output)
+  {
+    block[0] = instance->DOUTR;
+    block[1] = instance->DOUTR;
+    block[2] = instance->DOUTR;
+    block[3] = instance->DOUTR;
+  }
+
+  __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_ccm, CRYP_CLEAR_CCF);
+
+  return 0;
+}
+
 /*
  * Initialize context
  */
@@ -163,6 +424,8 @@ int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx,
   ctx->hcryp_ccm.Init.B0 = NULL;
   ctx->hcryp_ccm.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ONCE;
   ctx->hcryp_ccm.Init.HeaderWidthUnit = CRYP_HEADERWIDTHUNIT_BYTE;
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
   if (HAL_CRYP_Init(&ctx->hcryp_ccm) != HAL_OK)
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
@@ -214,7 +477,8 @@ void mbedtls_ccm_free(mbedtls_ccm_context *ctx)
     cryp_context_count--;
   }
 
-  if (cryp_mutex_started)
+  /* mutex is shared with the other CRYP contexts, free it with the last one */
+  if ((cryp_context_count == 0) && cryp_mutex_started)
   {
     mbedtls_mutex_free(&cryp_mutex);
     cryp_mutex_started = 0;
@@ -225,6 +489,7 @@ void mbedtls_ccm_free(mbedtls_ccm_context *ctx)
   if (cryp_context_count == 0)
 #endif /* MBEDTLS_THREADING_C */
   {
+    ST_AES_RELEASE();
     HAL_CRYP_DeInit(&ctx->hcryp_ccm);
   }
   mbedtls_platform_zeroize(ctx, sizeof(mbedtls_ccm_context));
@@ -240,6 +505,7 @@ void mbedtls_ccm_free(mbedtls_ccm_context *ctx)
 static void mbedtls_ccm_clear_state(mbedtls_ccm_context *ctx)
 {
   ctx->state = CCM_STATE__CLEAR;
+  ctx->processed = 0;
   memset(ctx->y, 0, 16);
 }
 
@@ -323,6 +589,14 @@ int mbedtls_ccm_starts(mbedtls_ccm_context *ctx,
   ctx->mode = mode;
   ctx->q = 16 - 1 - (unsigned char) iv_len;
 
+  /* the message starts with the init phase of the peripheral */
+  ctx->ctx_save_cr &= ~(AES_CR_GCMPH | AES_CR_MODE | AES_CR_NPBLB);
+  if (mode == MBEDTLS_CCM_DECRYPT || mode == MBEDTLS_CCM_STAR_DECRYPT)
+  {
+    ctx->ctx_save_cr |= ST_CCM_MODE_DECRYPT;
+  }
+  ctx->hcryp_ccm.KeyIVConfig = 0U;
+
   /*
    * See ccm_calculate_first_block_if_ready() for block layout description
    */
@@ -362,113 +636,140 @@ int mbedtls_ccm_set_lengths(mbedtls_ccm_context *ctx,
   return ccm_calculate_first_block_if_ready(ctx);
 }
 
-int mbedtls_ccm_update_ad(mbedtls_ccm_context *ctx,
-                          const unsigned char *add,
-                          size_t add_len)
+/*
+ * Feed additional data to the header phase, through the block staging
+ * buffer of ctx. The payload phase is selected after the last block.
+ */
+static int ccm_header_data(mbedtls_ccm_context *ctx,
+                           const unsigned char *add,
+                           size_t add_len)
 {
-  int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
-  unsigned char *b1_padded_addr = NULL;            /* Formatting of B1   */
-  size_t b1_length = 0;                            /* B1 with padding    */
-  uint8_t b1_padding = 0;                          /* B1 word alignment  */
+  unsigned char *block = (unsigned char *)ctx->b;
+  size_t offset = (H_LENGTH + ctx->processed) % 16U;
+  size_t use_len = 0;
 
-  if (ctx->state & CCM_STATE__ERROR)
+  while (add_len > 0)
   {
-    return MBEDTLS_ERR_CCM_BAD_INPUT;
-  }
+    use_len = 16U - offset;
+    if (use_len > add_len)
+    {
+      use_len = add_len;
+    }
 
-  if (add_len > 0)
-  {
-    if (ctx->state & CCM_STATE__AUTH_DATA_FINISHED)
+    memcpy(block + offset, add, use_len);
+    offset += use_len;
+    add += use_len;
+    add_len -= use_len;
+    ctx->processed += use_len;
+
+    if (ctx->processed == ctx->add_len)
     {
-      return MBEDTLS_ERR_CCM_BAD_INPUT;
+      /* zero padding of Br */
+      memset(block + offset, 0, 16U - offset);
+      offset = 16U;
     }
 
-    if (!(ctx->state & CCM_STATE__AUTH_DATA_STARTED))
+    if (offset == 16U)
     {
-      if (add_len > ctx->add_len)
+      if (ccm_process_block(ctx, ctx->b, 0) != 0)
       {
-        return MBEDTLS_ERR_CCM_BAD_INPUT;
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
       }
+      offset = 0;
+    }
+  }
 
-      /* Extra bytes to deal with data padding such that
-       * the resulting string can be partitioned into words
-       */
-      b1_padding = ((add_len + H_LENGTH) % 4);
-      b1_length = add_len + H_LENGTH + b1_padding;
+  if (ctx->processed == ctx->add_len)
+  {
+    MODIFY_REG(ctx->hcryp_ccm.Instance->CR, AES_CR_GCMPH, ST_CCM_PHASE_PAYLOAD);
+  }
 
-      b1_padded_addr = mbedtls_calloc(1, b1_length);
+  return 0;
+}
 
-      if (b1_padded_addr == NULL)
-      {
-        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-      }
+/*
+ * The additional data is formatted as B1..Br: its length on H_LENGTH bytes,
+ * the data, and zero padding to a whole block. Each block is fed to the
+ * header phase as soon as it is complete, the last partial one is kept in
+ * the context until more data comes, so that no copy of the whole
+ * additional data is needed.
+ */
+int mbedtls_ccm_update_ad(mbedtls_ccm_context *ctx,
+                          const unsigned char *add,
+                          size_t add_len)
+{
+  int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+  unsigned char *block = (unsigned char *)ctx->b;
+  size_t offset = 0;
 
-      /* Header length */
-      b1_padded_addr[0] = (unsigned char)((add_len >> 8) & 0xFF);
-      b1_padded_addr[1] = (unsigned char)((add_len) & 0xFF);
+  if (ctx->state & CCM_STATE__ERROR)
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
 
-      /* data concatenation */
-      memcpy(b1_padded_addr + H_LENGTH, add, add_len);
+  if (add_len == 0)
+  {
+    return 0;
+  }
 
-      /* blocks (B) associated to the Associated Data (A) */
-      ctx->hcryp_ccm.Init.Header     = (uint32_t *)b1_padded_addr;
+  if (!(ctx->state & CCM_STATE__STARTED) || !(ctx->state & CCM_STATE__LENGTHS_SET))
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
 
-      ctx->hcryp_ccm.Init.HeaderSize = b1_length;
+  if ((ctx->state & CCM_STATE__AUTH_DATA_FINISHED) ||
+      (add_len > ctx->add_len - ctx->processed))
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
 
-      ctx->state |= CCM_STATE__AUTH_DATA_STARTED;
+  if (!(ctx->state & CCM_STATE__AUTH_DATA_STARTED))
+  {
+    /* Header length */
+    block[0] = (unsigned char)((ctx->add_len >> 8) & 0xFF);
+    block[1] = (unsigned char)((ctx->add_len) & 0xFF);
 
-      /* allow multi-context of CRYP use: restore context */
-      ctx->hcryp_ccm.Instance->CR = ctx->ctx_save_cr;
+    ctx->state |= CCM_STATE__AUTH_DATA_STARTED;
+  }
 
-      if (ctx->mode == MBEDTLS_CCM_ENCRYPT || \
-          ctx->mode == MBEDTLS_CCM_STAR_ENCRYPT)
-      {
-        if (HAL_CRYP_Encrypt(&ctx->hcryp_ccm,
-                             (uint32_t *)NULL,
-                             0,
-                             (uint32_t *)NULL,
-                             ST_CRYP_TIMEOUT) != HAL_OK)
-        {
-          ctx->state |= CCM_STATE__ERROR;
-          ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-          goto exit;
-        }
-      }
+  offset = (H_LENGTH + ctx->processed) % 16U;
 
-      if (ctx->mode == MBEDTLS_CCM_DECRYPT || \
-          ctx->mode == MBEDTLS_CCM_STAR_DECRYPT)
-      {
-        if (HAL_CRYP_Decrypt(&ctx->hcryp_ccm,
-                             (uint32_t *)NULL,
-                             0,
-                             (uint32_t *)NULL,
-                             ST_CRYP_TIMEOUT) != HAL_OK)
-        {
-          ctx->state |= CCM_STATE__ERROR;
-          ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-          goto exit;
-        }
-      }
-      /* allow multi-context of CRYP : save context */
-      ctx->ctx_save_cr = ctx->hcryp_ccm.Instance->CR;
+  /* not enough data for a block yet: the peripheral is left untouched */
+  if (((offset + add_len) < 16U) && ((ctx->processed + add_len) < ctx->add_len))
+  {
+    memcpy(block + offset, add, add_len);
+    ctx->processed += add_len;
+    return 0;
+  }
 
-    }
+  if ((ret = ccm_lock()) != 0)
+  {
+    return ret;
   }
-  else
+
+  if ((ret = ccm_resume(ctx)) != 0)
   {
-    ctx->hcryp_ccm.Init.Header = NULL;
-    ctx->hcryp_ccm.Init.HeaderSize = 0;
+    goto error;
   }
 
-  ctx->state |= CCM_STATE__AUTH_DATA_FINISHED;
-  ret = 0;
+  if ((ret = ccm_header_data(ctx, add, add_len)) != 0)
+  {
+    goto error;
+  }
 
-exit:
-  if (add_len > 0)
+  if (ctx->processed == ctx->add_len)
   {
-    mbedtls_free(b1_padded_addr);
+    ctx->state |= CCM_STATE__AUTH_DATA_FINISHED;
   }
-  return ret;
+
+  ccm_suspend(ctx);
+
+  return ccm_unlock(0);
+
+error:
+  ccm_abort(ctx);
+  ctx->state |= CCM_STATE__ERROR;
+  return ccm_unlock(ret);
 }
 
 int mbedtls_ccm_update(mbedtls_ccm_context *ctx,
@@ -476,11 +777,24 @@ int mbedtls_ccm_update(mbedtls_ccm_context *ctx,
                        unsigned char *output, size_t output_size,
                        size_t *output_len)
 {
+  int ret = 0;
+
   if (ctx->state & CCM_STATE__ERROR)
   {
     return MBEDTLS_ERR_CCM_BAD_INPUT;
   }
 
+  if (!(ctx->state & CCM_STATE__STARTED) || !(ctx->state & CCM_STATE__LENGTHS_SET))
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
+
+  /* the header phase must be over before the payload phase */
+  if (ctx->add_len > 0 && !(ctx->state & CCM_STATE__AUTH_DATA_FINISHED))
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
+
   /* Check against plaintext length only if performing operation with
    * authentication
    */
@@ -496,8 +810,20 @@ int mbedtls_ccm_update(mbedtls_ccm_context *ctx,
 
   *output_len = input_len;
 
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_ccm.Instance->CR = ctx->ctx_save_cr;
+  if (input_len == 0)
+  {
+    return 0;
+  }
+
+  if ((ret = ccm_lock()) != 0)
+  {
+    return ret;
+  }
+
+  if ((ret = ccm_resume(ctx)) != 0)
+  {
+    goto error;
+  }
 
   /* blocks (B) associated to the plaintext message (P) */
   if (ctx->mode == MBEDTLS_CCM_ENCRYPT || \
@@ -509,8 +835,8 @@ int mbedtls_ccm_update(mbedtls_ccm_context *ctx,
                          (uint32_t *)output,
                          ST_CRYP_TIMEOUT) != HAL_OK)
     {
-      ctx->state |= CCM_STATE__ERROR;
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto error;
     }
   }
 
@@ -523,57 +849,81 @@ int mbedtls_ccm_update(mbedtls_ccm_context *ctx,
                          (uint32_t *)output,
                          ST_CRYP_TIMEOUT) != HAL_OK)
     {
-      ctx->state |= CCM_STATE__ERROR;
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto error;
     }
   }
 
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_ccm.Instance->CR;
+  ccm_suspend(ctx);
 
-  return 0;
+  return ccm_unlock(0);
+
+error:
+  ccm_abort(ctx);
+  ctx->state |= CCM_STATE__ERROR;
+  return ccm_unlock(ret);
 }
 
 int mbedtls_ccm_finish(mbedtls_ccm_context *ctx,
                        unsigned char *tag, size_t tag_len)
 {
-  __ALIGN_BEGIN uint8_t mac[16]      __ALIGN_END;  /* temporary mac */
+  int ret = 0;
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+  __ALIGN_BEGIN uint32_t mac[4]      __ALIGN_END;  /* temporary mac */
 
   if (ctx->state & CCM_STATE__ERROR)
   {
     return MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
   }
 
+  if (!(ctx->state & CCM_STATE__STARTED) || !(ctx->state & CCM_STATE__LENGTHS_SET))
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
+
   if (ctx->add_len > 0 && !(ctx->state & CCM_STATE__AUTH_DATA_FINISHED))
   {
     return MBEDTLS_ERR_CCM_BAD_INPUT;
   }
 
-  /* Tag has a variable length */
-  memset(mac, 0, sizeof(mac));
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_ccm.Instance->CR = ctx->ctx_save_cr;
+  if ((ret = ccm_lock()) != 0)
+  {
+    return ret;
+  }
+
+  if ((ret = ccm_resume(ctx)) != 0)
+  {
+    goto exit;
+  }
 
   /* Generate the authentication TAG */
-  if (HAL_CRYPEx_AESCCM_GenerateAuthTAG(&ctx->hcryp_ccm,
-                                        (uint32_t *)mac,
-                                        ST_CRYP_TIMEOUT) != HAL_OK)
+  MODIFY_REG(instance->CR, AES_CR_GCMPH, ST_CCM_PHASE_FINAL);
+
+  if (ccm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
   }
 
+  mac[0] = instance->DOUTR;
+  mac[1] = instance->DOUTR;
+  mac[2] = instance->DOUTR;
+  mac[3] = instance->DOUTR;
+
+  __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_ccm, CRYP_CLEAR_CCF);
+
+  /* Tag has a variable length */
   if (tag != NULL)
   {
     memcpy(tag, mac, tag_len);
   }
 
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_ccm.Instance->CR;
-
+exit:
+  ccm_abort(ctx);
+  mbedtls_platform_zeroize(mac, sizeof(mac));
   mbedtls_ccm_clear_state(ctx);
-  mbedtls_platform_zeroize(ctx->ccm_key, sizeof(ctx->ccm_key));
 
-  return 0;
+  return ccm_unlock(ret);
 }
 
 /*
@@ -698,6 +1048,126 @@ int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length,
                            input, output, tag, tag_len));
 }
 
+/*
+ * Authenticated encryption of a batch of CCM* frames. The key is loaded
+ * once, then each frame goes through the init, header, payload and final
+ * phases right after the previous one, with no peripheral state to save in
+ * between.
+ */
+int mbedtls_ccm_star_encrypt_and_tag_batch(mbedtls_ccm_context *ctx,
+                                           const mbedtls_ccm_frame *frames,
+                                           size_t count,
+                                           size_t tag_len)
+{
+  int ret = 0;
+  AES_TypeDef *instance = ctx->hcryp_ccm.Instance;
+  const mbedtls_ccm_frame *frame = NULL;
+  unsigned char *header = (unsigned char *)ctx->b;
+  uint32_t block[4];
+  size_t offset = 0;
+  size_t use_len = 0;
+  size_t i = 0;
+
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  if (frames == NULL)
+  {
+    return MBEDTLS_ERR_CCM_BAD_INPUT;
+  }
+
+  if ((ret = ccm_lock()) != 0)
+  {
+    return ret;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    frame = &frames[i];
+
+    /* first block B0 of the frame, in software */
+    mbedtls_ccm_clear_state(ctx);
+    if ((ret = mbedtls_ccm_set_lengths(ctx, frame->add_len, frame->length, tag_len)) != 0)
+    {
+      goto exit;
+    }
+    if ((ret = mbedtls_ccm_starts(ctx, MBEDTLS_CCM_STAR_ENCRYPT, frame->iv, frame->iv_len)) != 0)
+    {
+      goto exit;
+    }
+
+    /* the key stays loaded from one frame to the next */
+    ret = (i == 0) ? ccm_resume(ctx) : ccm_init_phase(ctx);
+    if (ret != 0)
+    {
+      goto exit;
+    }
+
+    if (frame->add_len > 0)
+    {
+      /* Header length */
+      header[0] = (unsigned char)((frame->add_len >> 8) & 0xFF);
+      header[1] = (unsigned char)((frame->add_len) & 0xFF);
+
+      if ((ret = ccm_header_data(ctx, frame->add, frame->add_len)) != 0)
+      {
+        goto exit;
+      }
+    }
+
+    /* last block is zero padded, no padding information in CCM encryption */
+    for (offset = 0; offset < frame->length; offset += use_len)
+    {
+      use_len = frame->length - offset;
+      if (use_len > 16U)
+      {
+        use_len = 16U;
+      }
+      else
+      {
+        memset(block, 0, sizeof(block));
+      }
+
+      memcpy(block, frame->input + offset, use_len);
+      if ((ret = ccm_process_block(ctx, block, 1)) != 0)
+      {
+        goto exit;
+      }
+      memcpy(frame->output + offset, block, use_len);
+    }
+
+    if (tag_len > 0)
+    {
+      MODIFY_REG(instance->CR, AES_CR_GCMPH, ST_CCM_PHASE_FINAL);
+
+      if (ccm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
+      {
+        ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        goto exit;
+      }
+
+      block[0] = instance->DOUTR;
+      block[1] = instance->DOUTR;
+      block[2] = instance->DOUTR;
+      block[3] = instance->DOUTR;
+
+      __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_ccm, CRYP_CLEAR_CCF);
+
+      memcpy(frame->tag, block, tag_len);
+    }
+
+    CLEAR_BIT(instance->CR, AES_CR_EN);
+  }
+
+exit:
+  ccm_abort(ctx);
+  mbedtls_platform_zeroize(block, sizeof(block));
+  mbedtls_ccm_clear_state(ctx);
+
+  return ccm_unlock(ret);
+}
 
 #endif /* MBEDTLS_HAL_CCM_ALT */
 
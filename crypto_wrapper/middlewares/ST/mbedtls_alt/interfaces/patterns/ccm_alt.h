@@ -67,9 +67,13 @@ typedef struct mbedtls_ccm_context
   uint32_t ccm_key[8];                 /* Encryption/Decryption key        */
   CRYP_HandleTypeDef hcryp_ccm;        /* HW driver handle                 */
   uint32_t           ctx_save_cr;      /* save context for multi-instance  */
+  uint32_t susp[8];                    /* Suspended CBC-MAC state          */
+  uint32_t ivr[4];                     /* Suspended counter                */
+  uint32_t b[4];                       /* Header block being assembled     */
   unsigned char y[16];                 /* The Y working buffer */
   size_t plaintext_len;                /* Total plaintext length */
   size_t add_len;                      /* Total authentication data length */
+  size_t processed;                    /* Authentication data processed    */
   size_t tag_len;                      /* Total tag length */
   unsigned int q;                      /* The Q working value */
   int mode;                            /* The operation to perform:
@@ -82,9 +86,47 @@ typedef struct mbedtls_ccm_context
 }
 mbedtls_ccm_context;
 
+/**
+  * @brief    A CCM* frame of a batch processed by
+  *           mbedtls_ccm_star_encrypt_and_tag_batch().
+  */
+typedef struct mbedtls_ccm_frame
+{
+  const unsigned char *iv;             /* Nonce                            */
+  size_t iv_len;                       /* Nonce length, 7 to 13 bytes      */
+  const unsigned char *add;            /* Additional data                  */
+  size_t add_len;                      /* Additional data length           */
+  const unsigned char *input;          /* Payload                          */
+  unsigned char *output;               /* Encrypted payload, same length   */
+  size_t length;                       /* Payload length                   */
+  unsigned char *tag;                  /* Tag, tag_len bytes               */
+}
+mbedtls_ccm_frame;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
+/**
+  * @brief          Encrypt and authenticate a batch of CCM* frames with the
+  *                 key of ctx, as mbedtls_ccm_star_encrypt_and_tag() would
+  *                 do for each of them. The key is loaded in the peripheral
+  *                 once and the frames are processed back to back.
+  *
+  * @note           ctx must not have a multi-part operation in progress.
+  *                 On error, the frames before the failing one are sealed.
+  *
+  * @param ctx      The CCM context, with a key set.
+  * @param frames   The frames to process.
+  * @param count    The number of frames.
+  * @param tag_len  The tag length of all the frames, in bytes: 0, or an
+  *                 even value from 4 to 16.
+  *
+  * @return         0 on success, or an MBEDTLS_ERR_xxx error code.
+  */
+int mbedtls_ccm_star_encrypt_and_tag_batch(mbedtls_ccm_context *ctx,
+                                           const mbedtls_ccm_frame *frames,
+                                           size_t count,
+                                           size_t tag_len);
 
 #ifdef __cplusplus
 }
@@ -34,6 +34,7 @@
 #include "mbedtls/error.h"
 
 #if defined(MBEDTLS_HAL_ECDH_ALT)
+#include "pka_alt.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -56,7 +57,7 @@ static int ecdh_compute_shared_restartable(mbedtls_ecp_group *grp,
                                            mbedtls_ecp_restart_ctx *rs_ctx)
 {
 
-  PKA_HandleTypeDef hpka = {0};                         /* HAL Pka Handle */
+  PKA_HandleTypeDef *hpka = NULL;                       /* HAL Pka Handle */
   PKA_ECCMulExInTypeDef ECDH_input = {0};               /* ECDH Curve struct */
   PKA_ECCMulOutTypeDef ECDH_ouput = {0};                /* ECDH point = shared secret */
   int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;      /* MBED return value */
@@ -64,15 +65,8 @@ static int ecdh_compute_shared_restartable(mbedtls_ecp_group *grp,
   size_t olen = 0;                                      /* Length of the point, internal use */
   uint8_t *Q_binary = NULL;                             /* Pointer to public key */
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Select the instance */
-  hpka.Instance = PKA;
-  /* Erase older context */
-  MBEDTLS_MPI_CHK((HAL_PKA_DeInit(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-  /* Initialize the PKA peripheral */
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
   /* Set HW peripheral input parameter : private key */
   d_binary = mbedtls_calloc(grp->st_order_size, sizeof(uint8_t));
@@ -99,7 +93,7 @@ static int ecdh_compute_shared_restartable(mbedtls_ecp_group *grp,
   ECDH_input.pointY = Q_binary + grp->st_modulus_size + 1U;
 
   /* Start the ECC scalar multiplication */
-  MBEDTLS_MPI_CHK((HAL_PKA_ECCMulEx(&hpka, &ECDH_input, ST_ECDH_TIMEOUT) != HAL_OK)
+  MBEDTLS_MPI_CHK((HAL_PKA_ECCMulEx(hpka, &ECDH_input, ST_ECDH_TIMEOUT) != HAL_OK)
                   ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
   /* Allocate memory space for computed secret */
@@ -110,20 +104,17 @@ static int ecdh_compute_shared_restartable(mbedtls_ecp_group *grp,
   MBEDTLS_MPI_CHK((ECDH_ouput.ptY == NULL) ? MBEDTLS_ERR_ECP_ALLOC_FAILED : 0);
 
   /* Copy the results to user specified space */
-  HAL_PKA_ECCMul_GetResult(&hpka, &ECDH_ouput);
+  HAL_PKA_ECCMul_GetResult(hpka, &ECDH_ouput);
 
   /* Convert the signature into mpi format */
   MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(z, ECDH_ouput.ptX, grp->st_order_size));
 
-  /* Deinitialize the PKA */
-  MBEDTLS_MPI_CHK((HAL_PKA_DeInit(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
 cleanup:
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 1U /* secret operands */);
+  }
 
   /* Free memory */
   if (d_binary != NULL)
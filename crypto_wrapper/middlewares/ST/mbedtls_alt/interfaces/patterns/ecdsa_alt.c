@@ -36,6 +36,7 @@
 #include "mbedtls/error.h"
 
 #if defined(MBEDTLS_HAL_ECDSA_ALT)
+#include "pka_alt.h"
 #if defined(MCUBOOT_DOUBLE_SIGN_VERIF)
 #include "boot_hal_imagevalid.h"
 #endif /* MCUBOOT_DOUBLE_SIGN_VERIF */
@@ -199,7 +200,7 @@ int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp, mbedtls_mpi *r, mbedtls_mpi *s,
   uint8_t *k_binary = NULL;
 
   mbedtls_mpi k;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_ECDSASignInTypeDef ECDSA_SignIn = {0};
   PKA_ECDSASignOutTypeDef ECDSA_SignOut = {0};
 
@@ -253,17 +254,11 @@ int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp, mbedtls_mpi *r, mbedtls_mpi *s,
 
   ECDSA_SignIn.integer = k_binary;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  HAL_PKA_RAMReset(&hpka);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
   /* Launch the signature */
-  MBEDTLS_MPI_CHK((HAL_PKA_ECDSASign(&hpka, &ECDSA_SignIn,
+  MBEDTLS_MPI_CHK((HAL_PKA_ECDSASign(hpka, &ECDSA_SignIn,
                                      ST_ECDSA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
   /* Allocate memory space for signature */
@@ -274,7 +269,7 @@ int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp, mbedtls_mpi *r, mbedtls_mpi *s,
   MBEDTLS_MPI_CHK((ECDSA_SignOut.SSign == NULL) ? MBEDTLS_ERR_ECP_ALLOC_FAILED : 0);
 
   /* Get the signature into allocated space */
-  HAL_PKA_ECDSASign_GetResult(&hpka, &ECDSA_SignOut, NULL);
+  HAL_PKA_ECDSASign_GetResult(hpka, &ECDSA_SignOut, NULL);
 
   /* Convert the signature into mpi format */
   MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(r, ECDSA_SignOut.RSign, grp->st_order_size));
@@ -282,15 +277,12 @@ int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp, mbedtls_mpi *r, mbedtls_mpi *s,
   MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(s, ECDSA_SignOut.SSign, grp->st_order_size));
 
 cleanup:
-  /* De-initialize HW peripheral */
-  if (HAL_PKA_DeInit(&hpka) != HAL_OK)
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
   {
-    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = mbedtls_pka_hw_close(ret, 1U /* secret operands */);
   }
 
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
-
   /* Free memory */
   mbedtls_mpi_free(&k);
 
@@ -361,6 +353,43 @@ static int CheckPKASignature(PKA_HandleTypeDef *hpka, PKA_ECDSAVerifInTypeDef *i
 }
 #endif /* MCUBOOT_DOUBLE_SIGN_VERIF */
 
+/*
+ * Run the signature verification on the PKA and check its result
+ */
+static int ecdsa_hal_verify(PKA_HandleTypeDef *hpka, PKA_ECDSAVerifInTypeDef *in)
+{
+  int ret = 0;
+
+  /* Launch the signature verification */
+  MBEDTLS_MPI_CHK((HAL_PKA_ECDSAVerif(hpka, in,
+                                      ST_ECDSA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
+
+  /* Check the result */
+  MBEDTLS_MPI_CHK((HAL_PKA_ECDSAVerif_IsValidSignature(hpka) != 1U) ? MBEDTLS_ERR_ECP_VERIFY_FAILED : 0);
+
+#if defined(MCUBOOT_DOUBLE_SIGN_VERIF)
+  /* Double the signature verification (using another way) to resist to basic HW attacks.
+   * The second verification is applicable to final signature check on primary slot images
+   * only (condition: ImageValidEnable).
+   * It is performed in 2 steps:
+   * 1- save signature status in global variable ImageValidStatus[]
+   *    Return value of HAL api (0 failed, 1 passed) is mul with IMAGE_VALID to avoid
+   *    value 1 for success: IMAGE_VALID for success.
+   * 2- verify saved signature status later in boot process
+   */
+  if (ImageValidEnable == 1)
+  {
+    /* Check ImageValidIndex is in expected range MCUBOOT_IMAGE_NUMBER */
+    MBEDTLS_MPI_CHK((ImageValidIndex >= MCUBOOT_IMAGE_NUMBER) ? MBEDTLS_ERR_ECP_VERIFY_FAILED : 0);
+
+    ImageValidStatus[ImageValidIndex++] = CheckPKASignature(hpka, in);
+  }
+#endif /* MCUBOOT_DOUBLE_SIGN_VERIF */
+
+cleanup:
+  return ret;
+}
+
 /*
  * Verify ECDSA signature of hashed message
  */
@@ -375,7 +404,7 @@ int mbedtls_ecdsa_verify(mbedtls_ecp_group *grp,
   uint8_t *Q_binary;
   uint8_t *r_binary = NULL;
   uint8_t *s_binary = NULL;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_ECDSAVerifInTypeDef ECDSA_VerifyIn = {0};
   uint8_t a_digest[66] = {0}; /* Local digest after rework input digest, 66 is the maximum order size supported */
 
@@ -430,51 +459,19 @@ int mbedtls_ecdsa_verify(mbedtls_ecp_group *grp,
   MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(s, s_binary, grp->st_order_size));
   ECDSA_VerifyIn.SSign = s_binary;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  HAL_PKA_RAMReset(&hpka);
-
-  /* Launch the signature verification */
-  MBEDTLS_MPI_CHK((HAL_PKA_ECDSAVerif(&hpka, &ECDSA_VerifyIn,
-                                      ST_ECDSA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  /* Check the result */
-  MBEDTLS_MPI_CHK((HAL_PKA_ECDSAVerif_IsValidSignature(&hpka) != 1U) ? MBEDTLS_ERR_ECP_VERIFY_FAILED : 0);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
-#if defined(MCUBOOT_DOUBLE_SIGN_VERIF)
-  /* Double the signature verification (using another way) to resist to basic HW attacks.
-   * The second verification is applicable to final signature check on primary slot images
-   * only (condition: ImageValidEnable).
-   * It is performed in 2 steps:
-   * 1- save signature status in global variable ImageValidStatus[]
-   *    Return value of HAL api (0 failed, 1 passed) is mul with IMAGE_VALID to avoid
-   *    value 1 for success: IMAGE_VALID for success.
-   * 2- verify saved signature status later in boot process
-   */
-  if (ImageValidEnable == 1)
-  {
-    /* Check ImageValidIndex is in expected range MCUBOOT_IMAGE_NUMBER */
-    MBEDTLS_MPI_CHK((ImageValidIndex >= MCUBOOT_IMAGE_NUMBER) ? MBEDTLS_ERR_ECP_VERIFY_FAILED : 0);
-
-    ImageValidStatus[ImageValidIndex++] = CheckPKASignature(&hpka, &ECDSA_VerifyIn);
-  }
+  /* Verify the signature */
+  MBEDTLS_MPI_CHK(ecdsa_hal_verify(hpka, &ECDSA_VerifyIn));
 
-#endif /* MCUBOOT_DOUBLE_SIGN_VERIF */
 cleanup:
-  /* De-initialize HW peripheral */
-  if (HAL_PKA_DeInit(&hpka) != HAL_OK)
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
   {
-    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = mbedtls_pka_hw_close(ret, 0U /* public operands */);
   }
 
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
-
   /* Free memory */
   if (Q_binary != NULL)
   {
@@ -497,6 +494,185 @@ cleanup:
   return ret;
 }
 
+/*
+ * Copy a scalar of a batch signature at the PKA operand length and make sure
+ * it is in range 1..n-1
+ */
+static int ecdsa_batch_load_scalar(const unsigned char *in, size_t in_len,
+                                   uint8_t *out, size_t out_len, const uint8_t *n)
+{
+  size_t i;
+  uint8_t acc = 0U;
+
+  /* Leading zeros beyond the operand length do not change the value */
+  while (in_len > out_len)
+  {
+    if (*in != 0U)
+    {
+      return MBEDTLS_ERR_ECP_VERIFY_FAILED;
+    }
+    in++;
+    in_len--;
+  }
+
+  (void) memset(out, 0, out_len - in_len);
+  if (in_len != 0U)
+  {
+    (void) memcpy(&out[out_len - in_len], in, in_len);
+  }
+
+  for (i = 0U; i < out_len; i++)
+  {
+    acc |= out[i];
+  }
+
+  if ((acc == 0U) || (memcmp(out, n, out_len) >= 0))
+  {
+    return MBEDTLS_ERR_ECP_VERIFY_FAILED;
+  }
+
+  return 0;
+}
+
+/*
+ * Verify a signature of a batch, the curve coefs being already set in the
+ * PKA input parameters
+ */
+static int ecdsa_batch_verify_item(const mbedtls_ecp_group *grp,
+                                   const mbedtls_ecdsa_verify_item *item,
+                                   PKA_ECDSAVerifInTypeDef *in, uint8_t *rs_binary)
+{
+  int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+  PKA_HandleTypeDef *hpka = NULL;
+  size_t hlen;
+  uint8_t a_digest[66] = {0}; /* Local digest after rework input digest, 66 is the maximum order size supported */
+
+  /* The PKA takes the coordinates of an uncompressed point */
+  if ((item->Q == NULL) || (item->Q_len != ((2U * grp->st_modulus_size) + 1U)) || (item->Q[0] != 0x04U))
+  {
+    return MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+  }
+
+  /* Make sure r and s are in range 1..n-1 */
+  MBEDTLS_MPI_CHK(ecdsa_batch_load_scalar(item->r, item->rs_len, rs_binary,
+                                          grp->st_order_size, grp->st_n));
+  MBEDTLS_MPI_CHK(ecdsa_batch_load_scalar(item->s, item->rs_len, rs_binary + grp->st_order_size,
+                                          grp->st_order_size, grp->st_n));
+
+  /* Prepare the digest, only its leftmost order size bytes are used */
+  hlen = (item->hlen > 0xFFU) ? 0xFFU : item->hlen;
+  ecc_hal_prepare_digest(item->hash, (uint8_t)hlen, a_digest, (uint8_t)grp->st_order_size, grp->st_n);
+
+  /* Set HW peripheral input parameter: hash, public key and signature */
+  in->hash            = a_digest;
+  in->pPubKeyCurvePtX = &item->Q[1];
+  in->pPubKeyCurvePtY = &item->Q[1U + grp->st_modulus_size];
+  in->RSign           = rs_binary;
+  in->SSign           = rs_binary + grp->st_order_size;
+
+  /* Get HW peripheral ready, it stays so within the batch session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
+
+  /* Verify the signature */
+  MBEDTLS_MPI_CHK(ecdsa_hal_verify(hpka, in));
+
+cleanup:
+  /* Release HW peripheral, kept up within the batch session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 0U /* public operands */);
+  }
+
+  return ret;
+}
+
+/*
+ * Verify a batch of ECDSA signatures of hashed messages
+ */
+int mbedtls_ecdsa_verify_batch(mbedtls_ecp_group *grp,
+                               const mbedtls_ecdsa_verify_item *items,
+                               size_t count, int *results)
+{
+  int ret = 0;
+  int status;
+  size_t i = 0U;
+  uint8_t *rs_binary;
+  PKA_ECDSAVerifInTypeDef ECDSA_VerifyIn = {0};
+
+  /* Fail cleanly on curves such as Curve25519 that can't be used for ECDSA */
+  if (grp->G.MBEDTLS_PRIVATE(Y).MBEDTLS_PRIVATE(p) == NULL)
+  {
+    return MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+  }
+
+  if (count == 0U)
+  {
+    return 0;
+  }
+
+  /* Set HW peripheral Input parameter: curve coefs, once for the batch */
+  ECDSA_VerifyIn.primeOrderSize = grp->st_order_size;
+  ECDSA_VerifyIn.modulusSize    = grp->st_modulus_size;
+  ECDSA_VerifyIn.modulus        = grp->st_p;
+  ECDSA_VerifyIn.coefSign       = grp->st_a_sign;
+  ECDSA_VerifyIn.coef           = grp->st_a_abs;
+  ECDSA_VerifyIn.basePointX     = grp->st_gx;
+  ECDSA_VerifyIn.basePointY     = grp->st_gy;
+  ECDSA_VerifyIn.primeOrder     = grp->st_n;
+
+  /* r and s of the signature being verified, at the PKA operand length */
+  rs_binary = (uint8_t *) mbedtls_calloc(2U * grp->st_order_size, sizeof(uint8_t));
+  if (rs_binary == NULL)
+  {
+    ret = MBEDTLS_ERR_ECP_ALLOC_FAILED;
+  }
+  else
+  {
+    /* The PKA is initialized by the first signature and cleared after the last */
+    (void) mbedtls_pka_session_start();
+
+    for (i = 0U; i < count; i++)
+    {
+      status = ecdsa_batch_verify_item(grp, &items[i], &ECDSA_VerifyIn, rs_binary);
+      results[i] = status;
+
+      if ((status == MBEDTLS_ERR_ECP_VERIFY_FAILED) || (status == MBEDTLS_ERR_ECP_BAD_INPUT_DATA))
+      {
+        /* This signature is rejected, the next ones are still verified */
+        ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+      }
+      else if (status != 0)
+      {
+        /* PKA failure, the batch stops */
+        ret = status;
+        i++;
+        break;
+      }
+      else
+      {
+        /* Valid signature */
+      }
+    }
+
+    status = mbedtls_pka_session_end();
+    if ((status != 0) && (ret == 0))
+    {
+      ret = status;
+    }
+
+    mbedtls_platform_zeroize(rs_binary, 2U * grp->st_order_size);
+    mbedtls_free(rs_binary);
+  }
+
+  /* The signatures left over are not verified */
+  for (; i < count; i++)
+  {
+    results[i] = ret;
+  }
+
+  return ret;
+}
+
 #endif /* MBEDTLS_ECDSA_VERIFY_ALT*/
 
 #endif /* MBEDTLS_HAL_ECDSA_ALT */
@@ -99,6 +99,7 @@
 #endif /* MBEDTLS_PLATFORM_C */
 
 #include "ecp_internal_alt.h"
+#include "pka_alt.h"
 
 #define ST_ECP_TIMEOUT     (5000U)
 #define ECP_CURVE25519_KEY_SIZE 32
@@ -1521,7 +1522,7 @@ static int ecp_mul_comb(mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
   uint8_t *P_binary;
   uint8_t *m_binary = NULL;
   uint8_t *R_binary = NULL;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_ECCMulExInTypeDef ECC_MulIn = {0};
   PKA_ECCMulOutTypeDef ECC_MulOut;
 
@@ -1555,18 +1556,11 @@ static int ecp_mul_comb(mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
   MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(m, m_binary, scalarMulSize));
   ECC_MulIn.scalarMul = m_binary;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  /* Reset PKA RAM */
-  HAL_PKA_RAMReset(&hpka);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
   /* Launch the scalar multiplication */
-  MBEDTLS_MPI_CHK((HAL_PKA_ECCMulEx(&hpka, &ECC_MulIn,
+  MBEDTLS_MPI_CHK((HAL_PKA_ECCMulEx(hpka, &ECC_MulIn,
                                     ST_ECP_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
   /* Allocate memory space for scalar multiplication result */
@@ -1577,18 +1571,18 @@ static int ecp_mul_comb(mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
   ECC_MulOut.ptY = R_binary + grp->st_modulus_size + 1U;
 
   /* Get the scalar multiplication result */
-  HAL_PKA_ECCMul_GetResult(&hpka, &ECC_MulOut);
+  HAL_PKA_ECCMul_GetResult(hpka, &ECC_MulOut);
 
   /* Convert the scalar multiplication result into ecp point format */
   R_binary[0] = 0x04U;
   MBEDTLS_MPI_CHK(mbedtls_ecp_point_read_binary(grp, R, R_binary, 2U * grp->st_modulus_size + 1U));
 
 cleanup:
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 1U /* secret operands */);
+  }
 
   /* Free memory */
   if (P_binary != NULL)
@@ -1937,7 +1931,7 @@ static int ecp_check_pubkey_sw(const mbedtls_ecp_group *grp, const mbedtls_ecp_p
   int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
   size_t olen;
   uint8_t *pt_binary;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_PointCheckInTypeDef ECC_PointCheck = {0};
   PKA_MontgomeryParamInTypeDef inp = {0};
   uint8_t *pt_montgomery = NULL;
@@ -1972,44 +1966,37 @@ static int ecp_check_pubkey_sw(const mbedtls_ecp_group *grp, const mbedtls_ecp_p
   ECC_PointCheck.pointX = pt_binary + 1U;
   ECC_PointCheck.pointY = pt_binary + grp->st_modulus_size + 1U;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  /* Reset PKA RAM */
-  HAL_PKA_RAMReset(&hpka);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
   /* Set Montgomery R2 input parameters */
   inp.size = grp->st_modulus_size;
   inp.pOp1 = grp->st_p;
 
   /* Launch the processing */
-  MBEDTLS_MPI_CHK((HAL_PKA_MontgomeryParam(&hpka, &inp,
+  MBEDTLS_MPI_CHK((HAL_PKA_MontgomeryParam(hpka, &inp,
                                            ST_ECP_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
   /* Get Montgomery R2 parameters */
-  HAL_PKA_MontgomeryParam_GetResult(&hpka, (uint32_t *)pt_montgomery);
+  HAL_PKA_MontgomeryParam_GetResult(hpka, (uint32_t *)pt_montgomery);
   ECC_PointCheck.pMontgomeryParam = (uint32_t *)pt_montgomery;
 
   /* Launch the point check */
-  MBEDTLS_MPI_CHK((HAL_PKA_PointCheck(&hpka, &ECC_PointCheck,
+  MBEDTLS_MPI_CHK((HAL_PKA_PointCheck(hpka, &ECC_PointCheck,
                                       ST_ECP_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
   /* Get the result of the point check */
-  if (HAL_PKA_PointCheck_IsOnCurve(&hpka) != 1U)
+  if (HAL_PKA_PointCheck_IsOnCurve(hpka) != 1U)
   {
     ret = MBEDTLS_ERR_ECP_INVALID_KEY;
   }
 
 cleanup:
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 0U /* public operands */);
+  }
 
   /* Free memory */
   if (pt_binary != NULL)
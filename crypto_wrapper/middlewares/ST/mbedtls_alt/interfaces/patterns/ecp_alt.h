@@ -170,6 +170,55 @@ mbedtls_ecp_group;
 
 /* @} name SECTION: Module settings */
 
+#if defined(MBEDTLS_HAL_ECDSA_ALT) && defined(MBEDTLS_ECDSA_VERIFY_ALT)
+/**
+  * @brief    An ECDSA signature of a batch verified by
+  *           mbedtls_ecdsa_verify_batch(). All the values are big endian
+  *           binary strings, as stored by PSA or read from an image header.
+  */
+typedef struct mbedtls_ecdsa_verify_item
+{
+  const unsigned char *Q;     /*!< Public key, uncompressed point 04 || X || Y */
+  size_t Q_len;               /*!< Public key length: 2 * st_modulus_size + 1 */
+  const unsigned char *hash;  /*!< Hash of the signed message */
+  size_t hlen;                /*!< Hash length */
+  const unsigned char *r;     /*!< First part of the signature */
+  const unsigned char *s;     /*!< Second part of the signature */
+  size_t rs_len;              /*!< Length of r and of s */
+}
+mbedtls_ecdsa_verify_item;
+
+/**
+  * @brief          Verify a batch of ECDSA signatures made on the curve of
+  *                 grp, as mbedtls_ecdsa_verify() would do for each of them.
+  *                 The curve parameters are set once, the keys and
+  *                 signatures are given to the PKA without MPI conversion
+  *                 and the batch runs in a single PKA session.
+  *
+  * @note           The public keys are not checked to lie on the curve:
+  *                 as for mbedtls_ecdsa_verify(), they must be valid, such
+  *                 as PSA keys checked at import.
+  *
+  * @param grp      The ECP group of all the signatures.
+  * @param items    The signatures to verify.
+  * @param count    The number of signatures.
+  * @param results  The status of each signature: 0 if valid,
+  *                 MBEDTLS_ERR_ECP_VERIFY_FAILED if not,
+  *                 MBEDTLS_ERR_ECP_BAD_INPUT_DATA if its public key is not
+  *                 an uncompressed point of the curve length, or the error
+  *                 that stopped the batch.
+  *
+  * @return         0 if all the signatures are valid,
+  *                 MBEDTLS_ERR_ECP_VERIFY_FAILED if at least one is
+  *                 rejected, or another MBEDTLS_ERR_xxx error code on an
+  *                 allocation or PKA failure, the signatures not verified
+  *                 then having that status.
+  */
+int mbedtls_ecdsa_verify_batch(mbedtls_ecp_group *grp,
+                               const mbedtls_ecdsa_verify_item *items,
+                               size_t count, int *results);
+#endif /* MBEDTLS_HAL_ECDSA_ALT && MBEDTLS_ECDSA_VERIFY_ALT */
+
 #endif /* MBEDTLS_ECP_ALT */
 
 #ifdef __cplusplus
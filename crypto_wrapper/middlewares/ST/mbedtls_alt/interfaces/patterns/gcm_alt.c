@@ -32,6 +32,12 @@
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
+#if defined(MBEDTLS_HAL_AES_ALT)
+#include "mbedtls/aes.h"
+#endif /* MBEDTLS_HAL_AES_ALT */
+#if (defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)) && defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+#include "kwe_core.h"
+#endif /* (HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM) && KWE_AES_KEY_RESIDENCY_ENABLED */
 
 #if defined(MBEDTLS_HAL_GCM_ALT)
 
@@ -42,8 +48,44 @@
 #if defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
 #define SEC_SUCCESS_CONSTANT  0x3AU   /* Secure Success value */
 #endif /* HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM */
+#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+#define ST_GCM_BULK_BLOCKS    16U     /* counter blocks encrypted per ECB call */
+#else
+/* GCM phases in the GCMPH field of the CR register */
+#define ST_GCM_PHASE_INIT     0x00000000U
+#define ST_GCM_PHASE_HEADER   AES_CR_GCMPH_0
+#define ST_GCM_PHASE_PAYLOAD  AES_CR_GCMPH_1
+#define ST_GCM_PHASE_FINAL    AES_CR_GCMPH
+#define ST_GCM_MODE_DECRYPT   AES_CR_MODE_1
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
 /* Private macro -------------------------------------------------------------*/
+#if (defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)) && defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+/*
+ * SAES is shared with the key wrap engine: drop the wrapped key it keeps
+ * loaded before reprogramming the peripheral
+ */
+#define ST_SAES_CLAIM()   KWE_AesKeyInvalidate()
+#else
+#define ST_SAES_CLAIM()
+#endif /* (HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM) && KWE_AES_KEY_RESIDENCY_ENABLED */
+
+#if defined(MBEDTLS_HAL_AES_ALT)
+/*
+ * The AES module keeps the key of its last context loaded: make it reload
+ * its configuration once the peripheral has been reprogrammed
+ */
+#define ST_AES_RELEASE()  mbedtls_aes_hw_release()
+#else
+#define ST_AES_RELEASE()
+#endif /* MBEDTLS_HAL_AES_ALT */
+
+/* The payload is moved by DMA with the channels set up by the AES module */
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD) && defined(MBEDTLS_HAL_AES_ALT) \
+    && !defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+#define ST_GCM_DMA
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD && MBEDTLS_HAL_AES_ALT && !HW_CRYPTO_DPA_CTR_FOR_GCM */
+
 /*
  * 32-bit integer manipulation macros (big endian)
  */
@@ -72,92 +114,353 @@
 /* Private functions ---------------------------------------------------------*/
 
 /*
- * Initialize a context
+ * Take the CRYP peripheral for the calling thread
  */
-void mbedtls_gcm_init(mbedtls_gcm_context *ctx)
+static int gcm_lock(void)
 {
-#if defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  /* Enable SAES clock */
-  __HAL_RCC_SAES_CLK_ENABLE();
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_lock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
 
-#endif /* HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM */
-  memset(ctx, 0, sizeof(mbedtls_gcm_context));
+  return 0;
+}
+
+/*
+ * Hand the CRYP peripheral over to the next waiting thread. ret is returned
+ * unless the unlock fails.
+ */
+static int gcm_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_unlock(&cryp_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return ret;
 }
 
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
 /*
- * Precompute small multiples of H, that is set
- *      HH[i] || HL[i] = H times i,
- * where i is seen as a field element as in [MGV], ie high-order bits
- * correspond to low powers of P. The result is stored in the same way, that
- * is the high-order bit of HH corresponds to P^0 and the low-order bit of HL
- * corresponds to P^127.
+ * Sets x to x times H, x and H are seen as elements of GF(2^128) as in [MGV].
+ * Bit serial multiplication: no table depending on H is kept, and the
+ * number of operations does not depend on the data.
  */
-static int gcm_gen_table(mbedtls_gcm_context *ctx)
+static void gcm_mult(mbedtls_gcm_context *ctx, unsigned char x[16])
 {
-  int i = 0;
-  int j = 0;
-  uint64_t hi = 0;
-  uint64_t lo = 0;
-  uint64_t vl = 0;
-  uint64_t vh = 0;
-  unsigned char h[16] = {0};
+  uint32_t z[4] = {0};
+  uint32_t v[4];
+  uint32_t mask = 0;
+  size_t i = 0;
+  size_t j = 0;
+
+  memcpy(v, ctx->h, sizeof(v));
 
-  memset(h, 0, 16);
+  for (i = 0; i < 128U; i++)
+  {
+    mask = 0U - (uint32_t)((x[i / 8U] >> (7U - (i % 8U))) & 1U);
+    for (j = 0; j < 4U; j++)
+    {
+      z[j] ^= v[j] & mask;
+    }
+
+    mask = 0U - (v[3] & 1U);
+    v[3] = (v[3] >> 1) | (v[2] << 31);
+    v[2] = (v[2] >> 1) | (v[1] << 31);
+    v[1] = (v[1] >> 1) | (v[0] << 31);
+    v[0] = (v[0] >> 1) ^ (0xE1000000U & mask);
+  }
+
+  PUT_UINT32_BE(z[0], x, 0);
+  PUT_UINT32_BE(z[1], x, 4);
+  PUT_UINT32_BE(z[2], x, 8);
+  PUT_UINT32_BE(z[3], x, 12);
+
+  mbedtls_platform_zeroize(z, sizeof(z));
+  mbedtls_platform_zeroize(v, sizeof(v));
+}
+
+/*
+ * Compute the key stream of the next blocks: the counter blocks are
+ * encrypted by a single ECB call on the peripheral.
+ */
+static int gcm_key_stream(mbedtls_gcm_context *ctx,
+                          unsigned char *stream, size_t blocks)
+{
+  size_t i = 0;
+  size_t j = 0;
+
+  for (i = 0; i < blocks; i++)
+  {
+    /* increment counter */
+    for (j = 16; j > 12; j--)
+    {
+      ++ctx->y[j - 1];
+      if (ctx->y[j - 1] != 0)
+      {
+        break;
+      }
+    }
+    memcpy(stream + (16U * i), ctx->y, 16);
+  }
 
-  /* compute Hash_subkey = E(0) */
   if (HAL_CRYP_Encrypt(&ctx->hcryp_gcm,
-                       (uint32_t *)h,
-                       16,
-                       (uint32_t *)h,
+                       (uint32_t *)stream,
+                       (uint16_t)(16U * blocks),
+                       (uint32_t *)stream,
                        ST_GCM_TIMEOUT) != HAL_OK)
   {
     return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
   }
 
-  /* pack h as two 64-bits ints, big-endian */
-  GET_UINT32_BE(hi, h,  0);
-  GET_UINT32_BE(lo, h,  4);
-  vh = (uint64_t) hi << 32 | lo;
+  return 0;
+}
+
+/*
+ * Encrypt or decrypt length bytes with the key stream ectr from offset,
+ * and xor the ciphertext into the GHASH state
+ */
+static void gcm_mask(mbedtls_gcm_context *ctx,
+                     const unsigned char *ectr,
+                     size_t offset,
+                     size_t length,
+                     const unsigned char *input,
+                     unsigned char *output)
+{
+  size_t i = 0;
+  unsigned char c = 0;
+
+  for (i = 0; i < length; i++)
+  {
+    c = input[i];
+    output[i] = ectr[offset + i] ^ c;
+    ctx->buf[offset + i] ^= (ctx->mode == MBEDTLS_GCM_DECRYPT) ? c : output[i];
+  }
+}
+
+#else
+/*
+ * Wait until a status flag of the CRYP peripheral is set
+ */
+static int gcm_wait_flag(mbedtls_gcm_context *ctx, uint32_t flag)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (__HAL_CRYP_GET_FLAG(&ctx->hcryp_gcm, flag) == RESET)
+  {
+    if ((HAL_GetTick() - tickstart) > ST_GCM_TIMEOUT)
+    {
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Feed a block to the current GCM phase of the peripheral. The output block,
+ * if any, is read back into block.
+ */
+static int gcm_process_block(mbedtls_gcm_context *ctx,
+                             uint32_t block[4],
+                             int read_output)
+{
+  AES_TypeDef *instance = ctx->hcryp_gcm.Instance;
+
+  instance->DINR = block[0];
+  instance->DINR = block[1];
+  instance->DINR = block[2];
+  instance->DINR = block[3];
+
+  if (gcm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
+  {
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  if (read_output)
+  {
+    block[0] = instance->DOUTR;
+    block[1] = instance->DOUTR;
+    block[2] = instance->DOUTR;
+    block[3] = instance->DOUTR;
+  }
 
-  GET_UINT32_BE(hi, h,  8);
-  GET_UINT32_BE(lo, h,  12);
-  vl = (uint64_t) hi << 32 | lo;
+  __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_gcm, CRYP_CLEAR_CCF);
 
-  /* 8 = 1000 corresponds to 1 in GF(2^128) */
-  ctx->HL[8] = vl;
-  ctx->HH[8] = vh;
+  return 0;
+}
 
-  /* 0 corresponds to 0 in GF(2^128) */
-  ctx->HH[0] = 0;
-  ctx->HL[0] = 0;
+/*
+ * Give the peripheral back the state of ctx: configuration and GCM phase,
+ * key, and for an operation in progress the GHASH state (SUSPxR) and the
+ * counter (IVRx) saved by gcm_suspend(). The peripheral is enabled unless
+ * the operation is still to be started.
+ * The counter is only required by the payload phase, it is kept from the
+ * header phase on so that the peripheral never runs on another context's.
+ */
+static int gcm_resume(mbedtls_gcm_context *ctx)
+{
+  AES_TypeDef *instance = ctx->hcryp_gcm.Instance;
+  uint32_t phase = ctx->ctx_save_cr & AES_CR_GCMPH;
+  uint32_t *key = ctx->gcm_key;
+  uint32_t *iv = (uint32_t *)ctx->y;
 
-  for (i = 4; i > 0; i >>= 1)
+  /* allow multi-context of CRYP use: restore context */
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+
+  if (phase == ST_GCM_PHASE_INIT)
+  {
+    /* pre-counter block, counter set to 2 for the first payload block */
+    instance->IVR3 = iv[0];
+    instance->IVR2 = iv[1];
+    instance->IVR1 = iv[2];
+    instance->IVR0 = iv[3];
+  }
+  else
+  {
+    instance->SUSP0R = ctx->susp[0];
+    instance->SUSP1R = ctx->susp[1];
+    instance->SUSP2R = ctx->susp[2];
+    instance->SUSP3R = ctx->susp[3];
+    instance->SUSP4R = ctx->susp[4];
+    instance->SUSP5R = ctx->susp[5];
+    instance->SUSP6R = ctx->susp[6];
+    instance->SUSP7R = ctx->susp[7];
+    instance->IVR0 = ctx->ivr[0];
+    instance->IVR1 = ctx->ivr[1];
+    instance->IVR2 = ctx->ivr[2];
+    instance->IVR3 = ctx->ivr[3];
+  }
+
+  instance->CR = ctx->ctx_save_cr & ~AES_CR_EN;
+
+#if defined(HW_CRYPTO_DPA_GCM)
+  /* hardware key is loaded by the key selection */
+  if (ctx->hcryp_gcm.Init.KeyProtection == CRYP_KEYSEL_NORMAL)
+#endif /* HW_CRYPTO_DPA_GCM */
   {
-    uint32_t T = (vl & 1) * 0xe1000000U;
-    vl  = (vh << 63) | (vl >> 1);
-    vh  = (vh >> 1) ^ ((uint64_t) T << 32);
+    if (ctx->hcryp_gcm.Init.KeySize == CRYP_KEYSIZE_256B)
+    {
+      instance->KEYR7 = key[0];
+      instance->KEYR6 = key[1];
+      instance->KEYR5 = key[2];
+      instance->KEYR4 = key[3];
+      key += 4;
+    }
+    instance->KEYR3 = key[0];
+    instance->KEYR2 = key[1];
+    instance->KEYR1 = key[2];
+    instance->KEYR0 = key[3];
+  }
+
+  if (gcm_wait_flag(ctx, CRYP_FLAG_KEYVALID) != 0)
+  {
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
 
-    ctx->HL[i] = vl;
-    ctx->HH[i] = vh;
+  if (phase != ST_GCM_PHASE_INIT)
+  {
+    SET_BIT(instance->CR, AES_CR_EN);
   }
 
-  for (i = 2; i <= 8; i *= 2)
+  return 0;
+}
+
+/*
+ * Save the state of the operation in progress in ctx and disable the
+ * peripheral, so that other contexts can use it until gcm_resume().
+ * To be called between two blocks, once the last one has completed.
+ */
+static void gcm_suspend(mbedtls_gcm_context *ctx)
+{
+  AES_TypeDef *instance = ctx->hcryp_gcm.Instance;
+
+  ctx->susp[0] = instance->SUSP0R;
+  ctx->susp[1] = instance->SUSP1R;
+  ctx->susp[2] = instance->SUSP2R;
+  ctx->susp[3] = instance->SUSP3R;
+  ctx->susp[4] = instance->SUSP4R;
+  ctx->susp[5] = instance->SUSP5R;
+  ctx->susp[6] = instance->SUSP6R;
+  ctx->susp[7] = instance->SUSP7R;
+  ctx->ivr[0] = instance->IVR0;
+  ctx->ivr[1] = instance->IVR1;
+  ctx->ivr[2] = instance->IVR2;
+  ctx->ivr[3] = instance->IVR3;
+
+  /* allow multi-context of CRYP : save context */
+  ctx->ctx_save_cr = instance->CR & ~AES_CR_EN;
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+}
+
+/*
+ * Stop the operation of ctx after an error, the next calls fail until
+ * mbedtls_gcm_starts()
+ */
+static void gcm_abort(mbedtls_gcm_context *ctx)
+{
+  CLEAR_BIT(ctx->hcryp_gcm.Instance->CR, AES_CR_EN);
+  ctx->ctx_save_cr &= ~(AES_CR_GCMPH | AES_CR_NPBLB);
+  mbedtls_platform_zeroize(ctx->susp, sizeof(ctx->susp));
+  mbedtls_platform_zeroize(ctx->ivr, sizeof(ctx->ivr));
+  mbedtls_platform_zeroize(ctx->buf, sizeof(ctx->buf));
+}
+
+/*
+ * Close the header phase: feed the last additional data block, zero padded,
+ * and select the payload phase
+ */
+static int gcm_end_header(mbedtls_gcm_context *ctx)
+{
+  uint32_t block[4] = {0};
+  size_t offset = (size_t)(ctx->add_len % 16U);
+
+  if (offset != 0U)
   {
-    uint64_t *HiL = ctx->HL + i, *HiH = ctx->HH + i;
-    vh = *HiH;
-    vl = *HiL;
-    for (j = 1; j < i; j++)
+    memcpy(block, ctx->buf, offset);
+    if (gcm_process_block(ctx, block, 0) != 0)
     {
-      HiH[j] = vh ^ ctx->HH[j];
-      HiL[j] = vl ^ ctx->HL[j];
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
     }
   }
 
+  MODIFY_REG(ctx->hcryp_gcm.Instance->CR, AES_CR_GCMPH, ST_GCM_PHASE_PAYLOAD);
+
   return 0;
 }
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
+/*
+ * Initialize a context
+ */
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx)
+{
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  /* mutex cannot be initialized twice */
+  if (!cryp_mutex_started)
+  {
+    mbedtls_mutex_init(&cryp_mutex);
+    cryp_mutex_started = 1;
+  }
+  cryp_context_count++;
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
+
+#if defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  /* Enable SAES clock */
+  __HAL_RCC_SAES_CLK_ENABLE();
+
+#endif /* HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM */
+  memset(ctx, 0, sizeof(mbedtls_gcm_context));
+}
+
 int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
                        mbedtls_cipher_id_t cipher,
                        const unsigned char *key,
@@ -165,6 +468,9 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
 {
   int ret = 0;
   unsigned int i = 0;
+#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  __ALIGN_BEGIN unsigned char h[16] __ALIGN_END = {0};
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
   switch (keybits)
   {
@@ -178,16 +484,19 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
       break;
 
     case 192:
-      ret = MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
-      goto exit;
+      return MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
 
     case 256:
       ctx->hcryp_gcm.Init.KeySize = CRYP_KEYSIZE_256B;
       break;
 
     default :
-      ret = MBEDTLS_ERR_GCM_BAD_INPUT;
-      goto exit;
+      return MBEDTLS_ERR_GCM_BAD_INPUT;
+  }
+
+  if ((ret = gcm_lock()) != 0)
+  {
+    return ret;
   }
 
   /* Format and fill AES key  */
@@ -217,6 +526,8 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
   }
 
   /* Deinitializes the CRYP peripheral */
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
   if (HAL_CRYP_DeInit(&ctx->hcryp_gcm) != HAL_OK)
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
@@ -230,6 +541,7 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
   ctx->hcryp_gcm.Init.Algorithm  = CRYP_AES_GCM_GMAC;
 
   /* Deinitializes the CRYP peripheral */
+  ST_AES_RELEASE();
   if (HAL_CRYP_DeInit(&ctx->hcryp_gcm) != HAL_OK)
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
@@ -247,87 +559,40 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx,
   }
 
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  if ((ret = gcm_gen_table(ctx)) != 0)
+  /* compute Hash_subkey H = E(0) */
+  if (HAL_CRYP_Encrypt(&ctx->hcryp_gcm,
+                       (uint32_t *)h,
+                       16,
+                       (uint32_t *)h,
+                       ST_GCM_TIMEOUT) != HAL_OK)
   {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
     goto exit;
   }
+
+  GET_UINT32_BE(ctx->h[0], h, 0);
+  GET_UINT32_BE(ctx->h[1], h, 4);
+  GET_UINT32_BE(ctx->h[2], h, 8);
+  GET_UINT32_BE(ctx->h[3], h, 12);
+  mbedtls_platform_zeroize(h, sizeof(h));
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
   /* allow multi-instance of CRYP use: save context for CRYP HW module CR */
   ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
+#if !defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  /* the GCM phases are driven by the operations, none is in progress */
+  ctx->ctx_save_cr &= ~(AES_CR_EN | AES_CR_GCMPH | AES_CR_MODE | AES_CR_NPBLB);
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
 exit :
-  return ret;
+  return gcm_unlock(ret);
 }
 
-#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-/*
- * Shoup's method for multiplication use this table with
- *      last4[x] = x times P^128
- * where x and last4[x] are seen as elements of GF(2^128) as in [MGV]
- */
-static const uint64_t last4[16] =
-{
-  0x0000, 0x1c20, 0x3840, 0x2460,
-  0x7080, 0x6ca0, 0x48c0, 0x54e0,
-  0xe100, 0xfd20, 0xd940, 0xc560,
-  0x9180, 0x8da0, 0xa9c0, 0xb5e0
-};
-
-/*
- * Sets output to x times H using the precomputed tables.
- * x and output are seen as elements of GF(2^128) as in [MGV].
- */
-static void gcm_mult(mbedtls_gcm_context *ctx, const unsigned char x[16],
-                     unsigned char output[16])
-{
-  int i = 0;
-  unsigned char lo = 0;
-  unsigned char hi = 0;
-  unsigned char rem = 0;
-  uint64_t zh = 0;
-  uint64_t zl = 0;
-
-  lo = x[15] & 0xf;
-
-  zh = ctx->HH[lo];
-  zl = ctx->HL[lo];
-
-  for (i = 15; i >= 0; i--)
-  {
-    lo = x[i] & 0xf;
-    hi = (x[i] >> 4) & 0xf;
-
-    if (i != 15)
-    {
-      rem = (unsigned char) zl & 0xf;
-      zl = (zh << 60) | (zl >> 4);
-      zh = (zh >> 4);
-      zh ^= (uint64_t) last4[rem] << 48;
-      zh ^= ctx->HH[lo];
-      zl ^= ctx->HL[lo];
-
-    }
-
-    rem = (unsigned char) zl & 0xf;
-    zl = (zh << 60) | (zl >> 4);
-    zh = (zh >> 4);
-    zh ^= (uint64_t) last4[rem] << 48;
-    zh ^= ctx->HH[hi];
-    zl ^= ctx->HL[hi];
-  }
-
-  PUT_UINT32_BE(zh >> 32, output, 0);
-  PUT_UINT32_BE(zh, output, 4);
-  PUT_UINT32_BE(zl >> 32, output, 8);
-  PUT_UINT32_BE(zl, output, 12);
-}
-#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
-
 int mbedtls_gcm_starts(mbedtls_gcm_context *ctx,
                        int mode,
                        const unsigned char *iv, size_t iv_len)
 {
+  int ret = 0;
 #if !defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
   size_t i = 0;
   uint32_t *iv_p = (uint32_t *)(ctx->y);
@@ -349,19 +614,26 @@ int mbedtls_gcm_starts(mbedtls_gcm_context *ctx,
     return MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
   }
 
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
-
-  if (HAL_CRYP_Init(&ctx->hcryp_gcm) != HAL_OK)
+  if ((ret = gcm_lock()) != 0)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    return ret;
   }
 
   ctx->mode = mode;
   ctx->len = 0;
+  ctx->add_len = 0;
 
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  ctx->add_len = 0;
+  /* allow multi-context of CRYP use: restore context */
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
+  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
+
+  if (HAL_CRYP_Init(&ctx->hcryp_gcm) != HAL_OK)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
 
   /* generate pre-counter block (Y = IV || 0exp(31) || 1) */
   memcpy(ctx->y, iv, iv_len);
@@ -375,9 +647,12 @@ int mbedtls_gcm_starts(mbedtls_gcm_context *ctx,
                        (uint32_t *)ctx->base_ectr,
                        ST_GCM_TIMEOUT) != HAL_OK)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
   }
 
+  /* allow multi-context of CRYP : save context */
+  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
 #else
   /* Set IV with invert endianness */
   for (i = 0; i < iv_len / 4U; i++)
@@ -388,43 +663,73 @@ int mbedtls_gcm_starts(mbedtls_gcm_context *ctx,
   /* counter value must be set to 2 when processing the first block of payload */
   iv_p[3] = 0x00000002;
 
-  ctx->hcryp_gcm.Init.pInitVect = (uint32_t *)ctx->y;
+  /* Init phase: the peripheral computes the hash subkey from the key */
+  ctx->ctx_save_cr &= ~(AES_CR_GCMPH | AES_CR_MODE | AES_CR_NPBLB);
+  if (mode == MBEDTLS_GCM_DECRYPT)
+  {
+    ctx->ctx_save_cr |= ST_GCM_MODE_DECRYPT;
+  }
 
-  /* Do not Allow IV reconfiguration at every gcm update */
-  ctx->hcryp_gcm.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ONCE;
+  if (gcm_resume(ctx) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  SET_BIT(ctx->hcryp_gcm.Instance->CR, AES_CR_EN);
+  if (gcm_wait_flag(ctx, CRYP_FLAG_CCF) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+  __HAL_CRYP_CLEAR_FLAG(&ctx->hcryp_gcm, CRYP_CLEAR_CCF);
 
+  /* Header phase, left for the additional data */
+  MODIFY_REG(ctx->hcryp_gcm.Instance->CR, AES_CR_GCMPH, ST_GCM_PHASE_HEADER);
+  SET_BIT(ctx->hcryp_gcm.Instance->CR, AES_CR_EN);
+  gcm_suspend(ctx);
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
+exit:
+#if !defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  if (ret != 0)
+  {
+    gcm_abort(ctx);
+  }
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
-  return 0;
+  return gcm_unlock(ret);
 }
 
 /**
-  * mbedtls_gcm_context::buf contains the partial state of the computation of
-  * the authentication tag.
+  * mbedtls_gcm_context::buf holds the additional data or payload bytes that
+  * do not fill a block yet: the peripheral only hashes whole blocks, the
+  * last payload block being padded by mbedtls_gcm_finish(). The payload
+  * bytes are all output by mbedtls_gcm_update() though. With
+  * HW_CRYPTO_DPA_CTR_FOR_GCM, it holds the partial GHASH state instead.
   * mbedtls_gcm_context::add_len and mbedtls_gcm_context::len indicate
   * different stages of the computation:
   *     * len == 0 && add_len == 0:      initial state
   *     * len == 0 && add_len % 16 != 0: the first `add_len % 16` bytes have
-  *                                      a partial block of AD that has been
-  *                                      xored in but not yet multiplied in.
+  *                                      a partial block of AD that has not
+  *                                      been hashed yet.
   *     * len == 0 && add_len % 16 == 0: the authentication tag is correct if
   *                                      the data ends now.
   *     * len % 16 != 0:                 the first `len % 16` bytes have
-  *                                      a partial block of ciphertext that has
-  *                                      been xored in but not yet multiplied in.
+  *                                      a partial block of payload that has
+  *                                      not been hashed yet.
   *     * len > 0 && len % 16 == 0:      the authentication tag is correct if
   *                                      the data ends now.
   */
 int mbedtls_gcm_update_ad(mbedtls_gcm_context *ctx,
                           const unsigned char *add, size_t add_len)
 {
-#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  const unsigned char *p;
-  size_t use_len;
+  size_t offset = 0;
+  size_t use_len = 0;
   size_t i = 0;
+#if !defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  int ret = 0;
+  uint32_t block[4];
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
   /* additional authentication data is limited to 2^64 bits, so 2^61 bytes */
@@ -433,54 +738,117 @@ int mbedtls_gcm_update_ad(mbedtls_gcm_context *ctx,
     return MBEDTLS_ERR_GCM_BAD_INPUT;
   }
 
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
+  /* additional data is not accepted once the payload has started */
+  if ((ctx->len != 0) || ((ctx->add_len + add_len) < ctx->add_len))
+  {
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+  }
+
+  offset = (size_t)(ctx->add_len % 16U);
 
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  ctx->add_len = add_len;
-  p = add;
-  while (add_len > 0)
+  ctx->add_len += add_len;
+
+  /* complete the partial block left by the previous call */
+  if (offset != 0)
   {
-    use_len = (add_len < 16) ? add_len : 16;
+    use_len = 16U - offset;
+    if (use_len > add_len)
+    {
+      use_len = add_len;
+    }
 
     for (i = 0; i < use_len; i++)
     {
-      ctx->buf[i] ^= p[i];
+      ctx->buf[offset + i] ^= add[i];
     }
 
-    gcm_mult(ctx, ctx->buf, ctx->buf);
+    if ((offset + use_len) == 16U)
+    {
+      gcm_mult(ctx, ctx->buf);
+    }
 
     add_len -= use_len;
-    p += use_len;
+    add += use_len;
   }
+
+  while (add_len >= 16U)
+  {
+    for (i = 0; i < 16U; i++)
+    {
+      ctx->buf[i] ^= add[i];
+    }
+
+    gcm_mult(ctx, ctx->buf);
+
+    add_len -= 16U;
+    add += 16U;
+  }
+
+  for (i = 0; i < add_len; i++)
+  {
+    ctx->buf[i] ^= add[i];
+  }
+
+  return 0;
 #else
+  if ((ctx->ctx_save_cr & AES_CR_GCMPH) != ST_GCM_PHASE_HEADER)
+  {
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+  }
 
-  if (add_len != 0)
+  /* only whole blocks reach the peripheral, keep the tail for later */
+  if ((offset + add_len) < 16U)
   {
-    ctx->hcryp_gcm.Init.Header = (uint32_t *)add;
-    /* header buffer in byte length */
-    ctx->hcryp_gcm.Init.HeaderSize = (uint32_t)add_len;
+    memcpy(ctx->buf + offset, add, add_len);
+    ctx->add_len += add_len;
+    return 0;
   }
-  else
+
+  if ((ret = gcm_lock()) != 0)
   {
-    ctx->hcryp_gcm.Init.Header = NULL;
-    ctx->hcryp_gcm.Init.HeaderSize = 0;
+    return ret;
   }
 
-  /* Additional Authentication Data in bytes unit */
-  ctx->hcryp_gcm.Init.HeaderWidthUnit = CRYP_HEADERWIDTHUNIT_BYTE;
+  if (gcm_resume(ctx) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  ctx->add_len += add_len;
 
-  /* reconfigure the CRYP */
-  if (HAL_CRYP_SetConfig(&ctx->hcryp_gcm, &ctx->hcryp_gcm.Init) != HAL_OK)
+  while ((offset + add_len) >= 16U)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    use_len = 16U - offset;
+    memcpy(block, ctx->buf, offset);
+    memcpy((unsigned char *)block + offset, add, use_len);
+    add_len -= use_len;
+    add += use_len;
+    offset = 0;
+
+    if (gcm_process_block(ctx, block, 0) != 0)
+    {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
   }
-#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
+  for (i = 0; i < add_len; i++)
+  {
+    ctx->buf[i] = add[i];
+  }
 
-  return 0;
+  gcm_suspend(ctx);
+
+exit:
+  if (ret != 0)
+  {
+    gcm_abort(ctx);
+  }
+
+  return gcm_unlock(ret);
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 }
 
 int mbedtls_gcm_update(mbedtls_gcm_context *ctx,
@@ -488,22 +856,19 @@ int mbedtls_gcm_update(mbedtls_gcm_context *ctx,
                        unsigned char *output, size_t output_size,
                        size_t *output_length)
 {
+  int ret = 0;
+  size_t offset = 0;
+  size_t use_len = 0;
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  unsigned char ectr[16] = {0};
+  __ALIGN_BEGIN unsigned char stream[ST_GCM_BULK_BLOCKS * 16U] __ALIGN_END;
+  size_t blocks = 0;
   size_t i = 0;
-  const unsigned char *p;
-  unsigned char *out_p = output;
-  size_t use_len = 0;
 #else
-  uint16_t wordnb = 0;          /* number of four data words */
-  uint16_t wordlen = 0;         /* length (in bytes) of four data words */
-  uint16_t in_datalen = 0;  /* length (in bytes) of processed data within input buffer */
-  __ALIGN_BEGIN unsigned char work_buf[16] __ALIGN_END;
-  uint16_t work_buf_len = 0;
+  uint32_t block[4];
+  size_t out_len = input_length;
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
-  size_t tmp_lenght = 0;
 
-  tmp_lenght = ctx->len;
+  *output_length = 0;
 
   if ((output > input) && ((size_t)(output - input) < input_length))
   {
@@ -518,147 +883,219 @@ int mbedtls_gcm_update(mbedtls_gcm_context *ctx,
     return MBEDTLS_ERR_GCM_BAD_INPUT;
   }
 
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
+  offset = (size_t)(ctx->len % 16U);
 
 #if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  p = input;
-  ctx->len += input_length;
-  while (input_length > 0)
+  if (output_size < input_length)
   {
-    use_len = (input_length < 16) ? input_length : 16;
+    return MBEDTLS_ERR_GCM_BUFFER_TOO_SMALL;
+  }
 
-    /* increment counter */
-    for (i = 16; i > 12; i--)
-    {
-      ++ctx->y[i - 1];
-      if (ctx->y[i - 1] != 0)
-      {
-        break;
-      }
-    }
+  if (input_length == 0)
+  {
+    return 0;
+  }
+
+  if ((ctx->len == 0) && ((ctx->add_len % 16U) != 0))
+  {
+    /* hash the last partial block of additional data */
+    gcm_mult(ctx, ctx->buf);
+  }
+
+  ctx->len += input_length;
 
-    if (HAL_CRYP_Encrypt(&ctx->hcryp_gcm,
-                         (uint32_t *)ctx->y,
-                         16,
-                         (uint32_t *)ectr,
-                         ST_GCM_TIMEOUT) != HAL_OK)
+  /* use the key stream left by the previous call first */
+  if (offset != 0)
+  {
+    use_len = 16U - offset;
+    if (use_len > input_length)
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      use_len = input_length;
     }
 
-    for (i = 0; i < use_len; i++)
+    gcm_mask(ctx, ctx->ectr, offset, use_len, input, output);
+
+    if ((offset + use_len) == 16U)
     {
-      if (ctx->mode == MBEDTLS_GCM_DECRYPT)
-      {
-        ctx->buf[i] ^= p[i];
-      }
-      out_p[i] = ectr[i] ^ p[i];
-      if (ctx->mode == MBEDTLS_GCM_ENCRYPT)
-      {
-        ctx->buf[i] ^= out_p[i];
-      }
+      gcm_mult(ctx, ctx->buf);
     }
 
-    gcm_mult(ctx, ctx->buf, ctx->buf);
-
     input_length -= use_len;
-    p += use_len;
-    out_p += use_len;
+    input += use_len;
+    output += use_len;
+    *output_length += use_len;
+  }
+
+  if (input_length == 0)
+  {
+    return 0;
   }
-#else
-  /* Calculate number of four data words */
-  wordnb = input_length / 16U;
 
-  /* if available, process them */
-  if (wordnb)
+  if ((ret = gcm_lock()) != 0)
   {
-    /* Convert in bytes */
-    wordlen = wordnb * 16U;
+    return ret;
+  }
 
-    if (ctx->mode == MBEDTLS_GCM_DECRYPT)
+  /* allow multi-context of CRYP use: restore context */
+  ST_AES_RELEASE();
+  ST_SAES_CLAIM();
+  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
+
+  while (input_length >= 16U)
+  {
+    blocks = input_length / 16U;
+    if (blocks > ST_GCM_BULK_BLOCKS)
     {
-      if (HAL_CRYP_Decrypt(&ctx->hcryp_gcm,
-                           (uint32_t *)input,
-                           wordlen,
-                           (uint32_t *)output,
-                           ST_GCM_TIMEOUT) != HAL_OK)
-      {
-        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-      }
+      blocks = ST_GCM_BULK_BLOCKS;
     }
-    else
+
+    if (gcm_key_stream(ctx, stream, blocks) != 0)
     {
-      if (HAL_CRYP_Encrypt(&ctx->hcryp_gcm,
-                           (uint32_t *)input,
-                           wordlen,
-                           (uint32_t *)output,
-                           ST_GCM_TIMEOUT) != HAL_OK)
-      {
-        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-      }
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
     }
 
-    /* update total length */
-    ctx->len += wordlen;
-
-    in_datalen += wordlen;
-
-    if (in_datalen < input_length)
+    for (i = 0; i < blocks; i++)
     {
-      /* Process them into a last four data word */
-      goto last_data_word;
+      gcm_mask(ctx, stream + (16U * i), 0, 16U, input, output);
+      gcm_mult(ctx, ctx->buf);
+
+      input_length -= 16U;
+      input += 16U;
+      output += 16U;
+      *output_length += 16U;
     }
-    else
+  }
+
+  /* keep the key stream of the last partial block for the next call */
+  if (input_length != 0)
+  {
+    if (gcm_key_stream(ctx, ctx->ectr, 1) != 0)
     {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
       goto exit;
     }
+
+    gcm_mask(ctx, ctx->ectr, 0, input_length, input, output);
+    *output_length += input_length;
+  }
+
+  /* allow multi-context of CRYP : save context */
+  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
+
+exit:
+  mbedtls_platform_zeroize(stream, sizeof(stream));
+
+  return gcm_unlock(ret);
+#else
+  if ((ctx->ctx_save_cr & AES_CR_GCMPH) == ST_GCM_PHASE_INIT)
+  {
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+  }
+
+  if (input_length == 0)
+  {
+    return 0;
+  }
+
+  if (output_size < input_length)
+  {
+    return MBEDTLS_ERR_GCM_BUFFER_TOO_SMALL;
+  }
+
+  if ((ret = gcm_lock()) != 0)
+  {
+    return ret;
   }
 
-last_data_word:
-  /* Calculate remaining bytes */
-  /* Can have a null length when payload is omitted (GMAC) */
-  work_buf_len = (uint16_t)((input_length - in_datalen) % 16U);
+  if (gcm_resume(ctx) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
 
-  memset(work_buf, 0, sizeof(work_buf));
-  memcpy(work_buf, input + in_datalen, work_buf_len);
+  if (((ctx->ctx_save_cr & AES_CR_GCMPH) == ST_GCM_PHASE_HEADER)
+      && (gcm_end_header(ctx) != 0))
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  ctx->len += input_length;
 
-  if (ctx->mode == MBEDTLS_GCM_DECRYPT)
+  while ((offset + input_length) >= 16U)
   {
-    if (HAL_CRYP_Decrypt(&ctx->hcryp_gcm,
-                         (uint32_t *)work_buf,
-                         work_buf_len,
-                         (uint32_t *)(output + in_datalen),
-                         ST_GCM_TIMEOUT) != HAL_OK)
+#if defined(ST_GCM_DMA)
+    /* Whole blocks read straight from input go by DMA */
+    use_len = input_length & ~((size_t) 15U);
+    if ((offset == 0U) && mbedtls_aes_hw_dma_usable(&ctx->hcryp_gcm, input, output, use_len))
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      if (mbedtls_aes_hw_dma_transfer(&ctx->hcryp_gcm, input, output, use_len) != 0)
+      {
+        ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        goto exit;
+      }
+      input_length -= use_len;
+      input += use_len;
+      output += use_len;
+      continue;
     }
+#endif /* ST_GCM_DMA */
+
+    use_len = 16U - offset;
+    memcpy(block, ctx->buf, offset);
+    memcpy((unsigned char *)block + offset, input, use_len);
+    input_length -= use_len;
+    input += use_len;
+
+    if (gcm_process_block(ctx, block, 1) != 0)
+    {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+
+    /* the first offset bytes were output by the previous call */
+    memcpy(output, (unsigned char *)block + offset, use_len);
+    output += use_len;
+    offset = 0;
   }
-  else
+
+  gcm_suspend(ctx);
+
+  /*
+   * Output the bytes of the last partial block now: the block is run zero
+   * padded, then dropped by leaving the state saved above in ctx. It is
+   * processed again, with its GHASH, once complete or by mbedtls_gcm_finish()
+   */
+  if (input_length != 0)
   {
-    if (HAL_CRYP_Encrypt(&ctx->hcryp_gcm,
-                         (uint32_t *)work_buf,
-                         work_buf_len,
-                         (uint32_t *)(output + in_datalen),
-                         ST_GCM_TIMEOUT) != HAL_OK)
+    memcpy(ctx->buf + offset, input, input_length);
+    memset(block, 0, sizeof(block));
+    memcpy(block, ctx->buf, offset + input_length);
+
+    SET_BIT(ctx->hcryp_gcm.Instance->CR, AES_CR_EN);
+    ret = gcm_process_block(ctx, block, 1);
+    CLEAR_BIT(ctx->hcryp_gcm.Instance->CR, AES_CR_EN);
+    if (ret != 0)
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
     }
+
+    memcpy(output, (unsigned char *)block + offset, input_length);
   }
 
-  /* update total length */
-  ctx->len += work_buf_len;
+  *output_length = out_len;
 
 exit:
+  mbedtls_platform_zeroize(block, sizeof(block));
+  if (ret != 0)
+  {
+    gcm_abort(ctx);
+  }
 
+  return gcm_unlock(ret);
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
-
-  *output_length = ctx->len - tmp_lenght;
-
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
-
-  return 0;
 }
 
 int mbedtls_gcm_finish(mbedtls_gcm_context *ctx,
@@ -666,30 +1103,42 @@ int mbedtls_gcm_finish(mbedtls_gcm_context *ctx,
                        size_t *output_length,
                        unsigned char *tag, size_t tag_len)
 {
-#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  unsigned char work_buf[16] = {0};
-  size_t i = 0;
   uint64_t orig_len = 0;
   uint64_t orig_add_len = 0;
+  size_t i = 0;
+#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  unsigned char work_buf[16] = {0};
 #else
-  __ALIGN_BEGIN uint8_t mac[16]      __ALIGN_END; /* temporary mac */
+  int ret = 0;
+  size_t offset = 0;
+  uint32_t block[4] = {0};
+  AES_TypeDef *instance = ctx->hcryp_gcm.Instance;
 #endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 
+  *output_length = 0;
+
   if (tag_len > 16 || tag_len < 4)
   {
     return MBEDTLS_ERR_GCM_BAD_INPUT;
   }
 
-#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
   orig_len = ctx->len * 8;
   orig_add_len = ctx->add_len * 8;
 
+#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  (void) output;
+  (void) output_size;
+
+  /* hash the last partial block of additional data or payload */
+  if (((ctx->len == 0) && ((ctx->add_len % 16U) != 0)) || ((ctx->len % 16U) != 0))
+  {
+    gcm_mult(ctx, ctx->buf);
+  }
+
   memcpy(tag, ctx->base_ectr, tag_len);
 
   if (orig_len || orig_add_len)
   {
-    memset(work_buf, 0x00, 16);
-
     PUT_UINT32_BE((orig_add_len >> 32), work_buf, 0);
     PUT_UINT32_BE((orig_add_len), work_buf, 4);
     PUT_UINT32_BE((orig_len     >> 32), work_buf, 8);
@@ -700,43 +1149,95 @@ int mbedtls_gcm_finish(mbedtls_gcm_context *ctx,
       ctx->buf[i] ^= work_buf[i];
     }
 
-    gcm_mult(ctx, ctx->buf, ctx->buf);
+    gcm_mult(ctx, ctx->buf);
 
     for (i = 0; i < tag_len; i++)
     {
       tag[i] ^= ctx->buf[i];
     }
   }
+
+  mbedtls_platform_zeroize(ctx->buf, sizeof(ctx->buf));
+  mbedtls_platform_zeroize(ctx->ectr, sizeof(ctx->ectr));
+
+  return 0;
 #else
-  /* implementation restrict support to a 16 bytes tag buffer */
-  if (tag_len != 16)
+  if ((ctx->ctx_save_cr & AES_CR_GCMPH) == ST_GCM_PHASE_INIT)
   {
-    return MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
   }
 
-  /* allow multi-context of CRYP use: restore context */
-  ctx->hcryp_gcm.Instance->CR = ctx->ctx_save_cr;
+  (void) output;
+  (void) output_size;
 
-  /* Tag has a variable length */
-  memset(mac, 0, sizeof(mac));
+  offset = (size_t)(ctx->len % 16U);
 
-  /* Generate the authentication TAG */
-  if (HAL_CRYPEx_AESGCM_GenerateAuthTAG(&ctx->hcryp_gcm,
-                                        (uint32_t *)mac,
-                                        ST_GCM_TIMEOUT) != HAL_OK)
+  if ((ret = gcm_lock()) != 0)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    return ret;
   }
 
-  memcpy(tag, mac, tag_len);
+  if (gcm_resume(ctx) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
 
-  /* allow multi-context of CRYP : save context */
-  ctx->ctx_save_cr = ctx->hcryp_gcm.Instance->CR;
-#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
+  if ((ctx->ctx_save_cr & AES_CR_GCMPH) == ST_GCM_PHASE_HEADER)
+  {
+    if (gcm_end_header(ctx) != 0)
+    {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+  }
+
+  /*
+   * Hash the last partial payload block, output by mbedtls_gcm_update().
+   * The peripheral hashes its padding as zeros.
+   */
+  if (offset != 0)
+  {
+    memcpy(block, ctx->buf, offset);
+    if (ctx->mode == MBEDTLS_GCM_ENCRYPT)
+    {
+      MODIFY_REG(instance->CR, AES_CR_NPBLB, (16U - offset) << AES_CR_NPBLB_Pos);
+    }
 
-  mbedtls_platform_zeroize(ctx->gcm_key, sizeof(ctx->gcm_key));
+    if (gcm_process_block(ctx, block, 1) != 0)
+    {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+  }
 
-  return 0;
+  /* Final phase: len(A) || len(C) in bits gives the authentication tag */
+  MODIFY_REG(instance->CR, AES_CR_GCMPH | AES_CR_MODE, ST_GCM_PHASE_FINAL);
+
+  block[0] = (uint32_t)(orig_add_len >> 32);
+  block[1] = (uint32_t)(orig_add_len);
+  block[2] = (uint32_t)(orig_len >> 32);
+  block[3] = (uint32_t)(orig_len);
+
+  if (gcm_process_block(ctx, block, 1) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  for (i = 0; i < tag_len; i++)
+  {
+    tag[i] = ((unsigned char *)block)[i];
+  }
+
+exit:
+  mbedtls_platform_zeroize(block, sizeof(block));
+
+  /* operation is over: next one starts with mbedtls_gcm_starts() */
+  gcm_abort(ctx);
+
+  return gcm_unlock(ret);
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
 }
 
 int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx,
@@ -855,6 +1356,22 @@ void mbedtls_gcm_free(mbedtls_gcm_context *ctx)
     return;
   }
 
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  if (cryp_context_count > 0)
+  {
+    cryp_context_count--;
+  }
+
+  /* mutex is shared with the other CRYP contexts, free it with the last one */
+  if ((cryp_context_count == 0) && cryp_mutex_started)
+  {
+    mbedtls_mutex_free(&cryp_mutex);
+    cryp_mutex_started = 0;
+  }
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
+
   mbedtls_platform_zeroize(ctx, sizeof(mbedtls_gcm_context));
 }
 
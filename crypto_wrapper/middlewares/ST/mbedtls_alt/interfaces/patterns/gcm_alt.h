@@ -53,12 +53,15 @@ typedef struct mbedtls_gcm_context
   CRYP_HandleTypeDef hcryp_gcm;         /* HW driver handle                    */
   uint32_t ctx_save_cr;                 /* Saved HW context for multi-instance */
   uint64_t len;                         /* total length of the encrypted data. */
-#if defined(HW_CRYPTO_DPA_GCM) || defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
-  uint64_t HL[16];                   /*!< Precalculated HTable low. */
-  uint64_t HH[16];                   /*!< Precalculated HTable high. */
-  uint64_t add_len;                  /*!< The total length of the additional data. */
+  uint64_t add_len;                     /*!< The total length of the additional data. */
+#if defined(HW_CRYPTO_DPA_CTR_FOR_GCM)
+  uint32_t h[4];                     /*!< Hash subkey H = E(0). */
   unsigned char base_ectr[16];       /*!< The first ECTR for tag. */
-#endif /* HW_CRYPTO_DPA_GCM || HW_CRYPTO_DPA_CTR_FOR_GCM */
+  unsigned char ectr[16];            /*!< Key stream of the last partial block. */
+#else
+  uint32_t susp[8];                  /*!< GHASH state (SUSPxR) of the suspended operation. */
+  uint32_t ivr[4];                   /*!< Counter (IVRx) of the suspended operation. */
+#endif /* HW_CRYPTO_DPA_CTR_FOR_GCM */
   unsigned char y[16];               /*!< The Y working value. */
   unsigned char buf[16];             /*!< The buf working value. */
   int mode;                             /* The operation to perform:
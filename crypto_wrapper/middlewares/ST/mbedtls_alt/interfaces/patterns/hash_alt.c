@@ -0,0 +1,183 @@
+/**
+  ******************************************************************************
+  * @file    hash_alt.c
+  * @author  GPM Application Team
+  * @brief   Implementation of mbedtls_alt HASH peripheral scheduling
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "common.h"
+
+#if defined(MBEDTLS_HAL_SHA1_ALT) || defined(MBEDTLS_HAL_SHA256_ALT) || defined(MBEDTLS_HAL_HMAC_ALT)
+#include "hash_alt.h"
+#include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+
+/* Global variables ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+#if defined(MBEDTLS_THREADING_C)
+/*
+ * Lock of the HASH peripheral, shared by the SHA-1, SHA-256 and HMAC
+ * contexts. Each update, process or finish call holds it for the whole call.
+ * It lives from the first context initialized to the last one freed.
+ */
+static mbedtls_threading_mutex_t hash_mutex;
+static unsigned char hash_mutex_started = 0;
+static unsigned int hash_context_count = 0;
+#endif /* MBEDTLS_THREADING_C */
+
+/*
+ * Context whose intermediate digest is held by the peripheral. Its register
+ * save area is stale until another context takes the peripheral.
+ */
+static struct
+{
+  const void *p_ctx;            /* Resident context, NULL if none */
+  HASH_HandleTypeDef *p_hhash;  /* HAL handle of the resident context */
+  uint8_t *p_save_regs;         /* Register save area of the resident context */
+} st_hash_owner;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+void mbedtls_hash_hw_reference(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  /* mutex cannot be initialized twice */
+  if (!hash_mutex_started)
+  {
+    mbedtls_mutex_init(&hash_mutex);
+    hash_mutex_started = 1;
+  }
+  hash_context_count++;
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
+
+  /* Enable HASH clock */
+  __HAL_RCC_HASH_CLK_ENABLE();
+}
+
+int mbedtls_hash_hw_unreference(const void *p_ctx)
+{
+  int last = 0;
+
+  /* The peripheral must not be saved to a freed context */
+  (void) mbedtls_hash_hw_lock();
+  mbedtls_hash_hw_forget(p_ctx);
+  (void) mbedtls_hash_hw_unlock(0);
+
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  if (hash_context_count > 0)
+  {
+    hash_context_count--;
+  }
+
+  /* mutex is freed with the last context */
+  if ((hash_context_count == 0) && hash_mutex_started)
+  {
+    mbedtls_mutex_free(&hash_mutex);
+    hash_mutex_started = 0;
+    last = 1;
+  }
+  __enable_irq();
+#endif /* MBEDTLS_THREADING_C */
+
+  return last;
+}
+
+int mbedtls_hash_hw_lock(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_lock(&hash_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return 0;
+}
+
+int mbedtls_hash_hw_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_unlock(&hash_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return ret;
+}
+
+void mbedtls_hash_hw_acquire(void *p_ctx,
+                             HASH_HandleTypeDef *p_hhash,
+                             uint8_t *p_save_regs)
+{
+  if (st_hash_owner.p_ctx == p_ctx)
+  {
+    return;
+  }
+
+  mbedtls_hash_hw_release();
+
+#ifdef ST_HW_CONTEXT_SAVING
+  /* restore hw context */
+  HAL_HASH_Resume(p_hhash, p_save_regs);
+#endif /* ST_HW_CONTEXT_SAVING */
+
+  mbedtls_hash_hw_claim(p_ctx, p_hhash, p_save_regs);
+}
+
+void mbedtls_hash_hw_claim(void *p_ctx,
+                           HASH_HandleTypeDef *p_hhash,
+                           uint8_t *p_save_regs)
+{
+  st_hash_owner.p_ctx = p_ctx;
+  st_hash_owner.p_hhash = p_hhash;
+  st_hash_owner.p_save_regs = p_save_regs;
+}
+
+void mbedtls_hash_hw_release(void)
+{
+  if (st_hash_owner.p_ctx != NULL)
+  {
+#ifdef ST_HW_CONTEXT_SAVING
+    /* save hw context */
+    HAL_HASH_Suspend(st_hash_owner.p_hhash, st_hash_owner.p_save_regs);
+#endif /* ST_HW_CONTEXT_SAVING */
+    st_hash_owner.p_ctx = NULL;
+  }
+}
+
+void mbedtls_hash_hw_forget(const void *p_ctx)
+{
+  if (st_hash_owner.p_ctx == p_ctx)
+  {
+    st_hash_owner.p_ctx = NULL;
+  }
+}
+
+int mbedtls_hash_hw_is_resident(const void *p_ctx)
+{
+  return (st_hash_owner.p_ctx == p_ctx) ? 1 : 0;
+}
+
+#endif /* MBEDTLS_HAL_SHA1_ALT || MBEDTLS_HAL_SHA256_ALT || MBEDTLS_HAL_HMAC_ALT */
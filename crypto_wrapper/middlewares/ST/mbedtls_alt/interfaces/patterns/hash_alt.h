@@ -0,0 +1,144 @@
+/**
+  ******************************************************************************
+  * @file    hash_alt.h
+  * @author  GPM Application Team
+  * @brief   Header for hash_alt.c module
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/**
+  * @brief   This file contains the scheduling of the STM32 HASH hardware
+  *          crypto accelerator between the SHA-1, SHA-256 and HMAC contexts.
+  *
+  *          The context whose intermediate digest is held by the peripheral
+  *          stays resident between calls: its registers are only saved, and
+  *          those of the next context restored, when another context uses
+  *          the peripheral.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MBEDTLS_HASH_ALT_H
+#define MBEDTLS_HASH_ALT_H
+
+#if defined(MBEDTLS_HAL_SHA1_ALT) || defined(MBEDTLS_HAL_SHA256_ALT) || defined(MBEDTLS_HAL_HMAC_ALT)
+
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+
+#if !defined(MBEDTLS_HAL_HASH_BATCH_QUANTUM)
+#define MBEDTLS_HAL_HASH_BATCH_QUANTUM ((size_t) 512) /*!< Bytes hashed per context and
+                                                           turn of a batch rotation */
+#endif /* MBEDTLS_HAL_HASH_BATCH_QUANTUM */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+  * @brief          Count a new SHA-1, SHA-256 or HMAC context, creating the
+  *                 HASH lock with the first one, and enable the HASH clock.
+  *                 To be called from the context init function.
+  */
+void mbedtls_hash_hw_reference(void);
+
+/**
+  * @brief          Forget a context being freed, and free the HASH lock with
+  *                 the last context. To be called from the context free
+  *                 function.
+  *
+  * @param p_ctx    The SHA-1, SHA-256 or HMAC context.
+  *
+  * @return         1 if p_ctx was the last context, 0 otherwise or without
+  *                 MBEDTLS_THREADING_C.
+  */
+int mbedtls_hash_hw_unreference(const void *p_ctx);
+
+/**
+  * @brief          Take the HASH peripheral for the calling thread.
+  *
+  * @return         0 on success, or MBEDTLS_ERR_THREADING_MUTEX_ERROR.
+  */
+int mbedtls_hash_hw_lock(void);
+
+/**
+  * @brief          Hand the HASH peripheral over to the next waiting thread.
+  *
+  * @param ret      The status of the operation done under the lock.
+  *
+  * @return         ret, or MBEDTLS_ERR_THREADING_MUTEX_ERROR if the unlock
+  *                 fails.
+  */
+int mbedtls_hash_hw_unlock(int ret);
+
+/**
+  * @brief          Make the peripheral hold the intermediate digest of a
+  *                 started context. The resident context is saved and the
+  *                 registers of p_ctx restored only if p_ctx is not already
+  *                 resident. To be called with the HASH lock held.
+  *
+  * @param p_ctx        The SHA-1, SHA-256 or HMAC context.
+  * @param p_hhash      The HAL handle of the context.
+  * @param p_save_regs  The register save area of the context.
+  */
+void mbedtls_hash_hw_acquire(void *p_ctx,
+                             HASH_HandleTypeDef *p_hhash,
+                             uint8_t *p_save_regs);
+
+/**
+  * @brief          Record a context as resident without restoring it, once
+  *                 its handle has programmed a new digest in the peripheral.
+  *                 To be called with the HASH lock held.
+  *
+  * @param p_ctx        The SHA-1, SHA-256 or HMAC context.
+  * @param p_hhash      The HAL handle of the context.
+  * @param p_save_regs  The register save area of the context.
+  */
+void mbedtls_hash_hw_claim(void *p_ctx,
+                           HASH_HandleTypeDef *p_hhash,
+                           uint8_t *p_save_regs);
+
+/**
+  * @brief          Save the resident context, if any, and forget it, before
+  *                 the peripheral is reprogrammed. To be called with the
+  *                 HASH lock held.
+  */
+void mbedtls_hash_hw_release(void);
+
+/**
+  * @brief          Forget a context without saving it, when its digest is
+  *                 complete or the context is freed. To be called with the
+  *                 HASH lock held.
+  *
+  * @param p_ctx    The SHA-1, SHA-256 or HMAC context.
+  */
+void mbedtls_hash_hw_forget(const void *p_ctx);
+
+/**
+  * @brief          Tell whether the peripheral holds the intermediate digest
+  *                 of a context, rather than its register save area. To be
+  *                 called with the HASH lock held.
+  *
+  * @param p_ctx    The SHA-1, SHA-256 or HMAC context.
+  *
+  * @return         1 if p_ctx is resident, 0 otherwise.
+  */
+int mbedtls_hash_hw_is_resident(const void *p_ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_HAL_SHA1_ALT || MBEDTLS_HAL_SHA256_ALT || MBEDTLS_HAL_HMAC_ALT */
+#endif /* MBEDTLS_HASH_ALT_H */
@@ -0,0 +1,242 @@
+/**
+  ******************************************************************************
+  * @file    hmac_alt.c
+  * @author  GPM Application Team
+  * @brief   Implementation of mbedtls_alt HMAC module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/**
+  * FIPS-198-1 compliant HMAC implementation
+  *
+  * This file implements HMAC-SHA-1, HMAC-SHA-224 and HMAC-SHA-256 based on the
+  * HMAC mode of STM32 HASH hardware crypto accelerator.
+  *
+  *  http://csrc.nist.gov/publications/fips/fips198-1/FIPS-198-1_final.pdf
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "common.h"
+
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+#include "hmac_alt.h"
+#include <string.h>
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define ST_HMAC_TIMEOUT ((uint32_t) 1000)  /* TO in ms for the hash processor */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+void mbedtls_hmac_init(mbedtls_hmac_context *ctx)
+{
+  mbedtls_hash_hw_reference();
+
+  mbedtls_platform_zeroize(ctx, sizeof(mbedtls_hmac_context));
+}
+
+void mbedtls_hmac_free(mbedtls_hmac_context *ctx)
+{
+  if (ctx == NULL)
+  {
+    return;
+  }
+
+  (void) mbedtls_hash_hw_unreference(ctx);
+
+  mbedtls_platform_zeroize(ctx, sizeof(mbedtls_hmac_context));
+}
+
+int mbedtls_hmac_starts(mbedtls_hmac_context *ctx,
+                        mbedtls_md_type_t md_type,
+                        const unsigned char *key,
+                        size_t keylen)
+{
+  int ret = 0;
+
+  ctx->md_type = md_type;
+
+  switch (md_type)
+  {
+    case MBEDTLS_MD_SHA1:
+      ctx->hhash.Init.Algorithm = HASH_ALGOSELECTION_SHA1;
+      break;
+    case MBEDTLS_MD_SHA224:
+      ctx->hhash.Init.Algorithm = HASH_ALGOSELECTION_SHA224;
+      break;
+    case MBEDTLS_MD_SHA256:
+      ctx->hhash.Init.Algorithm = HASH_ALGOSELECTION_SHA256;
+      break;
+    default:
+      return MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
+  }
+
+  if (keylen > ST_HMAC_BLOCK_SIZE)
+  {
+    return MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED;
+  }
+
+  /* The key is zero padded to the block size by HMAC: an empty key is given
+     to the peripheral as one zero word */
+  memset(ctx->key, 0, sizeof(ctx->key));
+  if (keylen != 0)
+  {
+    memcpy(ctx->key, key, keylen);
+  }
+
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
+  {
+    return (ret);
+  }
+
+  /* HASH Configuration, overwriting the resident context */
+  mbedtls_hash_hw_release();
+
+  /* a handle left ready by a previous digest only needs a new Init */
+  if ((ctx->hhash.State != HAL_HASH_STATE_READY) && (HAL_HASH_DeInit(&ctx->hhash) != HAL_OK))
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+  ctx->hhash.Instance = HASH;
+  ctx->hhash.Init.DataType = HASH_BYTE_SWAP;
+  ctx->hhash.Init.pKey = ctx->key;
+  ctx->hhash.Init.KeySize = (keylen != 0) ? keylen : 4U;
+  if (HAL_HASH_Init(&ctx->hhash) != HAL_OK)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    goto exit;
+  }
+
+  /* first block on 17 words */
+  ctx->first = ST_HMAC_EXTRA_BYTES;
+
+  ctx->sbuf_len = 0;
+
+  /* the inner key is hashed by the first accumulation */
+  mbedtls_hash_hw_claim(ctx, &ctx->hhash, ctx->ctx_save_regs);
+
+exit :
+  /* Free context access */
+  return mbedtls_hash_hw_unlock(ret);
+}
+
+int mbedtls_hmac_update(mbedtls_hmac_context *ctx,
+                        const unsigned char *input,
+                        size_t ilen)
+{
+  int ret = 0;
+  size_t currentlen = ilen;
+
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
+  {
+    return (ret);
+  }
+
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, ctx->ctx_save_regs);
+
+  if (currentlen < (ST_HMAC_BLOCK_SIZE + ctx->first - ctx->sbuf_len))
+  {
+    /* only store input data in context buffer */
+    memcpy(ctx->sbuf + ctx->sbuf_len, input, currentlen);
+    ctx->sbuf_len += currentlen;
+  }
+  else
+  {
+    /* fill context buffer until ST_HMAC_BLOCK_SIZE bytes, and process it */
+    memcpy(ctx->sbuf + ctx->sbuf_len,
+           input,
+           (ST_HMAC_BLOCK_SIZE + ctx->first - ctx->sbuf_len));
+    currentlen -= (ST_HMAC_BLOCK_SIZE + ctx->first - ctx->sbuf_len);
+
+    if (HAL_HASH_HMAC_Accumulate(&ctx->hhash,
+                                 (uint8_t *)(ctx->sbuf),
+                                 ST_HMAC_BLOCK_SIZE + ctx->first, ST_HMAC_TIMEOUT) != 0)
+    {
+      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      goto exit;
+    }
+
+    /* Process following input data
+                  with size multiple of ST_HMAC_BLOCK_SIZE bytes */
+    size_t iter = currentlen / ST_HMAC_BLOCK_SIZE;
+    if (iter != 0)
+    {
+      if (HAL_HASH_HMAC_Accumulate(&ctx->hhash,
+                                   (uint8_t *)(input + ST_HMAC_BLOCK_SIZE + ctx->first - ctx->sbuf_len),
+                                   (iter * ST_HMAC_BLOCK_SIZE), ST_HMAC_TIMEOUT) != 0)
+      {
+        ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        goto exit;
+      }
+    }
+
+    /* following blocks on 16 words */
+    ctx->first = 0;
+
+    /* Store only the remaining input data
+                    up to (ST_HMAC_BLOCK_SIZE - 1) bytes */
+    ctx->sbuf_len = currentlen % ST_HMAC_BLOCK_SIZE;
+    if (ctx->sbuf_len != 0)
+    {
+      memcpy(ctx->sbuf, input + ilen - ctx->sbuf_len, ctx->sbuf_len);
+    }
+  }
+
+exit :
+  /* Free context access */
+  return mbedtls_hash_hw_unlock(ret);
+}
+
+int mbedtls_hmac_finish(mbedtls_hmac_context *ctx, unsigned char *output)
+{
+  int ret = 0;
+
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
+  {
+    return (ret);
+  }
+
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, ctx->ctx_save_regs);
+
+  /* Last accumulation for pending bytes in sbuf_len, then the outer hash
+                                                 of the key and inner digest */
+  if (HAL_HASH_HMAC_AccumulateLast(&ctx->hhash,
+                                   ctx->sbuf,
+                                   ctx->sbuf_len,
+                                   output,
+                                   ST_HMAC_TIMEOUT) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  /* the digest is read out, nothing is left to save */
+  mbedtls_hash_hw_forget(ctx);
+
+  ctx->sbuf_len = 0;
+  mbedtls_platform_zeroize(ctx->key, sizeof(ctx->key));
+
+  /* Free context access */
+  return mbedtls_hash_hw_unlock(ret);
+}
+
+#endif /* MBEDTLS_HAL_HMAC_ALT */
@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file    hmac_alt.h
+  * @author  GPM Application Team
+  * @brief   Header for hmac_alt.c module
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/**
+  * @brief This file contains HMAC definitions and functions based on the HMAC
+  *        mode of STM32 HASH hardware crypto accelerator.
+  *
+  * The keyed-hash message authentication code (HMAC) is defined in
+  * <em>FIPS 198-1: The Keyed-Hash Message Authentication Code</em> and
+  * RFC 2104. The HASH peripheral computes the inner and outer hashes itself,
+  * the key padding is not done in software.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MBEDTLS_HMAC_ALT_H
+#define MBEDTLS_HMAC_ALT_H
+
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+/* Includes ------------------------------------------------------------------*/
+#include "mbedtls/md.h"
+#include "hash_alt.h"
+
+#define ST_HMAC_BLOCK_SIZE  ((size_t)  64)          /*!< HW handles 512 bits, ie 64 bytes */
+#define ST_HMAC_EXTRA_BYTES ((size_t)  4)           /*!< One supplementary word on first block */
+#define ST_HMAC_NB_HASH_REG ((uint32_t)106)         /*!< Number of HASH HW context Registers:
+                                                         CR + STR + IMR + CSR[103] */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+  * @brief          HMAC context structure
+  */
+typedef struct mbedtls_hmac_context
+{
+  mbedtls_md_type_t md_type;                      /*!< Hash of the HMAC, MBEDTLS_MD_NONE
+                                                       if the context is not started */
+  HASH_HandleTypeDef hhash;                       /*!< Handle of HASH HAL */
+  uint8_t key[ST_HMAC_BLOCK_SIZE];                /*!< Key, read by the HAL for the inner
+                                                       and the outer hash */
+  uint8_t sbuf[ST_HMAC_BLOCK_SIZE + ST_HMAC_EXTRA_BYTES];
+  /*!< Buffer to store input data
+      (first block with its extra bytes,
+       intermediate blocks,
+       or last input block) */
+  uint8_t sbuf_len;                               /*!< Number of bytes stored in sbuf */
+  uint8_t ctx_save_regs[ST_HMAC_NB_HASH_REG * 4];
+  uint8_t first;                                  /*!< Extra-bytes on first computed block */
+}
+mbedtls_hmac_context;
+
+/**
+  * @brief          Initialize an HMAC context.
+  *
+  * @param ctx      The HMAC context to initialize.
+  */
+void mbedtls_hmac_init(mbedtls_hmac_context *ctx);
+
+/**
+  * @brief          Clear an HMAC context.
+  *
+  * @param ctx      The HMAC context to clear. May be NULL.
+  */
+void mbedtls_hmac_free(mbedtls_hmac_context *ctx);
+
+/**
+  * @brief          Start an HMAC computation.
+  *
+  * @note           Keys longer than the 64-byte block must be replaced by
+  *                 their hash beforehand, as HMAC specifies.
+  *
+  * @param ctx      The HMAC context, initialized.
+  * @param md_type  MBEDTLS_MD_SHA1, MBEDTLS_MD_SHA224 or MBEDTLS_MD_SHA256.
+  * @param key      The key.
+  * @param keylen   The key length, at most 64 bytes. May be 0.
+  *
+  * @return         0 on success,
+  *                 MBEDTLS_ERR_PLATFORM_FEATURE_UNSUPPORTED for another hash
+  *                 or a longer key, or MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED.
+  */
+int mbedtls_hmac_starts(mbedtls_hmac_context *ctx,
+                        mbedtls_md_type_t md_type,
+                        const unsigned char *key,
+                        size_t keylen);
+
+/**
+  * @brief          Feed message data to an HMAC computation.
+  *
+  * @param ctx      The HMAC context, started.
+  * @param input    The data.
+  * @param ilen     The data length.
+  *
+  * @return         0 on success, or an MBEDTLS_ERR_xxx error code.
+  */
+int mbedtls_hmac_update(mbedtls_hmac_context *ctx,
+                        const unsigned char *input,
+                        size_t ilen);
+
+/**
+  * @brief          Finish an HMAC computation. The context must be started
+  *                 again before another computation.
+  *
+  * @param ctx      The HMAC context, started.
+  * @param output   The HMAC, of the length of the hash of md_type.
+  *
+  * @return         0 on success, or an MBEDTLS_ERR_xxx error code.
+  */
+int mbedtls_hmac_finish(mbedtls_hmac_context *ctx, unsigned char *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_HAL_HMAC_ALT */
+#endif /* MBEDTLS_HMAC_ALT_H */
@@ -0,0 +1,257 @@
+/**
+  ******************************************************************************
+  * @file    pka_alt.c
+  * @author  GPM Application Team
+  * @brief   Implementation of mbedtls_alt PKA session
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "common.h"
+
+#if defined(MBEDTLS_HAL_ECDSA_ALT) || defined(MBEDTLS_HAL_ECDH_ALT) || \
+    defined(MBEDTLS_HAL_ECP_ALT) || defined(MBEDTLS_HAL_RSA_ALT)
+#include "pka_alt.h"
+#include <string.h>
+#include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#if !defined(MBEDTLS_HAL_PKA_GET_TICK)
+#define MBEDTLS_HAL_PKA_GET_TICK() HAL_GetTick()
+#endif /* MBEDTLS_HAL_PKA_GET_TICK */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+#if defined(MBEDTLS_THREADING_C)
+/*
+ * Lock of the PKA, held by each operation from mbedtls_pka_hw_open() to
+ * mbedtls_pka_hw_close() and by the session start and end. It is
+ * initialized at its first use and never freed, as no context owns the PKA.
+ */
+static mbedtls_threading_mutex_t pka_mutex;
+static unsigned char pka_mutex_started = 0;
+#endif /* MBEDTLS_THREADING_C */
+
+/*
+ * PKA state shared by the ECDSA, ECDH, ECP and RSA alternative modules
+ */
+static struct
+{
+  PKA_HandleTypeDef hpka;         /* HAL handle of the PKA */
+  uint32_t depth;                 /* Nesting of open sessions, 0 if none */
+  uint8_t up;                     /* PKA initialized */
+  uint8_t used;                   /* An operation ran since the last RAM clear */
+  uint32_t op_start_tick;         /* Start of the current operation */
+  mbedtls_pka_session_stats stats;
+} st_pka;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static int pka_lock(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+  __disable_irq();
+  /* mutex cannot be initialized twice */
+  if (!pka_mutex_started)
+  {
+    mbedtls_mutex_init(&pka_mutex);
+    pka_mutex_started = 1;
+  }
+  __enable_irq();
+
+  if (mbedtls_mutex_lock(&pka_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return 0;
+}
+
+static int pka_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+  if (mbedtls_mutex_unlock(&pka_mutex) != 0)
+  {
+    return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+  }
+#endif /* MBEDTLS_THREADING_C */
+
+  return ret;
+}
+
+/*
+ * De-initialize the PKA and disable its clock, once its RAM is cleared if
+ * asked and an operation wrote operands
+ */
+static int pka_hw_down(uint8_t clear)
+{
+  int ret = 0;
+  uint32_t tick = MBEDTLS_HAL_PKA_GET_TICK();
+
+  if (st_pka.up == 0U)
+  {
+    return 0;
+  }
+
+  if ((clear != 0U) && (st_pka.used != 0U))
+  {
+    HAL_PKA_RAMReset(&st_pka.hpka);
+    st_pka.stats.ram_clear_count++;
+  }
+
+  /* De-initialize HW peripheral */
+  if (HAL_PKA_DeInit(&st_pka.hpka) != HAL_OK)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  /* Disable HW peripheral clock */
+  __HAL_RCC_PKA_CLK_DISABLE();
+
+  st_pka.up = 0U;
+  st_pka.used = 0U;
+  st_pka.stats.deinit_count++;
+  st_pka.stats.setup_ticks += MBEDTLS_HAL_PKA_GET_TICK() - tick;
+
+  return ret;
+}
+
+int mbedtls_pka_session_start(void)
+{
+  int ret = pka_lock();
+
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  st_pka.depth++;
+
+  return pka_unlock(0);
+}
+
+int mbedtls_pka_session_end(void)
+{
+  int ret = pka_lock();
+
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  if (st_pka.depth != 0U)
+  {
+    st_pka.depth--;
+    if (st_pka.depth == 0U)
+    {
+      ret = pka_hw_down(1U);
+    }
+  }
+
+  return pka_unlock(ret);
+}
+
+void mbedtls_pka_session_get_stats(mbedtls_pka_session_stats *stats)
+{
+  *stats = st_pka.stats;
+}
+
+void mbedtls_pka_session_reset_stats(void)
+{
+  (void) memset(&st_pka.stats, 0, sizeof(st_pka.stats));
+}
+
+int mbedtls_pka_hw_open(PKA_HandleTypeDef **pp_hpka)
+{
+  uint32_t tick;
+  int ret = pka_lock();
+
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  tick = MBEDTLS_HAL_PKA_GET_TICK();
+
+  if (st_pka.up == 0U)
+  {
+    /* Enable HW peripheral clock */
+    __HAL_RCC_PKA_CLK_ENABLE();
+
+    /* Initialize HW peripheral */
+    st_pka.hpka.Instance = PKA;
+    if (HAL_PKA_Init(&st_pka.hpka) != HAL_OK)
+    {
+      (void) HAL_PKA_DeInit(&st_pka.hpka);
+      __HAL_RCC_PKA_CLK_DISABLE();
+      return pka_unlock(MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
+    }
+
+    /* Reset PKA RAM */
+    HAL_PKA_RAMReset(&st_pka.hpka);
+
+    st_pka.up = 1U;
+    st_pka.stats.init_count++;
+    st_pka.stats.ram_clear_count++;
+  }
+
+  st_pka.op_start_tick = MBEDTLS_HAL_PKA_GET_TICK();
+  st_pka.stats.setup_ticks += st_pka.op_start_tick - tick;
+
+  /* The operands written from now on are cleared at the end of the session */
+  st_pka.used = 1U;
+
+  *pp_hpka = &st_pka.hpka;
+
+  return 0;
+}
+
+int mbedtls_pka_hw_close(int ret, uint8_t clear)
+{
+  uint32_t tick = MBEDTLS_HAL_PKA_GET_TICK();
+
+  st_pka.stats.op_count++;
+  st_pka.stats.compute_ticks += tick - st_pka.op_start_tick;
+
+  if (st_pka.depth != 0U)
+  {
+    /* Secret operands do not wait for the end of the session */
+    if (clear != 0U)
+    {
+      HAL_PKA_RAMReset(&st_pka.hpka);
+      st_pka.used = 0U;
+      st_pka.stats.ram_clear_count++;
+      st_pka.stats.setup_ticks += MBEDTLS_HAL_PKA_GET_TICK() - tick;
+    }
+
+    return pka_unlock(ret);
+  }
+
+  /* Out of a session, the PKA is released as each operation did, its RAM
+     is reset now if the operands are secret, else by the next
+     initialization */
+  if ((pka_hw_down(clear) != 0) && (ret == 0))
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  return pka_unlock(ret);
+}
+
+#endif /* MBEDTLS_HAL_ECDSA_ALT || MBEDTLS_HAL_ECDH_ALT || MBEDTLS_HAL_ECP_ALT || MBEDTLS_HAL_RSA_ALT */
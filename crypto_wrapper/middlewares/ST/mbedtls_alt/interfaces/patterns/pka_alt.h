@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file    pka_alt.h
+  * @author  GPM Application Team
+  * @brief   Header for pka_alt.c module
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/**
+  * @brief   This file contains the PKA session shared by the ECDSA, ECDH, ECP
+  *          and RSA alternative modules based on STM32 PKA hardware crypto
+  *          accelerator.
+  *
+  *          Out of a session, each operation initializes the PKA, resets its
+  *          RAM, runs and de-initializes the PKA. Within a session opened by
+  *          mbedtls_pka_session_start(), such as the verification of a
+  *          certificate chain, the PKA stays initialized between operations
+  *          and its RAM is cleared when mbedtls_pka_session_end() closes
+  *          the session: the HAL writes each operand followed by its
+  *          terminating zero words, so an operation never reads what the
+  *          previous one left. An operation on a private key or a nonce
+  *          clears the RAM as soon as it ends, in a session as well.
+  *
+  *          With MBEDTLS_THREADING_C, the operations and the session start
+  *          and end are serialized by a lock of the PKA.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MBEDTLS_PKA_ALT_H
+#define MBEDTLS_PKA_ALT_H
+
+#if defined(MBEDTLS_HAL_ECDSA_ALT) || defined(MBEDTLS_HAL_ECDH_ALT) || \
+    defined(MBEDTLS_HAL_ECP_ALT) || defined(MBEDTLS_HAL_RSA_ALT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+  * @brief          PKA session statistics
+  */
+typedef struct
+{
+  uint32_t init_count;          /*!< PKA initializations */
+  uint32_t deinit_count;        /*!< PKA de-initializations */
+  uint32_t ram_clear_count;     /*!< Full PKA RAM clears */
+  uint32_t op_count;            /*!< Operations run */
+  uint32_t setup_ticks;         /*!< Time spent to initialize, clear and
+                                     de-initialize the PKA, in
+                                     MBEDTLS_HAL_PKA_GET_TICK() units,
+                                     milliseconds by default */
+  uint32_t compute_ticks;       /*!< Time spent in operations, same unit */
+}
+mbedtls_pka_session_stats;
+
+/**
+  * @brief          Open a PKA session: the PKA is initialized by the next
+  *                 operation and stays so until the session ends. Sessions
+  *                 may be nested, the outermost one closes the PKA.
+  *
+  * @return         0 on success, or MBEDTLS_ERR_THREADING_MUTEX_ERROR.
+  */
+int mbedtls_pka_session_start(void);
+
+/**
+  * @brief          Close a PKA session: once the outermost session ends, the
+  *                 PKA RAM is cleared if an operation ran, then the PKA is
+  *                 de-initialized and its clock disabled.
+  *
+  * @return         0 on success, MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED or
+  *                 MBEDTLS_ERR_THREADING_MUTEX_ERROR.
+  */
+int mbedtls_pka_session_end(void);
+
+/**
+  * @brief          Read the PKA statistics, gathered in and out of sessions.
+  *                 Comparing the setup time of a verification chain run in
+  *                 a session with that of the same chain run operation by
+  *                 operation gives the saving of the session.
+  *
+  * @param stats    The statistics.
+  */
+void mbedtls_pka_session_get_stats(mbedtls_pka_session_stats *stats);
+
+/**
+  * @brief          Reset the PKA statistics.
+  */
+void mbedtls_pka_session_reset_stats(void);
+
+/**
+  * @brief          Get the PKA ready for an operation of an alternative
+  *                 module. Out of a session, or at the first operation of a
+  *                 session, the PKA clock is enabled, the PKA initialized
+  *                 and its RAM reset. On success, the PKA lock is held until
+  *                 mbedtls_pka_hw_close().
+  *
+  * @param pp_hpka  The HAL handle of the PKA.
+  *
+  * @return         0 on success, MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED or
+  *                 MBEDTLS_ERR_THREADING_MUTEX_ERROR.
+  */
+int mbedtls_pka_hw_open(PKA_HandleTypeDef **pp_hpka);
+
+/**
+  * @brief          End an operation opened by mbedtls_pka_hw_open() and
+  *                 release the PKA lock. Out of a session, the PKA is
+  *                 de-initialized and its clock disabled.
+  *
+  * @param ret      The status of the operation.
+  * @param clear    1 if the operation wrote a private key, a nonce or a
+  *                 blinded secret to the PKA RAM, which is then cleared
+  *                 at once, 0 if all its operands are public.
+  *
+  * @return         ret, MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED if the PKA
+  *                 cannot be de-initialized, or
+  *                 MBEDTLS_ERR_THREADING_MUTEX_ERROR.
+  */
+int mbedtls_pka_hw_close(int ret, uint8_t clear);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_HAL_ECDSA_ALT || MBEDTLS_HAL_ECDH_ALT || MBEDTLS_HAL_ECP_ALT || MBEDTLS_HAL_RSA_ALT */
+#endif /* MBEDTLS_PKA_ALT_H */
@@ -18,6 +18,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "psa_crypto_storage.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(psa_its_alt, LOG_LEVEL_DBG);
 #if defined(PSA_USE_ITS_ALT)
@@ -34,6 +36,12 @@ static mbedtls_svc_key_id_t its_key = {0};
 #endif /* PSA_USE_ENCRYPTED_ITS */
 
 /* Private function prototypes -----------------------------------------------*/
+static psa_status_t its_build_obj(psa_storage_uid_t uid,
+                                  uint32_t data_length,
+                                  const void *p_data,
+                                  psa_storage_create_flags_t create_flags,
+                                  its_obj_t *p_its_obj,
+                                  uint32_t *p_its_obj_length);
 #if defined(PSA_USE_ENCRYPTED_ITS)
 static psa_status_t its_crypto_setkey(void);
 static psa_status_t its_encrypt_obj(const void *p_data, uint32_t data_length, its_obj_t *p_its_obj);
@@ -220,6 +228,59 @@ static psa_status_t its_decrypt_obj(its_obj_t *p_its_obj, const uint32_t data_le
 }
 #endif /* PSA_USE_ENCRYPTED_ITS */
 
+/**
+  * @brief  A function that fill an ITS object with data, data is encrypted
+  *         if PSA_USE_ENCRYPTED_ITS is enabled.
+  * @param  uid : unique identifier used for identifying data.
+  * @param  data_length : size of the data in bytes.
+  * @param  p_data : a pointer to the data to be stored.
+  * @param  create_flags : data flag indicate data state Set = 1, Reset = 0.
+  * @param  p_its_obj : a pointer to the object to be filled.
+  * @param  p_its_obj_length : a pointer to the size of the object in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise.
+  */
+static psa_status_t its_build_obj(psa_storage_uid_t uid,
+                                  uint32_t data_length,
+                                  const void *p_data,
+                                  psa_storage_create_flags_t create_flags,
+                                  its_obj_t *p_its_obj,
+                                  uint32_t *p_its_obj_length)
+{
+  psa_status_t status = PSA_ERROR_STORAGE_FAILURE;
+
+  if (data_length > ITS_MAX_OBJECT_DATA_SIZE)
+  {
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+  }
+
+  *p_its_obj_length = sizeof(its_obj_info_t);
+
+  /* Fill object with data infomations */
+  memcpy(p_its_obj->obj_info.obj_id, &uid, sizeof(psa_storage_uid_t));
+  memcpy(p_its_obj->obj_info.size, &data_length, sizeof(data_length));
+  memcpy(p_its_obj->obj_info.flags, &create_flags, sizeof(create_flags));
+
+#if defined(PSA_USE_ENCRYPTED_ITS)
+  if (uid != ITS_ENCRYPTION_SECRET_KEY_ID) /* Don't encrypt the ITS encryption key */
+  {
+    /* Encrypt data and fill the object */
+    status = its_encrypt_obj(p_data, data_length, p_its_obj);
+    /* Increase object size by adding size of encrypted data  */
+    *p_its_obj_length = *p_its_obj_length + *p_its_obj->obj_info.size;
+  }
+  else
+#endif /* PSA_USE_ENCRYPTED_ITS */
+  {
+    /* Fill object with data */
+    memcpy(p_its_obj->obj_iv, p_data, data_length);
+    /* Increase object size by adding size of data  */
+    *p_its_obj_length = *p_its_obj_length + data_length;
+    status = PSA_SUCCESS;
+  }
+
+  return status;
+}
+
 /**
   * @brief  A function that store data in secure storage, data is encrypted
   *         if PSA_USE_ENCRYPTED_ITS is enabled.
@@ -246,31 +307,8 @@ psa_status_t psa_its_set(psa_storage_uid_t uid,
 
   if (data_length != 0)
   {
-    its_obj_length = sizeof(its_obj_info_t);
-
-    /* Fill object with data infomations */
-    memcpy(its_obj.obj_info.obj_id, &uid, sizeof(psa_storage_uid_t));
-    memcpy(its_obj.obj_info.size, &data_length, sizeof(data_length));
-    memcpy(its_obj.obj_info.flags, &create_flags, sizeof(create_flags));
-
-#if defined(PSA_USE_ENCRYPTED_ITS)
-    if (uid != ITS_ENCRYPTION_SECRET_KEY_ID) /* Don't encrypt the ITS encryption key */
-    {
-      /* Encrypt data and fill the object */
-      status = its_encrypt_obj(p_data, data_length, &its_obj);
-      /* Increase object size by adding size of encrypted data  */
-      its_obj_length = its_obj_length + *its_obj.obj_info.size;
-    }
-    else
-#endif /* PSA_USE_ENCRYPTED_ITS */
-    {
-      /* Fill object with data */
-      memcpy(its_obj.obj_iv, p_data, data_length);
-      /* Increase object size by adding size of data  */
-      its_obj_length = its_obj_length + data_length;
-      status = PSA_SUCCESS;
-    }
-
+    status = its_build_obj(uid, data_length, p_data, create_flags,
+                           &its_obj, &its_obj_length);
     if (status != PSA_SUCCESS)
     {
       return PSA_ERROR_STORAGE_FAILURE;
@@ -290,6 +328,87 @@ psa_status_t psa_its_set(psa_storage_uid_t uid,
   return status;
 }
 
+/**
+  * @brief  A function that store several new data in secure storage as one
+  *         storage batch, data is encrypted if PSA_USE_ENCRYPTED_ITS is
+  *         enabled.
+  * @note   Nothing is stored if one of the data can't be stored: the storage
+  *         interface checks the whole batch first and removes the objects
+  *         already written if a write fails.
+  * @note   The objects are built in heap buffers, only for this call.
+  * @param  p_entries : a pointer to the data to be stored.
+  * @param  entry_count : number of data, up to ITS_BATCH_MAX_OBJECTS.
+  * @retval PSA_SUCCESS if success, an error code otherwise.
+  */
+psa_status_t psa_its_set_batch(const its_batch_entry_t *p_entries,
+                               uint32_t entry_count)
+{
+  psa_status_t status = PSA_SUCCESS;
+  storage_obj_t objs[ITS_BATCH_MAX_OBJECTS] = {0};
+  its_obj_t its_obj = {0};
+  uint32_t its_obj_length = 0U;
+  uint8_t *p_obj;
+  uint32_t i;
+
+  if (entry_count > ITS_BATCH_MAX_OBJECTS)
+  {
+    return PSA_ERROR_INSUFFICIENT_MEMORY;
+  }
+
+  for (i = 0U; i < entry_count; i++)
+  {
+    if ((p_entries[i].uid == ITS_INVALID_UID) || (p_entries[i].data_length == 0U))
+    {
+      status = PSA_ERROR_INVALID_ARGUMENT;
+      break;
+    }
+
+    status = its_build_obj(p_entries[i].uid, p_entries[i].data_length,
+                           p_entries[i].p_data, p_entries[i].create_flags,
+                           &its_obj, &its_obj_length);
+    if (status != PSA_SUCCESS)
+    {
+      status = PSA_ERROR_STORAGE_FAILURE;
+      break;
+    }
+
+    p_obj = mbedtls_calloc(1U, its_obj_length);
+    if (p_obj == NULL)
+    {
+      status = PSA_ERROR_INSUFFICIENT_MEMORY;
+      break;
+    }
+
+    memcpy(p_obj, &its_obj, its_obj_length);
+    objs[i].obj_uid = p_entries[i].uid;
+    objs[i].obj_length = its_obj_length;
+    objs[i].p_obj = p_obj;
+
+    memset(&its_obj, 0, sizeof(its_obj));
+  }
+
+  if (status == PSA_SUCCESS)
+  {
+    status = storage_set_batch(objs, entry_count);
+    if ((status != PSA_SUCCESS) && (status != PSA_ERROR_ALREADY_EXISTS))
+    {
+      status = PSA_ERROR_STORAGE_FAILURE;
+    }
+  }
+
+  memset(&its_obj, 0, sizeof(its_obj));
+  for (i = 0U; i < entry_count; i++)
+  {
+    if (objs[i].p_obj != NULL)
+    {
+      mbedtls_platform_zeroize((void *)objs[i].p_obj, objs[i].obj_length);
+      mbedtls_free((void *)objs[i].p_obj);
+    }
+  }
+
+  return status;
+}
+
 /**
   * @brief  A function that retrieve data from secure storage, data is decrypted
   *         if PSA_USE_ENCRYPTED_ITS is enabled.
@@ -38,6 +38,7 @@ extern "C" {
 #endif /* MBEDTLS_HAL_GCM_ALT */
 #define ITS_TAG_SIZE              (16U)
 #define ITS_MAX_OBJECT_DATA_SIZE  (1024U)
+#define ITS_BATCH_MAX_OBJECTS     (16U)
 
 /* Exported types ------------------------------------------------------------*/
 typedef struct
@@ -55,11 +56,21 @@ typedef struct
   uint8_t obj[ITS_MAX_OBJECT_DATA_SIZE]; /*!< The object buffer */
 } its_obj_t;
 
+typedef struct
+{
+  psa_storage_uid_t uid;                     /*!< Unique identifier of the data */
+  uint32_t data_length;                      /*!< Size of the data in bytes */
+  const void *p_data;                        /*!< Pointer to the data to be stored */
+  psa_storage_create_flags_t create_flags;   /*!< Data flags */
+} its_batch_entry_t;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
+psa_status_t psa_its_set_batch(const its_batch_entry_t *p_entries,
+                               uint32_t entry_count);
 
 #endif /* PSA_USE_ITS_ALT */
 
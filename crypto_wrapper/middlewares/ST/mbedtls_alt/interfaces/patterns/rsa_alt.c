@@ -70,6 +70,7 @@
 #include "mbedtls/platform.h"
 
 #if defined(MBEDTLS_HAL_RSA_ALT)
+#include "pka_alt.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -106,7 +107,7 @@ static int rsa_pka_arithmetic_mul(const unsigned char *A,
                                   uint32_t *AxB)
 {
   int ret = 0;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_MulInTypeDef in = {0};
   uint32_t *input_A = NULL;
   uint32_t *input_B = NULL;
@@ -140,26 +141,19 @@ static int rsa_pka_arithmetic_mul(const unsigned char *A,
   in.pOp1 = input_A;
   in.pOp2 = input_B;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
+  MBEDTLS_MPI_CHK((HAL_PKA_Mul(hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
-  /* Reset PKA RAM */
-  HAL_PKA_RAMReset(&hpka);
-
-  MBEDTLS_MPI_CHK((HAL_PKA_Mul(&hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  HAL_PKA_Arithmetic_GetResult(&hpka, (uint32_t *)AxB);
+  HAL_PKA_Arithmetic_GetResult(hpka, (uint32_t *)AxB);
 
 cleanup:
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 1U /* secret operands */);
+  }
 
   if (input_A != NULL)
   {
@@ -296,7 +290,7 @@ static int rsa_pka_modexp(mbedtls_rsa_context *ctx,
   int ret = 0;
   size_t nlen = 0;
   size_t elen = 0;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_ModExpInTypeDef in = {0};
   uint8_t *e_binary = NULL;
   uint8_t *n_binary = NULL;
@@ -362,37 +356,30 @@ static int rsa_pka_modexp(mbedtls_rsa_context *ctx,
     in.pMod    = n_binary;       /* modulus */
   }
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  /* Reset PKA RAM */
-  HAL_PKA_RAMReset(&hpka);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
   if (is_protected)
   {
     /* output = input ^ e_binary mod n (protected mode) */
-    MBEDTLS_MPI_CHK((HAL_PKA_ModExpProtectMode(&hpka, &in_protected,
+    MBEDTLS_MPI_CHK((HAL_PKA_ModExpProtectMode(hpka, &in_protected,
                                                ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
   }
   else
   {
     /* output = input ^ e_binary mod n (normal mode) */
-    MBEDTLS_MPI_CHK((HAL_PKA_ModExp(&hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
+    MBEDTLS_MPI_CHK((HAL_PKA_ModExp(hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
   }
 
-  HAL_PKA_ModExp_GetResult(&hpka, (uint8_t *)output);
+  HAL_PKA_ModExp_GetResult(hpka, (uint8_t *)output);
 
 cleanup:
 
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, (uint8_t) is_private);
+  }
 
   if (e_binary != NULL)
   {
@@ -448,7 +435,7 @@ static int rsa_crt_pka_modexp(const mbedtls_mpi *dp,
   size_t plen = 0;
   size_t qlen = 0;
   size_t qplen = 0;
-  PKA_HandleTypeDef hpka = {0};
+  PKA_HandleTypeDef *hpka = NULL;
   PKA_RSACRTExpInTypeDef in = {0};
   uint8_t *dp_binary = NULL;
   uint8_t *dq_binary = NULL;
@@ -489,27 +476,20 @@ static int rsa_crt_pka_modexp(const mbedtls_mpi *dp,
   in.pPrimeQ = q_binary;
   in.popA    = input;
 
-  /* Enable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_ENABLE();
-
-  /* Initialize HW peripheral */
-  hpka.Instance = PKA;
-  MBEDTLS_MPI_CHK((HAL_PKA_Init(&hpka) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
-
-  /* Reset PKA RAM */
-  HAL_PKA_RAMReset(&hpka);
+  /* Get HW peripheral ready, it already is within a PKA session */
+  MBEDTLS_MPI_CHK(mbedtls_pka_hw_open(&hpka));
 
-  MBEDTLS_MPI_CHK((HAL_PKA_RSACRTExp(&hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
+  MBEDTLS_MPI_CHK((HAL_PKA_RSACRTExp(hpka, &in, ST_PKA_TIMEOUT) != HAL_OK) ? MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED : 0);
 
-  HAL_PKA_RSACRTExp_GetResult(&hpka, (uint8_t *)output);
+  HAL_PKA_RSACRTExp_GetResult(hpka, (uint8_t *)output);
 
 cleanup:
 
-  /* De-initialize HW peripheral */
-  HAL_PKA_DeInit(&hpka);
-
-  /* Disable HW peripheral clock */
-  __HAL_RCC_PKA_CLK_DISABLE();
+  /* Release HW peripheral, kept up within a PKA session */
+  if (hpka != NULL)
+  {
+    ret = mbedtls_pka_hw_close(ret, 1U /* secret operands */);
+  }
 
   if (dp_binary != NULL)
   {
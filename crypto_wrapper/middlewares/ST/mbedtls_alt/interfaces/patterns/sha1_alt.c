@@ -36,6 +36,9 @@
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
 
 #if defined(MBEDTLS_HAL_SHA1_ALT)
 
@@ -47,23 +50,70 @@
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
-void mbedtls_sha1_init(mbedtls_sha1_context *ctx)
+/*
+ * Hash input with the context resident in the peripheral. To be called with
+ * the HASH lock held.
+ */
+static int st_sha1_update(mbedtls_sha1_context *ctx,
+                          const unsigned char *input,
+                          size_t ilen)
 {
-#if defined(MBEDTLS_THREADING_C)
-  __disable_irq();
-  /* mutex cannot be initialized twice */
-  if (!hash_mutex_started)
+  size_t currentlen = ilen;
+
+  if (currentlen < (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len))
   {
-    mbedtls_mutex_init(&hash_mutex);
-    hash_mutex_started = 1;
+    /* only store input data in context buffer */
+    memcpy(ctx->sbuf + ctx->sbuf_len, input, currentlen);
+    ctx->sbuf_len += currentlen;
   }
-  hash_context_count++;
-  __enable_irq();
-#endif /* MBEDTLS_THREADING_C */
+  else
+  {
+    /* fill context buffer until ST_SHA1_BLOCK_SIZE bytes, and process it */
+    memcpy(ctx->sbuf + ctx->sbuf_len,
+           input,
+           (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len));
+    currentlen -= (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len);
+
+    if (HAL_HASH_Accumulate(&ctx->hhash,
+                            (uint8_t *)(ctx->sbuf),
+                            ST_SHA1_BLOCK_SIZE + ctx->first, ST_HASH_TIMEOUT) != 0)
+    {
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    /* Process following input data
+                  with size multiple of ST_SHA1_BLOCK_SIZE bytes */
+    size_t iter = currentlen / ST_SHA1_BLOCK_SIZE;
+    if (iter != 0)
+    {
+      if (HAL_HASH_Accumulate(&ctx->hhash,
+                              (uint8_t *)(input + ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len),
+                              (iter * ST_SHA1_BLOCK_SIZE), ST_HASH_TIMEOUT) != 0)
+      {
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      }
+    }
+
+    /* following blocks on 16 words */
+    ctx->first = 0;
+
+    /* Store only the remaining input data
+                    up to (ST_SHA1_BLOCK_SIZE - 1) bytes */
+    ctx->sbuf_len = currentlen % ST_SHA1_BLOCK_SIZE;
+    if (ctx->sbuf_len != 0)
+    {
+      memcpy(ctx->sbuf, input + ilen - ctx->sbuf_len, ctx->sbuf_len);
+    }
+  }
+
+  return 0;
+}
+
+void mbedtls_sha1_init(mbedtls_sha1_context *ctx)
+{
+  mbedtls_hash_hw_reference();
 
   mbedtls_platform_zeroize(ctx, sizeof(mbedtls_sha1_context));
-  /* Enable HASH clock */
-  __HAL_RCC_HASH_CLK_ENABLE();
 }
 
 void mbedtls_sha1_free(mbedtls_sha1_context *ctx)
@@ -73,26 +123,11 @@ void mbedtls_sha1_free(mbedtls_sha1_context *ctx)
     return;
   }
 
-#if defined(MBEDTLS_THREADING_C)
-  __disable_irq();
-  if (hash_context_count > 0)
-  {
-    hash_context_count--;
-  }
-
-  if (hash_mutex_started)
-  {
-    mbedtls_mutex_free(&hash_mutex);
-    hash_mutex_started = 0;
-  }
-  __enable_irq();
-
   /* Shut down HASH on last context */
-  if (hash_context_count == 0)
+  if (mbedtls_hash_hw_unreference(ctx) != 0)
   {
     HAL_HASH_DeInit(&ctx->hhash);
   }
-#endif /* MBEDTLS_THREADING_C */
 
   mbedtls_platform_zeroize(ctx, sizeof(mbedtls_sha1_context));
 }
@@ -100,22 +135,38 @@ void mbedtls_sha1_free(mbedtls_sha1_context *ctx)
 void mbedtls_sha1_clone(mbedtls_sha1_context *dst,
                         const mbedtls_sha1_context *src)
 {
+  (void) mbedtls_hash_hw_lock();
+
+  /* dst no longer owns the digest held by the peripheral */
+  mbedtls_hash_hw_forget(dst);
+
   *dst = *src;
+
+#ifdef ST_HW_CONTEXT_SAVING
+  /* the saved context of src is stale while src is resident */
+  if (mbedtls_hash_hw_is_resident(src))
+  {
+    HAL_HASH_Suspend(&dst->hhash, (uint8_t *)dst->ctx_save_regs);
+  }
+#endif /* ST_HW_CONTEXT_SAVING */
+
+  (void) mbedtls_hash_hw_unlock(0);
 }
 
 int mbedtls_sha1_starts(mbedtls_sha1_context *ctx)
 {
   int ret = 0;
 
-#if defined(MBEDTLS_THREADING_C)
-  if ((ret = mbedtls_mutex_lock(&hash_mutex)) != 0)
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
     return (ret);
   }
-#endif /* MBEDTLS_THREADING_C */
 
-  /* HASH Configuration */
-  if (HAL_HASH_DeInit(&ctx->hhash) != HAL_OK)
+  /* HASH Configuration, overwriting the resident context */
+  mbedtls_hash_hw_release();
+
+  /* a handle left ready by a previous digest only needs a new Init */
+  if ((ctx->hhash.State != HAL_HASH_STATE_READY) && (HAL_HASH_DeInit(&ctx->hhash) != HAL_OK))
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
     goto exit;
@@ -134,21 +185,12 @@ int mbedtls_sha1_starts(mbedtls_sha1_context *ctx)
 
   ctx->sbuf_len = 0;
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  /* hw context is saved only when another context takes the peripheral */
+  mbedtls_hash_hw_claim(ctx, &ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
 
 exit :
   /* Free context access */
-#if defined(MBEDTLS_THREADING_C)
-  if (mbedtls_mutex_unlock(&hash_mutex) != 0)
-  {
-    ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
-  }
-#endif /* MBEDTLS_THREADING_C */
-
-  return (ret);
+  return mbedtls_hash_hw_unlock(ret);
 }
 
 int mbedtls_internal_sha1_process(mbedtls_sha1_context *ctx,
@@ -156,41 +198,22 @@ int mbedtls_internal_sha1_process(mbedtls_sha1_context *ctx,
 {
   int ret = 0;
 
-#if defined(MBEDTLS_THREADING_C)
-  if ((ret = mbedtls_mutex_lock(&hash_mutex)) != 0)
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
     return (ret);
   }
-#endif /* MBEDTLS_THREADING_C */
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
 
   if (HAL_HASH_Accumulate(&ctx->hhash,
                           (uint8_t *) data,
                           ST_SHA1_BLOCK_SIZE, ST_HASH_TIMEOUT) != 0)
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-    goto exit;
   }
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
-
-exit :
   /* Free context access */
-#if defined(MBEDTLS_THREADING_C)
-  if (mbedtls_mutex_unlock(&hash_mutex) != 0)
-  {
-    ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
-  }
-#endif /* MBEDTLS_THREADING_C */
-
-  return (ret);
+  return mbedtls_hash_hw_unlock(ret);
 }
 
 int mbedtls_sha1_update(mbedtls_sha1_context *ctx,
@@ -198,81 +221,60 @@ int mbedtls_sha1_update(mbedtls_sha1_context *ctx,
                         size_t ilen)
 {
   int ret = 0;
-  size_t currentlen = ilen;
 
-#if defined(MBEDTLS_THREADING_C)
-  if ((ret = mbedtls_mutex_lock(&hash_mutex)) != 0)
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
     return (ret);
   }
-#endif /* MBEDTLS_THREADING_C */
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
 
-  if (currentlen < (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len))
-  {
-    /* only store input data in context buffer */
-    memcpy(ctx->sbuf + ctx->sbuf_len, input, currentlen);
-    ctx->sbuf_len += currentlen;
-  }
-  else
+  ret = st_sha1_update(ctx, input, ilen);
+
+  /* Free context access */
+  return mbedtls_hash_hw_unlock(ret);
+}
+
+int mbedtls_sha1_update_batch(const mbedtls_sha1_update_request *requests,
+                              size_t count)
+{
+  int ret = 0;
+  size_t offset;
+  size_t i;
+  size_t len;
+  int pending = 1;
+
+  /* each turn hashes the next quantum of every request still pending */
+  for (offset = 0; (pending != 0) && (ret == 0); offset += MBEDTLS_HAL_HASH_BATCH_QUANTUM)
   {
-    /* fill context buffer until ST_SHA1_BLOCK_SIZE bytes, and process it */
-    memcpy(ctx->sbuf + ctx->sbuf_len,
-           input,
-           (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len));
-    currentlen -= (ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len);
+    pending = 0;
 
-    if (HAL_HASH_Accumulate(&ctx->hhash,
-                            (uint8_t *)(ctx->sbuf),
-                            ST_SHA1_BLOCK_SIZE + ctx->first, ST_HASH_TIMEOUT) != 0)
+    if ((ret = mbedtls_hash_hw_lock()) != 0)
     {
-      ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-      goto exit;
+      return (ret);
     }
 
-    /* Process following input data
-                  with size multiple of ST_SHA1_BLOCK_SIZE bytes */
-    size_t iter = currentlen / ST_SHA1_BLOCK_SIZE;
-    if (iter != 0)
+    for (i = 0; (i < count) && (ret == 0); i++)
     {
-      if (HAL_HASH_Accumulate(&ctx->hhash,
-                              (uint8_t *)(input + ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len),
-                              (iter * ST_SHA1_BLOCK_SIZE), ST_HASH_TIMEOUT) != 0)
+      if (requests[i].ilen <= offset)
       {
-        ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-        goto exit;
+        continue;
       }
-    }
 
-    /* following blocks on 16 words */
-    ctx->first = 0;
+      len = requests[i].ilen - offset;
+      if (len > MBEDTLS_HAL_HASH_BATCH_QUANTUM)
+      {
+        len = MBEDTLS_HAL_HASH_BATCH_QUANTUM;
+        pending = 1;
+      }
 
-    /* Store only the remaining input data
-                    up to (ST_SHA1_BLOCK_SIZE - 1) bytes */
-    ctx->sbuf_len = currentlen % ST_SHA1_BLOCK_SIZE;
-    if (ctx->sbuf_len != 0)
-    {
-      memcpy(ctx->sbuf, input + ilen - ctx->sbuf_len, ctx->sbuf_len);
+      mbedtls_hash_hw_acquire(requests[i].ctx, &requests[i].ctx->hhash,
+                              (uint8_t *)requests[i].ctx->ctx_save_regs);
+      ret = st_sha1_update(requests[i].ctx, requests[i].input + offset, len);
     }
-  }
-
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
 
-exit :
-  /* Free context access */
-#if defined(MBEDTLS_THREADING_C)
-  if (mbedtls_mutex_unlock(&hash_mutex) != 0)
-  {
-    ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    ret = mbedtls_hash_hw_unlock(ret);
   }
-#endif /* MBEDTLS_THREADING_C */
 
   return (ret);
 }
@@ -282,17 +284,12 @@ int mbedtls_sha1_finish(mbedtls_sha1_context *ctx,
 {
   int ret = 0;
 
-#if defined(MBEDTLS_THREADING_C)
-  if ((ret = mbedtls_mutex_lock(&hash_mutex)) != 0)
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
     return (ret);
   }
-#endif /* MBEDTLS_THREADING_C */
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, (uint8_t *)ctx->ctx_save_regs);
 
   /* Last accumulation for pending bytes in sbuf_len,
                            then trig processing and get digest */
@@ -303,21 +300,15 @@ int mbedtls_sha1_finish(mbedtls_sha1_context *ctx,
                               ST_HASH_TIMEOUT) != 0)
   {
     ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-    goto exit;
   }
 
+  /* the digest is read out, nothing is left to save */
+  mbedtls_hash_hw_forget(ctx);
+
   ctx->sbuf_len = 0;
 
-exit :
   /* Free context access */
-#if defined(MBEDTLS_THREADING_C)
-  if (mbedtls_mutex_unlock(&hash_mutex) != 0)
-  {
-    ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
-  }
-#endif /* MBEDTLS_THREADING_C */
-
-  return (ret);
+  return mbedtls_hash_hw_unlock(ret);
 }
 
 #endif /* MBEDTLS_HAL_SHA1_ALT */
@@ -35,6 +35,7 @@
 #if defined (MBEDTLS_SHA1_ALT)
 /* Includes ------------------------------------------------------------------*/
 #if defined(MBEDTLS_HAL_SHA1_ALT)
+#include "hash_alt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +62,37 @@ typedef struct mbedtls_sha1_context
 }
 mbedtls_sha1_context;
 
+/**
+  * @brief          An update of a batch processed by
+  *                 mbedtls_sha1_update_batch().
+  */
+typedef struct mbedtls_sha1_update_request
+{
+  mbedtls_sha1_context *ctx;                                 /*!< Started context */
+  const unsigned char *input;                                /*!< Data to hash */
+  size_t ilen;                                               /*!< Length of the data */
+}
+mbedtls_sha1_update_request;
+
+/**
+  * @brief          Feed a batch of updates of different contexts, as
+  *                 mbedtls_sha1_update() would do for each of them. The
+  *                 requests are served in rotation, up to
+  *                 MBEDTLS_HAL_HASH_BATCH_QUANTUM bytes each per turn, so
+  *                 that a long update does not hold back the others. The
+  *                 HASH peripheral is locked once per turn.
+  *
+  * @note           A context must not appear twice in a batch. On error,
+  *                 the contexts of the batch must be started again.
+  *
+  * @param requests The updates to process.
+  * @param count    The number of updates.
+  *
+  * @return         0 on success, or an MBEDTLS_ERR_xxx error code.
+  */
+int mbedtls_sha1_update_batch(const mbedtls_sha1_update_request *requests,
+                              size_t count);
+
 #ifdef __cplusplus
 }
 #endif
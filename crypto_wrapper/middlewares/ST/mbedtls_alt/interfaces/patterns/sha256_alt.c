@@ -37,6 +37,9 @@
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif /* MBEDTLS_THREADING_C */
 
 #if defined(MBEDTLS_HAL_SHA256_ALT)
 /* Private typedef -----------------------------------------------------------*/
@@ -58,12 +61,63 @@ static void mbedtls_zeroize(void *value, size_t size)
   }
 }
 
+/*
+ * Hash input with the context resident in the peripheral. To be called with
+ * the HASH lock held.
+ */
+static int st_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
+{
+  size_t currentlen = ilen;
+
+  if (currentlen < (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len))
+  {
+    /* only store input data in context buffer */
+    memcpy(ctx->sbuf + ctx->sbuf_len, input, currentlen);
+    ctx->sbuf_len += currentlen;
+  }
+  else
+  {
+    /* fill context buffer until ST_SHA256_BLOCK_SIZE bytes, and process it */
+    memcpy(ctx->sbuf + ctx->sbuf_len, input, (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len));
+    currentlen -= (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len);
+
+    if (HAL_HASH_Accumulate(&ctx->hhash, (uint8_t *)(ctx->sbuf),
+                            ST_SHA256_BLOCK_SIZE + ctx->first, ST_SHA256_TIMEOUT) != 0)
+    {
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    /* Process following input data with size multiple of ST_SHA256_BLOCK_SIZE bytes */
+    size_t iter = currentlen / ST_SHA256_BLOCK_SIZE;
+    if (iter != 0)
+    {
+      if (HAL_HASH_Accumulate(&ctx->hhash,
+                              (uint8_t *)(input + ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len),
+                              (iter * ST_SHA256_BLOCK_SIZE), ST_SHA256_TIMEOUT) != 0)
+      {
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      }
+    }
+
+    /* following blocks on 16 words */
+    ctx->first = 0;
+
+    /* Store only the remaining input data up to (ST_SHA256_BLOCK_SIZE - 1) bytes */
+    ctx->sbuf_len = currentlen % ST_SHA256_BLOCK_SIZE;
+    if (ctx->sbuf_len != 0)
+    {
+      memcpy(ctx->sbuf, input + ilen - ctx->sbuf_len, ctx->sbuf_len);
+    }
+  }
+
+  return 0;
+}
+
 void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
 {
-  mbedtls_zeroize(ctx, sizeof(mbedtls_sha256_context));
+  mbedtls_hash_hw_reference();
 
-  /* Enable HASH clock */
-  __HAL_RCC_HASH_CLK_ENABLE();
+  mbedtls_zeroize(ctx, sizeof(mbedtls_sha256_context));
 }
 
 void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
@@ -73,21 +127,48 @@ void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
     return;
   }
 
+  (void) mbedtls_hash_hw_unreference(ctx);
+
   mbedtls_zeroize(ctx, sizeof(mbedtls_sha256_context));
 }
 
 void mbedtls_sha256_clone(mbedtls_sha256_context *dst,
                           const mbedtls_sha256_context *src)
 {
+  (void) mbedtls_hash_hw_lock();
+
+  /* dst no longer owns the digest held by the peripheral */
+  mbedtls_hash_hw_forget(dst);
+
   *dst = *src;
+
+#ifdef ST_HW_CONTEXT_SAVING
+  /* the saved context of src is stale while src is resident */
+  if (mbedtls_hash_hw_is_resident(src))
+  {
+    HAL_HASH_Suspend(&dst->hhash, dst->ctx_save_regs);
+  }
+#endif /* ST_HW_CONTEXT_SAVING */
+
+  (void) mbedtls_hash_hw_unlock(0);
 }
 
 int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
 {
-  /* HASH Configuration */
-  if (HAL_HASH_DeInit(&ctx->hhash) != HAL_OK)
+  int ret;
+
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
+  {
+    return ret;
+  }
+
+  /* HASH Configuration, overwriting the resident context */
+  mbedtls_hash_hw_release();
+
+  /* a handle left ready by a previous digest only needs a new Init */
+  if ((ctx->hhash.State != HAL_HASH_STATE_READY) && (HAL_HASH_DeInit(&ctx->hhash) != HAL_OK))
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    return mbedtls_hash_hw_unlock(MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
   }
 
   ctx->is224 = is224;
@@ -103,7 +184,7 @@ int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
   ctx->hhash.Init.DataType = HASH_BYTE_SWAP;
   if (HAL_HASH_Init(&ctx->hhash) != HAL_OK)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    return mbedtls_hash_hw_unlock(MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
   }
 
   /* first block on 17 words */
@@ -111,107 +192,113 @@ int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
 
   ctx->sbuf_len = 0;
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  /* hw context is saved only when another context takes the peripheral */
+  mbedtls_hash_hw_claim(ctx, &ctx->hhash, ctx->ctx_save_regs);
 
-  return 0;
+  return mbedtls_hash_hw_unlock(0);
 }
 
 int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[ST_SHA256_BLOCK_SIZE])
 {
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  int ret;
 
-  if (HAL_HASH_Accumulate(&ctx->hhash, (uint8_t *) data, ST_SHA256_BLOCK_SIZE, ST_SHA256_TIMEOUT) != 0)
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    return ret;
   }
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, ctx->ctx_save_regs);
 
-  return 0;
+  if (HAL_HASH_Accumulate(&ctx->hhash, (uint8_t *) data, ST_SHA256_BLOCK_SIZE, ST_SHA256_TIMEOUT) != 0)
+  {
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+
+  return mbedtls_hash_hw_unlock(ret);
 }
 
 int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
 {
-  size_t currentlen = ilen;
-
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  int ret;
 
-  if (currentlen < (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len))
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
   {
-    /* only store input data in context buffer */
-    memcpy(ctx->sbuf + ctx->sbuf_len, input, currentlen);
-    ctx->sbuf_len += currentlen;
+    return ret;
   }
-  else
+
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, ctx->ctx_save_regs);
+
+  ret = st_sha256_update(ctx, input, ilen);
+
+  return mbedtls_hash_hw_unlock(ret);
+}
+
+int mbedtls_sha256_update_batch(const mbedtls_sha256_update_request *requests,
+                                size_t count)
+{
+  int ret = 0;
+  size_t offset;
+  size_t i;
+  size_t len;
+  int pending = 1;
+
+  /* each turn hashes the next quantum of every request still pending */
+  for (offset = 0; (pending != 0) && (ret == 0); offset += MBEDTLS_HAL_HASH_BATCH_QUANTUM)
   {
-    /* fill context buffer until ST_SHA256_BLOCK_SIZE bytes, and process it */
-    memcpy(ctx->sbuf + ctx->sbuf_len, input, (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len));
-    currentlen -= (ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len);
+    pending = 0;
 
-    if (HAL_HASH_Accumulate(&ctx->hhash, (uint8_t *)(ctx->sbuf),
-                            ST_SHA256_BLOCK_SIZE + ctx->first, ST_SHA256_TIMEOUT) != 0)
+    if ((ret = mbedtls_hash_hw_lock()) != 0)
     {
-      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      return ret;
     }
 
-    /* Process following input data with size multiple of ST_SHA256_BLOCK_SIZE bytes */
-    size_t iter = currentlen / ST_SHA256_BLOCK_SIZE;
-    if (iter != 0)
+    for (i = 0; (i < count) && (ret == 0); i++)
     {
-      if (HAL_HASH_Accumulate(&ctx->hhash,
-                              (uint8_t *)(input + ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len),
-                              (iter * ST_SHA256_BLOCK_SIZE), ST_SHA256_TIMEOUT) != 0)
+      if (requests[i].ilen <= offset)
       {
-        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        continue;
       }
-    }
 
-    /* following blocks on 16 words */
-    ctx->first = 0;
+      len = requests[i].ilen - offset;
+      if (len > MBEDTLS_HAL_HASH_BATCH_QUANTUM)
+      {
+        len = MBEDTLS_HAL_HASH_BATCH_QUANTUM;
+        pending = 1;
+      }
 
-    /* Store only the remaining input data up to (ST_SHA256_BLOCK_SIZE - 1) bytes */
-    ctx->sbuf_len = currentlen % ST_SHA256_BLOCK_SIZE;
-    if (ctx->sbuf_len != 0)
-    {
-      memcpy(ctx->sbuf, input + ilen - ctx->sbuf_len, ctx->sbuf_len);
+      mbedtls_hash_hw_acquire(requests[i].ctx, &requests[i].ctx->hhash, requests[i].ctx->ctx_save_regs);
+      ret = st_sha256_update(requests[i].ctx, requests[i].input + offset, len);
     }
+
+    ret = mbedtls_hash_hw_unlock(ret);
   }
 
-#ifdef ST_HW_CONTEXT_SAVING
-  /* save hw context */
-  HAL_HASH_Suspend(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
-  return 0;
+  return ret;
 }
 
 int mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char *output)
 {
-#ifdef ST_HW_CONTEXT_SAVING
-  /* restore hw context */
-  HAL_HASH_Resume(&ctx->hhash, ctx->ctx_save_regs);
-#endif /* ST_HW_CONTEXT_SAVING */
+  int ret;
+
+  if ((ret = mbedtls_hash_hw_lock()) != 0)
+  {
+    return ret;
+  }
+
+  mbedtls_hash_hw_acquire(ctx, &ctx->hhash, ctx->ctx_save_regs);
 
   /* Last accumulation for pending bytes in sbuf_len, then trig processing and get digest */
   if (HAL_HASH_AccumulateLast(&ctx->hhash, (uint8_t *)(ctx->sbuf), ctx->sbuf_len, output, ST_SHA256_TIMEOUT) != 0)
   {
-    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
   }
 
+  /* the digest is read out, nothing is left to save */
+  mbedtls_hash_hw_forget(ctx);
+
   ctx->sbuf_len = 0;
 
-  return 0;
+  return mbedtls_hash_hw_unlock(ret);
 }
 
 #endif /* MBEDTLS_HAL_SHA256_ALT */
@@ -104,3 +104,24 @@ psa_status_t storage_remove(uint64_t obj_uid, uint32_t obj_size)
 
   return status;
 }
+
+/**
+  * @brief  A function that store several new objects in storage as one
+  *         batch.
+  * @note   Either all the objects are stored or none of them: objects already
+  *         written must be removed if a later one fails.
+  * @param  p_objs : a pointer to the objects to be stored.
+  * @param  obj_count : number of objects.
+  * @retval PSA_SUCCESS if success, an error code otherwise.
+  */
+psa_status_t storage_set_batch(const storage_obj_t *p_objs,
+                               uint32_t obj_count)
+{
+  psa_status_t status = PSA_ERROR_STORAGE_FAILURE;
+
+  /* User code start */
+
+  /* User code end */
+
+  return status;
+}
@@ -19,7 +19,6 @@
 /* Includes ------------------------------------------------------------------*/
 #include "kwe_core.h"
 #include <string.h>
-#include <stdlib.h>
 
 /** @defgroup KWE_MODULES KWE MODULES
   * @{
@@ -73,6 +72,16 @@ CRYP_HandleTypeDef hcryp;
           ((uint32_t) (b)[(i) + 3]       );          \
   } while(0)
 #endif /* !GET_UINT32_BE */
+
+#ifndef PUT_UINT32_BE
+#define PUT_UINT32_BE(n,b,i)                         \
+  do {                                               \
+    (b)[(i)    ] = (uint8_t) ( (n) >> 24 );          \
+    (b)[(i) + 1] = (uint8_t) ( (n) >> 16 );          \
+    (b)[(i) + 2] = (uint8_t) ( (n) >>  8 );          \
+    (b)[(i) + 3] = (uint8_t) ( (n)       );          \
+  } while(0)
+#endif /* !PUT_UINT32_BE */
 /**
   * @}
   */
@@ -86,6 +95,86 @@ CRYP_HandleTypeDef hcryp;
 #define KWE_BLOB_IV_OFFSET    0x00000000
 #define KWE_BLOB_TAG_OFFSET   0x00000004
 #define KWE_BLOB_KEY_OFFSET   0x00000008
+#define KWE_AEAD_PHASE_INIT     (0x00000000U)    /* AEAD phases in the GCMPH field of the SAES CR */
+#define KWE_AEAD_PHASE_HEADER   AES_CR_GCMPH_0
+#define KWE_AEAD_PHASE_PAYLOAD  AES_CR_GCMPH_1
+#define KWE_AEAD_PHASE_FINAL    AES_CR_GCMPH
+#define KWE_AEAD_MODE_DECRYPT   AES_CR_MODE_1
+#define KWE_AES_MAX_CHUNK_SIZE  (0xFFF0U) /* Largest block multiple a HAL_CRYP call takes */
+
+/**
+  * @}
+  */
+
+/** @defgroup CORE_Private_Variables CORE Private Variables
+  * @{
+  */
+
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+/**
+  * CCB session state
+  */
+static struct
+{
+  volatile uint32_t active;                 /*!< CCB initialized */
+  volatile uint32_t busy;                   /*!< An operation is running on the CCB */
+  uint32_t last_use_tick;                   /*!< End of the last operation */
+  uint32_t op_start_tick;                   /*!< Start of the running operation */
+  CCB_WrappingKeyTypeDef wrapping_key_conf; /*!< Wrapping key configuration */
+  KWE_SessionStatsTypeDef stats;            /*!< Session statistics */
+} kwe_ccb_session;
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
+
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+/**
+  * Wrapped AES key currently unwrapped in the SAES key registers
+  */
+static struct
+{
+  uint32_t valid;                               /*!< Key registers hold key_buffer */
+  size_t key_buffer_size;                       /*!< Size of the wrapped key blob */
+  uint8_t key_buffer[KWE_AES_KEY_BUFFER_MAX_SIZE];    /*!< Wrapped key blob (IV and key) */
+} kwe_aes_resident;
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
+
+/**
+  * Provisioning session state
+  */
+static struct
+{
+  uint32_t active;                          /*!< Provisioning session open */
+  uint32_t aes_key_size;                    /*!< SAES key size configured for wrapping, 0 if none */
+} kwe_provision;
+
+#if defined(KWE_AES_ASYNC_ENABLED)
+/**
+  * Asynchronous AES cipher operation state
+  */
+static struct
+{
+  KWE_AesCipherContextTypeDef *volatile p_ctx;  /*!< Operation in progress, NULL if none */
+  volatile uint32_t busy;                       /*!< SAES transfer in flight */
+  volatile uint32_t pending;                    /*!< Chunk done, to be processed by KWE_AesAsyncProcess() */
+  volatile KWE_StatusTypeDef status;            /*!< Status of the chunk done */
+  const uint8_t *p_input;                       /*!< Input of the running chunk */
+  uint8_t *p_output;                            /*!< Output of the running chunk */
+  size_t remaining;                             /*!< Bytes left, running chunk included */
+  size_t chunk;                                 /*!< Size of the running chunk */
+  uint32_t last_block[KWE_AES_BLOCK_SIZE / 4U]; /*!< Last ciphertext block of the chunk, CBC only */
+  KWE_AsyncCallbackTypeDef callback;            /*!< Completion callback */
+  void *p_context;                              /*!< Completion callback argument */
+} kwe_aes_async;
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+/**
+  * Default workspace, used until the application provides its own one
+  */
+static KWE_WorkspaceTypeDef kwe_workspace;
+
+/**
+  * Workspace used by KWE operations instead of heap buffers
+  */
+static KWE_WorkspaceTypeDef *p_kwe_workspace = &kwe_workspace;
 
 /**
   * @}
@@ -93,6 +182,187 @@ CRYP_HandleTypeDef hcryp;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Functions Definition ------------------------------------------------------*/
+/** @defgroup CORE_Private_Functions CORE Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Check that no asynchronous SAES transfer is in flight before an
+  *         operation reconfigures SAES or the CCB.
+  * @param  None
+  * @retval KWE_SUCCESS if SAES is free, KWE_ERROR_BUSY otherwise.
+  */
+static KWE_StatusTypeDef kwe_aes_check_idle(void)
+{
+#if defined(KWE_AES_ASYNC_ENABLED)
+  if (kwe_aes_async.busy != 0U)
+  {
+    return KWE_ERROR_BUSY;
+  }
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+  return KWE_SUCCESS;
+}
+
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+/**
+  * @brief  Close the CCB session and release the peripheral.
+  * @param  None
+  * @retval KWE_SUCCESS if success, an error code otherwise.
+  */
+static KWE_StatusTypeDef kwe_ccb_session_stop(void)
+{
+  if (kwe_ccb_session.active == 0U)
+  {
+    return KWE_SUCCESS;
+  }
+
+  kwe_ccb_session.active = 0U;
+  kwe_ccb_session.stats.deinit_count++;
+
+  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  {
+    return KWE_ERROR;
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Make the CCB ready for an operation, initializing it and loading
+  *         the wrapping key configuration only when no session is open.
+  * @note   The session is marked busy before it is checked: a
+  *         KWE_CcbSessionPoll() run in between either closes it before the
+  *         check, so that it is opened again here, or leaves it open.
+  * @param  None
+  * @retval KWE_SUCCESS if success, an error code otherwise.
+  */
+static KWE_StatusTypeDef kwe_ccb_acquire(void)
+{
+  uint32_t tick = KWE_GET_TICK();
+
+  if (kwe_aes_check_idle() != KWE_SUCCESS)
+  {
+    return KWE_ERROR_BUSY;
+  }
+
+  kwe_ccb_session.busy = 1U;
+
+  /* CCB operations go through SAES and overwrite its key registers */
+  KWE_AesKeyInvalidate();
+
+  if (kwe_ccb_session.active == 0U)
+  {
+    /* Initialize KWE engine and set default configuration */
+    hccb.Instance = CCB;
+    if (HAL_CCB_Init(&hccb) != HAL_OK)
+    {
+      kwe_ccb_session.busy = 0U;
+      return KWE_ERROR;
+    }
+
+    /* Configure Wrapping Key */
+    kwe_ccb_session.wrapping_key_conf.WrappingKeyType = HAL_CCB_USER_KEY_HW;
+
+    kwe_ccb_session.active = 1U;
+    kwe_ccb_session.stats.init_count++;
+    kwe_ccb_session.stats.setup_ticks += KWE_GET_TICK() - tick;
+  }
+
+  kwe_ccb_session.op_start_tick = KWE_GET_TICK();
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Account for the operation run on the CCB and close the session
+  *         if it is not persistent or if the operation failed.
+  * @param  op_status : status of the CCB operation.
+  * @retval KWE_SUCCESS if success, an error code otherwise.
+  */
+static KWE_StatusTypeDef kwe_ccb_release(KWE_StatusTypeDef op_status)
+{
+  kwe_ccb_session.last_use_tick = KWE_GET_TICK();
+  kwe_ccb_session.busy = 0U;
+  kwe_ccb_session.stats.op_count++;
+  kwe_ccb_session.stats.compute_ticks += kwe_ccb_session.last_use_tick - kwe_ccb_session.op_start_tick;
+
+  if (op_status == KWE_SUCCESS)
+  {
+#if defined(KWE_CCB_PERSISTENT_SESSION_ENABLED)
+    /* The session is closed once idle for KWE_CCB_SESSION_IDLE_TIMEOUT */
+    KWE_CcbSessionIdleCallback();
+    return KWE_SUCCESS;
+#else
+    /* A provisioning session keeps the CCB until KWE_ProvisionEnd() */
+    if (kwe_provision.active != 0U)
+    {
+      return KWE_SUCCESS;
+    }
+#endif /* KWE_CCB_PERSISTENT_SESSION_ENABLED */
+  }
+
+  /* Leave the CCB in reset state after an error */
+  if (kwe_ccb_session_stop() != KWE_SUCCESS)
+  {
+    return KWE_ERROR;
+  }
+
+  return op_status;
+}
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
+
+/**
+  * @brief  Take SAES over for a symmetric key operation that loads a new key.
+  * @note   The resident AES key is dropped and an open CCB session is closed
+  *         as the CCB relies on the SAES configuration.
+  * @param  None
+  * @retval None
+  */
+static void kwe_aes_acquire(void)
+{
+  KWE_AesKeyInvalidate();
+
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+  (void) kwe_ccb_session_stop();
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
+}
+
+/**
+  * @brief  End of an AES operation: record the wrapped key left in the SAES
+  *         key registers, or de-initialize SAES when residency is disabled.
+  * @param  p_key_buffer : a pointer to the wrapped key and IV in use.
+  * @param  key_buffer_size : size of the wrapped key and IV in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise.
+  */
+static KWE_StatusTypeDef kwe_aes_release(const uint8_t *p_key_buffer, size_t key_buffer_size)
+{
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+  if (key_buffer_size <= sizeof(kwe_aes_resident.key_buffer))
+  {
+    (void) memcpy(kwe_aes_resident.key_buffer, p_key_buffer, key_buffer_size);
+    kwe_aes_resident.key_buffer_size = key_buffer_size;
+    kwe_aes_resident.valid = 1U;
+
+    return KWE_SUCCESS;
+  }
+#else
+  UNUSED(p_key_buffer);
+  UNUSED(key_buffer_size);
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
+
+  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  {
+    return KWE_ERROR;
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @}
+  */
+
 /** @defgroup CORE_Exported_Functions CORE Exported Functions
   * @{
   */
@@ -107,6 +377,10 @@ CRYP_HandleTypeDef hcryp;
 [..]
     (+) Init
     (+) Get Version
+    (+) Set Workspace
+    (+) Get Workspace
+    (+) CCB Session management
+    (+) Provisioning session
 
 @endverbatim
   * @{
@@ -136,6 +410,8 @@ KWE_StatusTypeDef KWE_Init(void)
   {
     return status;
   }
+
+  (void) memset(&kwe_ccb_session, 0, sizeof(kwe_ccb_session));
 #endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
 
   status = KWE_SUCCESS;
@@ -143,6 +419,161 @@ KWE_StatusTypeDef KWE_Init(void)
   return status;
 }
 
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+/**
+  * @brief   Open a CCB session.
+  * @note    The CCB is initialized and the wrapping key configuration loaded
+  *          once, following asymmetric operations reuse them until the
+  *          session is closed.
+  * @param   None
+  * @retval  KWE_SUCCESS if success, an error code otherwise.
+  */
+KWE_StatusTypeDef KWE_CcbSessionOpen(void)
+{
+  KWE_StatusTypeDef status = kwe_ccb_acquire();
+
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  kwe_ccb_session.last_use_tick = KWE_GET_TICK();
+  kwe_ccb_session.busy = 0U;
+
+#if defined(KWE_CCB_PERSISTENT_SESSION_ENABLED)
+  KWE_CcbSessionIdleCallback();
+#endif /* KWE_CCB_PERSISTENT_SESSION_ENABLED */
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief   Close the CCB session and de-initialize the CCB.
+  * @param   None
+  * @retval  KWE_SUCCESS if success, an error code otherwise.
+  */
+KWE_StatusTypeDef KWE_CcbSessionClose(void)
+{
+  return kwe_ccb_session_stop();
+}
+
+/**
+  * @brief   Close the CCB session once it stays idle for
+  *          KWE_CCB_SESSION_IDLE_TIMEOUT.
+  * @note    This API is intended to be called by the application
+  *          KWE_CCB_SESSION_IDLE_TIMEOUT after KWE_CcbSessionIdleCallback(),
+  *          e.g. from a delayed work item. It must not be preempted by a
+  *          KWE operation, e.g. run from a cooperative thread: an operation
+  *          it preempts has marked the session busy and it is left open,
+  *          as is a session used again meanwhile.
+  * @param   None
+  * @retval  None
+  */
+void KWE_CcbSessionPoll(void)
+{
+#if defined(KWE_CCB_PERSISTENT_SESSION_ENABLED)
+  if ((kwe_ccb_session.active != 0U) && (kwe_ccb_session.busy == 0U)
+      && ((KWE_GET_TICK() - kwe_ccb_session.last_use_tick) >= KWE_CCB_SESSION_IDLE_TIMEOUT))
+  {
+    (void) kwe_ccb_session_stop();
+  }
+#endif /* KWE_CCB_PERSISTENT_SESSION_ENABLED */
+}
+
+/**
+  * @brief   Get the CCB session statistics: init/deinit transitions, number
+  *          of operations, time spent in setup versus compute.
+  * @param   p_stats : a pointer to the statistics to be filled.
+  * @retval  None
+  */
+void KWE_CcbSessionGetStats(KWE_SessionStatsTypeDef *p_stats)
+{
+  *p_stats = kwe_ccb_session.stats;
+}
+
+/**
+  * @brief   Reset the CCB session statistics.
+  * @param   None
+  * @retval  None
+  */
+void KWE_CcbSessionResetStats(void)
+{
+  (void) memset(&kwe_ccb_session.stats, 0, sizeof(kwe_ccb_session.stats));
+}
+
+/**
+  * @brief   The CCB session stays open after an operation, its idle timeout
+  *          starts.
+  * @note    This function should not be modified, when the callback is
+  *          needed, KWE_CcbSessionIdleCallback could be implemented in the
+  *          user file, e.g. to reschedule a work item calling
+  *          KWE_CcbSessionPoll() after KWE_CCB_SESSION_IDLE_TIMEOUT_MS.
+  * @param   None
+  * @retval  None
+  */
+__weak void KWE_CcbSessionIdleCallback(void)
+{
+}
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
+
+/**
+  * @brief   Open a provisioning session.
+  * @note    Until KWE_ProvisionEnd() is called, KWE_WrapAESKey() keeps SAES
+  *          configured for key wrapping and the CCB stays initialized between
+  *          asymmetric key wraps, so that a list of keys is wrapped without
+  *          a peripheral init and de-init per key. Wrapping keys grouped by
+  *          type avoids switching between SAES and CCB.
+  * @param   None
+  * @retval  KWE_SUCCESS if success, an error code otherwise.
+  */
+KWE_StatusTypeDef KWE_ProvisionBegin(void)
+{
+  if (kwe_provision.active != 0U)
+  {
+    return KWE_ERROR;
+  }
+
+  kwe_provision.active = 1U;
+  kwe_provision.aes_key_size = 0U;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief   Close the provisioning session and release SAES and the CCB.
+  * @param   None
+  * @retval  KWE_SUCCESS if success, an error code otherwise.
+  */
+KWE_StatusTypeDef KWE_ProvisionEnd(void)
+{
+  KWE_StatusTypeDef status = KWE_SUCCESS;
+
+  if (kwe_provision.active == 0U)
+  {
+    return KWE_ERROR;
+  }
+
+  kwe_provision.active = 0U;
+
+  if (kwe_provision.aes_key_size != 0U)
+  {
+    kwe_provision.aes_key_size = 0U;
+    if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+    {
+      status = KWE_ERROR;
+    }
+  }
+
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && !defined(KWE_CCB_PERSISTENT_SESSION_ENABLED)
+  if (kwe_ccb_session_stop() != KWE_SUCCESS)
+  {
+    status = KWE_ERROR;
+  }
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && !KWE_CCB_PERSISTENT_SESSION_ENABLED */
+
+  return status;
+}
+
 /**
   * @brief  KWE_GetVersion
   *         Returns the KWE Middleware revision
@@ -159,6 +590,94 @@ int32_t KWE_GetVersion(void)
 {
   return (int32_t)KWE_VERSION;
 }
+
+/**
+  * @brief   Provide the workspace used by KWE operations.
+  * @note    KWE operations build their temporary buffers (ECDSA digest,
+  *          ECDH shared point, RSA encoded message) in this workspace so
+  *          that no heap allocation is done. The workspace is
+  *          shared by all operations, each one holds it from
+  *          KWE_WorkspaceAcquire() to KWE_WorkspaceRelease().
+  *          The application may place it in a dedicated RAM section.
+  * @param   p_workspace : a pointer to the workspace, NULL to restore the
+  *          default internal workspace.
+  * @retval  None
+  */
+void KWE_SetWorkspace(KWE_WorkspaceTypeDef *p_workspace)
+{
+  KWE_WorkspaceLockCallback();
+
+  if (p_workspace == NULL)
+  {
+    p_kwe_workspace = &kwe_workspace;
+  }
+  else
+  {
+    p_kwe_workspace = p_workspace;
+  }
+
+  KWE_WorkspaceUnlockCallback();
+}
+
+/**
+  * @brief   Get the workspace used by KWE operations.
+  * @note    Its content is only to be accessed between
+  *          KWE_WorkspaceAcquire() and KWE_WorkspaceRelease().
+  * @param   None
+  * @retval  Pointer to the workspace.
+  */
+KWE_WorkspaceTypeDef *KWE_GetWorkspace(void)
+{
+  return p_kwe_workspace;
+}
+
+/**
+  * @brief   Take the workspace for an operation, waiting until no other
+  *          operation holds it.
+  * @param   None
+  * @retval  Pointer to the workspace.
+  */
+KWE_WorkspaceTypeDef *KWE_WorkspaceAcquire(void)
+{
+  KWE_WorkspaceLockCallback();
+
+  return p_kwe_workspace;
+}
+
+/**
+  * @brief   Give the workspace taken by KWE_WorkspaceAcquire() back.
+  * @param   None
+  * @retval  None
+  */
+void KWE_WorkspaceRelease(void)
+{
+  KWE_WorkspaceUnlockCallback();
+}
+
+/**
+  * @brief   Lock the workspace against the other threads.
+  * @note    This function should not be modified, when the callback is
+  *          needed, KWE_WorkspaceLockCallback could be implemented in the
+  *          user file, e.g. to lock an RTOS mutex. Without it, the KWE
+  *          operations must not be run concurrently.
+  * @param   None
+  * @retval  None
+  */
+__weak void KWE_WorkspaceLockCallback(void)
+{
+}
+
+/**
+  * @brief   Unlock the workspace locked by KWE_WorkspaceLockCallback().
+  * @note    This function should not be modified, when the callback is
+  *          needed, KWE_WorkspaceUnlockCallback could be implemented in the
+  *          user file.
+  * @param   None
+  * @retval  None
+  */
+__weak void KWE_WorkspaceUnlockCallback(void)
+{
+}
 /**
   * @}
   */
@@ -203,22 +722,11 @@ KWE_StatusTypeDef KWE_GenerateWrappedEccKey(
   size_t *p_key_buffer_length)
 {
   KWE_StatusTypeDef status = KWE_ERROR;
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_ECDSACurveParamTypeDef ecdsa_param;
   CCB_ECDSAKeyBlobTypeDef ecdsa_blob;
   CCB_ECCMulCurveParamTypeDef ecdh_param;
   CCB_ECCMulKeyBlobTypeDef ecdh_blob;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType        = HAL_CCB_USER_KEY_HW;
-
   ecdsa_param.primeOrderSizeByte           = p_ecp->order_size;
   ecdsa_param.modulusSizeByte              = p_ecp->modulus_size;
   ecdsa_param.pModulus                     = p_ecp->p_prime;
@@ -233,31 +741,41 @@ KWE_StatusTypeDef KWE_GenerateWrappedEccKey(
   ecdsa_blob.pTag        = (uint32_t *)p_key_buffer + KWE_BLOB_TAG_OFFSET;
   ecdsa_blob.pWrappedKey = (uint32_t *)p_key_buffer + KWE_BLOB_KEY_OFFSET;
 
+  if ((ecc_alg != KWE_ALG_ECC_ECDSA) && (ecc_alg != KWE_ALG_ECC_ECDH))
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
   if (ecc_alg == KWE_ALG_ECC_ECDSA)
   {
-    if (HAL_CCB_ECDSA_GenerateWrapPrivateKey(&hccb, &ecdsa_param, &wrapping_key_conf, &ecdsa_blob) != HAL_OK)
+    if (HAL_CCB_ECDSA_GenerateWrapPrivateKey(&hccb, &ecdsa_param, &kwe_ccb_session.wrapping_key_conf, &ecdsa_blob) != HAL_OK)
     {
+      (void) kwe_ccb_release(KWE_ERROR);
       return status;
     }
   }
-  else if (ecc_alg == KWE_ALG_ECC_ECDH)
+  else
   {
     ecdh_param               = ecdsa_param;
     ecdh_blob                = ecdsa_blob;
 
-    if (HAL_CCB_ECC_GenerateWrapPrivateKey(&hccb, &ecdh_param, &wrapping_key_conf, &ecdh_blob) != HAL_OK)
+    if (HAL_CCB_ECC_GenerateWrapPrivateKey(&hccb, &ecdh_param, &kwe_ccb_session.wrapping_key_conf, &ecdh_blob) != HAL_OK)
     {
+      (void) kwe_ccb_release(KWE_ERROR);
       return status;
     }
   }
-  else
-  {
-    return KWE_ERROR_NOT_SUPPORTED;
-  }
 
   *p_key_buffer_length = key_buffer_size;
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -292,7 +810,6 @@ KWE_StatusTypeDef KWE_WrapEccKey(
   size_t *p_key_buffer_length)
 {
   KWE_StatusTypeDef status = KWE_ERROR;
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_ECDSACurveParamTypeDef ecdsa_param;
   CCB_ECDSAKeyBlobTypeDef ecdsa_blob;
   CCB_ECCMulCurveParamTypeDef ecdh_param;
@@ -300,16 +817,6 @@ KWE_StatusTypeDef KWE_WrapEccKey(
 
   uint8_t *p_key_data = (uint8_t *)p_data;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key : DHUK */
-  wrapping_key_conf.WrappingKeyType        = HAL_CCB_USER_KEY_HW;
-
   /* Fill ECDSA In parameters */
   ecdsa_param.primeOrderSizeByte           = p_ecp->order_size;
   ecdsa_param.modulusSizeByte              = p_ecp->modulus_size;
@@ -325,30 +832,40 @@ KWE_StatusTypeDef KWE_WrapEccKey(
   ecdsa_blob.pTag        = (uint32_t *)p_key_buffer + KWE_BLOB_TAG_OFFSET;
   ecdsa_blob.pWrappedKey = (uint32_t *)p_key_buffer + KWE_BLOB_KEY_OFFSET;
 
+  if ((ecc_alg != KWE_ALG_ECC_ECDSA) && (ecc_alg != KWE_ALG_ECC_ECDH))
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
   if (ecc_alg == KWE_ALG_ECC_ECDSA)
   {
-    if (HAL_CCB_ECDSA_WrapPrivateKey(&hccb, &ecdsa_param, p_key_data, &wrapping_key_conf, &ecdsa_blob) != HAL_OK)
+    if (HAL_CCB_ECDSA_WrapPrivateKey(&hccb, &ecdsa_param, p_key_data, &kwe_ccb_session.wrapping_key_conf, &ecdsa_blob) != HAL_OK)
     {
+      (void) kwe_ccb_release(KWE_ERROR);
       return status;
     }
   }
-  else if (ecc_alg == KWE_ALG_ECC_ECDH)
+  else
   {
     ecdh_param               = ecdsa_param;
     ecdh_blob                = ecdsa_blob;
-    if (HAL_CCB_ECC_WrapPrivateKey(&hccb, &ecdh_param, p_key_data, &wrapping_key_conf, &ecdh_blob) != HAL_OK)
+    if (HAL_CCB_ECC_WrapPrivateKey(&hccb, &ecdh_param, p_key_data, &kwe_ccb_session.wrapping_key_conf, &ecdh_blob) != HAL_OK)
     {
+      (void) kwe_ccb_release(KWE_ERROR);
       return status;
     }
   }
-  else
-  {
-    return KWE_ERROR_NOT_SUPPORTED;
-  }
 
   *p_key_buffer_length = key_buffer_size;
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -376,21 +893,10 @@ KWE_StatusTypeDef KWE_WrapRsaKey(
   KWE_StatusTypeDef status = KWE_ERROR;
   uint32_t *p_modulus = NULL;
 
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_RSAParamTypeDef rsa_mod_exp_param;
   CCB_RSAKeyBlobTypeDef rsa_mod_exp_blob;
   CCB_RSAClearKeyTypeDef rsa_key;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType         = HAL_CCB_USER_KEY_HW;
-
   /* Fill RSA Modular exponentiation In parameters */
   rsa_mod_exp_param.expSizeByte             = p_rsa->exponent_size;
   rsa_mod_exp_param.modulusSizeByte         = p_rsa->modulus_size;
@@ -406,10 +912,18 @@ KWE_StatusTypeDef KWE_WrapRsaKey(
   rsa_mod_exp_blob.pWrappedPhi = (uint32_t *)p_key_buffer + KWE_BLOB_KEY_OFFSET
                                  + (rsa_mod_exp_param.expSizeByte / 4U);
 
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
   if (HAL_CCB_RSA_WrapPrivateKey(&hccb, &rsa_mod_exp_param, &rsa_key,
-                                 &wrapping_key_conf,  &rsa_mod_exp_blob)
+                                 &kwe_ccb_session.wrapping_key_conf,  &rsa_mod_exp_blob)
       != HAL_OK)
   {
+    (void) kwe_ccb_release(KWE_ERROR);
     return status;
   }
 
@@ -420,7 +934,7 @@ KWE_StatusTypeDef KWE_WrapRsaKey(
   *p_key_buffer_length = (rsa_mod_exp_param.modulusSizeByte + rsa_mod_exp_param.expSizeByte
                           + p_rsa->phi_size + 4 * sizeof(rsa_mod_exp_blob.pIV) + 4 * sizeof(rsa_mod_exp_blob.pTag));
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -470,21 +984,10 @@ KWE_StatusTypeDef KWE_EcdsaPublicKeyExport(
 {
   KWE_StatusTypeDef status = KWE_ERROR;
 
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_ECDSACurveParamTypeDef ecdsa_param;
   CCB_ECDSAKeyBlobTypeDef ecdsa_blob;
   CCB_ECCMulPointTypeDef publickey;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType         = HAL_CCB_USER_KEY_HW;
-
   ecdsa_param.primeOrderSizeByte            = p_ecp->order_size;
   ecdsa_param.modulusSizeByte               = p_ecp->modulus_size;
   ecdsa_param.pModulus                      = p_ecp->p_prime;
@@ -516,12 +1019,20 @@ KWE_StatusTypeDef KWE_EcdsaPublicKeyExport(
   publickey.pPointX                  = p_public_key;
 #endif /* KWE_ECP_SHORT_WEIERSTRASS_ENABLED */
 
-  if (HAL_CCB_ECDSA_ComputePublicKey(&hccb, &ecdsa_param, &wrapping_key_conf, &ecdsa_blob, &publickey) != HAL_OK)
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
   {
     return status;
   }
+  status = KWE_ERROR;
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (HAL_CCB_ECDSA_ComputePublicKey(&hccb, &ecdsa_param, &kwe_ccb_session.wrapping_key_conf, &ecdsa_blob, &publickey) != HAL_OK)
+  {
+    (void) kwe_ccb_release(KWE_ERROR);
+    return status;
+  }
+
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -557,22 +1068,11 @@ KWE_StatusTypeDef KWE_EcdhKeyAgreement(
   size_t *p_shared_secret_length)
 {
   KWE_StatusTypeDef status = KWE_ERROR;
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_ECCMulCurveParamTypeDef ecdh_param;
   CCB_ECCMulKeyBlobTypeDef ecdh_blob;
   CCB_ECCMulPointTypeDef ecdh_peer_pubkey;
   CCB_ECCMulPointTypeDef ecdh_shared_secret;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                           = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType       = HAL_CCB_USER_KEY_HW;
-
   /* Fill ECDSA In parameters */
   ecdh_param.primeOrderSizeByte           = p_ecp->order_size;
   ecdh_param.modulusSizeByte              = p_ecp->modulus_size;
@@ -592,16 +1092,24 @@ KWE_StatusTypeDef KWE_EcdhKeyAgreement(
   ecdh_shared_secret.pPointX  = p_shared_secret;
   ecdh_shared_secret.pPointY  = p_shared_secret + ecdh_param.primeOrderSizeByte;
 
-  if (HAL_CCB_ECC_ComputeScalarMul(&hccb, &ecdh_param, &wrapping_key_conf,
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
+  if (HAL_CCB_ECC_ComputeScalarMul(&hccb, &ecdh_param, &kwe_ccb_session.wrapping_key_conf,
                                    &ecdh_blob, &ecdh_peer_pubkey,
                                    &ecdh_shared_secret) != HAL_OK)
   {
+    (void) kwe_ccb_release(KWE_ERROR);
     return status;
   }
 
   *p_shared_secret_length = (2U * ecdh_param.primeOrderSizeByte);
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -624,6 +1132,7 @@ KWE_StatusTypeDef KWE_EcdhKeyAgreement(
  ===============================================================================
     [..]
         (+) EcdsaSignHash
+        (+) EcdsaSignHashBatch
         (+) RsaModularExp
 
 @endverbatim
@@ -653,21 +1162,10 @@ KWE_StatusTypeDef KWE_EcdsaSignHash(
   KWE_StatusTypeDef status = KWE_ERROR;
   uint8_t *p_hash_tmp = (uint8_t *)p_hash;
 
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_ECDSACurveParamTypeDef ecdsa_param;
   CCB_ECDSAKeyBlobTypeDef ecdsa_blob;
   CCB_ECDSASignTypeDef ecdsa_result;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType         = HAL_CCB_USER_KEY_HW;
-
   ecdsa_param.primeOrderSizeByte           = p_ecp->order_size;
   ecdsa_param.modulusSizeByte              = p_ecp->modulus_size;
   ecdsa_param.pModulus                     = p_ecp->p_prime;
@@ -685,12 +1183,20 @@ KWE_StatusTypeDef KWE_EcdsaSignHash(
   ecdsa_result.pRSign                      = p_signature;
   ecdsa_result.pSSign                      = p_signature + signature_size / 2U;
 
-  if (HAL_CCB_ECDSA_Sign(&hccb, &ecdsa_param, &wrapping_key_conf, &ecdsa_blob, p_hash_tmp, &ecdsa_result) != HAL_OK)
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
   {
     return status;
   }
+  status = KWE_ERROR;
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (HAL_CCB_ECDSA_Sign(&hccb, &ecdsa_param, &kwe_ccb_session.wrapping_key_conf, &ecdsa_blob, p_hash_tmp, &ecdsa_result) != HAL_OK)
+  {
+    (void) kwe_ccb_release(KWE_ERROR);
+    return status;
+  }
+
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -702,6 +1208,94 @@ KWE_StatusTypeDef KWE_EcdsaSignHash(
   return status;
 }
 
+/**
+  * @brief  A function that signs several hashes with the same asymmetric
+  *         wrapped private key through KWE hardware accelerator.
+  * @note   The curve parameters and the key blob are set up once and the
+  *         signatures run back to back on the CCB.
+  * @param  p_ecp : a pointer to elliptic curve parameters.
+  * @param  p_key_buffer : a pointer to the wrapped ECC private key.
+  * @param  p_hashes : pointer to the hashes to be signed, each one
+  *         p_ecp->order_size bytes long.
+  * @param  hash_count : number of hashes to sign.
+  * @param  p_signatures : pointer to buffer to store the signatures, each
+  *         one 2 * p_ecp->order_size bytes long (R then S).
+  * @param  signatures_size : size of the signatures buffer in bytes.
+  * @param  p_signatures_length : a pointer to the actual size of outputted
+  *         signatures in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_EcdsaSignHashBatch(
+  KWE_EcpTypeDef *p_ecp,
+  const uint8_t *p_key_buffer,
+  const uint8_t *p_hashes,
+  uint32_t hash_count,
+  uint8_t *p_signatures,
+  size_t signatures_size,
+  size_t *p_signatures_length)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  uint32_t i;
+
+  CCB_ECDSACurveParamTypeDef ecdsa_param;
+  CCB_ECDSAKeyBlobTypeDef ecdsa_blob;
+  CCB_ECDSASignTypeDef ecdsa_result;
+
+  /* The signatures are stored back to back: their total size must not
+   * overflow */
+  if ((p_ecp->order_size == 0U)
+      || (hash_count > (SIZE_MAX / (2U * (size_t)p_ecp->order_size)))
+      || (signatures_size < (2U * (size_t)p_ecp->order_size * hash_count)))
+  {
+    return status;
+  }
+
+  ecdsa_param.primeOrderSizeByte           = p_ecp->order_size;
+  ecdsa_param.modulusSizeByte              = p_ecp->modulus_size;
+  ecdsa_param.pModulus                     = p_ecp->p_prime;
+  ecdsa_param.coefSignA                    = p_ecp->a_sign;
+  ecdsa_param.pAbsCoefA                    = p_ecp->p_a_abs;
+  ecdsa_param.pCoefB                       = p_ecp->p_b;
+  ecdsa_param.pPointX                      = p_ecp->p_gx;
+  ecdsa_param.pPointY                      = p_ecp->p_gy;
+  ecdsa_param.pPrimeOrder                  = p_ecp->p_n;
+
+  ecdsa_blob.pIV         = (uint32_t *)p_key_buffer + KWE_BLOB_IV_OFFSET;
+  ecdsa_blob.pTag        = (uint32_t *)p_key_buffer + KWE_BLOB_TAG_OFFSET;
+  ecdsa_blob.pWrappedKey = (uint32_t *)p_key_buffer + KWE_BLOB_KEY_OFFSET;
+
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
+  for (i = 0U; i < hash_count; i++)
+  {
+    ecdsa_result.pRSign = p_signatures + (2U * ecdsa_param.primeOrderSizeByte * i);
+    ecdsa_result.pSSign = ecdsa_result.pRSign + ecdsa_param.primeOrderSizeByte;
+
+    if (HAL_CCB_ECDSA_Sign(&hccb, &ecdsa_param, &kwe_ccb_session.wrapping_key_conf, &ecdsa_blob,
+                           (uint8_t *)p_hashes + (ecdsa_param.primeOrderSizeByte * i),
+                           &ecdsa_result) != HAL_OK)
+    {
+      (void) kwe_ccb_release(KWE_ERROR);
+      return status;
+    }
+  }
+
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
+  {
+    return status;
+  }
+  *p_signatures_length = 2U * ecdsa_param.primeOrderSizeByte * hash_count;
+
+  status = KWE_SUCCESS;
+
+  return status;
+}
+
 /**
   * @brief  A function that performs modular exponentiation using wrapped RSA
   *         private key (Exponent and phi) through KWE hardware
@@ -720,20 +1314,9 @@ KWE_StatusTypeDef KWE_RsaModularExp(
   uint8_t *p_output)
 {
   KWE_StatusTypeDef status = KWE_ERROR;
-  CCB_WrappingKeyTypeDef wrapping_key_conf;
   CCB_RSAParamTypeDef rsa_mod_exp_param;
   CCB_RSAKeyBlobTypeDef rsa_mod_exp_blob;
 
-  /* Initialize KWE engine and set default configuration */
-  hccb.Instance                        = CCB;
-  if (HAL_CCB_Init(&hccb) != HAL_OK)
-  {
-    return status;
-  }
-
-  /* Configure Wrapping Key */
-  wrapping_key_conf.WrappingKeyType         = HAL_CCB_USER_KEY_HW;
-
   /* Fill RSA Modular exponentiation In parameters */
   rsa_mod_exp_param.expSizeByte               = p_rsa->exponent_size;
   rsa_mod_exp_param.modulusSizeByte           = p_rsa->modulus_size;
@@ -747,15 +1330,23 @@ KWE_StatusTypeDef KWE_RsaModularExp(
   rsa_mod_exp_blob.pWrappedPhi                = (uint32_t *)p_key_buffer + KWE_BLOB_KEY_OFFSET
                                                 + rsa_mod_exp_param.expSizeByte / 4U;
 
+  status = kwe_ccb_acquire();
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+  status = KWE_ERROR;
+
   if (HAL_CCB_RSA_ComputeModularExp(&hccb, &rsa_mod_exp_param,
-                                    &wrapping_key_conf, &rsa_mod_exp_blob,
+                                    &kwe_ccb_session.wrapping_key_conf, &rsa_mod_exp_blob,
                                     (uint8_t *)p_input, p_output)
       != HAL_OK)
   {
+    (void) kwe_ccb_release(KWE_ERROR);
     return status;
   }
 
-  if (HAL_CCB_DeInit(&hccb) != HAL_OK)
+  if (kwe_ccb_release(KWE_SUCCESS) != KWE_SUCCESS)
   {
     return status;
   }
@@ -783,6 +1374,23 @@ KWE_StatusTypeDef KWE_RsaModularExp(
     (+) AesAeadDecrypt
     (+) AesEncrypt
     (+) AesDecrypt
+    (+) AesCipherSetup
+    (+) AesCipherSetIv
+    (+) AesCipherUpdate
+    (+) AesCipherFinish
+    (+) AesCipherAbort
+    (+) AesCipherUpdateAsync
+    (+) AesAsyncIRQHandler
+    (+) AesAeadSetup
+    (+) AesAeadSetNonce
+    (+) AesAeadSetLengths
+    (+) AesAeadUpdateAd
+    (+) AesAeadUpdate
+    (+) AesAeadFinish
+    (+) AesAeadAbort
+    (+) AesKeyInvalidate
+    (+) AesKeyInvalidateCallback
+    (+) AesKeyDestroy
 
 @endverbatim
   * @{
@@ -818,9 +1426,10 @@ KWE_StatusTypeDef KWE_WrapAESKey(
   KWE_StatusTypeDef status = KWE_ERROR;
   uint32_t key_le[8] = {0};
   uint32_t *p_key = NULL;
+  uint32_t key_size;
   uint32_t i = 0;
   CRYP_ConfigTypeDef conf;
-  (void) memset(&hcryp, 0, sizeof(hcryp));
+
   (void) memset(&conf, 0, sizeof(conf));
 
   if (((key_buffer_size) % 16U) != 0U)
@@ -828,52 +1437,75 @@ KWE_StatusTypeDef KWE_WrapAESKey(
     return status;
   }
 
-  hcryp.Instance = SAES;
-  hcryp.Init.DataType = CRYP_NO_SWAP;
   if (data_length == 16U)
   {
-    hcryp.Init.KeySize = CRYP_KEYSIZE_128B;
+    key_size = CRYP_KEYSIZE_128B;
   }
   else if (data_length == 32U)
   {
-    hcryp.Init.KeySize = CRYP_KEYSIZE_256B;
+    key_size = CRYP_KEYSIZE_256B;
   }
   else
   {
     return KWE_ERROR_NOT_SUPPORTED;
   }
 
-  hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
-  hcryp.Init.KeyMode = CRYP_KEYMODE_WRAPPED;
-  hcryp.Init.KeySelect = CRYP_KEYSEL_HW;
-  hcryp.Init.KeyProtection = CRYP_KEYPROT_ENABLE;
-  hcryp.Init.DataWidthUnit     = CRYP_DATAWIDTHUNIT_WORD;
+  if (kwe_aes_check_idle() != KWE_SUCCESS)
+  {
+    return KWE_ERROR_BUSY;
+  }
+
+  /* Within a provisioning session SAES stays configured for key wrapping */
+  if ((kwe_provision.active == 0U) || (kwe_provision.aes_key_size != key_size))
+  {
+    kwe_aes_acquire();
+
+    (void) memset(&hcryp, 0, sizeof(hcryp));
+
+    hcryp.Instance = SAES;
+    hcryp.Init.DataType = CRYP_NO_SWAP;
+    hcryp.Init.KeySize = key_size;
+    hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
+    hcryp.Init.KeyMode = CRYP_KEYMODE_WRAPPED;
+    hcryp.Init.KeySelect = CRYP_KEYSEL_HW;
+    hcryp.Init.KeyProtection = CRYP_KEYPROT_ENABLE;
+    hcryp.Init.DataWidthUnit     = CRYP_DATAWIDTHUNIT_WORD;
 
 #if defined (KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY)
-  hcryp.Init.Algorithm = CRYP_AES_CBC;
-  p_key = (uint32_t *)(p_key_buffer + KWE_IV_MAX_SIZE);
+    hcryp.Init.Algorithm = CRYP_AES_CBC;
 #else
-  hcryp.Init.Algorithm = CRYP_AES_ECB;
-  p_key = (uint32_t *)p_key_buffer;
+    hcryp.Init.Algorithm = CRYP_AES_ECB;
 #endif  /* KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY */
 
-  if (HAL_CRYP_Init(&hcryp) != HAL_OK)
-  {
-    return status;
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK)
+    {
+      return status;
+    }
+
+    if (kwe_provision.active != 0U)
+    {
+      kwe_provision.aes_key_size = key_size;
+    }
   }
 
 #if defined (KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY)
+  p_key = (uint32_t *)(p_key_buffer + KWE_IV_MAX_SIZE);
+
   /* Reconfigure the SAES */
   if (HAL_CRYP_GetConfig(&hcryp, &conf) != HAL_OK)
   {
+    kwe_provision.aes_key_size = 0U;
     return status;
   }
   conf.pInitVect = (uint32_t *)p_key_buffer;
   /* Reconfigure the SAES */
   if (HAL_CRYP_SetConfig(&hcryp, &conf) != HAL_OK)
   {
+    kwe_provision.aes_key_size = 0U;
     return status;
   }
+#else
+  p_key = (uint32_t *)p_key_buffer;
 #endif /* KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY */
 
   /* Set key data in Little endian format */
@@ -885,14 +1517,19 @@ KWE_StatusTypeDef KWE_WrapAESKey(
   if (HAL_CRYPEx_WrapKey(&hcryp, key_le, p_key, KWE_TIMEOUT_VALUE) != HAL_OK)
   {
     /* Processing Error */
+    kwe_provision.aes_key_size = 0U;
     return status;
   }
 
   *p_key_buffer_length = key_buffer_size;
 
-  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  /* SAES is released by KWE_ProvisionEnd() within a provisioning session */
+  if (kwe_provision.active == 0U)
   {
-    return status;
+    if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+    {
+      return status;
+    }
   }
 
   status = KWE_SUCCESS;
@@ -918,6 +1555,39 @@ static KWE_StatusTypeDef KWE_UnwrapAESKey(
   uint32_t *p_key = NULL;
   size_t key_size = 0U;
   CRYP_ConfigTypeDef conf;
+
+  if (kwe_aes_check_idle() != KWE_SUCCESS)
+  {
+    return KWE_ERROR_BUSY;
+  }
+
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+  if ((kwe_aes_resident.valid != 0U)
+      && (kwe_aes_resident.key_buffer_size == key_buffer_size)
+      && (memcmp(kwe_aes_resident.key_buffer, p_key_buffer, key_buffer_size) == 0))
+  {
+    /* Key already unwrapped in SAES: only drop the message parameters of the
+       previous operation and load the key and IV once for the next one */
+#if defined (KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY)
+    hcryp.Init.pInitVect       = (uint32_t *)p_key_buffer;
+#else
+    hcryp.Init.pInitVect       = NULL;
+#endif  /* KWE_USE_CBC_TO_WRAP_SYMMETRIC_KEY */
+    hcryp.Init.Header          = NULL;
+    hcryp.Init.HeaderSize      = 0U;
+    hcryp.Init.B0              = NULL;
+    hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ONCE;
+    hcryp.KeyIVConfig          = 0U;
+
+    /* Resident again only once the operation completes */
+    kwe_aes_resident.valid = 0U;
+
+    return KWE_SUCCESS;
+  }
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
+
+  kwe_aes_acquire();
+
   (void) memset(&hcryp, 0, sizeof(hcryp));
   (void) memset(&conf, 0, sizeof(conf));
 
@@ -991,6 +1661,84 @@ static KWE_StatusTypeDef KWE_UnwrapAESKey(
   return status;
 }
 
+/**
+  * @brief  Run a single-part CCM operation through the multi-part SAES
+  *         sequence: B0 and the B1 blocks (encoded additional data length
+  *         and additional data) are fed to SAES through the 16-byte block of
+  *         the context as the data goes, whatever the additional data length.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @param  p_nonce : a pointer to the nonce.
+  * @param  nonce_length : size of the nonce in bytes, 7 to 13.
+  * @param  p_additional_data : a pointer to the additional data.
+  * @param  additional_data_length : size of the additional data in bytes.
+  * @param  p_input : a pointer to the plaintext, or to the ciphertext without
+  *         its tag.
+  * @param  input_length : size of the input in bytes.
+  * @param  p_output : a pointer to the output buffer.
+  * @param  output_size : size of the output buffer in bytes.
+  * @param  p_tag : a pointer to the tag computed by SAES.
+  * @param  tag_length : size of the tag in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef kwe_aes_ccm_crypt(
+  uint32_t encrypt,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  const uint8_t *p_nonce, size_t nonce_length,
+  const uint8_t *p_additional_data, size_t additional_data_length,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size,
+  uint8_t *p_tag, uint8_t tag_length)
+{
+  KWE_AesAeadContextTypeDef ctx;
+  KWE_StatusTypeDef status = KWE_ERROR;
+  size_t output_length = 0U;
+  size_t tail_length = 0U;
+  size_t tag_out_length = 0U;
+
+  status = KWE_AesAeadSetup(&ctx, KWE_ALG_AES_CCM, encrypt, tag_length, p_key_buffer, key_buffer_size);
+  if (status != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+
+  status = KWE_AesAeadSetLengths(&ctx, additional_data_length, input_length);
+  if (status != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+
+  status = KWE_AesAeadSetNonce(&ctx, p_nonce, nonce_length);
+  if (status != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+
+  if (additional_data_length != 0U)
+  {
+    status = KWE_AesAeadUpdateAd(&ctx, p_additional_data, additional_data_length);
+    if (status != KWE_SUCCESS)
+    {
+      goto exit;
+    }
+  }
+
+  status = KWE_AesAeadUpdate(&ctx, p_input, input_length, p_output, output_size, &output_length);
+  if (status != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+
+  status = KWE_AesAeadFinish(&ctx, p_output + output_length, output_size - output_length, &tail_length,
+                             p_tag, tag_length, &tag_out_length);
+
+exit:
+  KWE_AesAeadAbort(&ctx);
+
+  return status;
+}
+
 /**
   * @brief  A function that performs AES authenticated encryption operation
   *         using KWE hardware accelerator.
@@ -1026,15 +1774,7 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
   uint8_t init_vect[16] = {0};
   uint32_t *iv_p = (uint32_t *)init_vect;
   uint32_t i = 0;
-  size_t len_left = 0;
-  unsigned int q = 0;
-  
-  unsigned char *b1_padded_addr = NULL;            /* Formatting of B1   */
-  size_t b1_length = 0;                                /* B1 with padding    */
-  uint8_t b1_padding = 0;                              /* B1 word alignment  */
-  __ALIGN_BEGIN uint8_t tag[16]      __ALIGN_END;  /* temporary tag */
 
-  (void) memset(&hcryp, 0, sizeof(hcryp));
   (void) memset(&conf, 0, sizeof(conf));
 
   if (((uint64_t) additional_data_length >> 61U != 0U) || (nonce_length > 16U))
@@ -1042,6 +1782,28 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
     return status;
   }
 
+  if (alg == KWE_ALG_AES_CCM)
+  {
+    /* The CCM header blocks are streamed to SAES, no buffer is sized by the
+     * additional data */
+    if ((ciphertext_size < tag_length) || ((ciphertext_size - tag_length) < plaintext_length))
+    {
+      return status;
+    }
+
+    status = kwe_aes_ccm_crypt(1U, p_key_buffer, key_buffer_size, p_nonce, nonce_length,
+                               p_additional_data, additional_data_length,
+                               p_plaintext, plaintext_length,
+                               p_ciphertext, ciphertext_size - tag_length,
+                               p_ciphertext + plaintext_length, tag_length);
+    if (status == KWE_SUCCESS)
+    {
+      *p_ciphertext_length = plaintext_length + tag_length;
+    }
+
+    return status;
+  }
+
   if (KWE_UnwrapAESKey(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
@@ -1053,7 +1815,7 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
     return status;
   }
 
-  if ((alg == KWE_ALG_AES_GCM) || (alg == KWE_ALG_AES_CCM))
+  if (alg == KWE_ALG_AES_GCM)
   {
     /* additional authentication data limited to 2^64 bits */
     conf.HeaderWidthUnit = CRYP_HEADERWIDTHUNIT_BYTE;
@@ -1073,61 +1835,6 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
         conf.HeaderSize = additional_data_length;
         conf.Header = (uint32_t *)p_additional_data;
       }
-      else if (alg == KWE_ALG_AES_CCM)
-      {
-        /* Also implies q is within bounds */
-        if (nonce_length < 7 || nonce_length > 13)
-        {
-          return status;
-        }
-
-        (void) memcpy(init_vect + 1, p_nonce, nonce_length);
-
-        q = 16 - 1 - (unsigned char)nonce_length;
-        init_vect[0] |= (additional_data_length > 0U) << 6U;
-        init_vect[0] |= ((tag_length - 2U) / 2U) << 3U;
-        init_vect[0] |= q - 1U;
-        
-        for (i = 0, len_left = plaintext_length; i < q; i++, len_left >>= 8U)
-        {
-          init_vect[15 - i] = (uint8_t)((len_left)& 0xff);
-        }
-
-        if (len_left > 0U)
-        {
-          return status;
-        }
-        /* first authentication block */
-        for (i = 0U; i < 4U; i++)
-        {
-          GET_UINT32_BE(iv_p[i], init_vect, 4U * i);
-        }
-        conf.B0 = iv_p;
-        /* Extra bytes to deal with data padding such that
-         * the resulting string can be partitioned into words
-         */
-        b1_padding = ((additional_data_length + 2U) % 4U);
-        b1_length = additional_data_length + 2U + b1_padding;
-
-        b1_padded_addr = calloc(1, b1_length);
-
-        if (b1_padded_addr == NULL)
-        {
-          return status;
-        }
-
-        /* Header length */
-        b1_padded_addr[0] = (unsigned char)((additional_data_length >> 8) & 0xFF);
-        b1_padded_addr[1] = (unsigned char)((additional_data_length) & 0xFF);
-
-        /* data concatenation */
-        (void) memcpy(b1_padded_addr + 2U, p_additional_data, additional_data_length);
-
-        /* blocks (B) associated to the Associated Data (A) */
-        conf.Header     = (uint32_t *)b1_padded_addr;
-
-        conf.HeaderSize = b1_length;
-      }
     }
     else
     {
@@ -1142,14 +1849,7 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
 
   conf.DataWidthUnit     = CRYP_DATAWIDTHUNIT_BYTE;
   conf.DataType          = CRYP_BYTE_SWAP;
-  if (alg == KWE_ALG_AES_CCM)
-  {
-    conf.Algorithm       = CRYP_AES_CCM;
-  }
-  else
-  {
-    conf.Algorithm       = CRYP_AES_GCM_GMAC;
-  }
+  conf.Algorithm         = CRYP_AES_GCM_GMAC;
   conf.KeyMode           = CRYP_KEYMODE_NORMAL;
   conf.KeySelect         = CRYP_KEYSEL_NORMAL;
   conf.KeyIVConfigSkip   = CRYP_KEYIVCONFIG_ONCE;
@@ -1175,17 +1875,6 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
       return status;
     }
   }
-  else if (alg == KWE_ALG_AES_CCM)
-  {
-    /* Tag has a variable length */
-    (void) memset(tag, 0, sizeof(tag));
-    /* Compute the authentication TAG */
-    if (HAL_CRYPEx_AESCCM_GenerateAuthTAG(&hcryp, (uint32_t *)tag, KWE_TIMEOUT_VALUE))
-    {
-      goto exit;
-    }
-    (void) memcpy((p_ciphertext + plaintext_length), tag, tag_length);
-  }
   else
   {
     return status;
@@ -1193,7 +1882,7 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
 
   *p_ciphertext_length = ciphertext_size;
 
-  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  if (kwe_aes_release(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
   }
@@ -1201,10 +1890,6 @@ KWE_StatusTypeDef KWE_AesAeadEncrypt(
   status = KWE_SUCCESS;
 
 exit:
-  if (alg == KWE_ALG_AES_CCM)
-  {
-    free(b1_padded_addr);
-  }
   return status;
 }
 
@@ -1249,14 +1934,7 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
   size_t cipher_block_size = 0U;
   size_t last_bytes = 0;
   uint32_t i = 0;
-  size_t len_left = 0;
-  unsigned int q = 0;
-  
-  unsigned char *b1_padded_addr = NULL;            /* Formatting of B1   */
-  size_t b1_length = 0;                                /* B1 with padding    */
-  uint8_t b1_padding = 0;                              /* B1 word alignment  */
 
-  (void) memset(&hcryp, 0, sizeof(hcryp));
   (void) memset(&conf, 0, sizeof(conf));
 
   if ((((uint64_t) additional_data_length >> 61U) != 0U) || (nonce_length > 16U))
@@ -1264,6 +1942,34 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
     return status;
   }
 
+  if (alg == KWE_ALG_AES_CCM)
+  {
+    /* The CCM header blocks are streamed to SAES, no buffer is sized by the
+     * additional data */
+    if ((ciphertext_length < tag_length) || (plaintext_size < (ciphertext_length - tag_length)))
+    {
+      return status;
+    }
+
+    status = kwe_aes_ccm_crypt(0U, p_key_buffer, key_buffer_size, p_nonce, nonce_length,
+                               p_additional_data, additional_data_length,
+                               p_ciphertext, ciphertext_length - tag_length,
+                               p_plaintext, plaintext_size,
+                               check_tag, tag_length);
+    if ((status == KWE_SUCCESS)
+        && (memcmp(check_tag, p_ciphertext + (ciphertext_length - tag_length), tag_length) != 0))
+    {
+      status = KWE_ERROR;
+    }
+    if (status == KWE_SUCCESS)
+    {
+      *p_plaintext_length = ciphertext_length - tag_length;
+    }
+    (void) memset(check_tag, 0, sizeof(check_tag));
+
+    return status;
+  }
+
   if (KWE_UnwrapAESKey(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
@@ -1274,7 +1980,7 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
     return status;
   }
 
-  if ((alg == KWE_ALG_AES_GCM) || (alg == KWE_ALG_AES_CCM))
+  if (alg == KWE_ALG_AES_GCM)
   {
     /* Additional authentication data limited to 2^64 bits */
     conf.HeaderWidthUnit = CRYP_HEADERWIDTHUNIT_BYTE;
@@ -1294,60 +2000,6 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
         conf.HeaderSize = (uint32_t)additional_data_length;
         conf.Header = (uint32_t *)p_additional_data;
       }
-      else if (alg == KWE_ALG_AES_CCM)
-      {
-        /* Also implies q is within bounds */
-        if ((nonce_length < 7U) || (nonce_length > 13U))
-        {
-          return status;
-        }
-
-        (void) memcpy(init_vect + 1U, p_nonce, nonce_length);
-
-        q = 16U - 1U - (unsigned char)nonce_length;
-        init_vect[0] |= (additional_data_length > 0U) << 6U;
-        init_vect[0] |= ((tag_length - 2U) / 2U) << 3U;
-        init_vect[0] |= q - 1U;
-        
-        for (i = 0U, len_left = (ciphertext_length - tag_length); i < q; i++, len_left >>= 8U)
-        {
-          init_vect[15U - i] = (uint8_t)((len_left)& 0xff);
-        }
-
-        if (len_left > 0U)
-        {
-          return status;
-        }
-        /* first authentication block */
-        for (i = 0U; i < 4U; i++)
-        {
-          GET_UINT32_BE(iv_p[i], init_vect, 4U * i);
-        }
-        conf.B0 = iv_p;
-        /* Extra bytes to deal with data padding such that
-         * the resulting string can be partitioned into words
-         */
-        b1_padding = ((additional_data_length + 2U) % 4U);
-        b1_length = additional_data_length + 2U + b1_padding;
-
-        b1_padded_addr = calloc(1, b1_length);
-
-        if (b1_padded_addr == NULL)
-        {
-          return status;
-        }
-
-        /* Header length */
-        b1_padded_addr[0] = (unsigned char)((additional_data_length >> 8U) & 0xFF);
-        b1_padded_addr[1] = (unsigned char)((additional_data_length) & 0xFF);
-
-        /* data concatenation */
-        (void) memcpy(b1_padded_addr + 2U, p_additional_data, additional_data_length);
-
-        /* blocks (B) associated to the Associated Data (A) */
-        conf.Header     = (uint32_t *)b1_padded_addr;
-        conf.HeaderSize = b1_length;
-      }
     }
     else
     {
@@ -1358,14 +2010,7 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
 
   conf.DataWidthUnit     = CRYP_DATAWIDTHUNIT_BYTE;
   conf.DataType          = CRYP_BYTE_SWAP;
-  if (alg == KWE_ALG_AES_CCM)
-  {
-    conf.Algorithm       = CRYP_AES_CCM;
-  }
-  else
-  {
-    conf.Algorithm       = CRYP_AES_GCM_GMAC;
-  }
+  conf.Algorithm         = CRYP_AES_GCM_GMAC;
   conf.KeyMode           = CRYP_KEYMODE_NORMAL;
   conf.KeySelect         = CRYP_KEYSEL_NORMAL;
   conf.KeyIVConfigSkip   = CRYP_KEYIVCONFIG_ONCE;
@@ -1408,14 +2053,6 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
       return status;
     }
   }
-  else if (alg == KWE_ALG_AES_CCM)
-  {
-    /* Compute the authentication TAG */
-    if (HAL_CRYPEx_AESCCM_GenerateAuthTAG(&hcryp, (uint32_t *)(check_tag), KWE_TIMEOUT_VALUE) != HAL_OK)
-    {
-      goto exit;
-    }
-  }
   else
   {
     return status;
@@ -1428,7 +2065,7 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
 
   *p_plaintext_length = plaintext_size;
 
-  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  if (kwe_aes_release(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
   }
@@ -1436,10 +2073,6 @@ KWE_StatusTypeDef KWE_AesAeadDecrypt(
   status = KWE_SUCCESS;
 
 exit:
-  if (alg == KWE_ALG_AES_CCM)
-  {
-    free(b1_padded_addr);
-  }
   return status;
 }
 
@@ -1469,7 +2102,6 @@ KWE_StatusTypeDef KWE_AesEncrypt(
   CRYP_ConfigTypeDef conf;
   uint32_t init_vect[4] = {0};
   uint32_t i = 0;
-  (void) memset(&hcryp, 0, sizeof(hcryp));
   (void) memset(&conf, 0, sizeof(conf));
 
   if (KWE_UnwrapAESKey(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
@@ -1519,7 +2151,7 @@ KWE_StatusTypeDef KWE_AesEncrypt(
 
   *p_ciphertext_length = ciphertext_size;
 
-  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  if (kwe_aes_release(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
   }
@@ -1554,7 +2186,6 @@ KWE_StatusTypeDef KWE_AesDecrypt(
   uint32_t i = 0;
   CRYP_ConfigTypeDef conf;
   (void) memset(&conf, 0, sizeof(conf));
-  (void) memset(&hcryp, 0, sizeof(hcryp));
   *p_plaintext_length = 0U;
 
   if (KWE_UnwrapAESKey(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
@@ -1616,7 +2247,230 @@ KWE_StatusTypeDef KWE_AesDecrypt(
     *p_plaintext_length = ciphertext_length;
   }
 
-  if (HAL_CRYP_DeInit(&hcryp) != HAL_OK)
+  if (kwe_aes_release(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  status = KWE_SUCCESS;
+
+  return status;
+
+}
+
+/**
+  * @brief  Load a wrapped key in SAES and configure it to process whole
+  *         blocks from the given chaining value.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  p_chaining : the CBC IV or CTR counter block, in the SAES word
+  *         format. Unused for ECB.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AesCipherConfig(
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  KWE_AlgTypeDef alg,
+  uint32_t *p_chaining)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  CRYP_ConfigTypeDef conf;
+  (void) memset(&conf, 0, sizeof(conf));
+
+  /* The key stays resident in SAES from one update to the next */
+  status = KWE_UnwrapAESKey(p_key_buffer, key_buffer_size);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  status = KWE_ERROR;
+
+  if (HAL_CRYP_GetConfig(&hcryp, &conf) != HAL_OK)
+  {
+    return status;
+  }
+
+  conf.DataWidthUnit     = CRYP_DATAWIDTHUNIT_BYTE;
+  conf.DataType          = CRYP_BYTE_SWAP;
+  conf.KeyMode           = CRYP_KEYMODE_NORMAL;
+  conf.KeySelect         = CRYP_KEYSEL_NORMAL;
+  if (alg == KWE_ALG_AES_CBC)
+  {
+    conf.Algorithm       = CRYP_AES_CBC;
+    conf.pInitVect       = p_chaining;
+  }
+  else if (alg == KWE_ALG_AES_CTR)
+  {
+    conf.Algorithm       = CRYP_AES_CTR;
+    conf.pInitVect       = p_chaining;
+  }
+  else
+  {
+    conf.Algorithm       = CRYP_AES_ECB;
+  }
+
+  if (HAL_CRYP_SetConfig(&hcryp, &conf) != HAL_OK)
+  {
+    return status;
+  }
+
+  status = KWE_SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  Read the last block of a run of blocks in the SAES word format.
+  * @param  p_data : a pointer to the data.
+  * @param  length : size of the data in bytes, a non-zero multiple of the
+  *         block size.
+  * @param  p_block : the last block of the data.
+  * @retval None
+  */
+static void KWE_AesCipherLastBlock(const uint8_t *p_data, size_t length, uint32_t *p_block)
+{
+  uint32_t i = 0;
+
+  for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+  {
+    GET_UINT32_BE(p_block[i], p_data, (length - KWE_AES_BLOCK_SIZE) + (4U * i));
+  }
+}
+
+/**
+  * @brief  Update the chaining value once a run of blocks is processed.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  p_chaining : the CBC IV or CTR counter block, in the SAES word
+  *         format, updated for the next run. Unused for ECB.
+  * @param  p_last_block : the last ciphertext block of the run, CBC only.
+  * @param  length : size of the processed data in bytes.
+  * @retval None
+  */
+static void KWE_AesCipherChain(
+  KWE_AlgTypeDef alg,
+  uint32_t *p_chaining,
+  const uint32_t *p_last_block,
+  size_t length)
+{
+  uint32_t blocks;
+  uint32_t carry;
+  uint32_t i = 0;
+
+  if (alg == KWE_ALG_AES_CBC)
+  {
+    (void) memcpy(p_chaining, p_last_block, KWE_AES_BLOCK_SIZE);
+  }
+  else if (alg == KWE_ALG_AES_CTR)
+  {
+    /* Advance the 128-bit big endian counter by the number of blocks */
+    blocks = (uint32_t)(length / KWE_AES_BLOCK_SIZE);
+    for (i = (KWE_AES_BLOCK_SIZE / 4U); (i > 0U) && (blocks != 0U); i--)
+    {
+      carry = (p_chaining[i - 1U] > (0xFFFFFFFFU - blocks)) ? 1U : 0U;
+      p_chaining[i - 1U] += blocks;
+      blocks = carry;
+    }
+  }
+  else
+  {
+    /* ECB has no chaining value */
+  }
+}
+
+/**
+  * @brief  Size of the next run of blocks SAES can process in one call.
+  * @note   SAES only increments the low 32-bit word of the CTR counter block:
+  *         a run stops where that word wraps, KWE_AesCipherChain() then
+  *         carries into the upper words before the next run.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  p_chaining : the CTR counter block, in the SAES word format.
+  * @param  length : size of the data left in bytes, a multiple of the block
+  *         size.
+  * @retval Size of the run in bytes
+  */
+static size_t KWE_AesCipherChunk(KWE_AlgTypeDef alg, const uint32_t *p_chaining, size_t length)
+{
+  size_t chunk = (length < KWE_AES_MAX_CHUNK_SIZE) ? length : KWE_AES_MAX_CHUNK_SIZE;
+  uint32_t blocks;
+
+  if (alg == KWE_ALG_AES_CTR)
+  {
+    /* Blocks left before the low word wraps, 0 standing for 2^32 */
+    blocks = 0U - p_chaining[(KWE_AES_BLOCK_SIZE / 4U) - 1U];
+    if ((blocks != 0U) && ((chunk / KWE_AES_BLOCK_SIZE) > blocks))
+    {
+      chunk = (size_t)blocks * KWE_AES_BLOCK_SIZE;
+    }
+  }
+
+  return chunk;
+}
+
+/**
+  * @brief  Run whole blocks through SAES with a wrapped key and save the
+  *         chaining value for the next call.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @param  p_chaining : the CBC IV or CTR counter block, in the SAES word
+  *         format, updated for the next call. Unused for ECB.
+  * @param  p_input : a pointer to the input data.
+  * @param  length : size of the input data in bytes, a multiple of the block
+  *         size not above KWE_AES_MAX_CHUNK_SIZE.
+  * @param  p_output : a pointer to the output buffer, length bytes long.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AesCipherBlocks(
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  uint32_t *p_chaining,
+  const uint8_t *p_input, size_t length,
+  uint8_t *p_output)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  uint32_t last_block[KWE_AES_BLOCK_SIZE / 4U] = {0};
+
+  status = KWE_AesCipherConfig(p_key_buffer, key_buffer_size, alg, p_chaining);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  status = KWE_ERROR;
+
+  if ((alg == KWE_ALG_AES_CBC) && (encrypt == 0U))
+  {
+    /* Last ciphertext block, read before an in-place decryption overwrites it */
+    KWE_AesCipherLastBlock(p_input, length, last_block);
+  }
+
+  if (encrypt != 0U)
+  {
+    if (HAL_CRYP_Encrypt(&hcryp, (uint32_t *)p_input, length, (uint32_t *)p_output,
+                         KWE_TIMEOUT_VALUE) != HAL_OK)
+    {
+      return status;
+    }
+  }
+  else
+  {
+    if (HAL_CRYP_Decrypt(&hcryp, (uint32_t *)p_input, length, (uint32_t *)p_output,
+                         KWE_TIMEOUT_VALUE) != HAL_OK)
+    {
+      return status;
+    }
+  }
+
+  if ((alg == KWE_ALG_AES_CBC) && (encrypt != 0U))
+  {
+    KWE_AesCipherLastBlock(p_output, length, last_block);
+  }
+  KWE_AesCipherChain(alg, p_chaining, last_block, length);
+
+  if (kwe_aes_release(p_key_buffer, key_buffer_size) != KWE_SUCCESS)
   {
     return status;
   }
@@ -1624,7 +2478,1386 @@ KWE_StatusTypeDef KWE_AesDecrypt(
   status = KWE_SUCCESS;
 
   return status;
+}
+
+/**
+  * @brief  Run whole blocks through SAES with a wrapped key, in chunks the
+  *         HAL and the SAES counter can take, and save the chaining value for the next call.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @param  p_chaining : the CBC IV or CTR counter block, in the SAES word
+  *         format, updated for the next call. Unused for ECB.
+  * @param  p_input : a pointer to the input data.
+  * @param  length : size of the input data in bytes, a multiple of the block
+  *         size.
+  * @param  p_output : a pointer to the output buffer, length bytes long.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AesCipherProcess(
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  uint32_t *p_chaining,
+  const uint8_t *p_input, size_t length,
+  uint8_t *p_output)
+{
+  size_t chunk;
+
+  while (length != 0U)
+  {
+    chunk = KWE_AesCipherChunk(alg, p_chaining, length);
+    if (KWE_AesCipherBlocks(p_key_buffer, key_buffer_size, alg, encrypt, p_chaining,
+                            p_input, chunk, p_output) != KWE_SUCCESS)
+    {
+      return KWE_ERROR;
+    }
+    p_input += chunk;
+    p_output += chunk;
+    length -= chunk;
+  }
+
+  return KWE_SUCCESS;
+}
+
+#if defined(KWE_AES_ASYNC_ENABLED)
+/**
+  * @brief  Start the SAES transfer of the next chunk of the asynchronous
+  *         operation, completed in HAL_CRYP_OutCpltCallback().
+  * @note   Unwraps the key and initializes SAES: to be called from thread
+  *         context only.
+  * @param  None
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef kwe_aes_async_start(void)
+{
+  KWE_AesCipherContextTypeDef *p_ctx = kwe_aes_async.p_ctx;
+  KWE_StatusTypeDef status = KWE_ERROR;
+  HAL_StatusTypeDef hal_status;
+  size_t chunk;
+
+  chunk = KWE_AesCipherChunk(p_ctx->alg, p_ctx->chaining, kwe_aes_async.remaining);
+  kwe_aes_async.chunk = chunk;
+
+  status = KWE_AesCipherConfig(p_ctx->key_buffer, p_ctx->key_buffer_size, p_ctx->alg, p_ctx->chaining);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  if ((p_ctx->alg == KWE_ALG_AES_CBC) && (p_ctx->encrypt == 0U))
+  {
+    /* Last ciphertext block, read before an in-place decryption overwrites it */
+    KWE_AesCipherLastBlock(kwe_aes_async.p_input, chunk, kwe_aes_async.last_block);
+  }
 
+  kwe_aes_async.busy = 1U;
+
+#if defined(KWE_AES_ASYNC_DMA_ENABLED)
+  if (p_ctx->encrypt != 0U)
+  {
+    hal_status = HAL_CRYP_Encrypt_DMA(&hcryp, (uint32_t *)kwe_aes_async.p_input, chunk,
+                                      (uint32_t *)kwe_aes_async.p_output);
+  }
+  else
+  {
+    hal_status = HAL_CRYP_Decrypt_DMA(&hcryp, (uint32_t *)kwe_aes_async.p_input, chunk,
+                                      (uint32_t *)kwe_aes_async.p_output);
+  }
+#else
+  if (p_ctx->encrypt != 0U)
+  {
+    hal_status = HAL_CRYP_Encrypt_IT(&hcryp, (uint32_t *)kwe_aes_async.p_input, chunk,
+                                     (uint32_t *)kwe_aes_async.p_output);
+  }
+  else
+  {
+    hal_status = HAL_CRYP_Decrypt_IT(&hcryp, (uint32_t *)kwe_aes_async.p_input, chunk,
+                                     (uint32_t *)kwe_aes_async.p_output);
+  }
+#endif /* KWE_AES_ASYNC_DMA_ENABLED */
+
+  if (hal_status != HAL_OK)
+  {
+    kwe_aes_async.busy = 0U;
+    KWE_AesKeyInvalidate();
+    return KWE_ERROR;
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  End the asynchronous operation and report its status.
+  * @param  status : status of the operation.
+  * @retval None
+  */
+static void kwe_aes_async_complete(KWE_StatusTypeDef status)
+{
+  KWE_AsyncCallbackTypeDef callback = kwe_aes_async.callback;
+  void *p_context = kwe_aes_async.p_context;
+
+  kwe_aes_async.p_ctx = NULL;
+
+  if (callback != NULL)
+  {
+    callback(status, p_context);
+  }
+}
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+/**
+  * @brief  Start a multi-part AES cipher operation using a wrapped key.
+  * @note   The wrapped key is copied into the context, the caller buffer
+  *         does not have to outlive the operation.
+  * @param  p_ctx : a pointer to the cipher context to initialize.
+  * @param  alg : KWE_ALG_AES_ECB, KWE_ALG_AES_CBC or KWE_ALG_AES_CTR.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesCipherSetup(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  const uint8_t *p_key_buffer, size_t key_buffer_size)
+{
+  (void) memset(p_ctx, 0, sizeof(KWE_AesCipherContextTypeDef));
+
+  if ((alg != KWE_ALG_AES_ECB) && (alg != KWE_ALG_AES_CBC) && (alg != KWE_ALG_AES_CTR))
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  if ((key_buffer_size <= KWE_IV_MAX_SIZE) || (key_buffer_size > KWE_AES_KEY_BUFFER_MAX_SIZE))
+  {
+    return KWE_ERROR;
+  }
+
+  (void) memcpy(p_ctx->key_buffer, p_key_buffer, key_buffer_size);
+  p_ctx->key_buffer_size = key_buffer_size;
+  p_ctx->alg = alg;
+  p_ctx->encrypt = (encrypt != 0U) ? 1U : 0U;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Set the IV, or initial counter block, of a multi-part AES cipher
+  *         operation.
+  * @param  p_ctx : a pointer to the cipher context.
+  * @param  p_iv : a pointer to the IV.
+  * @param  iv_length : size of the IV in bytes, must be KWE_AES_BLOCK_SIZE.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesCipherSetIv(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_iv, size_t iv_length)
+{
+  uint32_t i = 0;
+
+  if ((p_ctx->alg == KWE_ALG_AES_ECB) || (iv_length != KWE_AES_BLOCK_SIZE))
+  {
+    return KWE_ERROR;
+  }
+
+  /* Set Initialization vector (IV) in Little endian format */
+  for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+  {
+    GET_UINT32_BE(p_ctx->chaining[i], p_iv, 4U * i);
+  }
+  p_ctx->iv_set = 1U;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Process a chunk of a multi-part AES cipher operation.
+  * @note   Only whole blocks are processed, up to KWE_AES_BLOCK_SIZE - 1
+  *         trailing bytes are kept in the context for the next call.
+  * @param  p_ctx : a pointer to the cipher context.
+  * @param  p_input : a pointer to the input data.
+  * @param  input_length : size of the input data in bytes.
+  * @param  p_output : a pointer to the output buffer.
+  * @param  output_size : size of the output buffer in bytes.
+  * @param  p_output_length : the number of bytes written to p_output.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesCipherUpdate(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  uint8_t block[KWE_AES_BLOCK_SIZE];
+  uint32_t overlap;
+  size_t copy_length;
+  size_t block_length;
+  *p_output_length = 0U;
+
+  if ((p_ctx->alg != KWE_ALG_AES_ECB) && (p_ctx->iv_set == 0U))
+  {
+    return KWE_ERROR;
+  }
+
+  block_length = ((p_ctx->partial_length + input_length) / KWE_AES_BLOCK_SIZE) * KWE_AES_BLOCK_SIZE;
+  if (output_size < block_length)
+  {
+    return KWE_ERROR;
+  }
+
+  /* Input and output overlap, as for an in-place operation */
+  overlap = (((uintptr_t)p_output < ((uintptr_t)p_input + input_length))
+             && ((uintptr_t)p_input < ((uintptr_t)p_output + block_length))) ? 1U : 0U;
+
+  /* Complete the block left over by the previous update. The output then runs
+   * partial_length bytes ahead of the input: with overlapping buffers, the
+   * input bytes a block output overwrites are staged in the context first,
+   * one block at a time */
+  while ((p_ctx->partial_length != 0U) && ((p_ctx->partial_length + input_length) >= KWE_AES_BLOCK_SIZE))
+  {
+    copy_length = KWE_AES_BLOCK_SIZE - p_ctx->partial_length;
+    (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, copy_length);
+    (void) memcpy(block, p_ctx->partial, KWE_AES_BLOCK_SIZE);
+    p_input += copy_length;
+    input_length -= copy_length;
+
+    copy_length = 0U;
+    if (overlap != 0U)
+    {
+      copy_length = (input_length < p_ctx->partial_length) ? input_length : p_ctx->partial_length;
+      (void) memcpy(p_ctx->partial, p_input, copy_length);
+      p_input += copy_length;
+      input_length -= copy_length;
+    }
+    p_ctx->partial_length = copy_length;
+
+    if (KWE_AesCipherProcess(p_ctx->key_buffer, p_ctx->key_buffer_size, p_ctx->alg,
+                             p_ctx->encrypt, p_ctx->chaining, block, KWE_AES_BLOCK_SIZE, p_output) != KWE_SUCCESS)
+    {
+      (void) memset(block, 0, sizeof(block));
+      return KWE_ERROR;
+    }
+    p_output += KWE_AES_BLOCK_SIZE;
+    *p_output_length += KWE_AES_BLOCK_SIZE;
+  }
+  (void) memset(block, 0, sizeof(block));
+
+  if (p_ctx->partial_length != 0U)
+  {
+    /* Not enough data for a block yet */
+    (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, input_length);
+    p_ctx->partial_length += input_length;
+    return KWE_SUCCESS;
+  }
+
+  block_length = (input_length / KWE_AES_BLOCK_SIZE) * KWE_AES_BLOCK_SIZE;
+  if (block_length != 0U)
+  {
+    if (KWE_AesCipherProcess(p_ctx->key_buffer, p_ctx->key_buffer_size, p_ctx->alg,
+                             p_ctx->encrypt, p_ctx->chaining, p_input, block_length, p_output) != KWE_SUCCESS)
+    {
+      return KWE_ERROR;
+    }
+    p_input += block_length;
+    *p_output_length += block_length;
+  }
+
+  /* Keep the tail for the next update */
+  p_ctx->partial_length = input_length - block_length;
+  if (p_ctx->partial_length != 0U)
+  {
+    (void) memcpy(p_ctx->partial, p_input, p_ctx->partial_length);
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Finish a multi-part AES cipher operation and wipe its context.
+  * @note   ECB and CBC require the total input to be a multiple of the
+  *         block size, CTR outputs the remaining bytes.
+  * @param  p_ctx : a pointer to the cipher context.
+  * @param  p_output : a pointer to the output buffer.
+  * @param  output_size : size of the output buffer in bytes.
+  * @param  p_output_length : the number of bytes written to p_output.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesCipherFinish(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  uint8_t block[KWE_AES_BLOCK_SIZE];
+  *p_output_length = 0U;
+
+  if (p_ctx->partial_length == 0U)
+  {
+    status = KWE_SUCCESS;
+  }
+  else if ((p_ctx->alg == KWE_ALG_AES_CTR) && (output_size >= p_ctx->partial_length))
+  {
+    (void) memset(&p_ctx->partial[p_ctx->partial_length], 0, KWE_AES_BLOCK_SIZE - p_ctx->partial_length);
+    if (KWE_AesCipherProcess(p_ctx->key_buffer, p_ctx->key_buffer_size, p_ctx->alg,
+                             p_ctx->encrypt, p_ctx->chaining, p_ctx->partial, KWE_AES_BLOCK_SIZE, block) == KWE_SUCCESS)
+    {
+      (void) memcpy(p_output, block, p_ctx->partial_length);
+      *p_output_length = p_ctx->partial_length;
+      status = KWE_SUCCESS;
+    }
+    (void) memset(block, 0, sizeof(block));
+  }
+  else
+  {
+    /* Incomplete block in ECB or CBC, or output buffer too small */
+  }
+
+  (void) memset(p_ctx, 0, sizeof(KWE_AesCipherContextTypeDef));
+
+  return status;
+}
+
+/**
+  * @brief  Abort a multi-part AES cipher operation and wipe its context.
+  * @param  p_ctx : a pointer to the cipher context.
+  * @retval None
+  */
+void KWE_AesCipherAbort(KWE_AesCipherContextTypeDef *p_ctx)
+{
+  (void) memset(p_ctx, 0, sizeof(KWE_AesCipherContextTypeDef));
+}
+
+#if defined(KWE_AES_ASYNC_ENABLED)
+/**
+  * @brief  Start processing whole blocks of a multi-part AES cipher operation
+  *         by interrupt, or by DMA with KWE_AES_ASYNC_DMA_ENABLED, and return
+  *         without waiting for SAES.
+  * @note   The callback is run by KWE_AesAsyncProcess() once all the blocks
+  *         are processed or on error. The context, input and output buffers
+  *         must stay valid and untouched until then. Other SAES and CCB
+  *         operations return KWE_ERROR_BUSY while the operation runs.
+  * @note   KWE_AesAsyncIRQHandler() must be called from the SAES interrupt,
+  *         and KWE_AesAsyncProcess() from thread context once the interrupt
+  *         has called KWE_AesAsyncScheduleCallback().
+  * @param  p_ctx : a pointer to the cipher context, without pending partial
+  *         block.
+  * @param  p_input : a pointer to the input data.
+  * @param  input_length : size of the input data in bytes, a multiple of the
+  *         block size. The callback is run before returning if it is 0.
+  * @param  p_output : a pointer to the output buffer, input_length bytes long.
+  * @param  callback : function called when the operation completes.
+  * @param  p_context : argument passed to the callback.
+  * @retval KWE_SUCCESS if the operation is started, an error code otherwise,
+  *         in which case the callback is not called.
+  */
+KWE_StatusTypeDef KWE_AesCipherUpdateAsync(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output,
+  KWE_AsyncCallbackTypeDef callback, void *p_context)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+
+  if (kwe_aes_async.p_ctx != NULL)
+  {
+    return KWE_ERROR_BUSY;
+  }
+
+  if ((p_ctx->alg != KWE_ALG_AES_ECB) && (p_ctx->iv_set == 0U))
+  {
+    return KWE_ERROR;
+  }
+
+  if ((p_ctx->partial_length != 0U) || ((input_length % KWE_AES_BLOCK_SIZE) != 0U))
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  if (input_length == 0U)
+  {
+    if (callback != NULL)
+    {
+      callback(KWE_SUCCESS, p_context);
+    }
+    return KWE_SUCCESS;
+  }
+
+  kwe_aes_async.p_input = p_input;
+  kwe_aes_async.p_output = p_output;
+  kwe_aes_async.remaining = input_length;
+  kwe_aes_async.callback = callback;
+  kwe_aes_async.p_context = p_context;
+  kwe_aes_async.pending = 0U;
+  kwe_aes_async.p_ctx = p_ctx;
+
+  status = kwe_aes_async_start();
+  if (status != KWE_SUCCESS)
+  {
+    kwe_aes_async.p_ctx = NULL;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  SAES interrupt handler of the asynchronous AES operations.
+  * @param  None
+  * @retval None
+  */
+void KWE_AesAsyncIRQHandler(void)
+{
+  HAL_CRYP_IRQHandler(&hcryp);
+}
+
+/**
+  * @brief  Process the chunk of the asynchronous AES operation reported by
+  *         KWE_AesAsyncScheduleCallback(): start the next chunk, or complete
+  *         the operation and run its callback.
+  * @note   The next chunk needs the key unwrapped and SAES initialized
+  *         again, which polls SAES: this function must be called from thread
+  *         context, e.g. from a work queue item, never from the interrupt.
+  * @param  None
+  * @retval None
+  */
+void KWE_AesAsyncProcess(void)
+{
+  KWE_AesCipherContextTypeDef *p_ctx = kwe_aes_async.p_ctx;
+  KWE_StatusTypeDef status = KWE_ERROR;
+
+  if ((p_ctx == NULL) || (kwe_aes_async.pending == 0U))
+  {
+    return;
+  }
+
+  kwe_aes_async.pending = 0U;
+  kwe_aes_async.busy = 0U;
+  status = kwe_aes_async.status;
+
+  if (status != KWE_SUCCESS)
+  {
+    /* leave SAES in reset state */
+    KWE_AesKeyInvalidate();
+    (void) HAL_CRYP_DeInit(&hcryp);
+    kwe_aes_async_complete(status);
+    return;
+  }
+
+  status = kwe_aes_release(p_ctx->key_buffer, p_ctx->key_buffer_size);
+
+  kwe_aes_async.p_input += kwe_aes_async.chunk;
+  kwe_aes_async.p_output += kwe_aes_async.chunk;
+  kwe_aes_async.remaining -= kwe_aes_async.chunk;
+
+  if ((status == KWE_SUCCESS) && (kwe_aes_async.remaining != 0U))
+  {
+    status = kwe_aes_async_start();
+    if (status == KWE_SUCCESS)
+    {
+      return;
+    }
+  }
+
+  kwe_aes_async_complete(status);
+}
+
+/**
+  * @brief  A chunk of the asynchronous AES operation is done or has failed,
+  *         KWE_AesAsyncProcess() is to be run from thread context.
+  * @note   This function is called from the SAES interrupt. It should not be
+  *         modified, when the callback is needed, KWE_AesAsyncScheduleCallback
+  *         could be implemented in the user file, e.g. to submit a work item
+  *         calling KWE_AesAsyncProcess().
+  * @param  None
+  * @retval None
+  */
+__weak void KWE_AesAsyncScheduleCallback(void)
+{
+}
+
+/**
+  * @brief  SAES output transfer completed: save the chaining value and leave
+  *         the rest of the chunk processing to KWE_AesAsyncProcess().
+  * @param  p_hcryp : CRYP handle.
+  * @retval None
+  */
+void HAL_CRYP_OutCpltCallback(CRYP_HandleTypeDef *p_hcryp)
+{
+  KWE_AesCipherContextTypeDef *p_ctx = kwe_aes_async.p_ctx;
+
+  if ((p_hcryp != &hcryp) || (kwe_aes_async.busy == 0U) || (p_ctx == NULL))
+  {
+    return;
+  }
+
+  if ((p_ctx->alg == KWE_ALG_AES_CBC) && (p_ctx->encrypt != 0U))
+  {
+    KWE_AesCipherLastBlock(kwe_aes_async.p_output, kwe_aes_async.chunk, kwe_aes_async.last_block);
+  }
+  KWE_AesCipherChain(p_ctx->alg, p_ctx->chaining, kwe_aes_async.last_block, kwe_aes_async.chunk);
+
+  kwe_aes_async.status = KWE_SUCCESS;
+  kwe_aes_async.pending = 1U;
+  KWE_AesAsyncScheduleCallback();
+}
+
+/**
+  * @brief  SAES transfer error: the asynchronous operation is completed with
+  *         an error by KWE_AesAsyncProcess().
+  * @param  p_hcryp : CRYP handle.
+  * @retval None
+  */
+void HAL_CRYP_ErrorCallback(CRYP_HandleTypeDef *p_hcryp)
+{
+  if ((p_hcryp != &hcryp) || (kwe_aes_async.busy == 0U) || (kwe_aes_async.pending != 0U))
+  {
+    return;
+  }
+
+  kwe_aes_async.status = KWE_ERROR;
+  kwe_aes_async.pending = 1U;
+  KWE_AesAsyncScheduleCallback();
+}
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+/**
+  * @brief  Wait for SAES to complete the computation of a block.
+  * @param  None
+  * @retval KWE_SUCCESS if success, KWE_ERROR on timeout
+  */
+static KWE_StatusTypeDef KWE_AeadWait(void)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (__HAL_CRYP_GET_FLAG(&hcryp, CRYP_FLAG_CCF) == RESET)
+  {
+    if ((HAL_GetTick() - tickstart) > KWE_TIMEOUT_VALUE)
+    {
+      return KWE_ERROR;
+    }
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Feed a block to the current phase of the SAES AEAD operation.
+  * @param  p_input : a pointer to the input block.
+  * @param  p_output : a pointer to the output block, NULL in the header phase
+  *         which has no output.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadBlock(const uint8_t *p_input, uint8_t *p_output)
+{
+  uint32_t block[KWE_AES_BLOCK_SIZE / 4U];
+  uint32_t i = 0;
+
+  (void) memcpy(block, p_input, sizeof(block));
+  for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+  {
+    hcryp.Instance->DINR = block[i];
+  }
+
+  if (KWE_AeadWait() != KWE_SUCCESS)
+  {
+    return KWE_ERROR;
+  }
+
+  if (p_output != NULL)
+  {
+    for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+    {
+      block[i] = hcryp.Instance->DOUTR;
+    }
+    (void) memcpy(p_output, block, sizeof(block));
+  }
+
+  __HAL_CRYP_CLEAR_FLAG(&hcryp, CRYP_CLEAR_CCF);
+  (void) memset(block, 0, sizeof(block));
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Load the key of a multi-part AEAD operation in SAES, configure
+  *         SAES for GCM or CCM and give it back the state saved by
+  *         KWE_AeadSuspend(): GHASH or CBC-MAC state (SUSPxR), counter (IVRx)
+  *         and phase. SAES is then enabled.
+  * @note   The hash key and the MAC state are only ever computed by SAES. For
+  *         an operation not started yet, only the configuration is set and
+  *         SAES is left disabled for KWE_AeadStart().
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadResume(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  AES_TypeDef *instance = NULL;
+  CRYP_ConfigTypeDef conf;
+  (void) memset(&conf, 0, sizeof(conf));
+
+  status = KWE_UnwrapAESKey(p_ctx->key_buffer, p_ctx->key_buffer_size);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  if (HAL_CRYP_GetConfig(&hcryp, &conf) != HAL_OK)
+  {
+    return KWE_ERROR;
+  }
+
+  conf.DataWidthUnit     = CRYP_DATAWIDTHUNIT_BYTE;
+  conf.HeaderWidthUnit   = CRYP_HEADERWIDTHUNIT_BYTE;
+  conf.DataType          = CRYP_BYTE_SWAP;
+  conf.KeyMode           = CRYP_KEYMODE_NORMAL;
+  conf.KeySelect         = CRYP_KEYSEL_NORMAL;
+  conf.Algorithm         = (p_ctx->alg == KWE_ALG_AES_CCM) ? CRYP_AES_CCM : CRYP_AES_GCM_GMAC;
+  conf.Header            = NULL;
+  conf.HeaderSize        = 0U;
+
+  if (HAL_CRYP_SetConfig(&hcryp, &conf) != HAL_OK)
+  {
+    return KWE_ERROR;
+  }
+
+  instance = hcryp.Instance;
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+
+  if (p_ctx->started == 0U)
+  {
+    p_ctx->cr = KWE_AEAD_PHASE_INIT | ((p_ctx->encrypt != 0U) ? 0U : KWE_AEAD_MODE_DECRYPT);
+    MODIFY_REG(instance->CR, AES_CR_GCMPH | AES_CR_MODE | AES_CR_NPBLB, p_ctx->cr);
+    return KWE_SUCCESS;
+  }
+
+  instance->SUSP0R = p_ctx->susp[0];
+  instance->SUSP1R = p_ctx->susp[1];
+  instance->SUSP2R = p_ctx->susp[2];
+  instance->SUSP3R = p_ctx->susp[3];
+  instance->SUSP4R = p_ctx->susp[4];
+  instance->SUSP5R = p_ctx->susp[5];
+  instance->SUSP6R = p_ctx->susp[6];
+  instance->SUSP7R = p_ctx->susp[7];
+  instance->IVR0 = p_ctx->ivr[0];
+  instance->IVR1 = p_ctx->ivr[1];
+  instance->IVR2 = p_ctx->ivr[2];
+  instance->IVR3 = p_ctx->ivr[3];
+  MODIFY_REG(instance->CR, AES_CR_GCMPH | AES_CR_MODE | AES_CR_NPBLB, p_ctx->cr);
+  SET_BIT(instance->CR, AES_CR_EN);
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Save the state of a multi-part AEAD operation from SAES into its
+  *         context and release SAES, other SAES users can run until
+  *         KWE_AeadResume().
+  * @note   To be called between two blocks, once the last one has completed.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadSuspend(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  AES_TypeDef *instance = hcryp.Instance;
+
+  p_ctx->susp[0] = instance->SUSP0R;
+  p_ctx->susp[1] = instance->SUSP1R;
+  p_ctx->susp[2] = instance->SUSP2R;
+  p_ctx->susp[3] = instance->SUSP3R;
+  p_ctx->susp[4] = instance->SUSP4R;
+  p_ctx->susp[5] = instance->SUSP5R;
+  p_ctx->susp[6] = instance->SUSP6R;
+  p_ctx->susp[7] = instance->SUSP7R;
+  p_ctx->ivr[0] = instance->IVR0;
+  p_ctx->ivr[1] = instance->IVR1;
+  p_ctx->ivr[2] = instance->IVR2;
+  p_ctx->ivr[3] = instance->IVR3;
+  p_ctx->cr = instance->CR & (AES_CR_GCMPH | AES_CR_MODE);
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+
+  return kwe_aes_release(p_ctx->key_buffer, p_ctx->key_buffer_size);
+}
+
+/**
+  * @brief  Stop a multi-part AEAD operation after an SAES error: SAES is
+  *         disabled and the context wiped, the next calls fail.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @retval KWE_ERROR
+  */
+static KWE_StatusTypeDef KWE_AeadFail(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  CLEAR_BIT(hcryp.Instance->CR, AES_CR_EN);
+  (void) memset(p_ctx, 0, sizeof(KWE_AesAeadContextTypeDef));
+
+  return KWE_ERROR;
+}
+
+/**
+  * @brief  Run the SAES init phase of a multi-part AEAD operation, then
+  *         select its next phase and suspend it.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_iv : the GCM counter block J0 + 1 or the CCM block B0, in the
+  *         SAES word format.
+  * @param  phase : KWE_AEAD_PHASE_HEADER, or KWE_AEAD_PHASE_PAYLOAD for a CCM
+  *         operation without additional data.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadStart(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint32_t *p_iv,
+  uint32_t phase)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  AES_TypeDef *instance = NULL;
+
+  status = KWE_AeadResume(p_ctx);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  instance = hcryp.Instance;
+  instance->IVR3 = p_iv[0];
+  instance->IVR2 = p_iv[1];
+  instance->IVR1 = p_iv[2];
+  instance->IVR0 = p_iv[3];
+
+  /* Init phase: SAES computes the hash key, or authenticates B0 */
+  SET_BIT(instance->CR, AES_CR_EN);
+  if (KWE_AeadWait() != KWE_SUCCESS)
+  {
+    return KWE_AeadFail(p_ctx);
+  }
+  __HAL_CRYP_CLEAR_FLAG(&hcryp, CRYP_CLEAR_CCF);
+
+  MODIFY_REG(instance->CR, AES_CR_GCMPH, phase);
+  SET_BIT(instance->CR, AES_CR_EN);
+  p_ctx->started = 1U;
+
+  return KWE_AeadSuspend(p_ctx);
+}
+
+/**
+  * @brief  Authenticate additional data of a multi-part AEAD operation in
+  *         the SAES header phase, keeping the trailing bytes for the next call.
+  * @param  p_ctx : a pointer to the AEAD context, resumed in SAES.
+  * @param  p_input : a pointer to the additional data.
+  * @param  input_length : size of the additional data in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadAbsorbAd(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length)
+{
+  size_t copy_length;
+
+  while ((p_ctx->partial_length + input_length) >= KWE_AES_BLOCK_SIZE)
+  {
+    if (p_ctx->partial_length != 0U)
+    {
+      /* Complete the block left over by the previous call */
+      copy_length = KWE_AES_BLOCK_SIZE - p_ctx->partial_length;
+      (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, copy_length);
+      if (KWE_AeadBlock(p_ctx->partial, NULL) != KWE_SUCCESS)
+      {
+        return KWE_ERROR;
+      }
+      p_ctx->partial_length = 0U;
+    }
+    else
+    {
+      copy_length = KWE_AES_BLOCK_SIZE;
+      if (KWE_AeadBlock(p_input, NULL) != KWE_SUCCESS)
+      {
+        return KWE_ERROR;
+      }
+    }
+    p_input += copy_length;
+    input_length -= copy_length;
+  }
+
+  /* Keep the tail for the next call */
+  (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, input_length);
+  p_ctx->partial_length += input_length;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Close the additional data of a multi-part AEAD operation: the
+  *         last partial block is zero padded and SAES moves to the payload
+  *         phase.
+  * @param  p_ctx : a pointer to the AEAD context, resumed in SAES.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadCloseAd(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  if (p_ctx->body_started != 0U)
+  {
+    return KWE_SUCCESS;
+  }
+
+  if (p_ctx->partial_length != 0U)
+  {
+    (void) memset(&p_ctx->partial[p_ctx->partial_length], 0, KWE_AES_BLOCK_SIZE - p_ctx->partial_length);
+    if (KWE_AeadBlock(p_ctx->partial, NULL) != KWE_SUCCESS)
+    {
+      return KWE_ERROR;
+    }
+    p_ctx->partial_length = 0U;
+  }
+
+  MODIFY_REG(hcryp.Instance->CR, AES_CR_GCMPH, KWE_AEAD_PHASE_PAYLOAD);
+  p_ctx->body_started = 1U;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Start a GCM operation: SAES derives the hash key in its init phase
+  *         from the pre-counter block J0 = nonce || 0^31 || 1.
+  * @note   SAES only takes 96-bit nonces: other lengths would need GHASH, so
+  *         the hash key, outside SAES.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_nonce : a pointer to the nonce.
+  * @param  nonce_length : size of the nonce in bytes, 12.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadGcmStart(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_nonce, size_t nonce_length)
+{
+  uint32_t iv[KWE_AES_BLOCK_SIZE / 4U] = {0};
+  uint32_t i = 0;
+
+  if (nonce_length != 12U)
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  for (i = 0; i < 3U; i++)
+  {
+    GET_UINT32_BE(iv[i], p_nonce, 4U * i);
+  }
+
+  /* counter value must be set to 2 when processing the first block of payload */
+  iv[3] = 2U;
+
+  return KWE_AeadStart(p_ctx, iv, KWE_AEAD_PHASE_HEADER);
+}
+
+/**
+  * @brief  Start a CCM operation once both the nonce and the lengths are
+  *         known: SAES authenticates B0 in its init phase, and the encoded
+  *         additional data length is kept as the first header bytes.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+static KWE_StatusTypeDef KWE_AeadCcmStart(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  uint8_t block[KWE_AES_BLOCK_SIZE] = {0};
+  uint32_t iv[KWE_AES_BLOCK_SIZE / 4U] = {0};
+  size_t q = (KWE_AES_BLOCK_SIZE - 1U) - p_ctx->nonce_length;
+  size_t len_left = 0;
+  uint32_t i = 0;
+
+  /* B0 = flags || nonce || payload length */
+  block[0] = (uint8_t)(((p_ctx->ad_length > 0U) ? 0x40U : 0U) |
+                       (((p_ctx->tag_length - 2U) / 2U) << 3U) |
+                       (q - 1U));
+  (void) memcpy(&block[1], p_ctx->nonce, p_ctx->nonce_length);
+  for (i = 0, len_left = p_ctx->payload_length; i < q; i++, len_left >>= 8U)
+  {
+    block[15U - i] = (uint8_t)(len_left & 0xFFU);
+  }
+
+  if (len_left > 0U)
+  {
+    return KWE_ERROR;
+  }
+
+  for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+  {
+    GET_UINT32_BE(iv[i], block, 4U * i);
+  }
+
+  status = KWE_AeadStart(p_ctx, iv,
+                         (p_ctx->ad_length != 0U) ? KWE_AEAD_PHASE_HEADER : KWE_AEAD_PHASE_PAYLOAD);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  if (p_ctx->ad_length == 0U)
+  {
+    p_ctx->body_started = 1U;
+    return KWE_SUCCESS;
+  }
+
+  /* Additional data is prefixed with its encoded length */
+  if (p_ctx->ad_length < 0xFF00U)
+  {
+    p_ctx->partial[0] = (uint8_t)((p_ctx->ad_length >> 8U) & 0xFFU);
+    p_ctx->partial[1] = (uint8_t)(p_ctx->ad_length & 0xFFU);
+    p_ctx->partial_length = 2U;
+  }
+  else
+  {
+    p_ctx->partial[0] = 0xFFU;
+    p_ctx->partial[1] = 0xFEU;
+    PUT_UINT32_BE((uint32_t)p_ctx->ad_length, p_ctx->partial, 2U);
+    p_ctx->partial_length = 6U;
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Start a multi-part AES AEAD operation using a wrapped key.
+  * @note   The operation runs in SAES, its state is saved in the context and
+  *         SAES is released after every call, other SAES users can run
+  *         between two calls.
+  * @param  p_ctx : a pointer to the AEAD context to initialize.
+  * @param  alg : KWE_ALG_AES_GCM or KWE_ALG_AES_CCM.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @param  tag_length : tag length in bytes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadSetup(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  uint32_t tag_length,
+  const uint8_t *p_key_buffer, size_t key_buffer_size)
+{
+  (void) memset(p_ctx, 0, sizeof(KWE_AesAeadContextTypeDef));
+
+  if ((alg != KWE_ALG_AES_GCM) && (alg != KWE_ALG_AES_CCM))
+  {
+    return KWE_ERROR_NOT_SUPPORTED;
+  }
+
+  if ((tag_length < 4U) || (tag_length > KWE_AES_BLOCK_SIZE)
+      || ((alg == KWE_ALG_AES_CCM) && ((tag_length % 2U) != 0U)))
+  {
+    return KWE_ERROR;
+  }
+
+  if ((key_buffer_size <= KWE_IV_MAX_SIZE) || (key_buffer_size > KWE_AES_KEY_BUFFER_MAX_SIZE))
+  {
+    return KWE_ERROR;
+  }
+
+  (void) memcpy(p_ctx->key_buffer, p_key_buffer, key_buffer_size);
+  p_ctx->key_buffer_size = key_buffer_size;
+  p_ctx->alg = alg;
+  p_ctx->encrypt = (encrypt != 0U) ? 1U : 0U;
+  p_ctx->tag_length = tag_length;
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Set the nonce of a multi-part AES AEAD operation.
+  * @note   A CCM operation starts once its lengths are set as well.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_nonce : a pointer to the nonce.
+  * @param  nonce_length : size of the nonce in bytes, 7 to 13 for CCM.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadSetNonce(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_nonce, size_t nonce_length)
+{
+  if ((p_ctx->started != 0U) || (p_ctx->nonce_length != 0U) || (nonce_length == 0U))
+  {
+    return KWE_ERROR;
+  }
+
+  if (p_ctx->alg == KWE_ALG_AES_GCM)
+  {
+    return KWE_AeadGcmStart(p_ctx, p_nonce, nonce_length);
+  }
+
+  if ((nonce_length < 7U) || (nonce_length > 13U))
+  {
+    return KWE_ERROR;
+  }
+
+  (void) memcpy(p_ctx->nonce, p_nonce, nonce_length);
+  p_ctx->nonce_length = nonce_length;
+
+  if (p_ctx->lengths_set != 0U)
+  {
+    return KWE_AeadCcmStart(p_ctx);
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Set the additional data and payload lengths of a multi-part AES
+  *         AEAD operation, mandatory for CCM.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  ad_length : size of the additional data in bytes.
+  * @param  plaintext_length : size of the payload in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadSetLengths(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  size_t ad_length,
+  size_t plaintext_length)
+{
+  if (p_ctx->alg == KWE_ALG_AES_GCM)
+  {
+    /* GCM counts the lengths as data goes */
+    return KWE_SUCCESS;
+  }
+
+  if ((p_ctx->started != 0U) || (p_ctx->lengths_set != 0U))
+  {
+    return KWE_ERROR;
+  }
+
+  p_ctx->ad_length = ad_length;
+  p_ctx->payload_length = plaintext_length;
+  p_ctx->lengths_set = 1U;
+
+  if (p_ctx->nonce_length != 0U)
+  {
+    return KWE_AeadCcmStart(p_ctx);
+  }
+
+  return KWE_SUCCESS;
+}
+
+/**
+  * @brief  Pass additional data to a multi-part AES AEAD operation.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_input : a pointer to the additional data.
+  * @param  input_length : size of the additional data in bytes.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadUpdateAd(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+
+  if ((p_ctx->started == 0U) || (p_ctx->body_started != 0U))
+  {
+    return KWE_ERROR;
+  }
+
+  if (p_ctx->alg == KWE_ALG_AES_GCM)
+  {
+    p_ctx->ad_length += input_length;
+  }
+
+  /* Not enough data for a block yet: SAES is left untouched */
+  if ((p_ctx->partial_length + input_length) < KWE_AES_BLOCK_SIZE)
+  {
+    (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, input_length);
+    p_ctx->partial_length += input_length;
+    return KWE_SUCCESS;
+  }
+
+  status = KWE_AeadResume(p_ctx);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  if (KWE_AeadAbsorbAd(p_ctx, p_input, input_length) != KWE_SUCCESS)
+  {
+    return KWE_AeadFail(p_ctx);
+  }
+
+  return KWE_AeadSuspend(p_ctx);
+}
+
+/**
+  * @brief  Encrypt or decrypt a chunk of a multi-part AES AEAD operation.
+  * @note   Only whole blocks are output, up to KWE_AES_BLOCK_SIZE - 1
+  *         trailing bytes are kept in the context for the next call.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_input : a pointer to the input data.
+  * @param  input_length : size of the input data in bytes.
+  * @param  p_output : a pointer to the output buffer.
+  * @param  output_size : size of the output buffer in bytes.
+  * @param  p_output_length : the number of bytes written to p_output.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadUpdate(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  uint8_t block[KWE_AES_BLOCK_SIZE];
+  size_t copy_length;
+  size_t block_length;
+  *p_output_length = 0U;
+
+  if (p_ctx->started == 0U)
+  {
+    return KWE_ERROR;
+  }
+
+  block_length = (p_ctx->body_started != 0U) ? p_ctx->partial_length : 0U;
+  block_length = ((block_length + input_length) / KWE_AES_BLOCK_SIZE) * KWE_AES_BLOCK_SIZE;
+  if (output_size < block_length)
+  {
+    return KWE_ERROR;
+  }
+
+  if (p_ctx->alg == KWE_ALG_AES_GCM)
+  {
+    p_ctx->payload_length += input_length;
+  }
+
+  /* Not enough data for a block yet: SAES is left untouched */
+  if ((block_length == 0U) && (p_ctx->body_started != 0U))
+  {
+    (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, input_length);
+    p_ctx->partial_length += input_length;
+    return KWE_SUCCESS;
+  }
+
+  status = KWE_AeadResume(p_ctx);
+  if (status != KWE_SUCCESS)
+  {
+    return status;
+  }
+
+  if (KWE_AeadCloseAd(p_ctx) != KWE_SUCCESS)
+  {
+    return KWE_AeadFail(p_ctx);
+  }
+
+  while ((p_ctx->partial_length + input_length) >= KWE_AES_BLOCK_SIZE)
+  {
+    copy_length = KWE_AES_BLOCK_SIZE - p_ctx->partial_length;
+    (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, copy_length);
+    (void) memcpy(block, p_ctx->partial, KWE_AES_BLOCK_SIZE);
+    p_input += copy_length;
+    input_length -= copy_length;
+
+    /* Keep the bytes of the next block before an in-place output overwrites them */
+    copy_length = (input_length < p_ctx->partial_length) ? input_length : p_ctx->partial_length;
+    (void) memcpy(p_ctx->partial, p_input, copy_length);
+    p_ctx->partial_length = copy_length;
+    p_input += copy_length;
+    input_length -= copy_length;
+
+    if (KWE_AeadBlock(block, p_output) != KWE_SUCCESS)
+    {
+      (void) memset(block, 0, sizeof(block));
+      return KWE_AeadFail(p_ctx);
+    }
+    p_output += KWE_AES_BLOCK_SIZE;
+    *p_output_length += KWE_AES_BLOCK_SIZE;
+  }
+
+  /* Keep the tail for the next update */
+  (void) memcpy(&p_ctx->partial[p_ctx->partial_length], p_input, input_length);
+  p_ctx->partial_length += input_length;
+  (void) memset(block, 0, sizeof(block));
+
+  return KWE_AeadSuspend(p_ctx);
+}
+
+/**
+  * @brief  Finish a multi-part AES AEAD operation: output the remaining
+  *         payload bytes and the tag computed by SAES, then wipe the context.
+  * @note   A decryption compares the returned tag with the expected one.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @param  p_output : a pointer to the output buffer.
+  * @param  output_size : size of the output buffer in bytes.
+  * @param  p_output_length : the number of bytes written to p_output.
+  * @param  p_tag : a pointer to the tag buffer.
+  * @param  tag_size : size of the tag buffer in bytes.
+  * @param  p_tag_length : the number of bytes written to p_tag.
+  * @retval KWE_SUCCESS if success, an error code otherwise
+  */
+KWE_StatusTypeDef KWE_AesAeadFinish(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length,
+  uint8_t *p_tag, size_t tag_size, size_t *p_tag_length)
+{
+  KWE_StatusTypeDef status = KWE_ERROR;
+  AES_TypeDef *instance = NULL;
+  uint8_t block[KWE_AES_BLOCK_SIZE] = {0};
+  uint32_t lengths[KWE_AES_BLOCK_SIZE / 4U];
+  uint64_t bit_length;
+  size_t remaining;
+  uint32_t i = 0;
+  *p_output_length = 0U;
+  *p_tag_length = 0U;
+
+  remaining = (p_ctx->body_started != 0U) ? p_ctx->partial_length : 0U;
+  if ((p_ctx->started == 0U) || (tag_size < p_ctx->tag_length) || (output_size < remaining))
+  {
+    goto exit;
+  }
+
+  status = KWE_AeadResume(p_ctx);
+  if (status != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+  status = KWE_ERROR;
+  instance = hcryp.Instance;
+
+  if (KWE_AeadCloseAd(p_ctx) != KWE_SUCCESS)
+  {
+    goto error;
+  }
+
+  /* Last partial payload block, zero padded. SAES authenticates its padding
+   * as zeros: when the MAC is over the output, NPBLB masks it */
+  if (remaining != 0U)
+  {
+    (void) memcpy(block, p_ctx->partial, remaining);
+    if ((p_ctx->alg == KWE_ALG_AES_GCM) == (p_ctx->encrypt != 0U))
+    {
+      MODIFY_REG(instance->CR, AES_CR_NPBLB, (KWE_AES_BLOCK_SIZE - remaining) << AES_CR_NPBLB_Pos);
+    }
+
+    if (KWE_AeadBlock(block, block) != KWE_SUCCESS)
+    {
+      goto error;
+    }
+    (void) memcpy(p_output, block, remaining);
+  }
+
+  /* Final phase: SAES outputs the tag */
+  if (p_ctx->alg == KWE_ALG_AES_GCM)
+  {
+    MODIFY_REG(instance->CR, AES_CR_GCMPH | AES_CR_MODE, KWE_AEAD_PHASE_FINAL);
+
+    /* len(A) || len(C) in bits */
+    bit_length = (uint64_t) p_ctx->ad_length * 8U;
+    lengths[0] = (uint32_t)(bit_length >> 32U);
+    lengths[1] = (uint32_t) bit_length;
+    bit_length = (uint64_t) p_ctx->payload_length * 8U;
+    lengths[2] = (uint32_t)(bit_length >> 32U);
+    lengths[3] = (uint32_t) bit_length;
+    for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+    {
+      instance->DINR = lengths[i];
+    }
+  }
+  else
+  {
+    MODIFY_REG(instance->CR, AES_CR_GCMPH, KWE_AEAD_PHASE_FINAL);
+  }
+
+  if (KWE_AeadWait() != KWE_SUCCESS)
+  {
+    goto error;
+  }
+
+  for (i = 0; i < (KWE_AES_BLOCK_SIZE / 4U); i++)
+  {
+    lengths[i] = instance->DOUTR;
+  }
+  __HAL_CRYP_CLEAR_FLAG(&hcryp, CRYP_CLEAR_CCF);
+  CLEAR_BIT(instance->CR, AES_CR_EN);
+
+  (void) memcpy(p_tag, lengths, p_ctx->tag_length);
+  (void) memset(lengths, 0, sizeof(lengths));
+
+  if (kwe_aes_release(p_ctx->key_buffer, p_ctx->key_buffer_size) != KWE_SUCCESS)
+  {
+    goto exit;
+  }
+
+  *p_output_length = remaining;
+  *p_tag_length = p_ctx->tag_length;
+  status = KWE_SUCCESS;
+  goto exit;
+
+error:
+  (void) KWE_AeadFail(p_ctx);
+
+exit:
+  (void) memset(block, 0, sizeof(block));
+  (void) memset(p_ctx, 0, sizeof(KWE_AesAeadContextTypeDef));
+
+  return status;
+}
+
+/**
+  * @brief  Abort a multi-part AES AEAD operation and wipe its context.
+  * @param  p_ctx : a pointer to the AEAD context.
+  * @retval None
+  */
+void KWE_AesAeadAbort(KWE_AesAeadContextTypeDef *p_ctx)
+{
+  (void) memset(p_ctx, 0, sizeof(KWE_AesAeadContextTypeDef));
+}
+
+/**
+  * @brief  Forget the wrapped AES key left in the SAES key registers, the next
+  *         AES operation unwraps its key again.
+  * @note   This API is to be called before any use of SAES outside of KWE and
+  *         before entering a low power mode that does not retain SAES.
+  * @param  None
+  * @retval None
+  */
+void KWE_AesKeyInvalidate(void)
+{
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+  kwe_aes_resident.valid = 0U;
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
+
+  /* SAES is no longer configured for provisioning key wrap */
+  kwe_provision.aes_key_size = 0U;
+
+  KWE_AesKeyInvalidateCallback();
+}
+
+/**
+  * @brief  SAES key registers are about to be reprogrammed by the KWE, or
+  *         have been lost.
+  * @note   This function should not be modified, when the callback is
+  *         needed, KWE_AesKeyInvalidateCallback could be implemented in the
+  *         user file, e.g. by a driver keeping its own key loaded in SAES.
+  * @param  None
+  * @retval None
+  */
+__weak void KWE_AesKeyInvalidateCallback(void)
+{
+}
+
+/**
+  * @brief  Drop a wrapped AES key being destroyed: if it is the resident key,
+  *         SAES is de-initialized so that it cannot be used anymore.
+  * @param  p_key_buffer : a pointer to the wrapped key and IV.
+  * @param  key_buffer_size : size of the wrapped key and IV in bytes.
+  * @retval None
+  */
+void KWE_AesKeyDestroy(
+  const uint8_t *p_key_buffer,
+  size_t key_buffer_size)
+{
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+  if ((kwe_aes_resident.valid != 0U)
+      && (kwe_aes_resident.key_buffer_size == key_buffer_size)
+      && (memcmp(kwe_aes_resident.key_buffer, p_key_buffer, key_buffer_size) == 0))
+  {
+    (void) memset(&kwe_aes_resident, 0, sizeof(kwe_aes_resident));
+    (void) HAL_CRYP_DeInit(&hcryp);
+  }
+#else
+  UNUSED(p_key_buffer);
+  UNUSED(key_buffer_size);
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
 }
 
 /**
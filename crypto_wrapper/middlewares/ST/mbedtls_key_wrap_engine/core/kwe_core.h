@@ -78,6 +78,36 @@ KWE_StatusTypeDef KWE_Init(void);
 
 int32_t KWE_GetVersion(void);
 
+void KWE_SetWorkspace(KWE_WorkspaceTypeDef *p_workspace);
+
+KWE_WorkspaceTypeDef *KWE_GetWorkspace(void);
+
+KWE_WorkspaceTypeDef *KWE_WorkspaceAcquire(void);
+
+void KWE_WorkspaceRelease(void);
+
+void KWE_WorkspaceLockCallback(void);
+
+void KWE_WorkspaceUnlockCallback(void);
+
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+KWE_StatusTypeDef KWE_CcbSessionOpen(void);
+
+KWE_StatusTypeDef KWE_CcbSessionClose(void);
+
+void KWE_CcbSessionPoll(void);
+
+void KWE_CcbSessionGetStats(KWE_SessionStatsTypeDef *p_stats);
+
+void KWE_CcbSessionResetStats(void);
+
+void KWE_CcbSessionIdleCallback(void);
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
+
+KWE_StatusTypeDef KWE_ProvisionBegin(void);
+
+KWE_StatusTypeDef KWE_ProvisionEnd(void);
+
 /**
   * @}
   */
@@ -155,6 +185,14 @@ KWE_StatusTypeDef KWE_EcdsaSignHash(
   size_t signature_size,
   size_t *p_signature_length);
 
+KWE_StatusTypeDef KWE_EcdsaSignHashBatch(
+  KWE_EcpTypeDef *p_ecp,
+  const uint8_t *p_key_buffer,
+  const uint8_t *p_hashes,
+  uint32_t hash_count,
+  uint8_t *p_signatures,
+  size_t signatures_size,
+  size_t *p_signatures_length);
 
 KWE_StatusTypeDef KWE_RsaModularExp(
   KWE_RsaTypeDef *p_rsa,
@@ -210,6 +248,81 @@ KWE_StatusTypeDef KWE_AesDecrypt(
   const uint8_t *input, size_t input_length,
   uint8_t *output, size_t output_size, size_t *output_length);
 
+KWE_StatusTypeDef KWE_AesCipherSetup(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  const uint8_t *p_key_buffer, size_t key_buffer_size);
+
+KWE_StatusTypeDef KWE_AesCipherSetIv(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_iv, size_t iv_length);
+
+KWE_StatusTypeDef KWE_AesCipherUpdate(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+KWE_StatusTypeDef KWE_AesCipherFinish(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+void KWE_AesCipherAbort(KWE_AesCipherContextTypeDef *p_ctx);
+
+#if defined(KWE_AES_ASYNC_ENABLED)
+KWE_StatusTypeDef KWE_AesCipherUpdateAsync(
+  KWE_AesCipherContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output,
+  KWE_AsyncCallbackTypeDef callback, void *p_context);
+
+void KWE_AesAsyncIRQHandler(void);
+
+void KWE_AesAsyncProcess(void);
+
+void KWE_AesAsyncScheduleCallback(void);
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+KWE_StatusTypeDef KWE_AesAeadSetup(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  KWE_AlgTypeDef alg,
+  uint32_t encrypt,
+  uint32_t tag_length,
+  const uint8_t *p_key_buffer, size_t key_buffer_size);
+
+KWE_StatusTypeDef KWE_AesAeadSetNonce(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_nonce, size_t nonce_length);
+
+KWE_StatusTypeDef KWE_AesAeadSetLengths(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  size_t ad_length,
+  size_t plaintext_length);
+
+KWE_StatusTypeDef KWE_AesAeadUpdateAd(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length);
+
+KWE_StatusTypeDef KWE_AesAeadUpdate(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+KWE_StatusTypeDef KWE_AesAeadFinish(
+  KWE_AesAeadContextTypeDef *p_ctx,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length,
+  uint8_t *p_tag, size_t tag_size, size_t *p_tag_length);
+
+void KWE_AesAeadAbort(KWE_AesAeadContextTypeDef *p_ctx);
+
+void KWE_AesKeyInvalidate(void);
+
+void KWE_AesKeyInvalidateCallback(void);
+
+void KWE_AesKeyDestroy(
+  const uint8_t *key_buffer,
+  size_t key_buffer_size);
+
 /**
   * @}
   */
@@ -25,6 +25,10 @@ extern "C" {
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED)
+/* The workspace layout follows the enabled Mbed TLS algorithms */
+#include "mbedtls/build_info.h"
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED */
 
 /** @addtogroup KWE_MODULES
   * @{
@@ -49,6 +53,7 @@ typedef enum
   KWE_WRONG_KEY_TYPE               = 0x02U,
   KWE_STORAGE_ERROR                = 0x03U,
   KWE_ERROR_NOT_SUPPORTED          = 0x04U,
+  KWE_ERROR_BUSY                   = 0x05U,
 } KWE_StatusTypeDef;
 /**
   * @}
@@ -65,6 +70,7 @@ typedef enum
   KWE_ALG_AES_CCM                      = 0x03U,
   KWE_ALG_AES_CBC                      = 0x04U,
   KWE_ALG_AES_ECB                      = 0x05U,
+  KWE_ALG_AES_CTR                      = 0x06U,
 } KWE_AlgTypeDef;
 /**
   * @}
@@ -105,6 +111,103 @@ typedef struct
   * @}
   */
 
+/** @defgroup CORE_Session_Statistics CORE Session Statistics
+  * @{
+  */
+typedef struct
+{
+  uint32_t init_count;       /*!< Number of HAL_CCB_Init transitions */
+  uint32_t deinit_count;     /*!< Number of HAL_CCB_DeInit transitions */
+  uint32_t op_count;         /*!< Number of operations run on the CCB */
+  uint32_t setup_ticks;      /*!< Time spent bringing up the CCB */
+  uint32_t compute_ticks;    /*!< Time spent in CCB operations */
+} KWE_SessionStatsTypeDef;
+/**
+  * @}
+  */
+
+/** @defgroup CORE_AES_Cipher_Context CORE AES Cipher Context
+  * @{
+  */
+#define KWE_AES_BLOCK_SIZE              (16U)  /*!< AES block size in bytes */
+#define KWE_AES_KEY_BUFFER_MAX_SIZE     (48U)  /*!< IV and wrapped AES-256 key */
+
+typedef struct
+{
+  KWE_AlgTypeDef alg;                              /*!< KWE_ALG_AES_ECB, _CBC or _CTR */
+  uint32_t encrypt;                                /*!< 1U to encrypt, 0U to decrypt */
+  uint32_t iv_set;                                 /*!< 1U once the IV has been loaded */
+  uint32_t chaining[KWE_AES_BLOCK_SIZE / 4U];      /*!< IV or counter of the next block */
+  uint8_t partial[KWE_AES_BLOCK_SIZE];             /*!< Input bytes not processed yet */
+  size_t partial_length;                           /*!< Number of bytes in partial */
+  uint8_t key_buffer[KWE_AES_KEY_BUFFER_MAX_SIZE]; /*!< Wrapped key blob (IV and key) */
+  size_t key_buffer_size;                          /*!< Size of the wrapped key blob */
+} KWE_AesCipherContextTypeDef;
+
+/**
+  * @brief Completion callback of an asynchronous AES operation, run in
+  *        thread context by KWE_AesAsyncProcess()
+  */
+typedef void (*KWE_AsyncCallbackTypeDef)(KWE_StatusTypeDef status, void *p_context);
+/**
+  * @}
+  */
+
+/** @defgroup CORE_AES_AEAD_Context CORE AES AEAD Context
+  * @{
+  */
+typedef struct
+{
+  KWE_AlgTypeDef alg;                              /*!< KWE_ALG_AES_GCM or _CCM */
+  uint32_t encrypt;                                /*!< 1U to encrypt, 0U to decrypt */
+  uint32_t tag_length;                             /*!< Tag length in bytes */
+  uint32_t started;                                /*!< 1U once the SAES init phase has run */
+  uint32_t body_started;                           /*!< 1U once the AAD has been closed */
+  uint32_t lengths_set;                            /*!< 1U once CCM lengths are known */
+  uint32_t cr;                                     /*!< Phase and mode fields of the SAES CR */
+  uint32_t susp[8];                                /*!< GHASH or CBC-MAC state (SAES SUSPxR) */
+  uint32_t ivr[KWE_AES_BLOCK_SIZE / 4U];           /*!< Counter block (SAES IVRx) */
+  uint8_t nonce[KWE_AES_BLOCK_SIZE];               /*!< CCM nonce, kept until lengths are set */
+  size_t nonce_length;                             /*!< Size of the CCM nonce */
+  uint8_t partial[KWE_AES_BLOCK_SIZE];             /*!< AAD or payload bytes not processed yet */
+  size_t partial_length;                           /*!< Number of bytes in partial */
+  size_t ad_length;                                /*!< AAD bytes received, or expected for CCM */
+  size_t payload_length;                           /*!< Payload bytes received, or expected for CCM */
+  uint8_t key_buffer[KWE_AES_KEY_BUFFER_MAX_SIZE]; /*!< Wrapped key blob (IV and key) */
+  size_t key_buffer_size;                          /*!< Size of the wrapped key blob */
+} KWE_AesAeadContextTypeDef;
+/**
+  * @}
+  */
+
+/** @defgroup CORE_Workspace CORE Workspace
+  * @{
+  */
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDSA_C)
+#if (KWE_ECDSA_BATCH_SIZE > 1U)
+#define KWE_WORKSPACE_DIGEST_COUNT      (KWE_ECDSA_BATCH_SIZE) /*!< ECDSA digests signed in one CCB session */
+#else
+#define KWE_WORKSPACE_DIGEST_COUNT      (1U)                   /*!< Batches signed one digest at a time */
+#endif /* KWE_ECDSA_BATCH_SIZE */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDSA_C */
+
+typedef struct
+{
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDSA_C)
+  uint32_t digest[(KWE_WORKSPACE_DIGEST_COUNT * KWE_WORKSPACE_ECC_MAX_SIZE + 3U) / 4U]; /*!< ECDSA digests fitted to the curve order */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDSA_C */
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDH_C)
+  uint32_t ecc_point[(2U * KWE_WORKSPACE_ECC_MAX_SIZE + 3U) / 4U]; /*!< ECDH shared point X and Y */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDH_C */
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_RSA_C)
+  uint32_t rsa_block[(KWE_WORKSPACE_RSA_MAX_SIZE + 3U) / 4U];      /*!< RSA encoded message */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_RSA_C */
+  uint32_t reserved;                                               /*!< Keeps the workspace non-empty */
+} KWE_WorkspaceTypeDef;
+/**
+  * @}
+  */
+
 /**
   * @}
   */
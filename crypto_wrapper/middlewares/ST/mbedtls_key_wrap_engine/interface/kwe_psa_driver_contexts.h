@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    kwe_psa_driver_contexts.h
+  * @author  MCD Application Team
+  * @brief   Multi-part operation contexts of the KWE PSA opaque driver
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef KWE_PSA_DRIVER_CONTEXTS_H
+#define KWE_PSA_DRIVER_CONTEXTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <psa/crypto_driver_common.h>
+#include "kwe_types.h"
+
+/** @addtogroup KWE_MODULES
+  * @{
+  */
+
+/** @addtogroup INTERFACE
+  * @brief
+  * @{
+  */
+#if defined(PSA_KWE_DRIVER_ENABLED)
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup INTERFACE_Exported_Types INTERFACE Exported Types
+  * @{
+  */
+
+/**
+  * @brief KWE opaque driver cipher operation, member kwe_opaque_ctx of
+  *        psa_driver_cipher_context_t
+  */
+typedef KWE_AesCipherContextTypeDef mbedtls_kwe_opaque_cipher_operation_t;
+
+/**
+  * @brief KWE opaque driver AEAD operation, member kwe_opaque_ctx of
+  *        psa_driver_aead_context_t
+  */
+typedef KWE_AesAeadContextTypeDef mbedtls_kwe_opaque_aead_operation_t;
+
+/**
+  * @}
+  */
+
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*KWE_PSA_DRIVER_CONTEXTS_H */
@@ -0,0 +1,539 @@
+/**
+  ******************************************************************************
+  * @file    kwe_psa_driver_curves.c
+  * @author  MCD Application Team
+  * @brief   Elliptic curve parameters of STM32 KWE Middleware interface module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "psa/crypto.h"
+#include "kwe_psa_driver_curves.h"
+
+/** @addtogroup KWE_MODULES
+  * @{
+  */
+
+/** @addtogroup INTERFACE
+  * @brief
+  * @{
+  */
+
+#if defined(PSA_KWE_DRIVER_ENABLED)
+
+/* Global variables ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/**
+  * Curve parameters entry, selected by PSA family and key size
+  */
+typedef struct
+{
+  psa_ecc_family_t family;   /*!< PSA elliptic curve family */
+  size_t bits;               /*!< Curve size in bits, 0 ends the table */
+  KWE_EcpTypeDef ecp;        /*!< KWE curve parameters */
+} kwe_ecp_curve_t;
+
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*
+ * Curve coefficients in big endian, as expected by the CCB.
+ * A coefficient is given as its absolute value with a_sign set to 1 when
+ * negative (A = -3 on NIST curves).
+ */
+#if defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+/* NIST P-256 */
+static const uint8_t kwe_secp256r1_p[] =
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+static const uint8_t kwe_secp256r1_a_abs[] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03
+};
+static const uint8_t kwe_secp256r1_b[] =
+{
+  0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7,
+  0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+  0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6,
+  0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B
+};
+static const uint8_t kwe_secp256r1_gx[] =
+{
+  0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47,
+  0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+  0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0,
+  0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96
+};
+static const uint8_t kwe_secp256r1_gy[] =
+{
+  0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B,
+  0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+  0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE,
+  0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5
+};
+static const uint8_t kwe_secp256r1_n[] =
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84,
+  0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+};
+#endif /* MBEDTLS_ECP_DP_SECP256R1_ENABLED */
+
+#if defined(MBEDTLS_ECP_DP_SECP384R1_ENABLED)
+/* NIST P-384 */
+static const uint8_t kwe_secp384r1_p[] =
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF
+};
+static const uint8_t kwe_secp384r1_a_abs[] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03
+};
+static const uint8_t kwe_secp384r1_b[] =
+{
+  0xB3, 0x31, 0x2F, 0xA7, 0xE2, 0x3E, 0xE7, 0xE4,
+  0x98, 0x8E, 0x05, 0x6B, 0xE3, 0xF8, 0x2D, 0x19,
+  0x18, 0x1D, 0x9C, 0x6E, 0xFE, 0x81, 0x41, 0x12,
+  0x03, 0x14, 0x08, 0x8F, 0x50, 0x13, 0x87, 0x5A,
+  0xC6, 0x56, 0x39, 0x8D, 0x8A, 0x2E, 0xD1, 0x9D,
+  0x2A, 0x85, 0xC8, 0xED, 0xD3, 0xEC, 0x2A, 0xEF
+};
+static const uint8_t kwe_secp384r1_gx[] =
+{
+  0xAA, 0x87, 0xCA, 0x22, 0xBE, 0x8B, 0x05, 0x37,
+  0x8E, 0xB1, 0xC7, 0x1E, 0xF3, 0x20, 0xAD, 0x74,
+  0x6E, 0x1D, 0x3B, 0x62, 0x8B, 0xA7, 0x9B, 0x98,
+  0x59, 0xF7, 0x41, 0xE0, 0x82, 0x54, 0x2A, 0x38,
+  0x55, 0x02, 0xF2, 0x5D, 0xBF, 0x55, 0x29, 0x6C,
+  0x3A, 0x54, 0x5E, 0x38, 0x72, 0x76, 0x0A, 0xB7
+};
+static const uint8_t kwe_secp384r1_gy[] =
+{
+  0x36, 0x17, 0xDE, 0x4A, 0x96, 0x26, 0x2C, 0x6F,
+  0x5D, 0x9E, 0x98, 0xBF, 0x92, 0x92, 0xDC, 0x29,
+  0xF8, 0xF4, 0x1D, 0xBD, 0x28, 0x9A, 0x14, 0x7C,
+  0xE9, 0xDA, 0x31, 0x13, 0xB5, 0xF0, 0xB8, 0xC0,
+  0x0A, 0x60, 0xB1, 0xCE, 0x1D, 0x7E, 0x81, 0x9D,
+  0x7A, 0x43, 0x1D, 0x7C, 0x90, 0xEA, 0x0E, 0x5F
+};
+static const uint8_t kwe_secp384r1_n[] =
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xC7, 0x63, 0x4D, 0x81, 0xF4, 0x37, 0x2D, 0xDF,
+  0x58, 0x1A, 0x0D, 0xB2, 0x48, 0xB0, 0xA7, 0x7A,
+  0xEC, 0xEC, 0x19, 0x6A, 0xCC, 0xC5, 0x29, 0x73
+};
+#endif /* MBEDTLS_ECP_DP_SECP384R1_ENABLED */
+
+#if defined(MBEDTLS_ECP_DP_SECP521R1_ENABLED)
+/* NIST P-521 */
+static const uint8_t kwe_secp521r1_p[] =
+{
+  0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF
+};
+static const uint8_t kwe_secp521r1_a_abs[] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x03
+};
+static const uint8_t kwe_secp521r1_b[] =
+{
+  0x00, 0x51, 0x95, 0x3E, 0xB9, 0x61, 0x8E, 0x1C,
+  0x9A, 0x1F, 0x92, 0x9A, 0x21, 0xA0, 0xB6, 0x85,
+  0x40, 0xEE, 0xA2, 0xDA, 0x72, 0x5B, 0x99, 0xB3,
+  0x15, 0xF3, 0xB8, 0xB4, 0x89, 0x91, 0x8E, 0xF1,
+  0x09, 0xE1, 0x56, 0x19, 0x39, 0x51, 0xEC, 0x7E,
+  0x93, 0x7B, 0x16, 0x52, 0xC0, 0xBD, 0x3B, 0xB1,
+  0xBF, 0x07, 0x35, 0x73, 0xDF, 0x88, 0x3D, 0x2C,
+  0x34, 0xF1, 0xEF, 0x45, 0x1F, 0xD4, 0x6B, 0x50,
+  0x3F, 0x00
+};
+static const uint8_t kwe_secp521r1_gx[] =
+{
+  0x00, 0xC6, 0x85, 0x8E, 0x06, 0xB7, 0x04, 0x04,
+  0xE9, 0xCD, 0x9E, 0x3E, 0xCB, 0x66, 0x23, 0x95,
+  0xB4, 0x42, 0x9C, 0x64, 0x81, 0x39, 0x05, 0x3F,
+  0xB5, 0x21, 0xF8, 0x28, 0xAF, 0x60, 0x6B, 0x4D,
+  0x3D, 0xBA, 0xA1, 0x4B, 0x5E, 0x77, 0xEF, 0xE7,
+  0x59, 0x28, 0xFE, 0x1D, 0xC1, 0x27, 0xA2, 0xFF,
+  0xA8, 0xDE, 0x33, 0x48, 0xB3, 0xC1, 0x85, 0x6A,
+  0x42, 0x9B, 0xF9, 0x7E, 0x7E, 0x31, 0xC2, 0xE5,
+  0xBD, 0x66
+};
+static const uint8_t kwe_secp521r1_gy[] =
+{
+  0x01, 0x18, 0x39, 0x29, 0x6A, 0x78, 0x9A, 0x3B,
+  0xC0, 0x04, 0x5C, 0x8A, 0x5F, 0xB4, 0x2C, 0x7D,
+  0x1B, 0xD9, 0x98, 0xF5, 0x44, 0x49, 0x57, 0x9B,
+  0x44, 0x68, 0x17, 0xAF, 0xBD, 0x17, 0x27, 0x3E,
+  0x66, 0x2C, 0x97, 0xEE, 0x72, 0x99, 0x5E, 0xF4,
+  0x26, 0x40, 0xC5, 0x50, 0xB9, 0x01, 0x3F, 0xAD,
+  0x07, 0x61, 0x35, 0x3C, 0x70, 0x86, 0xA2, 0x72,
+  0xC2, 0x40, 0x88, 0xBE, 0x94, 0x76, 0x9F, 0xD1,
+  0x66, 0x50
+};
+static const uint8_t kwe_secp521r1_n[] =
+{
+  0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFA, 0x51, 0x86, 0x87, 0x83, 0xBF, 0x2F,
+  0x96, 0x6B, 0x7F, 0xCC, 0x01, 0x48, 0xF7, 0x09,
+  0xA5, 0xD0, 0x3B, 0xB5, 0xC9, 0xB8, 0x89, 0x9C,
+  0x47, 0xAE, 0xBB, 0x6F, 0xB7, 0x1E, 0x91, 0x38,
+  0x64, 0x09
+};
+#endif /* MBEDTLS_ECP_DP_SECP521R1_ENABLED */
+
+#if defined(MBEDTLS_ECP_DP_BP256R1_ENABLED)
+/* Brainpool P256r1 */
+static const uint8_t kwe_bp256r1_p[] =
+{
+  0xA9, 0xFB, 0x57, 0xDB, 0xA1, 0xEE, 0xA9, 0xBC,
+  0x3E, 0x66, 0x0A, 0x90, 0x9D, 0x83, 0x8D, 0x72,
+  0x6E, 0x3B, 0xF6, 0x23, 0xD5, 0x26, 0x20, 0x28,
+  0x20, 0x13, 0x48, 0x1D, 0x1F, 0x6E, 0x53, 0x77
+};
+static const uint8_t kwe_bp256r1_a_abs[] =
+{
+  0x7D, 0x5A, 0x09, 0x75, 0xFC, 0x2C, 0x30, 0x57,
+  0xEE, 0xF6, 0x75, 0x30, 0x41, 0x7A, 0xFF, 0xE7,
+  0xFB, 0x80, 0x55, 0xC1, 0x26, 0xDC, 0x5C, 0x6C,
+  0xE9, 0x4A, 0x4B, 0x44, 0xF3, 0x30, 0xB5, 0xD9
+};
+static const uint8_t kwe_bp256r1_b[] =
+{
+  0x26, 0xDC, 0x5C, 0x6C, 0xE9, 0x4A, 0x4B, 0x44,
+  0xF3, 0x30, 0xB5, 0xD9, 0xBB, 0xD7, 0x7C, 0xBF,
+  0x95, 0x84, 0x16, 0x29, 0x5C, 0xF7, 0xE1, 0xCE,
+  0x6B, 0xCC, 0xDC, 0x18, 0xFF, 0x8C, 0x07, 0xB6
+};
+static const uint8_t kwe_bp256r1_gx[] =
+{
+  0x8B, 0xD2, 0xAE, 0xB9, 0xCB, 0x7E, 0x57, 0xCB,
+  0x2C, 0x4B, 0x48, 0x2F, 0xFC, 0x81, 0xB7, 0xAF,
+  0xB9, 0xDE, 0x27, 0xE1, 0xE3, 0xBD, 0x23, 0xC2,
+  0x3A, 0x44, 0x53, 0xBD, 0x9A, 0xCE, 0x32, 0x62
+};
+static const uint8_t kwe_bp256r1_gy[] =
+{
+  0x54, 0x7E, 0xF8, 0x35, 0xC3, 0xDA, 0xC4, 0xFD,
+  0x97, 0xF8, 0x46, 0x1A, 0x14, 0x61, 0x1D, 0xC9,
+  0xC2, 0x77, 0x45, 0x13, 0x2D, 0xED, 0x8E, 0x54,
+  0x5C, 0x1D, 0x54, 0xC7, 0x2F, 0x04, 0x69, 0x97
+};
+static const uint8_t kwe_bp256r1_n[] =
+{
+  0xA9, 0xFB, 0x57, 0xDB, 0xA1, 0xEE, 0xA9, 0xBC,
+  0x3E, 0x66, 0x0A, 0x90, 0x9D, 0x83, 0x8D, 0x71,
+  0x8C, 0x39, 0x7A, 0xA3, 0xB5, 0x61, 0xA6, 0xF7,
+  0x90, 0x1E, 0x0E, 0x82, 0x97, 0x48, 0x56, 0xA7
+};
+#endif /* MBEDTLS_ECP_DP_BP256R1_ENABLED */
+
+#if defined(MBEDTLS_ECP_DP_BP384R1_ENABLED)
+/* Brainpool P384r1 */
+static const uint8_t kwe_bp384r1_p[] =
+{
+  0x8C, 0xB9, 0x1E, 0x82, 0xA3, 0x38, 0x6D, 0x28,
+  0x0F, 0x5D, 0x6F, 0x7E, 0x50, 0xE6, 0x41, 0xDF,
+  0x15, 0x2F, 0x71, 0x09, 0xED, 0x54, 0x56, 0xB4,
+  0x12, 0xB1, 0xDA, 0x19, 0x7F, 0xB7, 0x11, 0x23,
+  0xAC, 0xD3, 0xA7, 0x29, 0x90, 0x1D, 0x1A, 0x71,
+  0x87, 0x47, 0x00, 0x13, 0x31, 0x07, 0xEC, 0x53
+};
+static const uint8_t kwe_bp384r1_a_abs[] =
+{
+  0x7B, 0xC3, 0x82, 0xC6, 0x3D, 0x8C, 0x15, 0x0C,
+  0x3C, 0x72, 0x08, 0x0A, 0xCE, 0x05, 0xAF, 0xA0,
+  0xC2, 0xBE, 0xA2, 0x8E, 0x4F, 0xB2, 0x27, 0x87,
+  0x13, 0x91, 0x65, 0xEF, 0xBA, 0x91, 0xF9, 0x0F,
+  0x8A, 0xA5, 0x81, 0x4A, 0x50, 0x3A, 0xD4, 0xEB,
+  0x04, 0xA8, 0xC7, 0xDD, 0x22, 0xCE, 0x28, 0x26
+};
+static const uint8_t kwe_bp384r1_b[] =
+{
+  0x04, 0xA8, 0xC7, 0xDD, 0x22, 0xCE, 0x28, 0x26,
+  0x8B, 0x39, 0xB5, 0x54, 0x16, 0xF0, 0x44, 0x7C,
+  0x2F, 0xB7, 0x7D, 0xE1, 0x07, 0xDC, 0xD2, 0xA6,
+  0x2E, 0x88, 0x0E, 0xA5, 0x3E, 0xEB, 0x62, 0xD5,
+  0x7C, 0xB4, 0x39, 0x02, 0x95, 0xDB, 0xC9, 0x94,
+  0x3A, 0xB7, 0x86, 0x96, 0xFA, 0x50, 0x4C, 0x11
+};
+static const uint8_t kwe_bp384r1_gx[] =
+{
+  0x1D, 0x1C, 0x64, 0xF0, 0x68, 0xCF, 0x45, 0xFF,
+  0xA2, 0xA6, 0x3A, 0x81, 0xB7, 0xC1, 0x3F, 0x6B,
+  0x88, 0x47, 0xA3, 0xE7, 0x7E, 0xF1, 0x4F, 0xE3,
+  0xDB, 0x7F, 0xCA, 0xFE, 0x0C, 0xBD, 0x10, 0xE8,
+  0xE8, 0x26, 0xE0, 0x34, 0x36, 0xD6, 0x46, 0xAA,
+  0xEF, 0x87, 0xB2, 0xE2, 0x47, 0xD4, 0xAF, 0x1E
+};
+static const uint8_t kwe_bp384r1_gy[] =
+{
+  0x8A, 0xBE, 0x1D, 0x75, 0x20, 0xF9, 0xC2, 0xA4,
+  0x5C, 0xB1, 0xEB, 0x8E, 0x95, 0xCF, 0xD5, 0x52,
+  0x62, 0xB7, 0x0B, 0x29, 0xFE, 0xEC, 0x58, 0x64,
+  0xE1, 0x9C, 0x05, 0x4F, 0xF9, 0x91, 0x29, 0x28,
+  0x0E, 0x46, 0x46, 0x21, 0x77, 0x91, 0x81, 0x11,
+  0x42, 0x82, 0x03, 0x41, 0x26, 0x3C, 0x53, 0x15
+};
+static const uint8_t kwe_bp384r1_n[] =
+{
+  0x8C, 0xB9, 0x1E, 0x82, 0xA3, 0x38, 0x6D, 0x28,
+  0x0F, 0x5D, 0x6F, 0x7E, 0x50, 0xE6, 0x41, 0xDF,
+  0x15, 0x2F, 0x71, 0x09, 0xED, 0x54, 0x56, 0xB3,
+  0x1F, 0x16, 0x6E, 0x6C, 0xAC, 0x04, 0x25, 0xA7,
+  0xCF, 0x3A, 0xB6, 0xAF, 0x6B, 0x7F, 0xC3, 0x10,
+  0x3B, 0x88, 0x32, 0x02, 0xE9, 0x04, 0x65, 0x65
+};
+#endif /* MBEDTLS_ECP_DP_BP384R1_ENABLED */
+
+#if defined(MBEDTLS_ECP_DP_BP512R1_ENABLED)
+/* Brainpool P512r1 */
+static const uint8_t kwe_bp512r1_p[] =
+{
+  0xAA, 0xDD, 0x9D, 0xB8, 0xDB, 0xE9, 0xC4, 0x8B,
+  0x3F, 0xD4, 0xE6, 0xAE, 0x33, 0xC9, 0xFC, 0x07,
+  0xCB, 0x30, 0x8D, 0xB3, 0xB3, 0xC9, 0xD2, 0x0E,
+  0xD6, 0x63, 0x9C, 0xCA, 0x70, 0x33, 0x08, 0x71,
+  0x7D, 0x4D, 0x9B, 0x00, 0x9B, 0xC6, 0x68, 0x42,
+  0xAE, 0xCD, 0xA1, 0x2A, 0xE6, 0xA3, 0x80, 0xE6,
+  0x28, 0x81, 0xFF, 0x2F, 0x2D, 0x82, 0xC6, 0x85,
+  0x28, 0xAA, 0x60, 0x56, 0x58, 0x3A, 0x48, 0xF3
+};
+static const uint8_t kwe_bp512r1_a_abs[] =
+{
+  0x78, 0x30, 0xA3, 0x31, 0x8B, 0x60, 0x3B, 0x89,
+  0xE2, 0x32, 0x71, 0x45, 0xAC, 0x23, 0x4C, 0xC5,
+  0x94, 0xCB, 0xDD, 0x8D, 0x3D, 0xF9, 0x16, 0x10,
+  0xA8, 0x34, 0x41, 0xCA, 0xEA, 0x98, 0x63, 0xBC,
+  0x2D, 0xED, 0x5D, 0x5A, 0xA8, 0x25, 0x3A, 0xA1,
+  0x0A, 0x2E, 0xF1, 0xC9, 0x8B, 0x9A, 0xC8, 0xB5,
+  0x7F, 0x11, 0x17, 0xA7, 0x2B, 0xF2, 0xC7, 0xB9,
+  0xE7, 0xC1, 0xAC, 0x4D, 0x77, 0xFC, 0x94, 0xCA
+};
+static const uint8_t kwe_bp512r1_b[] =
+{
+  0x3D, 0xF9, 0x16, 0x10, 0xA8, 0x34, 0x41, 0xCA,
+  0xEA, 0x98, 0x63, 0xBC, 0x2D, 0xED, 0x5D, 0x5A,
+  0xA8, 0x25, 0x3A, 0xA1, 0x0A, 0x2E, 0xF1, 0xC9,
+  0x8B, 0x9A, 0xC8, 0xB5, 0x7F, 0x11, 0x17, 0xA7,
+  0x2B, 0xF2, 0xC7, 0xB9, 0xE7, 0xC1, 0xAC, 0x4D,
+  0x77, 0xFC, 0x94, 0xCA, 0xDC, 0x08, 0x3E, 0x67,
+  0x98, 0x40, 0x50, 0xB7, 0x5E, 0xBA, 0xE5, 0xDD,
+  0x28, 0x09, 0xBD, 0x63, 0x80, 0x16, 0xF7, 0x23
+};
+static const uint8_t kwe_bp512r1_gx[] =
+{
+  0x81, 0xAE, 0xE4, 0xBD, 0xD8, 0x2E, 0xD9, 0x64,
+  0x5A, 0x21, 0x32, 0x2E, 0x9C, 0x4C, 0x6A, 0x93,
+  0x85, 0xED, 0x9F, 0x70, 0xB5, 0xD9, 0x16, 0xC1,
+  0xB4, 0x3B, 0x62, 0xEE, 0xF4, 0xD0, 0x09, 0x8E,
+  0xFF, 0x3B, 0x1F, 0x78, 0xE2, 0xD0, 0xD4, 0x8D,
+  0x50, 0xD1, 0x68, 0x7B, 0x93, 0xB9, 0x7D, 0x5F,
+  0x7C, 0x6D, 0x50, 0x47, 0x40, 0x6A, 0x5E, 0x68,
+  0x8B, 0x35, 0x22, 0x09, 0xBC, 0xB9, 0xF8, 0x22
+};
+static const uint8_t kwe_bp512r1_gy[] =
+{
+  0x7D, 0xDE, 0x38, 0x5D, 0x56, 0x63, 0x32, 0xEC,
+  0xC0, 0xEA, 0xBF, 0xA9, 0xCF, 0x78, 0x22, 0xFD,
+  0xF2, 0x09, 0xF7, 0x00, 0x24, 0xA5, 0x7B, 0x1A,
+  0xA0, 0x00, 0xC5, 0x5B, 0x88, 0x1F, 0x81, 0x11,
+  0xB2, 0xDC, 0xDE, 0x49, 0x4A, 0x5F, 0x48, 0x5E,
+  0x5B, 0xCA, 0x4B, 0xD8, 0x8A, 0x27, 0x63, 0xAE,
+  0xD1, 0xCA, 0x2B, 0x2F, 0xA8, 0xF0, 0x54, 0x06,
+  0x78, 0xCD, 0x1E, 0x0F, 0x3A, 0xD8, 0x08, 0x92
+};
+static const uint8_t kwe_bp512r1_n[] =
+{
+  0xAA, 0xDD, 0x9D, 0xB8, 0xDB, 0xE9, 0xC4, 0x8B,
+  0x3F, 0xD4, 0xE6, 0xAE, 0x33, 0xC9, 0xFC, 0x07,
+  0xCB, 0x30, 0x8D, 0xB3, 0xB3, 0xC9, 0xD2, 0x0E,
+  0xD6, 0x63, 0x9C, 0xCA, 0x70, 0x33, 0x08, 0x70,
+  0x55, 0x3E, 0x5C, 0x41, 0x4C, 0xA9, 0x26, 0x19,
+  0x41, 0x86, 0x61, 0x19, 0x7F, 0xAC, 0x10, 0x47,
+  0x1D, 0xB1, 0xD3, 0x81, 0x08, 0x5D, 0xDA, 0xDD,
+  0xB5, 0x87, 0x96, 0x82, 0x9C, 0xA9, 0x00, 0x69
+};
+#endif /* MBEDTLS_ECP_DP_BP512R1_ENABLED */
+
+/**
+  * Curves handled without loading an mbedtls_ecp_group
+  */
+static const kwe_ecp_curve_t kwe_ecp_curves[] =
+{
+#if defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_SECP_R1, 256U,
+    {
+      32U, 32U,
+      (uint8_t *)kwe_secp256r1_p, 1U, (uint8_t *)kwe_secp256r1_a_abs, (uint8_t *)kwe_secp256r1_b,
+      (uint8_t *)kwe_secp256r1_gx, (uint8_t *)kwe_secp256r1_gy, (uint8_t *)kwe_secp256r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_SECP256R1_ENABLED */
+#if defined(MBEDTLS_ECP_DP_SECP384R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_SECP_R1, 384U,
+    {
+      48U, 48U,
+      (uint8_t *)kwe_secp384r1_p, 1U, (uint8_t *)kwe_secp384r1_a_abs, (uint8_t *)kwe_secp384r1_b,
+      (uint8_t *)kwe_secp384r1_gx, (uint8_t *)kwe_secp384r1_gy, (uint8_t *)kwe_secp384r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_SECP384R1_ENABLED */
+#if defined(MBEDTLS_ECP_DP_SECP521R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_SECP_R1, 521U,
+    {
+      66U, 66U,
+      (uint8_t *)kwe_secp521r1_p, 1U, (uint8_t *)kwe_secp521r1_a_abs, (uint8_t *)kwe_secp521r1_b,
+      (uint8_t *)kwe_secp521r1_gx, (uint8_t *)kwe_secp521r1_gy, (uint8_t *)kwe_secp521r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_SECP521R1_ENABLED */
+#if defined(MBEDTLS_ECP_DP_BP256R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_BRAINPOOL_P_R1, 256U,
+    {
+      32U, 32U,
+      (uint8_t *)kwe_bp256r1_p, 0U, (uint8_t *)kwe_bp256r1_a_abs, (uint8_t *)kwe_bp256r1_b,
+      (uint8_t *)kwe_bp256r1_gx, (uint8_t *)kwe_bp256r1_gy, (uint8_t *)kwe_bp256r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_BP256R1_ENABLED */
+#if defined(MBEDTLS_ECP_DP_BP384R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_BRAINPOOL_P_R1, 384U,
+    {
+      48U, 48U,
+      (uint8_t *)kwe_bp384r1_p, 0U, (uint8_t *)kwe_bp384r1_a_abs, (uint8_t *)kwe_bp384r1_b,
+      (uint8_t *)kwe_bp384r1_gx, (uint8_t *)kwe_bp384r1_gy, (uint8_t *)kwe_bp384r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_BP384R1_ENABLED */
+#if defined(MBEDTLS_ECP_DP_BP512R1_ENABLED)
+  {
+    PSA_ECC_FAMILY_BRAINPOOL_P_R1, 512U,
+    {
+      64U, 64U,
+      (uint8_t *)kwe_bp512r1_p, 0U, (uint8_t *)kwe_bp512r1_a_abs, (uint8_t *)kwe_bp512r1_b,
+      (uint8_t *)kwe_bp512r1_gx, (uint8_t *)kwe_bp512r1_gy, (uint8_t *)kwe_bp512r1_n
+    }
+  },
+#endif /* MBEDTLS_ECP_DP_BP512R1_ENABLED */
+  { 0U, 0U, { 0U } }
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Functions Definition ------------------------------------------------------*/
+/** @addtogroup INTERFACE_Exported_Functions
+  * @{
+  */
+
+/** @defgroup INTERFACE_Exported_Functions_Group7 Curve Parameters functions
+  * @brief   KWE curve parameters tables
+  *
+@verbatim
+  ==============================================================================
+                      ##### Curve Parameters functions #####
+  ==============================================================================
+    [..]
+      This subsection provides a function returning the constant KWE curve
+      parameters of an enabled curve, so that asymmetric operations do not
+      build an mbedtls_ecp_group.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  A function that returns the KWE parameters of a curve.
+  * @param  family : PSA elliptic curve family.
+  * @param  bits : curve size in bits.
+  * @retval Pointer to the constant curve parameters, NULL if the curve is
+  *         not part of the tables.
+  */
+const KWE_EcpTypeDef *mbedtls_kwe_opaque_get_curve(
+  psa_ecc_family_t family,
+  size_t bits)
+{
+  uint32_t i;
+
+  for (i = 0U; kwe_ecp_curves[i].bits != 0U; i++)
+  {
+    if ((kwe_ecp_curves[i].family == family) && (kwe_ecp_curves[i].bits == bits))
+    {
+      return &kwe_ecp_curves[i].ecp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
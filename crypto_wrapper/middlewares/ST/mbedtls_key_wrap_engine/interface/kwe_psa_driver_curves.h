@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    kwe_psa_driver_curves.h
+  * @author  MCD Application Team
+  * @brief   Header for kwe_psa_driver_curves.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef KWE_PSA_DRIVER_CURVES_H
+#define KWE_PSA_DRIVER_CURVES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <psa/crypto_driver_common.h>
+#include "kwe_core.h"
+
+/** @addtogroup KWE_MODULES
+  * @{
+  */
+
+/** @addtogroup INTERFACE
+  * @brief
+  * @{
+  */
+#if defined(PSA_KWE_DRIVER_ENABLED)
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup INTERFACE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup INTERFACE_Exported_Functions_Group7
+  * @{
+  */
+const KWE_EcpTypeDef *mbedtls_kwe_opaque_get_curve(
+  psa_ecc_family_t family,
+  size_t bits);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*KWE_PSA_DRIVER_CURVES_H */
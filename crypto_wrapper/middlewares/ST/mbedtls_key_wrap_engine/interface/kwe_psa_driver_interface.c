@@ -33,8 +33,36 @@
 /* Global variables ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+#if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)
+#if (KWE_WORKSPACE_ECC_MAX_SIZE < PSA_BITS_TO_BYTES(PSA_VENDOR_ECC_MAX_CURVE_BITS))
+#error "KWE_WORKSPACE_ECC_MAX_SIZE is smaller than the largest enabled curve"
+#endif /* KWE_WORKSPACE_ECC_MAX_SIZE */
+#endif /* MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C */
+#if defined(MBEDTLS_RSA_C)
+#if (KWE_WORKSPACE_RSA_MAX_SIZE < PSA_BITS_TO_BYTES(PSA_VENDOR_RSA_MAX_KEY_BITS))
+#error "KWE_WORKSPACE_RSA_MAX_SIZE is smaller than the largest enabled RSA key"
+#endif /* KWE_WORKSPACE_RSA_MAX_SIZE */
+#endif /* MBEDTLS_RSA_C */
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if (defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)) && (KWE_ECC_PUBLIC_KEY_CACHE_SIZE > 0U)
+/**
+  * Public keys of ECC blobs that do not store their public key
+  */
+static struct
+{
+  uint32_t valid;                                       /*!< Entry holds a public key */
+  uint8_t id[PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE];     /*!< IV and Tag of the wrapped key */
+  size_t public_key_length;                             /*!< Size of the public key */
+  uint8_t public_key[PSA_KEY_EXPORT_ECC_PUBLIC_KEY_MAX_SIZE(PSA_VENDOR_ECC_MAX_CURVE_BITS)]; /*!< Public key */
+} kwe_ecc_public_key_cache[KWE_ECC_PUBLIC_KEY_CACHE_SIZE];
+
+/**
+  * Next cache entry to be replaced
+  */
+static uint32_t kwe_ecc_public_key_cache_next;
+#endif /* (MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C) && KWE_ECC_PUBLIC_KEY_CACHE_SIZE */
+
 /* Private function prototypes -----------------------------------------------*/
 /* Functions Definition ------------------------------------------------------*/
 /** @defgroup INTERFACE_Private_Functions INTERFACE Private Functions
@@ -184,6 +212,261 @@ static void ecc_hal_prepare_digest(const uint8_t *P_pDigestIn, uint8_t P_DigestI
 }
 #endif /* MBEDTLS_ECDSA_C */
 
+/**
+  * @}
+  */
+
+/** @defgroup INTERFACE_Private_Functions_Group2 Curve Parameters functions
+  *  @brief   INTERFACE private function to fill the KWE curve parameters
+  *           from the key attributes.
+  *
+@verbatim
+  ==============================================================================
+                      ##### Curve Parameters function #####
+  ==============================================================================
+
+@endverbatim
+  * @{
+  */
+
+#if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)
+/**
+  * @brief      Fill the KWE curve parameters of a key
+  * @note       Curves of the constant KWE tables are used as is, other curves
+  *             are loaded in p_grp. The wrapped key itself is not parsed.
+  *             The group shall be released with mbedtls_ecp_group_free()
+  *             once p_ecp is no longer used.
+  * @param[in]  p_attributes  Key attributes
+  * @param[out] p_grp         Group to be loaded when the curve is not in the
+  *                           tables
+  * @param[out] p_ecp         KWE curve parameters
+  * @retval     PSA_SUCCESS if success, an error code otherwise
+  */
+static psa_status_t kwe_ecp_group_load(const psa_key_attributes_t *p_attributes,
+                                       mbedtls_ecp_group *p_grp, KWE_EcpTypeDef *p_ecp)
+{
+  psa_status_t status;
+  mbedtls_ecp_group_id grp_id;
+  psa_ecc_family_t family = PSA_KEY_TYPE_ECC_GET_FAMILY(psa_get_key_type(p_attributes));
+  const KWE_EcpTypeDef *p_curve;
+
+  mbedtls_ecp_group_init(p_grp);
+
+  p_curve = mbedtls_kwe_opaque_get_curve(family, psa_get_key_bits(p_attributes));
+  if (p_curve != NULL)
+  {
+    *p_ecp = *p_curve;
+    return PSA_SUCCESS;
+  }
+
+  grp_id = mbedtls_ecc_group_from_psa(family, psa_get_key_bits(p_attributes));
+  if (grp_id == MBEDTLS_ECP_DP_NONE)
+  {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
+  status = mbedtls_to_psa_error(mbedtls_ecp_group_load(p_grp, grp_id));
+  if (status != PSA_SUCCESS)
+  {
+    return status;
+  }
+
+  p_ecp->modulus_size = p_grp->st_modulus_size;
+  p_ecp->order_size   = p_grp->st_order_size;
+  p_ecp->p_prime      = p_grp->st_p;
+  p_ecp->a_sign       = p_grp->st_a_sign;
+  p_ecp->p_a_abs      = p_grp->st_a_abs;
+  p_ecp->p_b          = p_grp->st_b;
+  p_ecp->p_gx         = p_grp->st_gx;
+  p_ecp->p_gy         = p_grp->st_gy;
+  p_ecp->p_n          = p_grp->st_n;
+
+  return PSA_SUCCESS;
+}
+#endif /* MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C */
+
+/**
+  * @}
+  */
+
+/** @defgroup INTERFACE_Private_Functions_Group3 Public Key Cache functions
+  *  @brief   INTERFACE private functions to store the public key of an ECC
+  *           key alongside its wrapped private key.
+  *
+@verbatim
+  ==============================================================================
+                      ##### Public Key Cache functions #####
+  ==============================================================================
+
+@endverbatim
+  * @{
+  */
+
+#if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)
+/**
+  * @brief      Compute the public key of a wrapped ECC key and store it in
+  *             the key blob
+  * @param[in]  p_ecp            KWE curve parameters
+  * @param[in]  p_key_buffer     Wrapped key blob
+  * @param[in]  key_buffer_size  Size of the wrapped key blob
+  * @param[in]  key_bytes        Size of the private key in bytes
+  * @retval     PSA_SUCCESS if success, an error code otherwise
+  */
+static psa_status_t kwe_ecc_public_key_store(KWE_EcpTypeDef *p_ecp,
+                                             uint8_t *p_key_buffer, size_t key_buffer_size,
+                                             size_t key_bytes)
+{
+  psa_status_t status;
+  uint8_t *p_header = p_key_buffer + PSA_KWE_ECC_PUBLIC_KEY_OFFSET(key_bytes);
+  uint32_t public_key_length = 0U;
+  size_t length = 0U;
+
+  if (key_buffer_size < PSA_KWE_ECC_BLOB_SIZE(key_bytes))
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  status = kwe_to_psa_error(KWE_EcdsaPublicKeyExport(p_ecp, p_key_buffer,
+                                                     p_header + PSA_KWE_DRIVER_ECC_PUBLIC_KEY_HEADER_SIZE,
+                                                     PSA_KWE_ECC_PUBLIC_KEY_MAX_SIZE(key_bytes),
+                                                     &length));
+  if (status == PSA_SUCCESS)
+  {
+    public_key_length = (uint32_t)length;
+  }
+
+  (void) memcpy(p_header, &public_key_length, sizeof(public_key_length));
+
+  return status;
+}
+
+/**
+  * @brief      Get the public key stored in a wrapped ECC key blob
+  * @param[in]  p_key            Wrapped key blob
+  * @param[in]  key_length       Size of the wrapped key blob
+  * @param[in]  key_bytes        Size of the private key in bytes
+  * @param[out] p_data           Public key
+  * @param[in]  data_size        Size of the public key buffer
+  * @param[out] p_data_length    Size of the public key
+  * @retval     PSA_SUCCESS if success, PSA_ERROR_DOES_NOT_EXIST if the blob
+  *             does not store its public key, an error code otherwise
+  */
+static psa_status_t kwe_ecc_public_key_load(const uint8_t *p_key, size_t key_length,
+                                            size_t key_bytes,
+                                            uint8_t *p_data, size_t data_size, size_t *p_data_length)
+{
+  const uint8_t *p_header = p_key + PSA_KWE_ECC_PUBLIC_KEY_OFFSET(key_bytes);
+  uint32_t public_key_length;
+
+  if (key_length < PSA_KWE_ECC_BLOB_SIZE(key_bytes))
+  {
+    return PSA_ERROR_DOES_NOT_EXIST;
+  }
+
+  (void) memcpy(&public_key_length, p_header, sizeof(public_key_length));
+
+  if ((public_key_length == 0U) || (public_key_length > PSA_KWE_ECC_PUBLIC_KEY_MAX_SIZE(key_bytes)))
+  {
+    return PSA_ERROR_DOES_NOT_EXIST;
+  }
+
+  if (data_size < public_key_length)
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  (void) memcpy(p_data, p_header + PSA_KWE_DRIVER_ECC_PUBLIC_KEY_HEADER_SIZE, public_key_length);
+  *p_data_length = public_key_length;
+
+  return PSA_SUCCESS;
+}
+
+#if (KWE_ECC_PUBLIC_KEY_CACHE_SIZE > 0U)
+/**
+  * @brief      Get a public key from the RAM cache
+  * @param[in]  p_key            Wrapped key blob
+  * @param[out] p_data           Public key
+  * @param[in]  data_size        Size of the public key buffer
+  * @param[out] p_data_length    Size of the public key
+  * @retval     PSA_SUCCESS if success, PSA_ERROR_DOES_NOT_EXIST if the key is
+  *             not cached, an error code otherwise
+  */
+static psa_status_t kwe_ecc_public_key_cache_get(const uint8_t *p_key,
+                                                 uint8_t *p_data, size_t data_size, size_t *p_data_length)
+{
+  uint32_t i;
+
+  for (i = 0U; i < KWE_ECC_PUBLIC_KEY_CACHE_SIZE; i++)
+  {
+    if ((kwe_ecc_public_key_cache[i].valid != 0U)
+        && (memcmp(kwe_ecc_public_key_cache[i].id, p_key, PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE) == 0))
+    {
+      if (data_size < kwe_ecc_public_key_cache[i].public_key_length)
+      {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+      }
+      (void) memcpy(p_data, kwe_ecc_public_key_cache[i].public_key,
+                    kwe_ecc_public_key_cache[i].public_key_length);
+      *p_data_length = kwe_ecc_public_key_cache[i].public_key_length;
+      return PSA_SUCCESS;
+    }
+  }
+
+  return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+/**
+  * @brief      Add a public key to the RAM cache, replacing the oldest entry
+  * @param[in]  p_key            Wrapped key blob
+  * @param[in]  p_data           Public key
+  * @param[in]  data_length      Size of the public key
+  * @retval     None
+  */
+static void kwe_ecc_public_key_cache_put(const uint8_t *p_key,
+                                         const uint8_t *p_data, size_t data_length)
+{
+  uint32_t i = kwe_ecc_public_key_cache_next;
+
+  if (data_length > sizeof(kwe_ecc_public_key_cache[i].public_key))
+  {
+    return;
+  }
+
+  (void) memcpy(kwe_ecc_public_key_cache[i].id, p_key, PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE);
+  (void) memcpy(kwe_ecc_public_key_cache[i].public_key, p_data, data_length);
+  kwe_ecc_public_key_cache[i].public_key_length = data_length;
+  kwe_ecc_public_key_cache[i].valid = 1U;
+
+  kwe_ecc_public_key_cache_next = (i + 1U) % KWE_ECC_PUBLIC_KEY_CACHE_SIZE;
+}
+
+/**
+  * @brief      Remove the public key of a wrapped key from the RAM cache
+  * @param[in]  p_key            Wrapped key blob
+  * @param[in]  key_length       Size of the wrapped key blob
+  * @retval     None
+  */
+static void kwe_ecc_public_key_cache_remove(const uint8_t *p_key, size_t key_length)
+{
+  uint32_t i;
+
+  if (key_length < PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE)
+  {
+    return;
+  }
+
+  for (i = 0U; i < KWE_ECC_PUBLIC_KEY_CACHE_SIZE; i++)
+  {
+    if ((kwe_ecc_public_key_cache[i].valid != 0U)
+        && (memcmp(kwe_ecc_public_key_cache[i].id, p_key, PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE) == 0))
+    {
+      (void) memset(&kwe_ecc_public_key_cache[i], 0, sizeof(kwe_ecc_public_key_cache[i]));
+    }
+  }
+}
+#endif /* KWE_ECC_PUBLIC_KEY_CACHE_SIZE */
+#endif /* MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C */
+
 /**
   * @}
   */
@@ -226,6 +509,9 @@ psa_status_t kwe_to_psa_error(KWE_StatusTypeDef state)
     case KWE_ERROR:
       status = PSA_ERROR_HARDWARE_FAILURE;
       break;
+    case KWE_ERROR_BUSY:
+      status = PSA_ERROR_BAD_STATE;
+      break;
     default:
       status = PSA_ERROR_HARDWARE_FAILURE;
       break;
@@ -247,7 +533,7 @@ psa_status_t kwe_to_psa_error(KWE_StatusTypeDef state)
   ==============================================================================
     [..]
       This subsection provides a set of functions allowing to wrap or generate
-      wrapped private keys.
+      wrapped private keys, and to release a wrapped key being destroyed.
 
 
 @endverbatim
@@ -278,7 +564,6 @@ psa_status_t mbedtls_kwe_opaque_generate_key(
   mbedtls_ecp_group ecp_group;
   KWE_EcpTypeDef ecp_tmp = {0};
   KWE_AlgTypeDef alg;
-  size_t curve_bits = 0U;
 
 #endif /* MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C */
 
@@ -298,38 +583,26 @@ psa_status_t mbedtls_kwe_opaque_generate_key(
       return PSA_ERROR_NOT_SUPPORTED;
     }
 
-    mbedtls_ecp_group_init(&ecp_group);
-    curve_bits = psa_get_key_bits(p_attributes);
-
-    ecp_group.id = mbedtls_ecc_group_from_psa(PSA_KEY_TYPE_ECC_GET_FAMILY(key_type),
-                                              curve_bits);
-
-    if (ecp_group.id == MBEDTLS_ECP_DP_NONE)
-    {
-      return PSA_ERROR_INVALID_ARGUMENT;
-    }
-
-    status = mbedtls_to_psa_error(mbedtls_ecp_group_load(&ecp_group,
-                                                         ecp_group.id));
-
+    status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
     if (status != PSA_SUCCESS)
     {
+      mbedtls_ecp_group_free(&ecp_group);
       return status;
     }
 
-    ecp_tmp.modulus_size = ecp_group.st_modulus_size;
-    ecp_tmp.order_size   = ecp_group.st_order_size;
-    ecp_tmp.p_prime      = ecp_group.st_p;
-    ecp_tmp.a_sign       = ecp_group.st_a_sign;
-    ecp_tmp.p_a_abs      = ecp_group.st_a_abs;
-    ecp_tmp.p_b          = ecp_group.st_b;
-    ecp_tmp.p_gx         = ecp_group.st_gx;
-    ecp_tmp.p_gy         = ecp_group.st_gy;
-    ecp_tmp.p_n          = ecp_group.st_n;
-
     status = kwe_to_psa_error(KWE_GenerateWrappedEccKey(&ecp_tmp, alg,
                                                         p_key_buffer, key_buffer_size,
                                                         p_key_buffer_length));
+    if (status == PSA_SUCCESS)
+    {
+      /* Public key is computed once and stored with the wrapped key */
+      status = kwe_ecc_public_key_store(&ecp_tmp, p_key_buffer, key_buffer_size,
+                                        PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes)));
+    }
+
+    /* Free ECP group */
+    mbedtls_ecp_group_free(&ecp_group);
+
     if (status != PSA_SUCCESS)
     {
       return status;
@@ -374,8 +647,10 @@ psa_status_t mbedtls_kwe_opaque_import_key(
   
 #if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)
   mbedtls_ecp_keypair *ecp = NULL;
+  mbedtls_ecp_group ecp_group;
   KWE_EcpTypeDef ecp_tmp = {0};
   size_t curve_bits = 0U;
+  size_t curve_bytes = 0U;
 #endif /* MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C */
 
 #if defined(MBEDTLS_RSA_C)
@@ -408,12 +683,32 @@ psa_status_t mbedtls_kwe_opaque_import_key(
     /* RSSE user key is already wrapped using STM32 Key Wrap Engine (KWE) */
     if (PSA_KWE_KEY_ID_IS_RSSE(p_attributes->id) != 0U)
     {
+      curve_bytes = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
+
+      if (key_buffer_size < PSA_KWE_ECC_BLOB_SIZE(curve_bytes))
+      {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+      }
+
       /* Get IV and Tag from the RSSE blob */
       (void) memcpy((void *)p_key_buffer, (void *)(p_data + PSA_KWE_RSSE_BLOB_IV_OFFSET), PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE);
 
       /* Get wrapped key from the RSSE blob */
       (void) memcpy((void *)(p_key_buffer + PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE),
-                    (void *)(p_data + PSA_KWE_RSSE_BLOB_KEY_OFFSET), (key_buffer_size - PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE));
+                    (void *)(p_data + PSA_KWE_RSSE_BLOB_KEY_OFFSET), curve_bytes);
+
+      /* Public key is computed once and stored with the wrapped key */
+      status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
+      if (status == PSA_SUCCESS)
+      {
+        status = kwe_ecc_public_key_store(&ecp_tmp, p_key_buffer, key_buffer_size, curve_bytes);
+      }
+      mbedtls_ecp_group_free(&ecp_group);
+
+      if (status != PSA_SUCCESS)
+      {
+        return status;
+      }
 
       *p_key_buffer_length = key_buffer_size;
 
@@ -455,8 +750,16 @@ psa_status_t mbedtls_kwe_opaque_import_key(
       status = kwe_to_psa_error(KWE_WrapEccKey(&ecp_tmp, alg, p_data,
                                                p_key_buffer, key_buffer_size,
                                                p_key_buffer_length));
+      if (status == PSA_SUCCESS)
+      {
+        /* Public key is computed once and stored with the wrapped key */
+        status = kwe_ecc_public_key_store(&ecp_tmp, p_key_buffer, key_buffer_size, data_length);
+      }
+
       if (status != PSA_SUCCESS)
       {
+        mbedtls_ecp_keypair_free(ecp);
+        mbedtls_free(ecp);
         return status;
       }
 
@@ -658,6 +961,38 @@ cleanup:
   return status;
 }
 
+/**
+  * @brief  This function releases the hardware resources still holding a
+  *         wrapped key being destroyed.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to the wrapped key buffer.
+  * @param  key_buffer_size : size of the wrapped key buffer in bytes.
+  * @retval PSA_SUCCESS
+  */
+psa_status_t mbedtls_kwe_opaque_destroy_key(
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size)
+{
+  UNUSED(p_attributes);
+  UNUSED(p_key_buffer);
+  UNUSED(key_buffer_size);
+
+#if defined(MBEDTLS_AES_C)
+  if (psa_get_key_type(p_attributes) == PSA_KEY_TYPE_AES)
+  {
+    KWE_AesKeyDestroy(p_key_buffer, key_buffer_size);
+  }
+#endif /* MBEDTLS_AES_C */
+#if (defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)) && (KWE_ECC_PUBLIC_KEY_CACHE_SIZE > 0U)
+  if (PSA_KEY_TYPE_IS_ECC(psa_get_key_type(p_attributes)))
+  {
+    kwe_ecc_public_key_cache_remove(p_key_buffer, key_buffer_size);
+  }
+#endif /* (MBEDTLS_ECDSA_C || MBEDTLS_ECDH_C) && KWE_ECC_PUBLIC_KEY_CACHE_SIZE */
+
+  return PSA_SUCCESS;
+}
+
 /**
   * @}
   */
@@ -697,10 +1032,9 @@ psa_status_t mbedtls_kwe_opaque_export_public_key(
   psa_status_t status = PSA_ERROR_HARDWARE_FAILURE;
 #if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_ECDH_C)
   psa_key_type_t key_type = psa_get_key_type(p_attributes);
-  mbedtls_ecp_keypair *ecp = NULL;
+  mbedtls_ecp_group ecp_group;
   KWE_EcpTypeDef ecp_tmp = {0};
   size_t curve_bytes = 0U;
-  size_t curve_bits = 0U;
 
 #endif /* MBEDTLS_ECDSA_C */
 
@@ -708,35 +1042,44 @@ psa_status_t mbedtls_kwe_opaque_export_public_key(
   if (PSA_KEY_TYPE_IS_ECC(key_type))
   {
     curve_bytes = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
-    curve_bits = psa_get_key_bits(p_attributes);
 
-    status = mbedtls_psa_ecp_load_representation(key_type, curve_bits, p_key + 1U,
-                                                 curve_bytes, &ecp);
-    if (status != PSA_SUCCESS)
+    /* Public key stored with the wrapped key */
+    status = kwe_ecc_public_key_load(p_key, key_length, curve_bytes,
+                                     p_data, data_size, p_data_length);
+    if (status != PSA_ERROR_DOES_NOT_EXIST)
+    {
+      return status;
+    }
+
+#if (KWE_ECC_PUBLIC_KEY_CACHE_SIZE > 0U)
+    /* Blob without public key, computed by a previous export */
+    status = kwe_ecc_public_key_cache_get(p_key, p_data, data_size, p_data_length);
+    if (status != PSA_ERROR_DOES_NOT_EXIST)
     {
       return status;
     }
+#endif /* KWE_ECC_PUBLIC_KEY_CACHE_SIZE */
 
-    ecp_tmp.modulus_size = ecp->MBEDTLS_PRIVATE(grp).st_modulus_size;
-    ecp_tmp.order_size   = ecp->MBEDTLS_PRIVATE(grp).st_order_size;
-    ecp_tmp.p_prime      = ecp->MBEDTLS_PRIVATE(grp).st_p;
-    ecp_tmp.a_sign       = ecp->MBEDTLS_PRIVATE(grp).st_a_sign;
-    ecp_tmp.p_a_abs      = ecp->MBEDTLS_PRIVATE(grp).st_a_abs;
-    ecp_tmp.p_b          = ecp->MBEDTLS_PRIVATE(grp).st_b;
-    ecp_tmp.p_gx         = ecp->MBEDTLS_PRIVATE(grp).st_gx;
-    ecp_tmp.p_gy         = ecp->MBEDTLS_PRIVATE(grp).st_gy;
-    ecp_tmp.p_n          = ecp->MBEDTLS_PRIVATE(grp).st_n;
+    status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
+    if (status != PSA_SUCCESS)
+    {
+      mbedtls_ecp_group_free(&ecp_group);
+      return status;
+    }
 
     status = kwe_to_psa_error(KWE_EcdsaPublicKeyExport(&ecp_tmp, p_key,
                                                        p_data, data_size, p_data_length));
-    /* Free ECP context */
-    mbedtls_ecp_keypair_free(ecp);
-    mbedtls_free(ecp);
+    /* Free ECP group */
+    mbedtls_ecp_group_free(&ecp_group);
 
     if (status != PSA_SUCCESS)
     {
       return status;
     }
+
+#if (KWE_ECC_PUBLIC_KEY_CACHE_SIZE > 0U)
+    kwe_ecc_public_key_cache_put(p_key, p_data, *p_data_length);
+#endif /* KWE_ECC_PUBLIC_KEY_CACHE_SIZE */
   }
   else
 #endif /* MBEDTLS_ECDSA_C */
@@ -776,13 +1119,13 @@ psa_status_t mbedtls_kwe_opaque_key_agreement(
   psa_status_t status = PSA_ERROR_HARDWARE_FAILURE;
   psa_key_type_t key_type = psa_get_key_type(p_attributes);
 
-#if defined(MBEDTLS_ECDH_C)
-  mbedtls_ecp_keypair *ecp = NULL;
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDH_C)
+  mbedtls_ecp_group ecp_group;
   KWE_EcpTypeDef ecp_tmp = {0};
   size_t curve_bytes = 0;
   uint8_t *p_shared_secret_xy = NULL;
   size_t p_shared_secret_length_xy = 0;
-#endif /* MBEDTLS_ECDH_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDH_C */
 
   if (!PSA_KEY_TYPE_IS_ECC_KEY_PAIR(key_type) ||
       !PSA_ALG_IS_ECDH(alg))
@@ -790,63 +1133,54 @@ psa_status_t mbedtls_kwe_opaque_key_agreement(
     return PSA_ERROR_INVALID_ARGUMENT;
   }
 
-#if defined(MBEDTLS_ECDH_C)
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDH_C)
   if (PSA_ALG_IS_ECDH(alg))
   {
     curve_bytes = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
 
-    status = mbedtls_psa_ecp_load_representation(key_type, 0U, p_key_buffer,
-                                                 curve_bytes,
-                                                 &ecp);
-
+    status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
     if (status != PSA_SUCCESS)
     {
+      mbedtls_ecp_group_free(&ecp_group);
       return status;
     }
 
-    ecp_tmp.modulus_size = ecp->MBEDTLS_PRIVATE(grp).st_modulus_size;
-    ecp_tmp.order_size   = ecp->MBEDTLS_PRIVATE(grp).st_order_size;
-    ecp_tmp.p_prime      = ecp->MBEDTLS_PRIVATE(grp).st_p;
-    ecp_tmp.a_sign       = ecp->MBEDTLS_PRIVATE(grp).st_a_sign;
-    ecp_tmp.p_a_abs      = ecp->MBEDTLS_PRIVATE(grp).st_a_abs;
-    ecp_tmp.p_b          = ecp->MBEDTLS_PRIVATE(grp).st_b;
-    ecp_tmp.p_gx         = ecp->MBEDTLS_PRIVATE(grp).st_gx;
-    ecp_tmp.p_gy         = ecp->MBEDTLS_PRIVATE(grp).st_gy;
-    ecp_tmp.p_n          = ecp->MBEDTLS_PRIVATE(grp).st_n;
-
-    /* Allocate memory space for computed secret */
-    p_shared_secret_xy = mbedtls_calloc((2U * ecp_tmp.order_size), sizeof(uint8_t));
-
+    /* Computed secret is held in the KWE workspace */
+    p_shared_secret_xy = (uint8_t *)KWE_WorkspaceAcquire()->ecc_point;
     status = kwe_to_psa_error(KWE_EcdhKeyAgreement(&ecp_tmp, p_key_buffer,
                                                    p_peer_key, peer_key_length,
-                                                   p_shared_secret_xy, shared_secret_size,
+                                                   p_shared_secret_xy, sizeof(KWE_GetWorkspace()->ecc_point),
                                                    &p_shared_secret_length_xy));
-    /* Only shared secret X part is exported */
-    *p_shared_secret_length = p_shared_secret_length_xy / 2U;
-
-    /* Copy the shared secret X part */
-    (void) memcpy(p_shared_secret, p_shared_secret_xy, *p_shared_secret_length);
-
-    /* Free the p_shared_secret_xy buffer */
-    mbedtls_zeroize_and_free(p_shared_secret_xy, (2U * ecp_tmp.order_size));
+    /* Free ECP group */
+    mbedtls_ecp_group_free(&ecp_group);
 
     if (status != PSA_SUCCESS)
     {
+      mbedtls_platform_zeroize(p_shared_secret_xy, sizeof(KWE_GetWorkspace()->ecc_point));
+      KWE_WorkspaceRelease();
       return status;
     }
 
-    if (curve_bytes != *p_shared_secret_length)
+    /* Only shared secret X part is exported */
+    *p_shared_secret_length = p_shared_secret_length_xy / 2U;
+
+    if ((*p_shared_secret_length > shared_secret_size) || (curve_bytes != *p_shared_secret_length))
     {
       status = PSA_ERROR_CORRUPTION_DETECTED;
     }
+    else
+    {
+      /* Copy the shared secret X part */
+      (void) memcpy(p_shared_secret, p_shared_secret_xy, *p_shared_secret_length);
+    }
 
-    /* Free ECP context */
-    mbedtls_ecp_keypair_free(ecp);
-    mbedtls_free(ecp);
+    /* Wipe the shared secret from the workspace */
+    mbedtls_platform_zeroize(p_shared_secret_xy, p_shared_secret_length_xy);
+    KWE_WorkspaceRelease();
 
   }
   else
-#endif /* MBEDTLS_ECDH_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDH_C */
 
   {
     status =  PSA_ERROR_NOT_SUPPORTED;
@@ -898,18 +1232,17 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
   uint8_t *p_signature, size_t signature_size, size_t *p_signature_length)
 {
   psa_status_t status = PSA_ERROR_HARDWARE_FAILURE;
-#if defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_RSA_C)
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && (defined(MBEDTLS_ECDSA_C) || defined(MBEDTLS_RSA_C))
   psa_key_type_t key_type = psa_get_key_type(p_attributes);
-#endif /* MBEDTLS_ECDSA_C || MBEDTLS_RSA_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && (MBEDTLS_ECDSA_C || MBEDTLS_RSA_C) */
 
-#if defined(MBEDTLS_ECDSA_C)
-  mbedtls_ecp_keypair *ecp = NULL;
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDSA_C)
+  mbedtls_ecp_group ecp_group;
   KWE_EcpTypeDef ecp_tmp = {0};
-  size_t curve_bytes = 0;
   uint8_t *p_digest = NULL;
-#endif /* MBEDTLS_ECDSA_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDSA_C */
 
-#if defined(MBEDTLS_RSA_C)
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_RSA_C)
   /* mbedtls_rsa_context *rsa = NULL; */
   mbedtls_md_type_t md_alg;
   unsigned char md_size;
@@ -926,43 +1259,31 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
   size_t offset = 0;
   size_t msb = 0;
 #endif /* MBEDTLS_PKCS1_V21 */
-#endif /* MBEDTLS_RSA_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_RSA_C */
 
-#if defined(MBEDTLS_ECDSA_C)
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDSA_C)
   if (PSA_KEY_TYPE_IS_ECC(key_type))
   {
-    curve_bytes = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
-    status = mbedtls_psa_ecp_load_representation(key_type, 0u, p_key_buffer,
-                                                 curve_bytes,
-                                                 &ecp);
+    status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
     if (status != PSA_SUCCESS)
     {
+      mbedtls_ecp_group_free(&ecp_group);
       return status;
     }
 
-    ecp_tmp.modulus_size = ecp->MBEDTLS_PRIVATE(grp).st_modulus_size;
-    ecp_tmp.order_size   = ecp->MBEDTLS_PRIVATE(grp).st_order_size;
-    ecp_tmp.p_prime      = ecp->MBEDTLS_PRIVATE(grp).st_p;
-    ecp_tmp.a_sign       = ecp->MBEDTLS_PRIVATE(grp).st_a_sign;
-    ecp_tmp.p_a_abs      = ecp->MBEDTLS_PRIVATE(grp).st_a_abs;
-    ecp_tmp.p_b          = ecp->MBEDTLS_PRIVATE(grp).st_b;
-    ecp_tmp.p_gx         = ecp->MBEDTLS_PRIVATE(grp).st_gx;
-    ecp_tmp.p_gy         = ecp->MBEDTLS_PRIVATE(grp).st_gy;
-    ecp_tmp.p_n          = ecp->MBEDTLS_PRIVATE(grp).st_n;
-
-    p_digest = mbedtls_calloc((ecp_tmp.order_size), sizeof(uint8_t));
-
+    /* Digest fitted to the curve order is held in the KWE workspace */
+    p_digest = (uint8_t *)KWE_WorkspaceAcquire()->digest;
     ecc_hal_prepare_digest(p_hash, hash_length,
                            p_digest, ecp_tmp.order_size, ecp_tmp.p_n);
 
-    status = KWE_EcdsaSignHash(&ecp_tmp, p_key_buffer, p_digest, p_signature,
-                               signature_size, p_signature_length);
+    status = kwe_to_psa_error(KWE_EcdsaSignHash(&ecp_tmp, p_key_buffer, p_digest, p_signature,
+                                                signature_size, p_signature_length));
 
-    mbedtls_zeroize_and_free(p_digest, (ecp_tmp.order_size));
+    mbedtls_platform_zeroize(p_digest, ecp_tmp.order_size);
+    KWE_WorkspaceRelease();
 
-    /* Free ECP context */
-    mbedtls_ecp_keypair_free(ecp);
-    mbedtls_free(ecp);
+    /* Free ECP group */
+    mbedtls_ecp_group_free(&ecp_group);
 
     if (status != PSA_SUCCESS)
     {
@@ -970,9 +1291,9 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
     }
   }
   else
-#endif /* MBEDTLS_ECDSA_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDSA_C */
 
-#if defined(MBEDTLS_RSA_C)
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_RSA_C)
     if (PSA_KEY_TYPE_IS_RSA(key_type))
     {
       md_alg = mbedtls_md_type_from_psa_alg(PSA_ALG_SIGN_GET_HASH(alg));
@@ -995,17 +1316,23 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
       rsa_tmp.modulus_size = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
       rsa_tmp.exponent_size = PSA_BITS_TO_BYTES(psa_get_key_bits(p_attributes));
 
-      tmp_sig = mbedtls_calloc(1, signature_size);
-      if (tmp_sig == NULL)
+      /* Encoded message is built in the KWE workspace */
+      if (signature_size > sizeof(KWE_GetWorkspace()->rsa_block))
       {
-        return MBEDTLS_ERR_MPI_ALLOC_FAILED;
+        return PSA_ERROR_INVALID_ARGUMENT;
       }
+      tmp_sig = (unsigned char *)KWE_WorkspaceAcquire()->rsa_block;
+#if defined(MBEDTLS_PKCS1_V21)
+      mbedtls_md_init(&md_ctx);
+#endif  /* MBEDTLS_PKCS1_V21 */
+      (void) memset(tmp_sig, 0, signature_size);
 #if defined(MBEDTLS_PKCS1_V15)
       if (PSA_ALG_IS_RSA_PKCS1V15_SIGN(alg))
       {
         if ((md_alg != MBEDTLS_MD_NONE || hash_length != 0) && p_hash == NULL)
         {
-          return MBEDTLS_ERR_RSA_BAD_INPUT_DATA;
+          status = PSA_ERROR_INVALID_ARGUMENT;
+          goto cleanup;
         }
         /*
          * Prepare PKCS1-v1.5 encoding (padding and hash identifier)
@@ -1022,8 +1349,8 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
          * temporary buffer and check it before returning it.
          */
 
-        status = KWE_RsaModularExp(&rsa_tmp, p_key_buffer,
-                                   tmp_sig, p_signature);
+        status = kwe_to_psa_error(KWE_RsaModularExp(&rsa_tmp, p_key_buffer,
+                                                    tmp_sig, p_signature));
 
         if (status != PSA_SUCCESS)
         {
@@ -1041,7 +1368,8 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
           /* Just make sure this hash is supported in this build. */
           if (md_info == NULL)
           {
-            return MBEDTLS_ERR_RSA_INVALID_PADDING;
+            status = PSA_ERROR_NOT_SUPPORTED;
+            goto cleanup;
           }
           hlen = mbedtls_md_get_size(md_info);
           /* Calculate the largest possible salt length, up to the hash size.
@@ -1054,7 +1382,8 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
           min_slen = hlen - 2;
           if (signature_size < (hlen + min_slen + 2))
           {
-            return MBEDTLS_ERR_RSA_BAD_INPUT_DATA;
+            status = PSA_ERROR_INVALID_ARGUMENT;
+            goto cleanup;
           }
           else if (signature_size >= (hlen + hlen + 2))
           {
@@ -1079,7 +1408,6 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
 
           p += slen;
 
-          mbedtls_md_init(&md_ctx);
           status = mbedtls_to_psa_error(mbedtls_md_setup(&md_ctx, md_info, 0));
           if (status != 0)
           {
@@ -1137,8 +1465,8 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
           p += hlen;
           *p++ = 0xBC;
 
-          status = KWE_RsaModularExp(&rsa_tmp, p_key_buffer,
-                                     tmp_sig, p_signature);
+          status = kwe_to_psa_error(KWE_RsaModularExp(&rsa_tmp, p_key_buffer,
+                                                      tmp_sig, p_signature));
 
           if (status != PSA_SUCCESS)
           {
@@ -1154,14 +1482,15 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
         }
 
 cleanup:
-      mbedtls_zeroize_and_free(tmp_sig, signature_size);
+      mbedtls_platform_zeroize(tmp_sig, signature_size);
 #if defined(MBEDTLS_PKCS1_V21)
       mbedtls_md_free(&md_ctx);
 #endif  /* MBEDTLS_PKCS1_V21 */
+      KWE_WorkspaceRelease();
 
     }
     else
-#endif /* MBEDTLS_RSA_C */
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_RSA_C */
     {
       status = PSA_ERROR_NOT_SUPPORTED;
     }
@@ -1170,35 +1499,167 @@ cleanup:
 }
 
 /**
-  * @brief  A function that signs a message with asymmetric wrapped private key
-  *         through KWE hardware accelerator.
+  * @brief  A function that signs several hashes with the same asymmetric
+  *         wrapped private key through KWE hardware accelerator.
+  * @note   Only ECDSA is supported. The curve is loaded once and the digests
+  *         are signed in chunks of KWE_ECDSA_BATCH_SIZE within one CCB
+  *         session.
   * @param  p_attributes : a pointer to key attributes.
   * @param  p_key_buffer : a pointer to buffer that contain the wrapped private
   *                        key.
   * @param  key_buffer_size : size of the wrapped private key buffer in bytes.
-  * @param  alg : a signature algorithm.
-  * @param  p_input : a pointer to the message to sign.
-  * @param  input_length : size of message buffer in bytes.
-  * @param  p_signature : a pointer to signature buffer to store signature.
-  * @param  signature_size : size of signature buffer in bytes.
-  * @param  p_signature_length : a pointer to actual size of outputted signature
-                                 in bytes.
+  * @param  alg : a signature algorithm (ECDSA).
+  * @param  p_hashes : a pointer to the hashes to sign, stored back to back.
+  * @param  hash_length : size of each hash in bytes.
+  * @param  hash_count : number of hashes to sign.
+  * @param  p_signatures : a pointer to buffer to store the signatures, stored
+  *                        back to back with PSA_ECDSA_SIGNATURE_SIZE bytes
+  *                        each.
+  * @param  signatures_size : size of signatures buffer in bytes.
+  * @param  p_signatures_length : a pointer to actual size of outputted
+  *                               signatures in bytes.
   * @retval PSA_SUCCESS if success, an error code otherwise.
   */
-psa_status_t mbedtls_kwe_opaque_signature_sign_message(
+psa_status_t mbedtls_kwe_opaque_signature_sign_hash_batch(
   const psa_key_attributes_t *p_attributes,
   const uint8_t *p_key_buffer, size_t key_buffer_size,
-  psa_algorithm_t alg, const uint8_t *p_input, size_t input_length,
-  uint8_t *p_signature, size_t signature_size, size_t *p_signature_length)
+  psa_algorithm_t alg,
+  const uint8_t *p_hashes, size_t hash_length, size_t hash_count,
+  uint8_t *p_signatures, size_t signatures_size, size_t *p_signatures_length)
 {
-  psa_status_t status = PSA_ERROR_HARDWARE_FAILURE;
+  psa_status_t status = PSA_ERROR_NOT_SUPPORTED;
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(MBEDTLS_ECDSA_C)
+  psa_key_type_t key_type = psa_get_key_type(p_attributes);
+  mbedtls_ecp_group ecp_group;
+  KWE_EcpTypeDef ecp_tmp = {0};
+  uint8_t *p_digest = NULL;
+  size_t signature_length;
+  size_t chunk_length;
+  size_t done = 0U;
+  size_t count;
+  size_t i;
 
-  if (PSA_ALG_IS_SIGN_HASH(alg))
+  (void) key_buffer_size;
+
+  if (!PSA_KEY_TYPE_IS_ECC(key_type) || !PSA_ALG_IS_ECDSA(alg))
   {
-    size_t hash_length = 0;
-    uint8_t hash[PSA_HASH_MAX_SIZE];
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
 
-    status = psa_driver_wrapper_hash_compute(PSA_ALG_SIGN_GET_HASH(alg),
+  status = kwe_ecp_group_load(p_attributes, &ecp_group, &ecp_tmp);
+  if (status != PSA_SUCCESS)
+  {
+    mbedtls_ecp_group_free(&ecp_group);
+    return status;
+  }
+
+  /* The hashes and signatures are stored back to back: their total size
+   * must not overflow */
+  if ((hash_length != 0U) && (hash_count > (SIZE_MAX / hash_length)))
+  {
+    mbedtls_ecp_group_free(&ecp_group);
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  signature_length = 2U * ecp_tmp.order_size;
+  if ((hash_count > (SIZE_MAX / signature_length))
+      || (signatures_size < (signature_length * hash_count)))
+  {
+    mbedtls_ecp_group_free(&ecp_group);
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  /* Digests fitted to the curve order are held in the KWE workspace */
+  p_digest = (uint8_t *)KWE_WorkspaceAcquire()->digest;
+
+  while (done < hash_count)
+  {
+    count = hash_count - done;
+    if (count > KWE_WORKSPACE_DIGEST_COUNT)
+    {
+      count = KWE_WORKSPACE_DIGEST_COUNT;
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+      ecc_hal_prepare_digest(p_hashes + ((done + i) * hash_length), hash_length,
+                             p_digest + (i * ecp_tmp.order_size),
+                             ecp_tmp.order_size, ecp_tmp.p_n);
+    }
+
+    status = kwe_to_psa_error(KWE_EcdsaSignHashBatch(&ecp_tmp, p_key_buffer, p_digest,
+                                                     count,
+                                                     p_signatures + (done * signature_length),
+                                                     signature_length * count,
+                                                     &chunk_length));
+
+    mbedtls_platform_zeroize(p_digest, count * ecp_tmp.order_size);
+
+    if (status != PSA_SUCCESS)
+    {
+      break;
+    }
+    done += count;
+  }
+
+  KWE_WorkspaceRelease();
+
+  /* Free ECP group */
+  mbedtls_ecp_group_free(&ecp_group);
+
+  if (status != PSA_SUCCESS)
+  {
+    mbedtls_platform_zeroize(p_signatures, signatures_size);
+    return status;
+  }
+
+  *p_signatures_length = signature_length * hash_count;
+#else
+  (void) p_attributes;
+  (void) p_key_buffer;
+  (void) key_buffer_size;
+  (void) alg;
+  (void) p_hashes;
+  (void) hash_length;
+  (void) hash_count;
+  (void) p_signatures;
+  (void) signatures_size;
+  (void) p_signatures_length;
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && MBEDTLS_ECDSA_C */
+
+  return status;
+}
+
+/**
+  * @brief  A function that signs a message with asymmetric wrapped private key
+  *         through KWE hardware accelerator.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped private
+  *                        key.
+  * @param  key_buffer_size : size of the wrapped private key buffer in bytes.
+  * @param  alg : a signature algorithm.
+  * @param  p_input : a pointer to the message to sign.
+  * @param  input_length : size of message buffer in bytes.
+  * @param  p_signature : a pointer to signature buffer to store signature.
+  * @param  signature_size : size of signature buffer in bytes.
+  * @param  p_signature_length : a pointer to actual size of outputted signature
+                                 in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise.
+  */
+psa_status_t mbedtls_kwe_opaque_signature_sign_message(
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg, const uint8_t *p_input, size_t input_length,
+  uint8_t *p_signature, size_t signature_size, size_t *p_signature_length)
+{
+  psa_status_t status = PSA_ERROR_HARDWARE_FAILURE;
+
+  if (PSA_ALG_IS_SIGN_HASH(alg))
+  {
+    size_t hash_length = 0;
+    uint8_t hash[PSA_HASH_MAX_SIZE];
+
+    status = psa_driver_wrapper_hash_compute(PSA_ALG_SIGN_GET_HASH(alg),
                                              p_input, input_length,
                                              hash, sizeof(hash), &hash_length);
 
@@ -1684,6 +2145,463 @@ psa_status_t mbedtls_kwe_opaque_cipher_decrypt(
 
   return status;
 }
+
+/**
+  * @brief  Common part of the multi-part cipher encrypt and decrypt setup.
+  * @param  p_operation : a pointer to the cipher operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a cipher algorithm.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+static psa_status_t kwe_opaque_cipher_setup(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg,
+  uint32_t encrypt)
+{
+  KWE_AlgTypeDef alg_tmp;
+
+  if (psa_get_key_type(p_attributes) != PSA_KEY_TYPE_AES)
+  {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
+  switch (alg)
+  {
+#if defined(MBEDTLS_CIPHER_MODE_ECB)
+    case PSA_ALG_ECB_NO_PADDING:
+      alg_tmp = KWE_ALG_AES_ECB;
+      break;
+#endif /* MBEDTLS_CIPHER_MODE_ECB */
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+    case PSA_ALG_CBC_NO_PADDING:
+      alg_tmp = KWE_ALG_AES_CBC;
+      break;
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+    case PSA_ALG_CTR:
+      alg_tmp = KWE_ALG_AES_CTR;
+      break;
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+    default:
+      return PSA_ERROR_NOT_SUPPORTED;
+  }
+
+  if (KWE_AesCipherSetup(p_operation, alg_tmp, encrypt, p_key_buffer, key_buffer_size) != KWE_SUCCESS)
+  {
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  return PSA_SUCCESS;
+}
+
+/**
+  * @brief  Set up a multi-part AES encryption using KWE hardware
+  *         accelerator.
+  * @note   The SAES key stays loaded between updates so that large payloads
+  *         can be processed in fixed-size chunks.
+  * @param  p_operation : a pointer to the cipher operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a cipher algorithm.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_encrypt_setup(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg)
+{
+  return kwe_opaque_cipher_setup(p_operation, p_attributes, p_key_buffer, key_buffer_size, alg, 1U);
+}
+
+/**
+  * @brief  Set up a multi-part AES decryption using KWE hardware
+  *         accelerator.
+  * @param  p_operation : a pointer to the cipher operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a cipher algorithm.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_decrypt_setup(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg)
+{
+  return kwe_opaque_cipher_setup(p_operation, p_attributes, p_key_buffer, key_buffer_size, alg, 0U);
+}
+
+/**
+  * @brief  Set the IV of a multi-part AES cipher operation.
+  * @param  p_operation : a pointer to the cipher operation.
+  * @param  p_iv : a pointer to initialization vectors (IV).
+  * @param  iv_length : Size of the IV buffer in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_set_iv(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const uint8_t *p_iv, size_t iv_length)
+{
+  if (KWE_AesCipherSetIv(p_operation, p_iv, iv_length) != KWE_SUCCESS)
+  {
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  return PSA_SUCCESS;
+}
+
+/**
+  * @brief  Encrypt or decrypt a chunk of a multi-part AES cipher operation.
+  * @note   Whole blocks are output, the trailing bytes are output by a later
+  *         update or by mbedtls_kwe_opaque_cipher_finish().
+  * @param  p_operation : a pointer to the cipher operation.
+  * @param  p_input : a pointer to the input data.
+  * @param  input_length : Size of the input data in bytes.
+  * @param  p_output : Output buffer for the processed data.
+  * @param  output_size : Size of the output buffer in bytes.
+  * @param  p_output_length : The size of the actual output in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_update(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  *p_output_length = 0U;
+
+  if ((p_operation->alg != KWE_ALG_AES_ECB) && (p_operation->iv_set == 0U))
+  {
+    return PSA_ERROR_BAD_STATE;
+  }
+
+  if (output_size < (((p_operation->partial_length + input_length) / KWE_AES_BLOCK_SIZE) * KWE_AES_BLOCK_SIZE))
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  return kwe_to_psa_error(KWE_AesCipherUpdate(p_operation, p_input, input_length,
+                                              p_output, output_size, p_output_length));
+}
+
+/**
+  * @brief  Finish a multi-part AES cipher operation.
+  * @param  p_operation : a pointer to the cipher operation.
+  * @param  p_output : Output buffer for the remaining data.
+  * @param  output_size : Size of the output buffer in bytes.
+  * @param  p_output_length : The size of the actual output in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_finish(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  *p_output_length = 0U;
+
+  if ((p_operation->partial_length != 0U) && (p_operation->alg != KWE_ALG_AES_CTR))
+  {
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  if (output_size < p_operation->partial_length)
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  return kwe_to_psa_error(KWE_AesCipherFinish(p_operation, p_output, output_size, p_output_length));
+}
+
+/**
+  * @brief  Abort a multi-part AES cipher operation.
+  * @param  p_operation : a pointer to the cipher operation.
+  * @retval PSA_SUCCESS
+  */
+psa_status_t mbedtls_kwe_opaque_cipher_abort(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation)
+{
+  KWE_AesCipherAbort(p_operation);
+
+  return PSA_SUCCESS;
+}
+
+/**
+  * @brief  Common part of the multi-part AEAD encrypt and decrypt setup.
+  * @param  p_operation : a pointer to the AEAD operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a AEAD algorithm.
+  * @param  encrypt : 1U for an encryption, 0U for a decryption.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+static psa_status_t kwe_opaque_aead_setup(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg,
+  uint32_t encrypt)
+{
+  KWE_AlgTypeDef alg_tmp;
+
+  if (psa_get_key_type(p_attributes) != PSA_KEY_TYPE_AES)
+  {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
+#if defined(MBEDTLS_GCM_C)
+  if (PSA_ALG_AEAD_WITH_SHORTENED_TAG(alg, 0) == PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_GCM, 0))
+  {
+    alg_tmp = KWE_ALG_AES_GCM;
+  }
+  else
+#endif /* MBEDTLS_GCM_C */
+#if defined(MBEDTLS_CCM_C)
+  if (PSA_ALG_AEAD_WITH_SHORTENED_TAG(alg, 0) == PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, 0))
+  {
+    alg_tmp = KWE_ALG_AES_CCM;
+  }
+  else
+#endif /* MBEDTLS_CCM_C */
+  {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
+  switch (KWE_AesAeadSetup(p_operation, alg_tmp, encrypt, PSA_ALG_AEAD_GET_TAG_LENGTH(alg),
+                           p_key_buffer, key_buffer_size))
+  {
+    case KWE_SUCCESS:
+      return PSA_SUCCESS;
+    case KWE_ERROR_NOT_SUPPORTED:
+      return PSA_ERROR_NOT_SUPPORTED;
+    default:
+      return PSA_ERROR_INVALID_ARGUMENT;
+  }
+}
+
+/**
+  * @brief  Set up a multi-part AES authenticated encryption using KWE
+  *         hardware accelerator.
+  * @note   SAES is released after every call of the operation, so other
+  *         SAES users can run between two updates.
+  * @param  p_operation : a pointer to the AEAD operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a AEAD algorithm.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_encrypt_setup(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg)
+{
+  return kwe_opaque_aead_setup(p_operation, p_attributes, p_key_buffer, key_buffer_size, alg, 1U);
+}
+
+/**
+  * @brief  Set up a multi-part AES authenticated decryption using KWE
+  *         hardware accelerator.
+  * @param  p_operation : a pointer to the AEAD operation to initialize.
+  * @param  p_attributes : a pointer to key attributes.
+  * @param  p_key_buffer : a pointer to buffer that contain the wrapped key.
+  * @param  key_buffer_size : size of the wrapped  key buffer in bytes.
+  * @param  alg : a AEAD algorithm.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_decrypt_setup(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg)
+{
+  return kwe_opaque_aead_setup(p_operation, p_attributes, p_key_buffer, key_buffer_size, alg, 0U);
+}
+
+/**
+  * @brief  Set the nonce of a multi-part AES AEAD operation.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  p_nonce : a pointer to nonce or initialization vectors (IV).
+  * @param  nonce_length : Size of the nonce or IV buffer in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_set_nonce(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_nonce, size_t nonce_length)
+{
+  if ((nonce_length == 0U)
+      || ((p_operation->alg == KWE_ALG_AES_CCM) && ((nonce_length < 7U) || (nonce_length > 13U))))
+  {
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  return kwe_to_psa_error(KWE_AesAeadSetNonce(p_operation, p_nonce, nonce_length));
+}
+
+/**
+  * @brief  Declare the additional data and payload lengths of a multi-part
+  *         AES AEAD operation, mandatory for CCM.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  ad_length : Size of additional data in bytes.
+  * @param  plaintext_length : Size of the payload in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_set_lengths(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  size_t ad_length,
+  size_t plaintext_length)
+{
+  return kwe_to_psa_error(KWE_AesAeadSetLengths(p_operation, ad_length, plaintext_length));
+}
+
+/**
+  * @brief  Pass additional data to a multi-part AES AEAD operation.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  p_input : a pointer to additional data that will be
+  *                   authenticated but not encrypted.
+  * @param  input_length : Size of additional data in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_update_ad(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length)
+{
+  /* A CCM operation needs both its nonce and its lengths */
+  if (p_operation->started == 0U)
+  {
+    return PSA_ERROR_BAD_STATE;
+  }
+
+  return kwe_to_psa_error(KWE_AesAeadUpdateAd(p_operation, p_input, input_length));
+}
+
+/**
+  * @brief  Encrypt or decrypt a chunk of a multi-part AES AEAD operation.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  p_input : a pointer to the input data.
+  * @param  input_length : Size of the input data in bytes.
+  * @param  p_output : Output buffer for the processed data.
+  * @param  output_size : Size of the output buffer in bytes.
+  * @param  p_output_length : The size of the actual output in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_update(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length)
+{
+  size_t pending;
+
+  *p_output_length = 0U;
+
+  if (p_operation->started == 0U)
+  {
+    return PSA_ERROR_BAD_STATE;
+  }
+
+  /* Bytes kept in the context are additional data until the payload starts */
+  pending = (p_operation->body_started != 0U) ? p_operation->partial_length : 0U;
+  if (output_size < (((pending + input_length) / KWE_AES_BLOCK_SIZE) * KWE_AES_BLOCK_SIZE))
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  return kwe_to_psa_error(KWE_AesAeadUpdate(p_operation, p_input, input_length,
+                                            p_output, output_size, p_output_length));
+}
+
+/**
+  * @brief  Finish a multi-part AES authenticated encryption.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  p_ciphertext : Output buffer for the remaining encrypted data.
+  * @param  ciphertext_size : Size of the output buffer in bytes.
+  * @param  p_ciphertext_length : The size of the actual output in bytes.
+  * @param  p_tag : Output buffer for the authentication tag.
+  * @param  tag_size : Size of the tag buffer in bytes.
+  * @param  p_tag_length : The size of the actual tag in bytes.
+  * @retval PSA_SUCCESS if success, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_finish(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  uint8_t *p_ciphertext, size_t ciphertext_size, size_t *p_ciphertext_length,
+  uint8_t *p_tag, size_t tag_size, size_t *p_tag_length)
+{
+  size_t pending;
+
+  *p_ciphertext_length = 0U;
+  *p_tag_length = 0U;
+
+  if (p_operation->started == 0U)
+  {
+    return PSA_ERROR_BAD_STATE;
+  }
+
+  pending = (p_operation->body_started != 0U) ? p_operation->partial_length : 0U;
+  if ((ciphertext_size < pending) || (tag_size < p_operation->tag_length))
+  {
+    return PSA_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  return kwe_to_psa_error(KWE_AesAeadFinish(p_operation, p_ciphertext, ciphertext_size, p_ciphertext_length,
+                                            p_tag, tag_size, p_tag_length));
+}
+
+/**
+  * @brief  Finish a multi-part AES authenticated decryption and check the
+  *         authentication tag.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @param  p_plaintext : Output buffer for the remaining decrypted data.
+  * @param  plaintext_size : Size of the output buffer in bytes.
+  * @param  p_plaintext_length : The size of the actual output in bytes.
+  * @param  p_tag : a pointer to the expected authentication tag.
+  * @param  tag_length : Size of the expected tag in bytes.
+  * @retval PSA_SUCCESS if success, PSA_ERROR_INVALID_SIGNATURE if the tag
+  *         does not match, an error code otherwise
+  */
+psa_status_t mbedtls_kwe_opaque_aead_verify(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  uint8_t *p_plaintext, size_t plaintext_size, size_t *p_plaintext_length,
+  const uint8_t *p_tag, size_t tag_length)
+{
+  psa_status_t status;
+  uint8_t check_tag[PSA_AEAD_TAG_MAX_SIZE];
+  size_t check_tag_length = 0;
+
+  status = mbedtls_kwe_opaque_aead_finish(p_operation, p_plaintext, plaintext_size, p_plaintext_length,
+                                          check_tag, sizeof(check_tag), &check_tag_length);
+
+  if (status == PSA_SUCCESS)
+  {
+    if ((tag_length != check_tag_length) || (mbedtls_ct_memcmp(p_tag, check_tag, tag_length) != 0))
+    {
+      status = PSA_ERROR_INVALID_SIGNATURE;
+    }
+  }
+
+  mbedtls_platform_zeroize(check_tag, sizeof(check_tag));
+
+  return status;
+}
+
+/**
+  * @brief  Abort a multi-part AES AEAD operation.
+  * @param  p_operation : a pointer to the AEAD operation.
+  * @retval PSA_SUCCESS
+  */
+psa_status_t mbedtls_kwe_opaque_aead_abort(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation)
+{
+  KWE_AesAeadAbort(p_operation);
+
+  return PSA_SUCCESS;
+}
 /**
   * @}
   */
@@ -34,6 +34,9 @@ extern "C" {
 #include "md_psa.h"
 #include "kwe_core.h"
 #include "kwe_psa_driver_key_management.h"
+#include "kwe_psa_driver_curves.h"
+#include "kwe_psa_driver_provisioning.h"
+#include "kwe_psa_driver_contexts.h"
 
 /** @addtogroup KWE_MODULES
   * @{
@@ -76,6 +79,10 @@ psa_status_t mbedtls_kwe_opaque_import_key(
   uint8_t *p_key_buffer, size_t key_buffer_size,
   size_t *p_key_buffer_length, size_t *bits);
 
+psa_status_t mbedtls_kwe_opaque_destroy_key(
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size);
+
 /**
   * @}
   */
@@ -110,6 +117,13 @@ psa_status_t mbedtls_kwe_opaque_signature_sign_hash(
   const uint8_t *p_hash, size_t hash_length,
   uint8_t *p_signature, size_t signature_size, size_t *p_signature_length);
 
+psa_status_t mbedtls_kwe_opaque_signature_sign_hash_batch(
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg,
+  const uint8_t *p_hashes, size_t hash_length, size_t hash_count,
+  uint8_t *p_signatures, size_t signatures_size, size_t *p_signatures_length);
+
 psa_status_t mbedtls_kwe_opaque_signature_sign_message(
   const psa_key_attributes_t *p_attributes,
   const uint8_t *p_key_buffer, size_t key_buffer_size,
@@ -164,6 +178,77 @@ psa_status_t mbedtls_kwe_opaque_cipher_decrypt(
   const uint8_t *p_ciphertext, size_t input_length,
   uint8_t *p_plaintext, size_t plaintext_size, size_t *p_plaintext_length);
 
+psa_status_t mbedtls_kwe_opaque_cipher_encrypt_setup(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg);
+
+psa_status_t mbedtls_kwe_opaque_cipher_decrypt_setup(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg);
+
+psa_status_t mbedtls_kwe_opaque_cipher_set_iv(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const uint8_t *p_iv, size_t iv_length);
+
+psa_status_t mbedtls_kwe_opaque_cipher_update(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+psa_status_t mbedtls_kwe_opaque_cipher_finish(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+psa_status_t mbedtls_kwe_opaque_cipher_abort(
+  mbedtls_kwe_opaque_cipher_operation_t *p_operation);
+
+psa_status_t mbedtls_kwe_opaque_aead_encrypt_setup(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg);
+
+psa_status_t mbedtls_kwe_opaque_aead_decrypt_setup(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const psa_key_attributes_t *p_attributes,
+  const uint8_t *p_key_buffer, size_t key_buffer_size,
+  psa_algorithm_t alg);
+
+psa_status_t mbedtls_kwe_opaque_aead_set_nonce(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_nonce, size_t nonce_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_set_lengths(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  size_t ad_length,
+  size_t plaintext_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_update_ad(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_update(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  const uint8_t *p_input, size_t input_length,
+  uint8_t *p_output, size_t output_size, size_t *p_output_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_finish(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  uint8_t *p_ciphertext, size_t ciphertext_size, size_t *p_ciphertext_length,
+  uint8_t *p_tag, size_t tag_size, size_t *p_tag_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_verify(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation,
+  uint8_t *p_plaintext, size_t plaintext_size, size_t *p_plaintext_length,
+  const uint8_t *p_tag, size_t tag_length);
+
+psa_status_t mbedtls_kwe_opaque_aead_abort(
+  mbedtls_kwe_opaque_aead_operation_t *p_operation);
+
 /**
   * @}
   */
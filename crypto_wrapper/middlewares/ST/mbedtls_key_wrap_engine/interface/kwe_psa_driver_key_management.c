@@ -78,9 +78,9 @@ size_t mbedtls_kwe_opaque_size_function(
     return 0;
   }
   /* Include spacing for base size overhead over the key size */
-  if (PSA_KEY_TYPE_IS_ECC(key_type)) /* KWE wraps only the private key */
+  if (PSA_KEY_TYPE_IS_ECC(key_type)) /* KWE wraps the private key, the public key is stored with the blob */
   {
-    key_buffer_size = key_buffer_size + PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE;
+    key_buffer_size = PSA_KWE_ECC_BLOB_SIZE(key_buffer_size);
   }
   else if (PSA_KEY_TYPE_IS_RSA(key_type)) /* KWE wraps exponent and phi, the modulus is stored with the blob */
   {
@@ -59,6 +59,8 @@ extern "C" {
 #define PSA_KWE_DRIVER_TAG_BASE_SIZE         (16U)
 /*!< STM32 Key Wrap Engine context base size: 16 bytes IV + 16 bytes Tag */
 #define PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE (32U)
+/*!< STM32 Key Wrap Engine ECC public key header size: cached length */
+#define PSA_KWE_DRIVER_ECC_PUBLIC_KEY_HEADER_SIZE (4U)
 /**
   * @}
   */
@@ -92,6 +94,23 @@ extern "C" {
 #define PSA_KWE_KEY_ID_IS_RSSE(id) \
   ((((id) >= PSA_KWE_KEY_ID_RSSE_MIN) && ((id) <= PSA_KWE_KEY_ID_RSSE_MAX))? \
    1U: 0U)
+
+/*
+ * ECC key blob layout:
+ * | IV (16) | Tag (16) | wrapped private key (word aligned) |
+ * | public key length (4) | public key (up to 1 + 2 * key bytes) |
+ * Blobs created before the public key was cached stop after the wrapped
+ * private key.
+ */
+#define PSA_KWE_ECC_PUBLIC_KEY_OFFSET(key_bytes) \
+  (PSA_KWE_DRIVER_KEY_CONTEXT_BASE_SIZE + ((((key_bytes) + 3U) / 4U) * 4U))
+
+#define PSA_KWE_ECC_PUBLIC_KEY_MAX_SIZE(key_bytes) \
+  ((2U * (key_bytes)) + 1U)
+
+#define PSA_KWE_ECC_BLOB_SIZE(key_bytes) \
+  (PSA_KWE_ECC_PUBLIC_KEY_OFFSET(key_bytes) + PSA_KWE_DRIVER_ECC_PUBLIC_KEY_HEADER_SIZE \
+   + PSA_KWE_ECC_PUBLIC_KEY_MAX_SIZE(key_bytes))
 /**
   * @}
   */
@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    kwe_psa_driver_provisioning.c
+  * @author  MCD Application Team
+  * @brief   Bulk key provisioning of STM32 KWE Middleware interface module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "psa/crypto.h"
+#include "psa_crypto_slot_management.h"
+#include "psa_crypto_storage.h"
+#include "psa_its_alt.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "kwe_psa_driver_interface.h"
+#include "kwe_psa_driver_provisioning.h"
+
+/** @addtogroup KWE_MODULES
+  * @{
+  */
+
+/** @addtogroup INTERFACE
+  * @brief
+  * @{
+  */
+
+#if defined(PSA_KWE_DRIVER_ENABLED) && defined(PSA_USE_ITS_ALT)
+
+/* Global variables ----------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#if (KWE_PROVISION_MAX_KEYS > ITS_BATCH_MAX_OBJECTS)
+#error "KWE_PROVISION_MAX_KEYS exceeds ITS_BATCH_MAX_OBJECTS"
+#endif /* KWE_PROVISION_MAX_KEYS > ITS_BATCH_MAX_OBJECTS */
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+
+/* Functions Definition ------------------------------------------------------*/
+/** @addtogroup INTERFACE_Exported_Functions
+  * @{
+  */
+
+/** @defgroup INTERFACE_Exported_Functions_Group8 Provisioning functions
+  * @brief   KWE bulk key provisioning
+  *
+@verbatim
+  ==============================================================================
+                      ##### Provisioning functions #####
+  ==============================================================================
+    [..]
+      This subsection provides a function wrapping a list of keys within one
+      KWE provisioning session and storing all of them in one storage batch.
+      Either all the keys are provisioned or none of them.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  A function that wraps and stores a list of persistent keys.
+  * @note   Each key goes through the attribute and key identifier checks of
+  *         psa_import_key() and must not exist yet. Symmetric keys are then
+  *         wrapped first, then asymmetric keys, so that SAES and the CCB are
+  *         each set up once. The keys are stored together with
+  *         psa_save_persistent_keys(); nothing is stored if a key can't be
+  *         wrapped or if the storage fails.
+  *         The keys can be used with the PSA API once this function returns.
+  * @note   The wrapped keys are held in a heap buffer sized for the call.
+  * @param  p_keys : a pointer to the keys to provision, their lifetime must be
+  *                  persistent in the KWE location.
+  * @param  key_count : number of keys, up to KWE_PROVISION_MAX_KEYS.
+  * @retval PSA_SUCCESS if success, an error code otherwise.
+  */
+psa_status_t mbedtls_kwe_opaque_provision_keys(
+  const mbedtls_kwe_provision_key_t *p_keys,
+  size_t key_count)
+{
+  psa_status_t status = PSA_SUCCESS;
+  psa_key_attributes_t attributes[KWE_PROVISION_MAX_KEYS];
+  const uint8_t *p_blobs[KWE_PROVISION_MAX_KEYS];
+  size_t blob_lengths[KWE_PROVISION_MAX_KEYS];
+  size_t key_buffer_sizes[KWE_PROVISION_MAX_KEYS];
+  psa_se_drv_table_entry_t *p_drv = NULL;
+  uint8_t *p_buffer = NULL;
+  psa_key_lifetime_t lifetime;
+  size_t buffer_size = 0U;
+  size_t bits = 0U;
+  size_t offset = 0U;
+  uint32_t asymmetric;
+  size_t i;
+  size_t j;
+
+  if ((key_count == 0U) || (key_count > KWE_PROVISION_MAX_KEYS))
+  {
+    return PSA_ERROR_INVALID_ARGUMENT;
+  }
+
+  for (i = 0U; i < key_count; i++)
+  {
+    lifetime = psa_get_key_lifetime(&p_keys[i].attributes);
+    if (PSA_KEY_LIFETIME_IS_VOLATILE(lifetime)
+        || (PSA_KEY_LIFETIME_GET_LOCATION(lifetime) != PSA_CRYPTO_KWE_DRIVER_LOCATION)
+        || (p_keys[i].data_length == 0U))
+    {
+      return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Same checks as psa_import_key(): lifetime, key identifier range, policy, size */
+    status = psa_validate_key_attributes(&p_keys[i].attributes, &p_drv);
+    if (status != PSA_SUCCESS)
+    {
+      return status;
+    }
+
+    for (j = 0U; j < i; j++)
+    {
+      if (mbedtls_svc_key_id_equal(psa_get_key_id(&p_keys[i].attributes),
+                                   psa_get_key_id(&p_keys[j].attributes)) != 0)
+      {
+        return PSA_ERROR_INVALID_ARGUMENT;
+      }
+    }
+
+    if (psa_is_key_present_in_storage(psa_get_key_id(&p_keys[i].attributes)) == 1)
+    {
+      return PSA_ERROR_ALREADY_EXISTS;
+    }
+
+    status = mbedtls_kwe_opaque_get_key_buffer_size_from_key_data(&p_keys[i].attributes,
+                                                                   p_keys[i].p_data,
+                                                                   p_keys[i].data_length,
+                                                                   &key_buffer_sizes[i]);
+    if (status != PSA_SUCCESS)
+    {
+      return status;
+    }
+
+    /* Word aligned, as the KWE blobs are accessed by words */
+    buffer_size += (key_buffer_sizes[i] + 3U) & ~((size_t)3U);
+  }
+
+  p_buffer = mbedtls_calloc(1U, buffer_size);
+  if (p_buffer == NULL)
+  {
+    return PSA_ERROR_INSUFFICIENT_MEMORY;
+  }
+
+  for (i = 0U; i < key_count; i++)
+  {
+    p_blobs[i] = &p_buffer[offset];
+    offset += (key_buffer_sizes[i] + 3U) & ~((size_t)3U);
+  }
+
+  if (KWE_ProvisionBegin() != KWE_SUCCESS)
+  {
+    mbedtls_free(p_buffer);
+    return PSA_ERROR_BAD_STATE;
+  }
+
+  /* Symmetric keys on the first pass, asymmetric keys on the second one */
+  for (asymmetric = 0U; (asymmetric < 2U) && (status == PSA_SUCCESS); asymmetric++)
+  {
+    for (i = 0U; (i < key_count) && (status == PSA_SUCCESS); i++)
+    {
+      if ((PSA_KEY_TYPE_IS_ASYMMETRIC(psa_get_key_type(&p_keys[i].attributes)) ? 1U : 0U)
+          != asymmetric)
+      {
+        continue;
+      }
+
+      attributes[i] = p_keys[i].attributes;
+
+      status = mbedtls_kwe_opaque_import_key(&attributes[i],
+                                             p_keys[i].p_data, p_keys[i].data_length,
+                                             (uint8_t *)p_blobs[i], key_buffer_sizes[i],
+                                             &blob_lengths[i], &bits);
+      if (status != PSA_SUCCESS)
+      {
+        break;
+      }
+
+      /* Same key size checks as psa_import_key() */
+      if (psa_get_key_bits(&attributes[i]) == 0U)
+      {
+        psa_set_key_bits(&attributes[i], bits);
+      }
+      else if (psa_get_key_bits(&attributes[i]) != bits)
+      {
+        status = PSA_ERROR_INVALID_ARGUMENT;
+        break;
+      }
+
+      if (bits > PSA_MAX_KEY_BITS)
+      {
+        status = PSA_ERROR_NOT_SUPPORTED;
+        break;
+      }
+    }
+  }
+
+  if ((KWE_ProvisionEnd() != KWE_SUCCESS) && (status == PSA_SUCCESS))
+  {
+    status = PSA_ERROR_HARDWARE_FAILURE;
+  }
+
+  if (status == PSA_SUCCESS)
+  {
+    /* One storage batch, the objects written are removed on failure */
+    status = psa_save_persistent_keys(attributes, p_blobs, blob_lengths, key_count);
+  }
+
+  mbedtls_platform_zeroize(p_buffer, buffer_size);
+  mbedtls_free(p_buffer);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* PSA_KWE_DRIVER_ENABLED && PSA_USE_ITS_ALT */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    kwe_psa_driver_provisioning.h
+  * @author  MCD Application Team
+  * @brief   Header for kwe_psa_driver_provisioning.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef KWE_PSA_DRIVER_PROVISIONING_H
+#define KWE_PSA_DRIVER_PROVISIONING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "psa/crypto.h"
+#include "kwe_core.h"
+
+/** @addtogroup KWE_MODULES
+  * @{
+  */
+
+/** @addtogroup INTERFACE
+  * @brief
+  * @{
+  */
+#if defined(PSA_KWE_DRIVER_ENABLED) && defined(PSA_USE_ITS_ALT)
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup INTERFACE_Provisioning_Key INTERFACE Provisioning Key
+  * @{
+  */
+typedef struct
+{
+  psa_key_attributes_t attributes;  /*!< Persistent key attributes in the KWE location */
+  const uint8_t *p_data;            /*!< Key material in PSA import format */
+  size_t data_length;               /*!< Size of the key material in bytes */
+} mbedtls_kwe_provision_key_t;
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup INTERFACE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup INTERFACE_Exported_Functions_Group8
+  * @{
+  */
+psa_status_t mbedtls_kwe_opaque_provision_keys(
+  const mbedtls_kwe_provision_key_t *p_keys,
+  size_t key_count);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* PSA_KWE_DRIVER_ENABLED && PSA_USE_ITS_ALT */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*KWE_PSA_DRIVER_PROVISIONING_H */
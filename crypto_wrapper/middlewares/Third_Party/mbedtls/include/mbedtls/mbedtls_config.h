@@ -3510,6 +3510,31 @@
  */
 //#define MBEDTLS_SHA256_USE_A64_CRYPTO_ONLY
 
+/**
+ * \def MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT
+ *
+ * Enable acceleration of the SHA-256 and SHA-224 cryptographic hash algorithms
+ * with the x86 SHA extensions (SHA-NI) if they are available at runtime, and
+ * hash the buffers of mbedtls_sha256_batch() eight at a time in the lanes of
+ * AVX2 registers on CPUs that have AVX2 but not SHA-NI. Both are detected
+ * with CPUID. If neither is present, the library will fall back to the C
+ * implementation.
+ *
+ * \note This is meant for host builds, for instance tooling that hashes many
+ * small objects. If MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT is defined when
+ * building for a non-x86-64 target it will be silently ignored.
+ *
+ * \note    Minimum compiler versions for this feature are Clang 3.9 or GCC 5.0.
+ *
+ * Requires: MBEDTLS_SHA256_C.
+ *
+ * Module:  library/sha256.c
+ *
+ * Uncomment to have the library check for the x86 SHA extensions and AVX2
+ * and use them if available.
+ */
+//#define MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT
+
 /**
  * \def MBEDTLS_SHA384_C
  *
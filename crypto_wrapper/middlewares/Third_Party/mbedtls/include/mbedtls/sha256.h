@@ -169,6 +169,36 @@ int mbedtls_sha256(const unsigned char *input,
                    unsigned char *output,
                    int is224);
 
+/**
+ * \brief          This function calculates the SHA-224 or SHA-256
+ *                 checksums of several independent buffers.
+ *
+ *                 The result is the same as calling mbedtls_sha256() on
+ *                 each buffer in turn. When
+ *                 MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT is enabled and
+ *                 the CPU has AVX2 but not the SHA extensions, up to eight
+ *                 buffers are hashed at once, one per 32-bit lane.
+ *
+ * \param input    The array of \p count buffers holding the data. Each
+ *                 buffer must be readable for its length in \p ilen.
+ * \param ilen     The array of \p count data lengths in Bytes.
+ * \param output   The array of \p count checksum results. Each must be a
+ *                 writable buffer of length \c 32 bytes for SHA-256,
+ *                 \c 28 bytes for SHA-224.
+ * \param count    The number of buffers. May be \c 0.
+ * \param is224    Determines which function to use. This must be
+ *                 either \c 0 for SHA-256, or \c 1 for SHA-224.
+ *
+ * \return         \c 0 on success.
+ * \return         A negative error code on failure, in which case some
+ *                 of the outputs may not have been written.
+ */
+int mbedtls_sha256_batch(const unsigned char *const input[],
+                         const size_t ilen[],
+                         unsigned char *const output[],
+                         size_t count,
+                         int is224);
+
 #if defined(MBEDTLS_SELF_TEST)
 
 #if defined(MBEDTLS_SHA224_C)
@@ -41,6 +41,10 @@
 #define MBEDTLS_PSA_BUILTIN_MAC
 #endif
 
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+#include "hmac_alt.h"
+#endif
+
 #if defined(MBEDTLS_PSA_BUILTIN_ALG_HMAC) || defined(PSA_CRYPTO_DRIVER_TEST)
 typedef struct {
     /** The HMAC algorithm in use */
@@ -49,6 +53,11 @@ typedef struct {
     struct psa_hash_operation_s hash_ctx;
     /** The HMAC part of the context. */
     uint8_t MBEDTLS_PRIVATE(opad)[PSA_HMAC_MAX_HASH_BLOCK_SIZE];
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+    /** The HMAC context of the HASH peripheral, used instead of hash_ctx
+     *  and opad when its md_type is set. */
+    mbedtls_hmac_context MBEDTLS_PRIVATE(hw);
+#endif
 } mbedtls_psa_hmac_operation_t;
 
 #define MBEDTLS_PSA_HMAC_OPERATION_INIT { 0, PSA_HASH_OPERATION_INIT, { 0 } }
@@ -104,6 +104,10 @@ typedef mbedtls_psa_pake_operation_t
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
 
+#if defined(PSA_KWE_DRIVER_ENABLED)
+#include "../../../../ST/mbedtls_key_wrap_engine/interface/kwe_psa_driver_contexts.h"
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
 /* Define the context to be used for an operation that is executed through the
  * PSA Driver wrapper layer as the union of all possible driver's contexts.
  *
@@ -126,6 +130,9 @@ typedef union {
 #if defined(PSA_CRYPTO_DRIVER_TEST)
     mbedtls_transparent_test_driver_aead_operation_t transparent_test_driver_ctx;
 #endif
+#if defined(PSA_KWE_DRIVER_ENABLED)
+    mbedtls_kwe_opaque_aead_operation_t kwe_opaque_ctx;
+#endif
 } psa_driver_aead_context_t;
 
 typedef union {
@@ -77,6 +77,10 @@ typedef struct {
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
 
+#if defined(PSA_KWE_DRIVER_ENABLED)
+#include "../../../../ST/mbedtls_key_wrap_engine/interface/kwe_psa_driver_contexts.h"
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
 /* Define the context to be used for an operation that is executed through the
  * PSA Driver wrapper layer as the union of all possible driver's contexts.
  *
@@ -99,6 +103,9 @@ typedef union {
     mbedtls_transparent_test_driver_cipher_operation_t transparent_test_driver_ctx;
     mbedtls_opaque_test_driver_cipher_operation_t opaque_test_driver_ctx;
 #endif
+#if defined(PSA_KWE_DRIVER_ENABLED)
+    mbedtls_kwe_opaque_cipher_operation_t kwe_opaque_ctx;
+#endif
 } psa_driver_cipher_context_t;
 
 #endif /* PSA_CRYPTO_DRIVER_CONTEXTS_PRIMITIVES_H */
@@ -583,6 +583,119 @@ psa_status_t mbedtls_psa_platform_get_builtin_key(
 
 /** @} */
 
+/** \defgroup psa_verify_hash_batch Batch signing and verification
+ * @{
+ */
+
+/** A signature of a batch verified by mbedtls_psa_verify_hash_batch(). */
+typedef struct mbedtls_psa_verify_hash_batch_item_s {
+    /** Identifier of the key to use for the verification. */
+    mbedtls_svc_key_id_t key;
+    /** A signature algorithm that is compatible with the type of \c key,
+     * as for psa_verify_hash(). */
+    psa_algorithm_t alg;
+    /** The hash whose signature is to be verified. */
+    const uint8_t *hash;
+    /** Size of the \c hash buffer in bytes. */
+    size_t hash_length;
+    /** Buffer containing the signature to verify. */
+    const uint8_t *signature;
+    /** Size of the \c signature buffer in bytes. */
+    size_t signature_length;
+} mbedtls_psa_verify_hash_batch_item_t;
+
+/**
+ * \brief Verify a batch of hash signatures, such as the signatures of the
+ *        images of a firmware update or of a certificate chain.
+ *
+ * Each signature is verified as psa_verify_hash() would. When the STM32 PKA
+ * is used for ECDSA (#MBEDTLS_HAL_ECDSA_ALT and #MBEDTLS_ECDSA_VERIFY_ALT),
+ * consecutive signatures made with ECC public keys of the same curve and
+ * stored in the local key store are verified together, up to
+ * #MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE at a time: the curve is loaded once,
+ * the keys and signatures are given to the PKA without conversion and the
+ * PKA stays initialized between signatures. The other signatures are
+ * verified one by one.
+ *
+ * \note Unlike psa_verify_hash(), this function reads the hashes and
+ *       signatures of the batch in place: the caller must make sure that
+ *       they are not modified during the call.
+ *
+ * \param[in] items     The signatures to verify.
+ * \param count         The number of signatures.
+ * \param[out] results  The status of each signature, as psa_verify_hash()
+ *                      would return it: #PSA_SUCCESS if the signature is
+ *                      valid, #PSA_ERROR_INVALID_SIGNATURE if it is not,
+ *                      or another error if it could not be verified.
+ *
+ * \retval #PSA_SUCCESS
+ *         All the signatures are valid.
+ * \retval #PSA_ERROR_BAD_STATE
+ *         The library has not been previously initialized by psa_crypto_init().
+ * \return The status of the first signature of the batch that is not
+ *         valid otherwise, see \p results for the others.
+ */
+psa_status_t mbedtls_psa_verify_hash_batch(
+    const mbedtls_psa_verify_hash_batch_item_t *items,
+    size_t count,
+    psa_status_t *results);
+
+/**
+ * \brief Sign a batch of hashes with the same private key, such as the
+ *        records of a log or the messages of a protocol run.
+ *
+ * Each hash is signed as psa_sign_hash() would, with the key locked and
+ * its policy checked once for the whole batch. When the key is wrapped by
+ * the STM32 KWE opaque driver (#PSA_KWE_DRIVER_ENABLED) and \p alg is
+ * ECDSA, the curve is loaded once and the hashes are signed in chunks of
+ * #KWE_ECDSA_BATCH_SIZE within one CCB session. The other keys sign the
+ * hashes one by one.
+ *
+ * \note Unlike psa_sign_hash(), this function reads the hashes and writes
+ *       the signatures in place: the caller must make sure that the buffers
+ *       are not accessed during the call.
+ *
+ * \param key                 Identifier of the key to use for the
+ *                            operation. It must be an asymmetric key pair
+ *                            allowing #PSA_KEY_USAGE_SIGN_HASH.
+ * \param alg                 A signature algorithm that is compatible with
+ *                            the type of \p key, as for psa_sign_hash().
+ * \param[in] hashes          The hashes to sign, stored back to back.
+ * \param hash_length         Size of each hash in bytes.
+ * \param hash_count          Number of hashes to sign.
+ * \param[out] signatures     Buffer where the signatures are written, back
+ *                            to back, each of
+ *                            #PSA_SIGN_OUTPUT_SIZE(\c key_type,
+ *                            \c key_bits, \p alg) bytes.
+ * \param signatures_size     Size of the \p signatures buffer in bytes.
+ * \param[out] signatures_length On success, the number of bytes that make
+ *                            up the returned signatures.
+ *
+ * \retval #PSA_SUCCESS \emptydescription
+ * \retval #PSA_ERROR_INVALID_HANDLE \emptydescription
+ * \retval #PSA_ERROR_NOT_PERMITTED
+ *         The key does not have the #PSA_KEY_USAGE_SIGN_HASH flag, or it
+ *         does not permit the requested algorithm.
+ * \retval #PSA_ERROR_BUFFER_TOO_SMALL
+ *         The \p signatures buffer cannot hold \p hash_count signatures.
+ * \retval #PSA_ERROR_INVALID_ARGUMENT \emptydescription
+ * \retval #PSA_ERROR_NOT_SUPPORTED \emptydescription
+ * \retval #PSA_ERROR_BAD_STATE
+ *         The library has not been previously initialized by psa_crypto_init().
+ * \return Another error of psa_sign_hash(), in which case no signature
+ *         is returned.
+ */
+psa_status_t mbedtls_psa_sign_hash_batch(mbedtls_svc_key_id_t key,
+                                         psa_algorithm_t alg,
+                                         const uint8_t *hashes,
+                                         size_t hash_length,
+                                         size_t hash_count,
+                                         uint8_t *signatures,
+                                         size_t signatures_size,
+                                         size_t *signatures_length);
+
+/** @} */
+
 /** \defgroup psa_crypto_client Functions defined by a client provider
  *
  * The functions in this group are meant to be implemented by providers of
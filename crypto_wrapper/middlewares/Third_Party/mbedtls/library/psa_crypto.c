@@ -19,6 +19,7 @@
 #include "psa/crypto.h"
 #include "psa/crypto_values.h"
 
+#include "psa_crypto_aead.h"
 #include "psa_crypto_cipher.h"
 #include "psa_crypto_core.h"
 #include "psa_crypto_invasive.h"
@@ -1397,6 +1398,20 @@ psa_status_t psa_destroy_key(mbedtls_svc_key_id_t key)
     }
 #endif /* MBEDTLS_PSA_CRYPTO_SE_C */
 
+    /* Let an opaque driver release the hardware resources still holding
+     * the key. */
+    status = psa_driver_wrapper_destroy_key(&slot->attr,
+                                            slot->key.data, slot->key.bytes);
+    if (overall_status == PSA_SUCCESS) {
+        overall_status = status;
+    }
+
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM) && (MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0)
+    /* Drop the GCM contexts prepared with the key by the one-shot AEAD
+     * entry points. */
+    mbedtls_psa_aead_gcm_cache_invalidate(&slot->attr.id);
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM && MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0 */
+
 #if defined(MBEDTLS_PSA_CRYPTO_STORAGE_C)
     if (!PSA_KEY_LIFETIME_IS_VOLATILE(slot->attr.lifetime)) {
         /* Destroy the copy of the persistent key from storage.
@@ -1721,7 +1736,7 @@ static psa_status_t psa_validate_key_policy(const psa_key_policy_t *policy)
  *                          NULL for a transparent key.
  *
  */
-static psa_status_t psa_validate_key_attributes(
+psa_status_t psa_validate_key_attributes(
     const psa_key_attributes_t *attributes,
     psa_se_drv_table_entry_t **p_drv)
 {
@@ -3455,6 +3470,226 @@ exit:
     return status;
 }
 
+#if defined(MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH)
+/* Whether a signature can join an ECDSA batch verified on the PKA: it is an
+ * ECDSA signature made with an ECC public key of a short Weierstrass curve,
+ * in the local key store, of the same type and size as the first key of the
+ * batch if any. */
+static int psa_verify_hash_batch_is_eligible(const psa_key_slot_t *slot,
+                                             psa_algorithm_t alg,
+                                             const psa_key_slot_t *first)
+{
+    psa_key_type_t type = slot->attr.type;
+
+    if (!PSA_ALG_IS_ECDSA(alg) ||
+        !PSA_KEY_TYPE_IS_ECC_PUBLIC_KEY(type) ||
+        !PSA_ECC_FAMILY_IS_WEIERSTRASS(PSA_KEY_TYPE_ECC_GET_FAMILY(type)) ||
+        PSA_KEY_LIFETIME_GET_LOCATION(slot->attr.lifetime) !=
+        PSA_KEY_LOCATION_LOCAL_STORAGE) {
+        return 0;
+    }
+
+    return first == NULL ||
+           (first->attr.type == type && first->attr.bits == slot->attr.bits);
+}
+
+/* Verify the signatures at the start of a batch: the ECDSA signatures that
+ * can go to the PKA together, up to MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE of
+ * them, or else the first signature alone. Return the number of signatures
+ * verified. */
+static size_t psa_verify_hash_batch_run(
+    const mbedtls_psa_verify_hash_batch_item_t *items,
+    size_t count,
+    psa_status_t *results)
+{
+    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
+    psa_status_t unlock_status = PSA_ERROR_CORRUPTION_DETECTED;
+    psa_key_slot_t *slots[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    const uint8_t *key_buffers[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    size_t key_buffer_sizes[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    size_t n = 0;
+    size_t i;
+
+    /* Lock the keys of the signatures that share the curve of the first
+     * one. The signature that stops the run starts the next one, where it
+     * is either batched or verified alone. */
+    while (n < count && n < MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE) {
+        if (psa_sign_verify_check_alg(0, items[n].alg) != PSA_SUCCESS) {
+            break;
+        }
+
+        if (psa_get_and_lock_key_slot_with_policy(items[n].key, &slots[n],
+                                                  PSA_KEY_USAGE_VERIFY_HASH,
+                                                  items[n].alg) != PSA_SUCCESS) {
+            break;
+        }
+
+        if (!psa_verify_hash_batch_is_eligible(slots[n], items[n].alg,
+                                               n == 0 ? NULL : slots[0])) {
+            (void) psa_unregister_read_under_mutex(slots[n]);
+            break;
+        }
+
+        key_buffers[n] = slots[n]->key.data;
+        key_buffer_sizes[n] = slots[n]->key.bytes;
+        n++;
+    }
+
+    if (n == 0) {
+        results[0] = psa_verify_hash(items[0].key, items[0].alg,
+                                     items[0].hash, items[0].hash_length,
+                                     items[0].signature,
+                                     items[0].signature_length);
+        return 1;
+    }
+
+    status = mbedtls_psa_ecdsa_verify_hash_batch(&slots[0]->attr,
+                                                 key_buffers, key_buffer_sizes,
+                                                 items, n, results);
+
+    for (i = 0; i < n; i++) {
+        if (status != PSA_SUCCESS) {
+            results[i] = status;
+        }
+
+        unlock_status = psa_unregister_read_under_mutex(slots[i]);
+        if (results[i] == PSA_SUCCESS) {
+            results[i] = unlock_status;
+        }
+    }
+
+    return n;
+}
+#endif /* MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH */
+
+psa_status_t mbedtls_psa_verify_hash_batch(
+    const mbedtls_psa_verify_hash_batch_item_t *items,
+    size_t count,
+    psa_status_t *results)
+{
+    psa_status_t status = PSA_SUCCESS;
+    size_t done = 0;
+    size_t i;
+
+#if defined(MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH)
+    while (done < count) {
+        done += psa_verify_hash_batch_run(&items[done], count - done,
+                                          &results[done]);
+    }
+#else
+    for (done = 0; done < count; done++) {
+        results[done] = psa_verify_hash(items[done].key, items[done].alg,
+                                        items[done].hash,
+                                        items[done].hash_length,
+                                        items[done].signature,
+                                        items[done].signature_length);
+    }
+#endif /* MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH */
+
+    for (i = 0; i < count; i++) {
+        if (results[i] != PSA_SUCCESS) {
+            status = results[i];
+            break;
+        }
+    }
+
+    return status;
+}
+
+psa_status_t mbedtls_psa_sign_hash_batch(mbedtls_svc_key_id_t key,
+                                         psa_algorithm_t alg,
+                                         const uint8_t *hashes,
+                                         size_t hash_length,
+                                         size_t hash_count,
+                                         uint8_t *signatures,
+                                         size_t signatures_size,
+                                         size_t *signatures_length)
+{
+    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
+    psa_status_t unlock_status = PSA_ERROR_CORRUPTION_DETECTED;
+    psa_key_slot_t *slot = NULL;
+    size_t signature_size;
+    size_t length;
+    size_t i;
+
+    *signatures_length = 0;
+
+    if (hash_count == 0 || hash_length > SIZE_MAX / hash_count) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    status = psa_sign_verify_check_alg(0, alg);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (signatures_size == 0) {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    status = psa_get_and_lock_key_slot_with_policy(key, &slot,
+                                                   PSA_KEY_USAGE_SIGN_HASH,
+                                                   alg);
+    if (status != PSA_SUCCESS) {
+        goto exit;
+    }
+
+    if (!PSA_KEY_TYPE_IS_KEY_PAIR(slot->attr.type)) {
+        status = PSA_ERROR_INVALID_ARGUMENT;
+        goto exit;
+    }
+
+    /* The signatures are stored back to back, each of the size of the
+     * signatures of the key. */
+    signature_size = PSA_SIGN_OUTPUT_SIZE(slot->attr.type, slot->attr.bits,
+                                          alg);
+    if (signature_size == 0) {
+        status = PSA_ERROR_NOT_SUPPORTED;
+        goto exit;
+    }
+    if (signature_size > SIZE_MAX / hash_count ||
+        signatures_size < signature_size * hash_count) {
+        status = PSA_ERROR_BUFFER_TOO_SMALL;
+        goto exit;
+    }
+
+    status = psa_driver_wrapper_sign_hash_batch(
+        &slot->attr, slot->key.data, slot->key.bytes, alg,
+        hashes, hash_length, hash_count,
+        signatures, signatures_size, signatures_length);
+    if (status != PSA_ERROR_NOT_SUPPORTED) {
+        goto exit;
+    }
+
+    /* No batch entry point for this key: sign the hashes one by one under
+     * the same slot lock. */
+    for (i = 0; i < hash_count; i++) {
+        status = psa_driver_wrapper_sign_hash(
+            &slot->attr, slot->key.data, slot->key.bytes, alg,
+            hashes + i * hash_length, hash_length,
+            signatures + i * signature_size, signature_size, &length);
+        if (status != PSA_SUCCESS) {
+            goto exit;
+        }
+        if (length != signature_size) {
+            status = PSA_ERROR_CORRUPTION_DETECTED;
+            goto exit;
+        }
+    }
+    *signatures_length = signature_size * hash_count;
+
+exit:
+    if (status != PSA_SUCCESS) {
+        *signatures_length = 0;
+    }
+    psa_wipe_tag_output_buffer(signatures, status, signatures_size,
+                               *signatures_length);
+
+    unlock_status = psa_unregister_read_under_mutex(slot);
+
+    return (status == PSA_SUCCESS) ? unlock_status : status;
+}
+
 psa_status_t psa_asymmetric_encrypt(mbedtls_svc_key_id_t key,
                                     psa_algorithm_t alg,
                                     const uint8_t *input_external,
@@ -8297,6 +8532,15 @@ void mbedtls_psa_crypto_free(void)
     }
 
     if (global_data.initialized & PSA_CRYPTO_SUBSYSTEM_KEY_SLOTS_INITIALIZED) {
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM) && (MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0)
+#if defined(MBEDTLS_THREADING_C)
+        mbedtls_mutex_lock(&mbedtls_threading_key_slot_mutex);
+#endif /* defined(MBEDTLS_THREADING_C) */
+        mbedtls_psa_aead_gcm_cache_invalidate(NULL);
+#if defined(MBEDTLS_THREADING_C)
+        mbedtls_mutex_unlock(&mbedtls_threading_key_slot_mutex);
+#endif /* defined(MBEDTLS_THREADING_C) */
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM && MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0 */
         psa_wipe_all_key_slots();
         global_data.initialized &= ~PSA_CRYPTO_SUBSYSTEM_KEY_SLOTS_INITIALIZED;
     }
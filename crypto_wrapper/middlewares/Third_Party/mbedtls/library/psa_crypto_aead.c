@@ -22,6 +22,9 @@
 #include "mbedtls/cipher.h"
 #include "mbedtls/gcm.h"
 #include "mbedtls/error.h"
+#include "mbedtls/constant_time.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/threading.h"
 
 static psa_status_t psa_aead_setup(
     mbedtls_psa_aead_operation_t *operation,
@@ -114,6 +117,182 @@ static psa_status_t psa_aead_setup(
     return PSA_SUCCESS;
 }
 
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM) && (MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0)
+#define PSA_AEAD_GCM_CACHE
+
+/* A GCM context with its key already set, kept between one-shot calls so
+ * that messages encrypted or decrypted with the same key skip
+ * mbedtls_gcm_setkey(). Entries are looked up by key identifier and no copy
+ * of the key material is kept: psa_destroy_key() drops the entries of a
+ * key, so an identifier given to a new key never finds the old context. */
+typedef struct {
+    mbedtls_svc_key_id_t key_id;
+    psa_key_type_t key_type;
+    size_t key_bits;
+    uint32_t last_use;
+    unsigned char valid;
+    unsigned char in_use;
+    unsigned char discard;
+    mbedtls_gcm_context gcm;
+} psa_aead_gcm_cache_entry_t;
+
+static psa_aead_gcm_cache_entry_t
+    psa_aead_gcm_cache[MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE];
+static uint32_t psa_aead_gcm_cache_clock;
+
+static void psa_aead_gcm_cache_wipe(psa_aead_gcm_cache_entry_t *entry)
+{
+    if (entry->valid) {
+        mbedtls_gcm_free(&entry->gcm);
+    }
+    mbedtls_platform_zeroize(entry, sizeof(*entry));
+}
+
+static int psa_aead_gcm_cache_match(const psa_aead_gcm_cache_entry_t *entry,
+                                    const psa_key_attributes_t *attributes)
+{
+    return entry->valid && !entry->in_use &&
+           mbedtls_svc_key_id_equal(entry->key_id,
+                                    psa_get_key_id(attributes)) &&
+           entry->key_type == psa_get_key_type(attributes) &&
+           entry->key_bits == psa_get_key_bits(attributes);
+}
+
+static void psa_aead_gcm_cache_release(psa_aead_gcm_cache_entry_t *entry)
+{
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&mbedtls_threading_key_slot_mutex) != 0) {
+        return;
+    }
+#endif /* MBEDTLS_THREADING_C */
+
+    if (entry->discard) {
+        psa_aead_gcm_cache_wipe(entry);
+    } else {
+        entry->in_use = 0;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&mbedtls_threading_key_slot_mutex);
+#endif /* MBEDTLS_THREADING_C */
+}
+
+/* Get a GCM context with the key of a one-shot operation set, and fill in
+ * the operation as psa_aead_setup() would. Return NULL when the operation
+ * is not GCM, or when every entry is in use or the key cannot be set: the
+ * caller then goes through psa_aead_setup(), which reports the errors.
+ *
+ * The entry is picked and marked in use under the key slot mutex, the key
+ * schedule is then computed without holding it. An entry in use is never
+ * matched nor evicted, and psa_destroy_key() only flags it for discard. */
+static psa_aead_gcm_cache_entry_t *psa_aead_gcm_cache_acquire(
+    mbedtls_psa_aead_operation_t *operation,
+    const psa_key_attributes_t *attributes,
+    const uint8_t *key_buffer,
+    size_t key_buffer_size,
+    psa_algorithm_t alg)
+{
+    psa_aead_gcm_cache_entry_t *entry = NULL;
+    psa_aead_gcm_cache_entry_t *victim = NULL;
+    mbedtls_cipher_id_t cipher_id;
+    mbedtls_cipher_mode_t mode;
+    size_t key_bits = attributes->bits;
+    size_t i;
+
+    if (PSA_ALG_AEAD_WITH_SHORTENED_TAG(alg, 0) !=
+        PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_GCM, 0) ||
+        PSA_BLOCK_CIPHER_BLOCK_LENGTH(attributes->type) != 16 ||
+        key_buffer_size != PSA_BITS_TO_BYTES(psa_get_key_bits(attributes)) ||
+        mbedtls_svc_key_id_is_null(psa_get_key_id(attributes))) {
+        return NULL;
+    }
+
+    if (mbedtls_cipher_values_from_psa(alg, attributes->type, &key_bits,
+                                       &mode, &cipher_id) != PSA_SUCCESS) {
+        return NULL;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&mbedtls_threading_key_slot_mutex) != 0) {
+        return NULL;
+    }
+#endif /* MBEDTLS_THREADING_C */
+
+    for (i = 0; i < MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE; i++) {
+        psa_aead_gcm_cache_entry_t *candidate = &psa_aead_gcm_cache[i];
+
+        if (psa_aead_gcm_cache_match(candidate, attributes)) {
+            entry = candidate;
+            break;
+        }
+        /* Evict a free entry first, else the least recently used one. */
+        if (!candidate->in_use &&
+            (victim == NULL ||
+             (victim->valid &&
+              (!candidate->valid ||
+               (int32_t) (candidate->last_use - victim->last_use) < 0)))) {
+            victim = candidate;
+        }
+    }
+
+    if (entry == NULL && victim != NULL) {
+        psa_aead_gcm_cache_wipe(victim);
+        mbedtls_gcm_init(&victim->gcm);
+        victim->valid = 1;
+        victim->key_id = psa_get_key_id(attributes);
+        victim->key_type = psa_get_key_type(attributes);
+        victim->key_bits = psa_get_key_bits(attributes);
+        entry = victim;
+    } else {
+        victim = NULL;
+    }
+
+    if (entry != NULL) {
+        entry->in_use = 1;
+        entry->last_use = ++psa_aead_gcm_cache_clock;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&mbedtls_threading_key_slot_mutex);
+#endif /* MBEDTLS_THREADING_C */
+
+    if (victim != NULL &&
+        mbedtls_gcm_setkey(&victim->gcm, cipher_id, key_buffer,
+                           (unsigned int) key_bits) != 0) {
+        victim->discard = 1;
+        psa_aead_gcm_cache_release(victim);
+        entry = NULL;
+    }
+
+    if (entry != NULL) {
+        operation->alg = PSA_ALG_GCM;
+        operation->key_type = psa_get_key_type(attributes);
+        operation->tag_length = PSA_ALG_AEAD_GET_TAG_LENGTH(alg);
+    }
+
+    return entry;
+}
+
+void mbedtls_psa_aead_gcm_cache_invalidate(const mbedtls_svc_key_id_t *key)
+{
+    size_t i;
+
+    for (i = 0; i < MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE; i++) {
+        psa_aead_gcm_cache_entry_t *entry = &psa_aead_gcm_cache[i];
+
+        if (!entry->valid ||
+            (key != NULL && !mbedtls_svc_key_id_equal(entry->key_id, *key))) {
+            continue;
+        }
+        if (entry->in_use) {
+            entry->discard = 1;
+        } else {
+            psa_aead_gcm_cache_wipe(entry);
+        }
+    }
+}
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM && MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0 */
+
 psa_status_t mbedtls_psa_aead_encrypt(
     const psa_key_attributes_t *attributes,
     const uint8_t *key_buffer, size_t key_buffer_size,
@@ -126,7 +305,19 @@ psa_status_t mbedtls_psa_aead_encrypt(
     psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
     mbedtls_psa_aead_operation_t operation = MBEDTLS_PSA_AEAD_OPERATION_INIT;
     uint8_t *tag;
-
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM)
+    mbedtls_gcm_context *gcm = &operation.ctx.gcm;
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM */
+#if defined(PSA_AEAD_GCM_CACHE)
+    psa_aead_gcm_cache_entry_t *cached;
+
+    cached = psa_aead_gcm_cache_acquire(&operation, attributes, key_buffer,
+                                        key_buffer_size, alg);
+    if (cached != NULL) {
+        gcm = &cached->gcm;
+        status = PSA_SUCCESS;
+    } else
+#endif /* PSA_AEAD_GCM_CACHE */
     status = psa_aead_setup(&operation, attributes, key_buffer,
                             key_buffer_size, alg);
 
@@ -157,7 +348,7 @@ psa_status_t mbedtls_psa_aead_encrypt(
 #if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM)
     if (operation.alg == PSA_ALG_GCM) {
         status = mbedtls_to_psa_error(
-            mbedtls_gcm_crypt_and_tag(&operation.ctx.gcm,
+            mbedtls_gcm_crypt_and_tag(gcm,
                                       MBEDTLS_GCM_ENCRYPT,
                                       plaintext_length,
                                       nonce, nonce_length,
@@ -198,6 +389,11 @@ psa_status_t mbedtls_psa_aead_encrypt(
     }
 
 exit:
+#if defined(PSA_AEAD_GCM_CACHE)
+    if (cached != NULL) {
+        psa_aead_gcm_cache_release(cached);
+    } else
+#endif /* PSA_AEAD_GCM_CACHE */
     mbedtls_psa_aead_abort(&operation);
 
     return status;
@@ -238,7 +434,19 @@ psa_status_t mbedtls_psa_aead_decrypt(
     psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
     mbedtls_psa_aead_operation_t operation = MBEDTLS_PSA_AEAD_OPERATION_INIT;
     const uint8_t *tag = NULL;
-
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM)
+    mbedtls_gcm_context *gcm = &operation.ctx.gcm;
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM */
+#if defined(PSA_AEAD_GCM_CACHE)
+    psa_aead_gcm_cache_entry_t *cached;
+
+    cached = psa_aead_gcm_cache_acquire(&operation, attributes, key_buffer,
+                                        key_buffer_size, alg);
+    if (cached != NULL) {
+        gcm = &cached->gcm;
+        status = PSA_SUCCESS;
+    } else
+#endif /* PSA_AEAD_GCM_CACHE */
     status = psa_aead_setup(&operation, attributes, key_buffer,
                             key_buffer_size, alg);
 
@@ -268,7 +476,7 @@ psa_status_t mbedtls_psa_aead_decrypt(
 #if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM)
     if (operation.alg == PSA_ALG_GCM) {
         status = mbedtls_to_psa_error(
-            mbedtls_gcm_auth_decrypt(&operation.ctx.gcm,
+            mbedtls_gcm_auth_decrypt(gcm,
                                      ciphertext_length - operation.tag_length,
                                      nonce, nonce_length,
                                      additional_data,
@@ -308,6 +516,11 @@ psa_status_t mbedtls_psa_aead_decrypt(
     }
 
 exit:
+#if defined(PSA_AEAD_GCM_CACHE)
+    if (cached != NULL) {
+        psa_aead_gcm_cache_release(cached);
+    } else
+#endif /* PSA_AEAD_GCM_CACHE */
     mbedtls_psa_aead_abort(&operation);
 
     if (status == PSA_SUCCESS) {
@@ -11,6 +11,11 @@
 
 #include <psa/crypto.h>
 
+/* See mbedtls_config.h for definition */
+#if !defined(MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE)
+#define MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE 0
+#endif
+
 /**
  * \brief Process an authenticated encryption operation.
  *
@@ -496,4 +501,20 @@ psa_status_t mbedtls_psa_aead_finish(
 psa_status_t mbedtls_psa_aead_abort(
     mbedtls_psa_aead_operation_t *operation);
 
+#if defined(MBEDTLS_PSA_BUILTIN_ALG_GCM) && (MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0)
+/** Drop the GCM contexts prepared for a key by mbedtls_psa_aead_encrypt()
+ *  and mbedtls_psa_aead_decrypt().
+ *
+ * Free entries are wiped immediately, entries in use by another thread are
+ * wiped when that thread releases them.
+ *
+ * \note When #MBEDTLS_THREADING_C is enabled, the caller must hold
+ *       mbedtls_threading_key_slot_mutex.
+ *
+ * \param[in] key    The identifier of the key being destroyed, or \c NULL
+ *                   to drop all the cached contexts.
+ */
+void mbedtls_psa_aead_gcm_cache_invalidate(const mbedtls_svc_key_id_t *key);
+#endif /* MBEDTLS_PSA_BUILTIN_ALG_GCM && MBEDTLS_PSA_GCM_CONTEXT_CACHE_SIZE > 0 */
+
 #endif /* PSA_CRYPTO_AEAD_H */
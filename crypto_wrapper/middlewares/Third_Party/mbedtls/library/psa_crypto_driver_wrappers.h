@@ -396,6 +396,52 @@ static inline psa_status_t psa_driver_wrapper_sign_hash(
     }
 }
 
+/* Sign several hashes with the same key in one driver call. Only opaque
+ * drivers with a batch entry point implement it: PSA_ERROR_NOT_SUPPORTED
+ * lets the core sign the hashes one by one. */
+static inline psa_status_t psa_driver_wrapper_sign_hash_batch(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *key_buffer, size_t key_buffer_size,
+    psa_algorithm_t alg, const uint8_t *hashes, size_t hash_length,
+    size_t hash_count, uint8_t *signatures, size_t signatures_size,
+    size_t *signatures_length )
+{
+    psa_key_location_t location =
+        PSA_KEY_LIFETIME_GET_LOCATION( psa_get_key_lifetime(attributes) );
+
+    switch( location )
+    {
+#if defined(PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT)
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            return( mbedtls_kwe_opaque_signature_sign_hash_batch
+            (attributes,
+                            key_buffer,
+                            key_buffer_size,
+                            alg,
+                            hashes,
+                            hash_length,
+                            hash_count,
+                            signatures,
+                            signatures_size,
+                            signatures_length
+        ));
+#endif
+#endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
+        default:
+            (void) key_buffer;
+            (void) key_buffer_size;
+            (void) alg;
+            (void) hashes;
+            (void) hash_length;
+            (void) hash_count;
+            (void) signatures;
+            (void) signatures_size;
+            (void) signatures_length;
+            return( PSA_ERROR_NOT_SUPPORTED );
+    }
+}
+
 static inline psa_status_t psa_driver_wrapper_verify_hash(
     const psa_key_attributes_t *attributes,
     const uint8_t *key_buffer, size_t key_buffer_size,
@@ -1015,6 +1061,36 @@ static inline psa_status_t psa_driver_wrapper_import_key(
 
 }
 
+static inline psa_status_t psa_driver_wrapper_destroy_key(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *key_buffer, size_t key_buffer_size )
+{
+    psa_key_location_t location = PSA_KEY_LIFETIME_GET_LOCATION(
+                                      psa_get_key_lifetime( attributes ) );
+
+    switch( location )
+    {
+        /* Add cases for opaque driver here */
+#if defined(PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT)
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            return( mbedtls_kwe_opaque_destroy_key
+            (attributes,
+                            key_buffer,
+                            key_buffer_size
+        ));
+#endif
+
+#endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
+        default:
+            /* Nothing to release for keys held in memory only */
+            (void) key_buffer;
+            (void) key_buffer_size;
+            return( PSA_SUCCESS );
+    }
+}
+
 static inline psa_status_t psa_driver_wrapper_export_key(
     const psa_key_attributes_t *attributes,
     const uint8_t *key_buffer, size_t key_buffer_size,
@@ -1399,6 +1475,20 @@ static inline psa_status_t psa_driver_wrapper_cipher_encrypt_setup(
 
             return( status );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            status = mbedtls_kwe_opaque_cipher_encrypt_setup(
+                         &operation->ctx.kwe_opaque_ctx,
+                         attributes,
+                         key_buffer, key_buffer_size,
+                         alg );
+
+            if( status == PSA_SUCCESS )
+                operation->id = MBEDTLS_KWE_OPAQUE_DRIVER_ID;
+
+            return( status );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
         default:
             /* Key is declared with a lifetime not known to us */
@@ -1472,6 +1562,20 @@ static inline psa_status_t psa_driver_wrapper_cipher_decrypt_setup(
 
             return( status );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            status = mbedtls_kwe_opaque_cipher_decrypt_setup(
+                         &operation->ctx.kwe_opaque_ctx,
+                         attributes,
+                         key_buffer, key_buffer_size,
+                         alg );
+
+            if( status == PSA_SUCCESS )
+                operation->id = MBEDTLS_KWE_OPAQUE_DRIVER_ID;
+
+            return( status );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
         default:
             /* Key is declared with a lifetime not known to us */
@@ -1510,6 +1614,13 @@ static inline psa_status_t psa_driver_wrapper_cipher_set_iv(
                         &operation->ctx.opaque_test_driver_ctx,
                         iv, iv_length ) );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_cipher_set_iv(
+                        &operation->ctx.kwe_opaque_ctx,
+                        iv, iv_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -1553,6 +1664,14 @@ static inline psa_status_t psa_driver_wrapper_cipher_update(
                         input, input_length,
                         output, output_size, output_length ) );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_cipher_update(
+                        &operation->ctx.kwe_opaque_ctx,
+                        input, input_length,
+                        output, output_size, output_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -1593,6 +1712,13 @@ static inline psa_status_t psa_driver_wrapper_cipher_finish(
                         &operation->ctx.opaque_test_driver_ctx,
                         output, output_size, output_length ) );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_cipher_finish(
+                        &operation->ctx.kwe_opaque_ctx,
+                        output, output_size, output_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -1633,6 +1759,16 @@ static inline psa_status_t psa_driver_wrapper_cipher_abort(
                 sizeof( operation->ctx.opaque_test_driver_ctx ) );
             return( status );
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            status = mbedtls_kwe_opaque_cipher_abort(
+                         &operation->ctx.kwe_opaque_ctx );
+            mbedtls_platform_zeroize(
+                &operation->ctx.kwe_opaque_ctx,
+                sizeof( operation->ctx.kwe_opaque_ctx ) );
+            return( status );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -1990,6 +2126,21 @@ static inline psa_status_t psa_driver_wrapper_aead_encrypt_setup(
             return( status );
 
         /* Add cases for opaque driver here */
+#if defined(PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT)
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            status = mbedtls_kwe_opaque_aead_encrypt_setup(
+                        &operation->ctx.kwe_opaque_ctx,
+                        attributes,
+                        key_buffer, key_buffer_size,
+                        alg );
+
+            if( status == PSA_SUCCESS )
+                operation->id = MBEDTLS_KWE_OPAQUE_DRIVER_ID;
+
+            return( status );
+#endif
+#endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
 
         default:
             /* Key is declared with a lifetime not known to us */
@@ -2040,6 +2191,21 @@ static inline psa_status_t psa_driver_wrapper_aead_decrypt_setup(
             return( status );
 
         /* Add cases for opaque driver here */
+#if defined(PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT)
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case PSA_CRYPTO_KWE_DRIVER_LOCATION:
+            status = mbedtls_kwe_opaque_aead_decrypt_setup(
+                        &operation->ctx.kwe_opaque_ctx,
+                        attributes,
+                        key_buffer, key_buffer_size,
+                        alg );
+
+            if( status == PSA_SUCCESS )
+                operation->id = MBEDTLS_KWE_OPAQUE_DRIVER_ID;
+
+            return( status );
+#endif
+#endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
 
         default:
             /* Key is declared with a lifetime not known to us */
@@ -2073,6 +2239,13 @@ static inline psa_status_t psa_driver_wrapper_aead_set_nonce(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_set_nonce(
+                         &operation->ctx.kwe_opaque_ctx,
+                         nonce, nonce_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2107,6 +2280,13 @@ static inline psa_status_t psa_driver_wrapper_aead_set_lengths(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_set_lengths(
+                        &operation->ctx.kwe_opaque_ctx,
+                        ad_length, plaintext_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2141,6 +2321,13 @@ static inline psa_status_t psa_driver_wrapper_aead_update_ad(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_update_ad(
+                        &operation->ctx.kwe_opaque_ctx,
+                        input, input_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2180,6 +2367,14 @@ static inline psa_status_t psa_driver_wrapper_aead_update(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_update(
+                        &operation->ctx.kwe_opaque_ctx,
+                        input, input_length, output, output_size,
+                        output_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2224,6 +2419,14 @@ static inline psa_status_t psa_driver_wrapper_aead_finish(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_finish(
+                        &operation->ctx.kwe_opaque_ctx,
+                        ciphertext, ciphertext_size,
+                        ciphertext_length, tag, tag_size, tag_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2288,6 +2491,14 @@ static inline psa_status_t psa_driver_wrapper_aead_verify(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_verify(
+                        &operation->ctx.kwe_opaque_ctx,
+                        plaintext, plaintext_size,
+                        plaintext_length, tag, tag_length ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -2320,6 +2531,12 @@ static inline psa_status_t psa_driver_wrapper_aead_abort(
         /* Add cases for opaque driver here */
 
 #endif /* PSA_CRYPTO_DRIVER_TEST */
+
+#if (defined(PSA_KWE_DRIVER_ENABLED) )
+        case MBEDTLS_KWE_OPAQUE_DRIVER_ID:
+            return( mbedtls_kwe_opaque_aead_abort(
+               &operation->ctx.kwe_opaque_ctx ) );
+#endif
 #endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
     }
 
@@ -508,6 +508,74 @@ cleanup:
     return status;
 }
 
+#if defined(MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH)
+psa_status_t mbedtls_psa_ecdsa_verify_hash_batch(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *const key_buffers[], const size_t key_buffer_sizes[],
+    const mbedtls_psa_verify_hash_batch_item_t *items, size_t count,
+    psa_status_t *results)
+{
+    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ecp_group_id grp_id;
+    mbedtls_ecp_group grp;
+    mbedtls_ecdsa_verify_item batch[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    int batch_results[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    size_t batch_index[MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE];
+    size_t curve_bytes;
+    size_t n = 0;
+    size_t i;
+
+    if (count > MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    grp_id = mbedtls_ecc_group_from_psa(PSA_KEY_TYPE_ECC_GET_FAMILY(attributes->type),
+                                        attributes->bits);
+    if (grp_id == MBEDTLS_ECP_DP_NONE) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* The curve is loaded once for the whole batch */
+    mbedtls_ecp_group_init(&grp);
+    status = mbedtls_to_psa_error(mbedtls_ecp_group_load(&grp, grp_id));
+    if (status != PSA_SUCCESS) {
+        goto cleanup;
+    }
+
+    curve_bytes = PSA_BITS_TO_BYTES(grp.pbits);
+
+    /* The key buffers hold the uncompressed points checked at import and the
+     * signatures are r || s: both go to the PKA as they are. */
+    for (i = 0; i < count; i++) {
+        if (items[i].signature_length != 2 * curve_bytes) {
+            results[i] = PSA_ERROR_INVALID_SIGNATURE;
+            continue;
+        }
+
+        batch[n].Q = key_buffers[i];
+        batch[n].Q_len = key_buffer_sizes[i];
+        batch[n].hash = items[i].hash;
+        batch[n].hlen = items[i].hash_length;
+        batch[n].r = items[i].signature;
+        batch[n].s = items[i].signature + curve_bytes;
+        batch[n].rs_len = curve_bytes;
+        batch_index[n] = i;
+        n++;
+    }
+
+    (void) mbedtls_ecdsa_verify_batch(&grp, batch, n, batch_results);
+
+    for (i = 0; i < n; i++) {
+        results[batch_index[i]] = mbedtls_to_psa_error(batch_results[i]);
+    }
+
+cleanup:
+    mbedtls_ecp_group_free(&grp);
+
+    return status;
+}
+#endif /* MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH */
+
 #endif /* defined(MBEDTLS_PSA_BUILTIN_ALG_ECDSA) || \
         * defined(MBEDTLS_PSA_BUILTIN_ALG_DETERMINISTIC_ECDSA) */
 
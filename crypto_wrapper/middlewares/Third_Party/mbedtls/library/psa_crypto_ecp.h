@@ -12,6 +12,21 @@
 #include <psa/crypto.h>
 #include <mbedtls/ecp.h>
 
+/* See mbedtls_config.h for definition */
+#if !defined(MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE)
+#define MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE 8
+#endif
+
+/* ECDSA signatures of a batch are verified together on the PKA, unless a
+ * transparent driver takes over the verification. */
+#if defined(MBEDTLS_HAL_ECDSA_ALT) && defined(MBEDTLS_ECDSA_VERIFY_ALT) && \
+    (defined(MBEDTLS_PSA_BUILTIN_ALG_ECDSA) || \
+    defined(MBEDTLS_PSA_BUILTIN_ALG_DETERMINISTIC_ECDSA)) && \
+    !defined(MBEDTLS_PSA_P256M_DRIVER_ENABLED) && !defined(PSA_CRYPTO_DRIVER_TEST) && \
+    (MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE > 1)
+#define MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH
+#endif
+
 /** Load the contents of a key buffer into an internal ECP representation
  *
  * \param[in] type          The type of key contained in \p data.
@@ -216,6 +231,35 @@ psa_status_t mbedtls_psa_ecdsa_verify_hash(
     psa_algorithm_t alg, const uint8_t *hash, size_t hash_length,
     const uint8_t *signature, size_t signature_length);
 
+#if defined(MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH)
+/**
+ * \brief Verify a batch of ECDSA hash signatures made with public keys of
+ *        the same curve, in a single PKA session.
+ *
+ * \param[in]  attributes       The attributes shared by the keys: their
+ *                              ECC public key type and bit size.
+ * \param[in]  key_buffers      The public keys, in export representation.
+ * \param[in]  key_buffer_sizes Size of each key buffer in bytes.
+ * \param[in]  items            The hashes and signatures to verify. Their
+ *                              key and algorithm are not used.
+ * \param      count            Number of signatures, at most
+ *                              #MBEDTLS_PSA_ECDSA_VERIFY_BATCH_SIZE.
+ * \param[out] results          The status of each signature, set on
+ *                              success only.
+ *
+ * \retval #PSA_SUCCESS
+ *         Each signature has its status in \p results.
+ * \retval #PSA_ERROR_NOT_SUPPORTED \emptydescription
+ * \retval #PSA_ERROR_INVALID_ARGUMENT \emptydescription
+ * \retval #PSA_ERROR_INSUFFICIENT_MEMORY \emptydescription
+ */
+psa_status_t mbedtls_psa_ecdsa_verify_hash_batch(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *const key_buffers[], const size_t key_buffer_sizes[],
+    const mbedtls_psa_verify_hash_batch_item_t *items, size_t count,
+    psa_status_t *results);
+#endif /* MBEDTLS_PSA_ECDSA_VERIFY_HASH_BATCH */
+
 
 /** Perform a key agreement and return the raw ECDH shared secret.
  *
@@ -21,9 +21,31 @@
 #include <string.h>
 
 #if defined(MBEDTLS_PSA_BUILTIN_ALG_HMAC)
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+/* Hash algorithms of the HMAC mode of the HASH peripheral */
+static mbedtls_md_type_t psa_hmac_hw_md_type(psa_algorithm_t hash_alg)
+{
+    switch (hash_alg) {
+        case PSA_ALG_SHA_1:
+            return MBEDTLS_MD_SHA1;
+        case PSA_ALG_SHA_224:
+            return MBEDTLS_MD_SHA224;
+        case PSA_ALG_SHA_256:
+            return MBEDTLS_MD_SHA256;
+        default:
+            return MBEDTLS_MD_NONE;
+    }
+}
+#endif /* MBEDTLS_HAL_HMAC_ALT */
+
 static psa_status_t psa_hmac_abort_internal(
     mbedtls_psa_hmac_operation_t *hmac)
 {
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+    if (hmac->hw.md_type != MBEDTLS_MD_NONE) {
+        mbedtls_hmac_free(&hmac->hw);
+    }
+#endif /* MBEDTLS_HAL_HMAC_ALT */
     mbedtls_platform_zeroize(hmac->opad, sizeof(hmac->opad));
     return psa_hash_abort(&hmac->hash_ctx);
 }
@@ -58,6 +80,26 @@ static psa_status_t psa_hmac_setup_internal(
         return PSA_ERROR_NOT_SUPPORTED;
     }
 
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+    if (psa_hmac_hw_md_type(hash_alg) != MBEDTLS_MD_NONE) {
+        /* The peripheral pads the key and computes both hashes itself */
+        if (key_length > block_size) {
+            status = psa_hash_compute(hash_alg, key, key_length,
+                                      ipad, sizeof(ipad), &key_length);
+            if (status != PSA_SUCCESS) {
+                goto cleanup;
+            }
+            key = ipad;
+        }
+
+        mbedtls_hmac_init(&hmac->hw);
+        status = mbedtls_to_psa_error(
+            mbedtls_hmac_starts(&hmac->hw, psa_hmac_hw_md_type(hash_alg),
+                                key, key_length));
+        goto cleanup;
+    }
+#endif /* MBEDTLS_HAL_HMAC_ALT */
+
     if (key_length > block_size) {
         status = psa_hash_compute(hash_alg, key, key_length,
                                   ipad, sizeof(ipad), &key_length);
@@ -105,6 +147,12 @@ static psa_status_t psa_hmac_update_internal(
     const uint8_t *data,
     size_t data_length)
 {
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+    if (hmac->hw.md_type != MBEDTLS_MD_NONE) {
+        return mbedtls_to_psa_error(
+            mbedtls_hmac_update(&hmac->hw, data, data_length));
+    }
+#endif /* MBEDTLS_HAL_HMAC_ALT */
     return psa_hash_update(&hmac->hash_ctx, data, data_length);
 }
 
@@ -119,6 +167,17 @@ static psa_status_t psa_hmac_finish_internal(
     size_t block_size = PSA_HASH_BLOCK_LENGTH(hash_alg);
     psa_status_t status;
 
+#if defined(MBEDTLS_HAL_HMAC_ALT)
+    if (hmac->hw.md_type != MBEDTLS_MD_NONE) {
+        hash_size = PSA_HASH_LENGTH(hash_alg);
+        status = mbedtls_to_psa_error(mbedtls_hmac_finish(&hmac->hw, tmp));
+        if (status == PSA_SUCCESS) {
+            memcpy(mac, tmp, mac_size);
+        }
+        goto exit;
+    }
+#endif /* MBEDTLS_HAL_HMAC_ALT */
+
     status = psa_hash_finish(&hmac->hash_ctx, tmp, sizeof(tmp), &hash_size);
     if (status != PSA_SUCCESS) {
         return status;
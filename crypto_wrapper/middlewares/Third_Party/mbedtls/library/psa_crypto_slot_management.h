@@ -341,4 +341,23 @@ psa_status_t psa_validate_key_persistence(psa_key_lifetime_t lifetime);
  */
 int psa_is_valid_key_id(mbedtls_svc_key_id_t key, int vendor_ok);
 
+/** Validate the internal consistency of key attributes.
+ *
+ * This is the check psa_import_key() and the other key creation functions
+ * run first: key location and persistence, key identifier out of the
+ * vendor range, usage policy and key size. It does not validate the
+ * consistency of the attributes with any key data.
+ *
+ * \param[in] attributes    Key attributes for the new key.
+ * \param[out] p_drv        On any return, the driver for the key, if any.
+ *                          NULL for a transparent key.
+ *
+ * \retval #PSA_SUCCESS \emptydescription
+ * \retval #PSA_ERROR_INVALID_ARGUMENT \emptydescription
+ * \retval #PSA_ERROR_NOT_SUPPORTED \emptydescription
+ */
+psa_status_t psa_validate_key_attributes(
+    const psa_key_attributes_t *attributes,
+    psa_se_drv_table_entry_t **p_drv);
+
 #endif /* PSA_CRYPTO_SLOT_MANAGEMENT_H */
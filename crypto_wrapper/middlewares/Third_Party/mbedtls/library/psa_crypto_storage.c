@@ -20,6 +20,9 @@
 
 #if defined(MBEDTLS_PSA_ITS_FILE_C) || defined(PSA_USE_ITS_ALT)
 #include "psa_crypto_its.h"
+#if defined(PSA_USE_ITS_ALT)
+#include "psa_its_alt.h"
+#endif
 #else /* Native ITS implementation */
 #include "mbedtls/error.h"
 #include "psa/internal_trusted_storage.h"
@@ -348,6 +351,70 @@ psa_status_t psa_save_persistent_key(const psa_key_attributes_t *attr,
     return status;
 }
 
+#if defined(PSA_USE_ITS_ALT)
+psa_status_t psa_save_persistent_keys(const psa_key_attributes_t *attrs,
+                                      const uint8_t *const *data,
+                                      const size_t *data_lengths,
+                                      size_t key_count)
+{
+    its_batch_entry_t entries[ITS_BATCH_MAX_OBJECTS];
+    uint8_t *storage_data[ITS_BATCH_MAX_OBJECTS] = { NULL };
+    size_t storage_data_lengths[ITS_BATCH_MAX_OBJECTS] = { 0 };
+    psa_status_t status = PSA_SUCCESS;
+    size_t i;
+
+    if (key_count > ITS_BATCH_MAX_OBJECTS) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    for (i = 0; i < key_count; i++) {
+        /* All keys saved to persistent storage always have a key context */
+        if (data[i] == NULL || data_lengths[i] == 0) {
+            status = PSA_ERROR_INVALID_ARGUMENT;
+            goto exit;
+        }
+
+        if (data_lengths[i] > PSA_CRYPTO_MAX_STORAGE_SIZE) {
+            status = PSA_ERROR_INSUFFICIENT_STORAGE;
+            goto exit;
+        }
+
+        if (psa_is_key_present_in_storage(attrs[i].id) == 1) {
+            status = PSA_ERROR_ALREADY_EXISTS;
+            goto exit;
+        }
+
+        storage_data_lengths[i] = data_lengths[i] +
+                                  sizeof(psa_persistent_key_storage_format);
+        storage_data[i] = mbedtls_calloc(1, storage_data_lengths[i]);
+        if (storage_data[i] == NULL) {
+            status = PSA_ERROR_INSUFFICIENT_MEMORY;
+            goto exit;
+        }
+
+        psa_format_key_data_for_storage(data[i], data_lengths[i], &attrs[i],
+                                        storage_data[i]);
+
+        entries[i].uid = psa_its_identifier_of_slot(attrs[i].id);
+        entries[i].data_length = (uint32_t) storage_data_lengths[i];
+        entries[i].p_data = storage_data[i];
+        entries[i].create_flags = 0;
+    }
+
+    /* The storage writes the keys or, on failure, removes the ones written */
+    status = psa_its_set_batch(entries, (uint32_t) key_count);
+
+exit:
+    for (i = 0; i < key_count; i++) {
+        if (storage_data[i] != NULL) {
+            mbedtls_zeroize_and_free(storage_data[i], storage_data_lengths[i]);
+        }
+    }
+
+    return status;
+}
+#endif /* PSA_USE_ITS_ALT */
+
 void psa_free_persistent_key_data(uint8_t *key_data, size_t key_data_length)
 {
     mbedtls_zeroize_and_free(key_data, key_data_length);
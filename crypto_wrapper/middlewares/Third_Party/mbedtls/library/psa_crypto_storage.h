@@ -104,6 +104,37 @@ psa_status_t psa_save_persistent_key(const psa_key_attributes_t *attr,
                                      const uint8_t *data,
                                      const size_t data_length);
 
+#if defined(PSA_USE_ITS_ALT)
+/**
+ * \brief Format key data and metadata of several keys and save them to
+ *        persistent storage as one storage batch.
+ *
+ * This is the batch counterpart of psa_save_persistent_key(), used to
+ * provision many keys at once. The storage locations of all the keys must
+ * be empty. The storage backend checks the whole batch before writing and
+ * removes the keys already written if a write fails, so either all the
+ * keys are saved or none of them is. The keys are still written one by
+ * one: a reset during the call can leave part of the batch stored.
+ *
+ * \param[in] attrs         The attributes of the keys to save.
+ * \param[in] data          Buffers containing the key data.
+ * \param[in] data_lengths  The number of bytes that make up each key data.
+ * \param key_count         The number of keys, at most
+ *                          #ITS_BATCH_MAX_OBJECTS.
+ *
+ * \retval #PSA_SUCCESS \emptydescription
+ * \retval #PSA_ERROR_INVALID_ARGUMENT \emptydescription
+ * \retval #PSA_ERROR_INSUFFICIENT_MEMORY \emptydescription
+ * \retval #PSA_ERROR_INSUFFICIENT_STORAGE \emptydescription
+ * \retval #PSA_ERROR_STORAGE_FAILURE \emptydescription
+ * \retval #PSA_ERROR_ALREADY_EXISTS \emptydescription
+ */
+psa_status_t psa_save_persistent_keys(const psa_key_attributes_t *attrs,
+                                      const uint8_t *const *data,
+                                      const size_t *data_lengths,
+                                      size_t key_count);
+#endif /* PSA_USE_ITS_ALT */
+
 /**
  * \brief Parses key data and metadata and load persistent key for given
  * key slot number.
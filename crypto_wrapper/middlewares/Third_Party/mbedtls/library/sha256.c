@@ -131,6 +131,72 @@
 #  undef MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT
 #endif
 
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+#  if !defined(MBEDTLS_ARCH_IS_X64)
+#    undef MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT
+#  elif defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+/* The SHA-NI and AVX2 code is compiled with per-function target attributes,
+ * so the rest of the file does not require these instructions. */
+#    include <cpuid.h>
+#    include <immintrin.h>
+#    define MBEDTLS_SHA256_TARGET_SHA_NI __attribute__((target("sha,sse4.1,ssse3")))
+#    define MBEDTLS_SHA256_TARGET_AVX2   __attribute__((target("avx2")))
+#  else
+#    error "Only GCC >= 5 and Clang supported for MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT"
+#  endif
+#endif
+
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+#define MBEDTLS_SHA256_X86_SHA_NI  0x01u
+#define MBEDTLS_SHA256_X86_AVX2    0x02u
+
+/*
+ * x86 SHA extensions and AVX2 support detection with CPUID
+ */
+static unsigned int mbedtls_x86_sha256_determine_support(void)
+{
+    unsigned int eax, ebx, ecx, edx, xcr0_lo, xcr0_hi;
+    unsigned int caps = 0;
+
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return 0;
+    }
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    const unsigned int leaf1_ecx = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    /* SHA-NI code also uses SSSE3 (ECX bit 9) and SSE4.1 (ECX bit 19) */
+    if ((ebx & (1u << 29)) && (leaf1_ecx & (1u << 9)) && (leaf1_ecx & (1u << 19))) {
+        caps |= MBEDTLS_SHA256_X86_SHA_NI;
+    }
+
+    /* AVX2 also needs the OS to save the YMM registers (OSXSAVE, XCR0) */
+    if ((ebx & (1u << 5)) && (leaf1_ecx & (1u << 27)) && (leaf1_ecx & (1u << 28))) {
+        __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+        (void) xcr0_hi;
+        if ((xcr0_lo & 0x6) == 0x6) {
+            caps |= MBEDTLS_SHA256_X86_AVX2;
+        }
+    }
+
+    return caps;
+}
+
+static int mbedtls_x86_sha256_has_support(unsigned int what)
+{
+    static int done = 0;
+    static unsigned int caps = 0;
+
+    if (!done) {
+        caps = mbedtls_x86_sha256_determine_support();
+        done = 1;
+    }
+
+    return (caps & what) != 0;
+}
+#endif /* MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT */
+
 #if defined(MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT)
 /*
  * Capability detection code comes early, so we can disable
@@ -447,7 +513,87 @@ int mbedtls_internal_sha256_process_a64_crypto(mbedtls_sha256_context *ctx,
 #undef MBEDTLS_POP_TARGET_PRAGMA
 #endif
 
-#if !defined(MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT)
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+
+/*
+ * SHA-NI keeps the state as ABEF and CDGH, two rounds per SHA256RNDS2
+ */
+MBEDTLS_SHA256_TARGET_SHA_NI
+static size_t mbedtls_internal_sha256_process_many_x86_sha_ni(
+    mbedtls_sha256_context *ctx, const uint8_t *msg, size_t len)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp, abef, cdgh;
+
+    tmp  = _mm_loadu_si128((const __m128i *) &ctx->state[0]);   /* DCBA */
+    cdgh = _mm_loadu_si128((const __m128i *) &ctx->state[4]);   /* HGFE */
+    tmp  = _mm_shuffle_epi32(tmp, 0xB1);                        /* CDAB */
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1B);                       /* EFGH */
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);                       /* ABEF */
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);                    /* CDGH */
+
+    size_t processed = 0;
+
+    for (;
+         len >= SHA256_BLOCK_SIZE;
+         processed += SHA256_BLOCK_SIZE,
+         msg += SHA256_BLOCK_SIZE,
+         len -= SHA256_BLOCK_SIZE) {
+        __m128i sched[4];
+
+        const __m128i abef_orig = abef;
+        const __m128i cdgh_orig = cdgh;
+
+        for (int t = 0; t < 64; t += 4) {
+            __m128i *w = &sched[(t / 4) & 3];
+
+            if (t < 16) {
+                *w = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (msg + 4 * t)),
+                                      bswap);
+            } else {
+                /* W[t..t+3] from W[t-16..t-1], held in w and the three next */
+                const __m128i w1 = sched[(t / 4 + 1) & 3];
+                const __m128i w2 = sched[(t / 4 + 2) & 3];
+                const __m128i w3 = sched[(t / 4 + 3) & 3];
+                tmp = _mm_add_epi32(_mm_sha256msg1_epu32(*w, w1),
+                                    _mm_alignr_epi8(w3, w2, 4));
+                *w = _mm_sha256msg2_epu32(tmp, w3);
+            }
+
+            /* Rounds t to t + 3 */
+            tmp  = _mm_add_epi32(*w, _mm_loadu_si128((const __m128i *) &K[t]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, tmp);
+            tmp  = _mm_shuffle_epi32(tmp, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, tmp);
+        }
+
+        abef = _mm_add_epi32(abef, abef_orig);
+        cdgh = _mm_add_epi32(cdgh, cdgh_orig);
+    }
+
+    tmp  = _mm_shuffle_epi32(abef, 0x1B);                       /* FEBA */
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);                       /* DCHG */
+    abef = _mm_blend_epi16(tmp, cdgh, 0xF0);                    /* DCBA */
+    cdgh = _mm_alignr_epi8(cdgh, tmp, 8);                       /* HGFE */
+
+    _mm_storeu_si128((__m128i *) &ctx->state[0], abef);
+    _mm_storeu_si128((__m128i *) &ctx->state[4], cdgh);
+
+    return processed;
+}
+
+static int mbedtls_internal_sha256_process_x86_sha_ni(mbedtls_sha256_context *ctx,
+                                                      const unsigned char data[SHA256_BLOCK_SIZE])
+{
+    return (mbedtls_internal_sha256_process_many_x86_sha_ni(ctx, data,
+                                                            SHA256_BLOCK_SIZE) ==
+            SHA256_BLOCK_SIZE) ? 0 : -1;
+}
+
+#endif /* MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT */
+
+#if !defined(MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT) && \
+    !defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
 #define mbedtls_internal_sha256_process_many_c mbedtls_internal_sha256_process_many
 #define mbedtls_internal_sha256_process_c      mbedtls_internal_sha256_process
 #endif
@@ -482,10 +628,12 @@ int mbedtls_internal_sha256_process_a64_crypto(mbedtls_sha256_context *ctx,
         (d) += local.temp1; (h) = local.temp1 + local.temp2;        \
     } while (0)
 
-#if defined(MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT)
+#if defined(MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT) || \
+    defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
 /*
  * This function is for internal use only if we are building both C and Armv8
- * versions, otherwise it is renamed to be the public mbedtls_internal_sha256_process()
+ * or x86 versions, otherwise it is renamed to be the public
+ * mbedtls_internal_sha256_process()
  */
 static
 #endif
@@ -638,6 +786,30 @@ int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
 
 #endif /* MBEDTLS_SHA256_USE_ARMV8_A_CRYPTO_IF_PRESENT */
 
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+
+static size_t mbedtls_internal_sha256_process_many(mbedtls_sha256_context *ctx,
+                                                   const uint8_t *msg, size_t len)
+{
+    if (mbedtls_x86_sha256_has_support(MBEDTLS_SHA256_X86_SHA_NI)) {
+        return mbedtls_internal_sha256_process_many_x86_sha_ni(ctx, msg, len);
+    } else {
+        return mbedtls_internal_sha256_process_many_c(ctx, msg, len);
+    }
+}
+
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
+                                    const unsigned char data[SHA256_BLOCK_SIZE])
+{
+    if (mbedtls_x86_sha256_has_support(MBEDTLS_SHA256_X86_SHA_NI)) {
+        return mbedtls_internal_sha256_process_x86_sha_ni(ctx, data);
+    } else {
+        return mbedtls_internal_sha256_process_c(ctx, data);
+    }
+}
+
+#endif /* MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT */
+
 
 /*
  * SHA-256 process buffer
@@ -765,6 +937,240 @@ exit:
     return ret;
 }
 
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+
+#define SHA256_LANES 8
+
+/*
+ * One message of a batch, hashed in one 32-bit lane of the AVX2 registers
+ */
+typedef struct {
+    uint32_t state[8];                          /* Intermediate digest */
+    const unsigned char *input;                 /* Message, for its full blocks */
+    size_t blocks;                              /* Number of full blocks */
+    size_t total;                               /* Full and tail blocks */
+    size_t next;                                /* Next block to hash */
+    unsigned char tail[2 * SHA256_BLOCK_SIZE];  /* Partial block and padding */
+    unsigned char *output;                      /* Digest, NULL for an idle lane */
+} mbedtls_sha256_lane;
+
+#define V_ADD(x, y)    _mm256_add_epi32(x, y)
+#define V_ROTR(x, n)   _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+#define V_S0(x) _mm256_xor_si256(_mm256_xor_si256(V_ROTR(x, 7), V_ROTR(x, 18)),  \
+                                 _mm256_srli_epi32(x, 3))
+#define V_S1(x) _mm256_xor_si256(_mm256_xor_si256(V_ROTR(x, 17), V_ROTR(x, 19)), \
+                                 _mm256_srli_epi32(x, 10))
+
+#define V_S2(x) _mm256_xor_si256(_mm256_xor_si256(V_ROTR(x, 2), V_ROTR(x, 13)),  \
+                                 V_ROTR(x, 22))
+#define V_S3(x) _mm256_xor_si256(_mm256_xor_si256(V_ROTR(x, 6), V_ROTR(x, 11)),  \
+                                 V_ROTR(x, 25))
+
+#define V_F0(x, y, z) _mm256_or_si256(_mm256_and_si256(x, y),                    \
+                                      _mm256_and_si256(z, _mm256_or_si256(x, y)))
+#define V_F1(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+
+#define V_GATHER(p, i)                                                        \
+    _mm256_setr_epi32((int) (p)[0][i], (int) (p)[1][i], (int) (p)[2][i],     \
+                      (int) (p)[3][i], (int) (p)[4][i], (int) (p)[5][i],     \
+                      (int) (p)[6][i], (int) (p)[7][i])
+
+/*
+ * Eight independent SHA-256 compressions, one block per lane
+ */
+MBEDTLS_SHA256_TARGET_AVX2
+static void mbedtls_internal_sha256_process_x8_avx2(uint32_t *const state[SHA256_LANES],
+                                                    const unsigned char *const data[SHA256_LANES])
+{
+    struct {
+        __m256i W[16];
+        uint32_t words[SHA256_LANES][16];
+    } local;
+    __m256i a, b, c, d, e, f, g, h, temp1, temp2;
+    unsigned int i, t;
+
+    for (i = 0; i < SHA256_LANES; i++) {
+        for (t = 0; t < 16; t++) {
+            local.words[i][t] = MBEDTLS_GET_UINT32_BE(data[i], 4 * t);
+        }
+    }
+
+    a = V_GATHER(state, 0);
+    b = V_GATHER(state, 1);
+    c = V_GATHER(state, 2);
+    d = V_GATHER(state, 3);
+    e = V_GATHER(state, 4);
+    f = V_GATHER(state, 5);
+    g = V_GATHER(state, 6);
+    h = V_GATHER(state, 7);
+
+    for (t = 0; t < 64; t++) {
+        __m256i *w = &local.W[t & 15];
+
+        if (t < 16) {
+            *w = V_GATHER(local.words, t);
+        } else {
+            *w = V_ADD(V_ADD(V_S1(local.W[(t - 2) & 15]), local.W[(t - 7) & 15]),
+                       V_ADD(V_S0(local.W[(t - 15) & 15]), *w));
+        }
+
+        temp1 = V_ADD(V_ADD(h, V_S3(e)),
+                      V_ADD(V_F1(e, f, g), V_ADD(_mm256_set1_epi32((int) K[t]), *w)));
+        temp2 = V_ADD(V_S2(a), V_F0(a, b, c));
+
+        h = g; g = f; f = e; e = V_ADD(d, temp1);
+        d = c; c = b; b = a; a = V_ADD(temp1, temp2);
+    }
+
+    {
+        uint32_t out[8][SHA256_LANES];
+
+        _mm256_storeu_si256((__m256i *) out[0], a);
+        _mm256_storeu_si256((__m256i *) out[1], b);
+        _mm256_storeu_si256((__m256i *) out[2], c);
+        _mm256_storeu_si256((__m256i *) out[3], d);
+        _mm256_storeu_si256((__m256i *) out[4], e);
+        _mm256_storeu_si256((__m256i *) out[5], f);
+        _mm256_storeu_si256((__m256i *) out[6], g);
+        _mm256_storeu_si256((__m256i *) out[7], h);
+
+        for (i = 0; i < SHA256_LANES; i++) {
+            for (t = 0; t < 8; t++) {
+                state[i][t] += out[t][i];
+            }
+        }
+
+        mbedtls_platform_zeroize(out, sizeof(out));
+    }
+
+    /* Zeroise buffers and variables to clear sensitive data from memory. */
+    mbedtls_platform_zeroize(&local, sizeof(local));
+}
+
+#undef V_GATHER
+#undef V_F1
+#undef V_F0
+#undef V_S3
+#undef V_S2
+#undef V_S1
+#undef V_S0
+#undef V_ROTR
+#undef V_ADD
+
+/*
+ * Give a lane its next message: the full blocks are read in place, the
+ * remaining bytes are padded in the lane.
+ */
+static void mbedtls_sha256_lane_load(mbedtls_sha256_lane *lane,
+                                     const uint32_t iv[8],
+                                     const unsigned char *input,
+                                     size_t ilen,
+                                     unsigned char *output)
+{
+    size_t left = ilen % SHA256_BLOCK_SIZE;
+
+    memcpy(lane->state, iv, sizeof(lane->state));
+    lane->input  = input;
+    lane->blocks = ilen / SHA256_BLOCK_SIZE;
+    lane->total  = lane->blocks + ((left < 56) ? 1 : 2);
+    lane->next   = 0;
+    lane->output = output;
+
+    memset(lane->tail, 0, sizeof(lane->tail));
+    if (left > 0) {
+        memcpy(lane->tail, input + lane->blocks * SHA256_BLOCK_SIZE, left);
+    }
+    lane->tail[left] = 0x80;
+    MBEDTLS_PUT_UINT64_BE((uint64_t) ilen << 3, lane->tail,
+                          (lane->total - lane->blocks) * SHA256_BLOCK_SIZE - 8);
+}
+
+/*
+ * Hash a batch of messages eight at a time: a lane whose message is done
+ * takes the next one, idle lanes hash their stale tail.
+ */
+static int mbedtls_sha256_batch_x8_avx2(const unsigned char *const input[],
+                                        const size_t ilen[],
+                                        unsigned char *const output[],
+                                        size_t count,
+                                        int is224)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_lane lanes[SHA256_LANES];
+    uint32_t *state[SHA256_LANES];
+    const unsigned char *data[SHA256_LANES];
+    size_t queued = 0;
+    unsigned int active = 0;
+    unsigned int i, l;
+
+    memset(lanes, 0, sizeof(lanes));
+    mbedtls_sha256_init(&ctx);
+
+    /* The initial value of SHA-224 or SHA-256 */
+    if ((ret = mbedtls_sha256_starts(&ctx, is224)) != 0) {
+        goto exit;
+    }
+
+    for (l = 0; l < SHA256_LANES; l++) {
+        state[l] = lanes[l].state;
+
+        if (queued < count) {
+            mbedtls_sha256_lane_load(&lanes[l], ctx.state, input[queued],
+                                     ilen[queued], output[queued]);
+            queued++;
+            active++;
+        }
+    }
+
+    while (active > 0) {
+        for (l = 0; l < SHA256_LANES; l++) {
+            mbedtls_sha256_lane *lane = &lanes[l];
+
+            if (lane->output != NULL && lane->next < lane->blocks) {
+                data[l] = lane->input + lane->next * SHA256_BLOCK_SIZE;
+            } else if (lane->output != NULL) {
+                data[l] = lane->tail + (lane->next - lane->blocks) * SHA256_BLOCK_SIZE;
+            } else {
+                data[l] = lane->tail;
+            }
+        }
+
+        mbedtls_internal_sha256_process_x8_avx2(state, data);
+
+        for (l = 0; l < SHA256_LANES; l++) {
+            mbedtls_sha256_lane *lane = &lanes[l];
+
+            if (lane->output == NULL || ++lane->next < lane->total) {
+                continue;
+            }
+
+            for (i = 0; i < (is224 ? 7u : 8u); i++) {
+                MBEDTLS_PUT_UINT32_BE(lane->state[i], lane->output, 4 * i);
+            }
+
+            if (queued < count) {
+                mbedtls_sha256_lane_load(lane, ctx.state, input[queued],
+                                         ilen[queued], output[queued]);
+                queued++;
+            } else {
+                lane->output = NULL;
+                active--;
+            }
+        }
+    }
+
+    ret = 0;
+
+exit:
+    mbedtls_platform_zeroize(lanes, sizeof(lanes));
+    mbedtls_sha256_free(&ctx);
+    return ret;
+}
+
+#endif /* MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT */
+
 #endif /* !MBEDTLS_SHA256_ALT */
 
 /*
@@ -812,6 +1218,37 @@ exit:
     return ret;
 }
 
+/*
+ * output[i] = SHA-256( input[i] buffer ) for each buffer
+ */
+int mbedtls_sha256_batch(const unsigned char *const input[],
+                         const size_t ilen[],
+                         unsigned char *const output[],
+                         size_t count,
+                         int is224)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t i;
+
+#if defined(MBEDTLS_SHA256_USE_X86_SIMD_IF_PRESENT)
+    /* One SHA-NI stream outpaces eight AVX2 lanes, which only pay off
+     * without the SHA extensions */
+    if (count > 1 &&
+        !mbedtls_x86_sha256_has_support(MBEDTLS_SHA256_X86_SHA_NI) &&
+        mbedtls_x86_sha256_has_support(MBEDTLS_SHA256_X86_AVX2)) {
+        return mbedtls_sha256_batch_x8_avx2(input, ilen, output, count, is224);
+    }
+#endif
+
+    for (i = 0; i < count; i++) {
+        if ((ret = mbedtls_sha256(input[i], ilen[i], output[i], is224)) != 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
 #if defined(MBEDTLS_SELF_TEST)
 /*
  * FIPS-180-2 test vectors
@@ -24,9 +24,17 @@
 #include "stm32_crypto_wrapper.h"
 #include "psa/crypto.h"
 #include "kwe_psa_driver_interface.h"
+#include "mbedtls/aes.h"
 #include <zephyr/kernel.h>
 #include <zephyr/sys/printk.h>
 #include <zephyr/logging/log.h>
+#if defined(CONFIG_PM)
+#include <zephyr/pm/pm.h>
+#include <zephyr/pm/policy.h>
+#endif /* CONFIG_PM */
+#if defined(MBEDTLS_HAL_SHA1_ALT) || defined(MBEDTLS_HAL_SHA256_ALT) || defined(MBEDTLS_HAL_HMAC_ALT)
+#include "hash_alt.h"
+#endif /* MBEDTLS_HAL_SHA1_ALT || MBEDTLS_HAL_SHA256_ALT || MBEDTLS_HAL_HMAC_ALT */
 LOG_MODULE_REGISTER(crypto, LOG_LEVEL_DBG);
 /* Global variables ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
@@ -43,6 +51,42 @@ typedef enum
  */
 #define PSA_AES_CBC_KEY_ID_USER  ((psa_key_id_t)0x1fff0001)
 
+/* AES message lengths timed at boot, 16 to 1024 bytes */
+#define AES_CALIBRATION_SIZES    7U
+
+/* SAES interrupt priority: asynchronous KWE AES operations only */
+#define SAES_IRQ_PRIORITY        2U
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+/* GPDMA1 channels moving the data of long AES and GCM messages */
+#if defined(HW_CRYPTO_DPA_AES)
+#define CRYP_DMA_INSTANCE        SAES
+#define CRYP_DMA_IN_REQUEST      GPDMA1_REQUEST_SAES_IN
+#define CRYP_DMA_OUT_REQUEST     GPDMA1_REQUEST_SAES_OUT
+#else
+#define CRYP_DMA_INSTANCE        AES
+#define CRYP_DMA_IN_REQUEST      GPDMA1_REQUEST_AES_IN
+#define CRYP_DMA_OUT_REQUEST     GPDMA1_REQUEST_AES_OUT
+#endif /* HW_CRYPTO_DPA_AES */
+#define CRYP_DMA_IN_CHANNEL      GPDMA1_Channel6
+#define CRYP_DMA_IN_IRQn         GPDMA1_Channel6_IRQn
+#define CRYP_DMA_OUT_CHANNEL     GPDMA1_Channel7
+#define CRYP_DMA_OUT_IRQn        GPDMA1_Channel7_IRQn
+#define CRYP_DMA_IRQ_PRIORITY    2U
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
+/* CCB kept initialized between asymmetric KWE operations until idle */
+#if defined(KWE_ASYMMETRIC_KEY_WRAP_ENABLED) && defined(KWE_CCB_PERSISTENT_SESSION_ENABLED)
+#define CRYPTO_CCB_SESSION_ENABLED
+#endif /* KWE_ASYMMETRIC_KEY_WRAP_ENABLED && KWE_CCB_PERSISTENT_SESSION_ENABLED */
+
+/* Low power state notification: resident SAES key, CCB session and HASH context */
+#if defined(CONFIG_PM) && (defined(KWE_AES_KEY_RESIDENCY_ENABLED) || defined(CRYPTO_CCB_SESSION_ENABLED) \
+                           || defined(MBEDTLS_HAL_SHA1_ALT) || defined(MBEDTLS_HAL_SHA256_ALT) \
+                           || defined(MBEDTLS_HAL_HMAC_ALT))
+#define CRYPTO_PM_NOTIFIER_ENABLED
+#endif /* CONFIG_PM && (KWE_AES_KEY_RESIDENCY_ENABLED || CRYPTO_CCB_SESSION_ENABLED || MBEDTLS_HAL_xxx_ALT) */
+
 /* Private variables ---------------------------------------------------------*/
 /* AES CBC */
 /** Extract from NIST Special Publication 800-38A
@@ -123,8 +167,311 @@ __IO TestStatus glob_status = FAILED;
 /* Private function prototypes -----------------------------------------------*/
 static void SystemClock_Config(void);
 void Error_Handler(void);
+#if defined(CRYPTO_PM_NOTIFIER_ENABLED)
+static void crypto_pm_state_entry(enum pm_state state);
+
+static struct pm_notifier crypto_pm_notifier =
+{
+  .state_entry = crypto_pm_state_entry,
+};
+#endif /* CRYPTO_PM_NOTIFIER_ENABLED */
+#if defined(CRYPTO_CCB_SESSION_ENABLED)
+static void crypto_ccb_idle_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(crypto_ccb_idle_work, crypto_ccb_idle_work_handler);
+#endif /* CRYPTO_CCB_SESSION_ENABLED */
+#if defined(KWE_AES_ASYNC_ENABLED)
+static void kwe_saes_isr(const void *arg);
+static void kwe_async_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(kwe_async_work, kwe_async_work_handler);
+#endif /* KWE_AES_ASYNC_ENABLED */
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+static void crypto_dma_init(void);
+static void crypto_dma_isr(const void *arg);
+static int crypto_dma_wait(uint32_t timeout);
+static void crypto_dma_signal(void);
+
+static DMA_HandleTypeDef crypto_hdma_in;
+static DMA_HandleTypeDef crypto_hdma_out;
+static K_SEM_DEFINE(crypto_dma_sem, 0, 1);
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+#if defined(PSA_KWE_DRIVER_ENABLED)
+static K_MUTEX_DEFINE(crypto_kwe_workspace_mutex);
+#endif /* PSA_KWE_DRIVER_ENABLED */
 /* Functions Definition ------------------------------------------------------*/
 
+#if defined(CRYPTO_PM_NOTIFIER_ENABLED)
+/**
+  * @brief  Low power state entry notification
+  * @note   SAES key registers are not kept across low power states, the KWE
+  *         unwraps the AES key again on the next operation. The CCB session
+  *         is closed, the next asymmetric operation opens it again. The HASH
+  *         context left resident in the peripheral is saved to its context
+  *         for the same reason.
+  * @note   Run by the idle thread: no other thread is within a crypto call,
+  *         a thread blocked on an AES DMA transfer holds the low power
+  *         states off until the transfer is over.
+  * @param  state: low power state being entered
+  * @retval None
+  */
+static void crypto_pm_state_entry(enum pm_state state)
+{
+  ARG_UNUSED(state);
+
+#if defined(KWE_AES_KEY_RESIDENCY_ENABLED)
+  KWE_AesKeyInvalidate();
+#endif /* KWE_AES_KEY_RESIDENCY_ENABLED */
+#if defined(CRYPTO_CCB_SESSION_ENABLED)
+  (void) KWE_CcbSessionClose();
+#endif /* CRYPTO_CCB_SESSION_ENABLED */
+#if defined(MBEDTLS_HAL_SHA1_ALT) || defined(MBEDTLS_HAL_SHA256_ALT) || defined(MBEDTLS_HAL_HMAC_ALT)
+  mbedtls_hash_hw_release();
+#endif /* MBEDTLS_HAL_SHA1_ALT || MBEDTLS_HAL_SHA256_ALT || MBEDTLS_HAL_HMAC_ALT */
+}
+#endif /* CRYPTO_PM_NOTIFIER_ENABLED */
+
+#if defined(PSA_KWE_DRIVER_ENABLED)
+/**
+  * @brief  Take the KWE workspace for the operation of the calling thread
+  * @retval None
+  */
+void KWE_WorkspaceLockCallback(void)
+{
+  (void) k_mutex_lock(&crypto_kwe_workspace_mutex, K_FOREVER);
+}
+
+/**
+  * @brief  Give the KWE workspace back
+  * @retval None
+  */
+void KWE_WorkspaceUnlockCallback(void)
+{
+  (void) k_mutex_unlock(&crypto_kwe_workspace_mutex);
+}
+#endif /* PSA_KWE_DRIVER_ENABLED */
+
+#if defined(CRYPTO_CCB_SESSION_ENABLED)
+/**
+  * @brief  The CCB session stays open after an asymmetric KWE operation:
+  *         (re)start its idle timeout
+  * @retval None
+  */
+void KWE_CcbSessionIdleCallback(void)
+{
+  (void) k_work_reschedule(&crypto_ccb_idle_work, K_MSEC(KWE_CCB_SESSION_IDLE_TIMEOUT_MS));
+}
+
+/**
+  * @brief  Close the CCB session once idle
+  * @note   Run from the system work queue, whose cooperative thread is not
+  *         preempted by a KWE operation between the idle check and the
+  *         close. An operation it runs in the middle of has marked the
+  *         session busy before using it, so the session is left open.
+  * @param  work: unused
+  * @retval None
+  */
+static void crypto_ccb_idle_work_handler(struct k_work *work)
+{
+  ARG_UNUSED(work);
+
+  KWE_CcbSessionPoll();
+}
+#endif /* CRYPTO_CCB_SESSION_ENABLED */
+
+#if defined(KWE_AES_ASYNC_ENABLED)
+/**
+  * @brief  SAES interrupt service routine
+  * @note   Drives the asynchronous KWE AES operations.
+  * @param  arg: unused
+  * @retval None
+  */
+static void kwe_saes_isr(const void *arg)
+{
+  ARG_UNUSED(arg);
+
+  KWE_AesAsyncIRQHandler();
+}
+
+/**
+  * @brief  Hand a chunk of asynchronous KWE AES operation done by SAES over
+  *         to the system work queue
+  * @note   Called from the SAES interrupt.
+  * @retval None
+  */
+void KWE_AesAsyncScheduleCallback(void)
+{
+  (void) k_work_submit(&kwe_async_work);
+}
+
+/**
+  * @brief  Start the next chunk or complete the asynchronous KWE AES
+  *         operation, in thread context as it unwraps the key
+  * @param  work: unused
+  * @retval None
+  */
+static void kwe_async_work_handler(struct k_work *work)
+{
+  ARG_UNUSED(work);
+
+  KWE_AesAsyncProcess();
+}
+
+/**
+  * @brief  Completion callback of asynchronous KWE AES operations
+  * @note   Run from the system work queue.
+  *         Pass a struct k_poll_signal as p_context to
+  *         KWE_AesCipherUpdateAsync(), the signal is raised with the KWE
+  *         status as result so that the caller can wait with k_poll().
+  * @param  status: KWE status of the operation
+  * @param  p_context: the k_poll_signal to raise
+  * @retval None
+  */
+void crypto_kwe_async_signal(KWE_StatusTypeDef status, void *p_context)
+{
+  (void) k_poll_signal_raise((struct k_poll_signal *)p_context, (int)status);
+}
+#endif /* KWE_AES_ASYNC_ENABLED */
+
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+/**
+  * @brief  Initialize the GPDMA1 channels of the AES peripheral and give
+  *         them to the AES and GCM alternative modules
+  * @note   Each channel moves 32-bit words between memory and the data
+  *         register of the peripheral on its DMA request.
+  * @retval None
+  */
+static void crypto_dma_init(void)
+{
+  DMA_HandleTypeDef *hdma[2] = {&crypto_hdma_in, &crypto_hdma_out};
+  uint32_t i;
+
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+  crypto_hdma_in.Instance = CRYP_DMA_IN_CHANNEL;
+  crypto_hdma_in.Init.Request = CRYP_DMA_IN_REQUEST;
+  crypto_hdma_in.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  crypto_hdma_in.Init.SrcInc = DMA_SINC_INCREMENTED;
+  crypto_hdma_in.Init.DestInc = DMA_DINC_FIXED;
+
+  crypto_hdma_out.Instance = CRYP_DMA_OUT_CHANNEL;
+  crypto_hdma_out.Init.Request = CRYP_DMA_OUT_REQUEST;
+  crypto_hdma_out.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  crypto_hdma_out.Init.SrcInc = DMA_SINC_FIXED;
+  crypto_hdma_out.Init.DestInc = DMA_DINC_INCREMENTED;
+
+  for (i = 0U; i < 2U; i++)
+  {
+    hdma[i]->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    hdma[i]->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_WORD;
+    hdma[i]->Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+    hdma[i]->Init.Priority = DMA_HIGH_PRIORITY;
+    hdma[i]->Init.SrcBurstLength = 1U;
+    hdma[i]->Init.DestBurstLength = 1U;
+    hdma[i]->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    hdma[i]->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    hdma[i]->Init.Mode = DMA_NORMAL;
+    if (HAL_DMA_Init(hdma[i]) != HAL_OK)
+    {
+      /* The data is fed by the CPU */
+      LOG_ERR("AES DMA init failed");
+      return;
+    }
+  }
+
+  IRQ_CONNECT(CRYP_DMA_IN_IRQn, CRYP_DMA_IRQ_PRIORITY, crypto_dma_isr, &crypto_hdma_in, 0);
+  IRQ_CONNECT(CRYP_DMA_OUT_IRQn, CRYP_DMA_IRQ_PRIORITY, crypto_dma_isr, &crypto_hdma_out, 0);
+  irq_enable(CRYP_DMA_IN_IRQn);
+  irq_enable(CRYP_DMA_OUT_IRQn);
+
+  mbedtls_aes_hw_dma_setup(CRYP_DMA_INSTANCE, &crypto_hdma_in, &crypto_hdma_out,
+                           crypto_dma_wait, crypto_dma_signal);
+}
+
+/**
+  * @brief  AES DMA channel interrupt service routine
+  * @param  arg: DMA handle of the channel
+  * @retval None
+  */
+static void crypto_dma_isr(const void *arg)
+{
+  HAL_DMA_IRQHandler((DMA_HandleTypeDef *)arg);
+}
+
+/**
+  * @brief  Block the calling thread until the AES DMA transfer completes
+  * @note   The low power states are locked while the thread is blocked, as
+  *         the peripheral and the channels are not kept across them. The
+  *         thread has just started the transfer and the idle thread cannot
+  *         run before it blocks here.
+  * @param  timeout: timeout in ms
+  * @retval 0 when the transfer completed, else the transfer timed out
+  */
+static int crypto_dma_wait(uint32_t timeout)
+{
+  int ret;
+
+#if defined(CONFIG_PM)
+  pm_policy_state_lock_get(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES);
+  pm_policy_state_lock_get(PM_STATE_STANDBY, PM_ALL_SUBSTATES);
+#endif /* CONFIG_PM */
+
+  ret = k_sem_take(&crypto_dma_sem, K_MSEC(timeout));
+
+#if defined(CONFIG_PM)
+  pm_policy_state_lock_put(PM_STATE_STANDBY, PM_ALL_SUBSTATES);
+  pm_policy_state_lock_put(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES);
+#endif /* CONFIG_PM */
+
+  return ret;
+}
+
+/**
+  * @brief  Wake the thread waiting for the AES DMA transfer
+  * @note   Called from the DMA interrupt.
+  * @retval None
+  */
+static void crypto_dma_signal(void)
+{
+  k_sem_give(&crypto_dma_sem);
+}
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
+
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED) && defined(CONFIG_AES_SW_CALIBRATE)
+/**
+  * @brief  Calibrate the AES software/hardware crossover
+  * @note   Logs the AES-CBC latency per message length with the AES
+  *         peripheral, with the software AES, and as measured through the
+  *         hybrid dispatch with the calibrated threshold.
+  * @retval None
+  */
+static void crypto_aes_calibrate(void)
+{
+  uint32_t hw_cycles[AES_CALIBRATION_SIZES];
+  uint32_t sw_cycles[AES_CALIBRATION_SIZES];
+  uint32_t hybrid_cycles[AES_CALIBRATION_SIZES];
+  uint32_t threshold;
+  uint32_t length;
+  uint32_t i;
+
+  if (mbedtls_aes_hw_calibrate(hw_cycles, sw_cycles, hybrid_cycles,
+                               AES_CALIBRATION_SIZES) != 0)
+  {
+    LOG_ERR("AES calibration failed");
+    return;
+  }
+
+  threshold = (uint32_t) mbedtls_aes_hw_get_threshold();
+  for (i = 0U; i < AES_CALIBRATION_SIZES; i++)
+  {
+    length = 16U << i;
+    LOG_INF("AES-CBC %4u bytes: hw %6u, sw %6u, hybrid %6u cycles", length,
+            hw_cycles[i], sw_cycles[i], hybrid_cycles[i]);
+  }
+  LOG_INF("AES software threshold %u bytes", threshold);
+}
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED && CONFIG_AES_SW_CALIBRATE */
+
 static psa_status_t check_key_existence(psa_key_id_t key_id, psa_key_attributes_t *attributes) {
     psa_status_t status = psa_get_key_attributes(key_id, attributes);
     if (status != PSA_SUCCESS) {
@@ -154,12 +501,25 @@ int crypto_main(void)
    * --------------------------------------------------------------------------
    */
   
+#if defined(MBEDTLS_HAL_CRYP_DMA_THRESHOLD)
+  crypto_dma_init();
+#endif /* MBEDTLS_HAL_CRYP_DMA_THRESHOLD */
   retval = psa_crypto_init();
   if (retval != PSA_SUCCESS)
   {
     Error_Handler();
   }
   LOG_INF("PSA Crypto Initialized");
+#if defined(MBEDTLS_HAL_AES_SW_ENABLED) && defined(CONFIG_AES_SW_CALIBRATE)
+  crypto_aes_calibrate();
+#endif /* MBEDTLS_HAL_AES_SW_ENABLED && CONFIG_AES_SW_CALIBRATE */
+#if defined(CRYPTO_PM_NOTIFIER_ENABLED)
+  pm_notifier_register(&crypto_pm_notifier);
+#endif /* CRYPTO_PM_NOTIFIER_ENABLED */
+#if defined(KWE_AES_ASYNC_ENABLED)
+  IRQ_CONNECT(SAES_IRQn, SAES_IRQ_PRIORITY, kwe_saes_isr, NULL, 0);
+  irq_enable(SAES_IRQn);
+#endif /* KWE_AES_ASYNC_ENABLED */
   k_sleep(K_MSEC(1000));
   /* --------------------------------------------------------------------------
    *                   STM32 Key Wrap Engine
@@ -41,6 +41,9 @@ LOG_MODULE_REGISTER(storage, LOG_LEVEL_DBG);
 #ifndef PSA_ERROR_INSUFFICIENT_STORAGE
 #define PSA_ERROR_INSUFFICIENT_STORAGE ((psa_status_t)-3)
 #endif
+#ifndef PSA_ERROR_ALREADY_EXISTS
+#define PSA_ERROR_ALREADY_EXISTS ((psa_status_t)-5)
+#endif
 
 typedef struct {
     bool        used;
@@ -186,6 +189,58 @@ psa_status_t storage_remove(uint64_t obj_uid, uint32_t obj_size)
     return PSA_SUCCESS;
 }
 
+psa_status_t storage_set_batch(const storage_obj_t *p_objs,
+                               uint32_t obj_count)
+{
+    uint32_t free_slots = 0U;
+
+    if ((p_objs == NULL) && (obj_count != 0U)) {
+        LOG_ERR("storage_set_batch: p_objs is NULL");
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Check the whole batch fits before storing anything */
+    for (int i = 0; i < (int)STORAGE_MAX_ENTRIES; i++) {
+        if (!storage_table[i].used) {
+            free_slots++;
+        }
+    }
+    if (obj_count > free_slots) {
+        LOG_ERR("storage_set_batch: %u objects, %u free slots",
+                obj_count, free_slots);
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+    for (uint32_t i = 0U; i < obj_count; i++) {
+        if (p_objs[i].p_obj == NULL) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if (p_objs[i].obj_length > STORAGE_MAX_ITEM_SIZE) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+        if (find_entry(p_objs[i].obj_uid) >= 0) {
+            return PSA_ERROR_ALREADY_EXISTS;
+        }
+    }
+
+    for (uint32_t i = 0U; i < obj_count; i++) {
+        psa_status_t status = storage_set(p_objs[i].obj_uid,
+                                          p_objs[i].obj_length,
+                                          p_objs[i].p_obj);
+        if (status != PSA_SUCCESS) {
+            LOG_ERR("storage_set_batch: failed to store uid 0x%llx",
+                    p_objs[i].obj_uid);
+            /* Roll back: none of the batch objects existed before */
+            while (i > 0U) {
+                i--;
+                (void)storage_remove(p_objs[i].obj_uid,
+                                     p_objs[i].obj_length);
+            }
+            return status;
+        }
+    }
+    return PSA_SUCCESS;
+}
+
 static int storage_init(void)
 {
     for (int i = 0; i < (int)STORAGE_MAX_ENTRIES; i++) {
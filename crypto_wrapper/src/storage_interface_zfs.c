@@ -50,6 +50,9 @@ LOG_MODULE_REGISTER(key_storage, LOG_LEVEL_DBG);
 #ifndef PSA_ERROR_IO_ERROR
 #define PSA_ERROR_IO_ERROR ((psa_status_t)-4)
 #endif
+#ifndef PSA_ERROR_ALREADY_EXISTS
+#define PSA_ERROR_ALREADY_EXISTS ((psa_status_t)-5)
+#endif
 
 #define ZMS_PARTITION        storage_partition
 #define ZMS_PARTITION_DEVICE FIXED_PARTITION_DEVICE(ZMS_PARTITION)
@@ -163,6 +166,68 @@ psa_status_t storage_remove(uint64_t obj_uid, uint32_t obj_size)
     return PSA_SUCCESS;
 }
 
+psa_status_t storage_set_batch(const storage_obj_t *p_objs,
+                               uint32_t obj_count)
+{
+    int rc;
+    uint32_t i;
+    uint32_t written = 0U;
+
+    if ((p_objs == NULL) && (obj_count != 0U)) {
+        LOG_ERR("storage_set_batch: p_objs is NULL");
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /*
+     * ZMS has no multi-record transaction: the objects are written one by
+     * one, so the whole batch is validated before the first flash write and
+     * the objects already written are deleted if a write fails. A reset in
+     * the middle of the batch can still leave part of it stored.
+     */
+    for (i = 0U; i < obj_count; i++) {
+        if (p_objs[i].p_obj == NULL) {
+            LOG_ERR("storage_set_batch: p_obj %u is NULL", i);
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if (p_objs[i].obj_length > STORAGE_MAX_ITEM_SIZE) {
+            LOG_ERR("storage_set_batch: obj_length %u exceeds max %u",
+                    p_objs[i].obj_length, STORAGE_MAX_ITEM_SIZE);
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+        if (zms_get_data_length(&fs, p_objs[i].obj_uid) > 0) {
+            LOG_ERR("storage_set_batch: uid 0x%llx already exists",
+                    p_objs[i].obj_uid);
+            return PSA_ERROR_ALREADY_EXISTS;
+        }
+    }
+
+    for (i = 0U; i < obj_count; i++) {
+        rc = zms_write(&fs, p_objs[i].obj_uid, p_objs[i].p_obj,
+                       p_objs[i].obj_length);
+        if ((rc < 0) || (rc < p_objs[i].obj_length)) {
+            LOG_ERR("storage_set_batch: failed to write uid 0x%llx, rc=%d",
+                    p_objs[i].obj_uid, rc);
+            break;
+        }
+        written++;
+    }
+
+    if (written != obj_count) {
+        /* Roll back: none of the batch objects existed before */
+        for (i = 0U; i < written; i++) {
+            rc = zms_delete(&fs, p_objs[i].obj_uid);
+            if (rc < 0) {
+                LOG_ERR("storage_set_batch: failed to roll back uid 0x%llx, rc=%d",
+                        p_objs[i].obj_uid, rc);
+            }
+        }
+        return PSA_ERROR_IO_ERROR;
+    }
+
+    LOG_INF("storage_set_batch: stored %u objects", obj_count);
+    return PSA_SUCCESS;
+}
+
 static int delete_and_verify_items(uint64_t id)
 {
 	int rc = 0;